@@ -0,0 +1,177 @@
+// This benchmark compares the engines of the BlendOscillator (WAVETABLE, POLYBLEP, PREBLENDED) with
+// respect to CPU time (per oscillator sample and per Open303 output sample), the memory of the
+// tables they use and aliasing.
+//
+// Aliasing is measured at the oversampled rate of Open303 with frequencies that have an integer
+// number of periods in the FFT block (and a phase increment that is exactly representable), so the
+// output is exactly periodic and no window is needed: all the energy in the bins between the
+// harmonics is aliasing. It is given as the ratio of the aliased power below 20 kHz (the part
+// that survives the decimation) to the power of the harmonics.
+
+#include "../Source/DSPCode/rosic_Open303.h"
+#include "../Source/DSPCode/rosic_FourierTransformerRadix2.h"
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+using namespace rosic;
+
+static const double sampleRate        = 44100.0;
+static const double oversampledRate   = 4*sampleRate; // Open303 runs the oscillator at this rate
+static const int    tableLength       = 2048;         // MipMappedWaveTable::tableLength
+static const int    numMipMapLevels   = 12;           // MipMappedWaveTable::numTables
+static const int    fftSize           = 65536;
+static const int    numEngines        = 3;
+
+static const char* engineNames[numEngines] = { "WAVETABLE", "POLYBLEP", "PREBLENDED" };
+
+// an oscillator with its tables, set up like in Open303:
+struct OscillatorSetup
+{
+  MipMappedWaveTable waveTable1, waveTable2, blendedWaveTable;
+  BlendOscillator    oscillator;
+
+  OscillatorSetup(int engine, double blend)
+  {
+    oscillator.setWaveTable1(&waveTable1);
+    oscillator.setWaveForm1(MipMappedWaveTable::SAW303);
+    oscillator.setWaveTable2(&waveTable2);
+    oscillator.setWaveForm2(MipMappedWaveTable::SQUARE303);
+    oscillator.setBlendedWaveTable(&blendedWaveTable);
+    oscillator.setSampleRate(oversampledRate);
+    oscillator.setEngine(engine);
+    oscillator.setBlendFactor(blend);
+    for(int i=0; i<numMipMapLevels; i++) // the PREBLENDED table is rendered level by level
+      oscillator.updateWaveTables();
+  }
+};
+
+static double getSeconds(std::chrono::steady_clock::time_point start)
+{
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+
+//-------------------------------------------------------------------------------------------------
+// aliasing:
+
+// returns the aliased power below 20 kHz relative to the power of the harmonics (in dB) for a
+// frequency of periods*oversampledRate/fftSize:
+static double measureAliasing(int engine, double blend, int periods)
+{
+  OscillatorSetup setup(engine, blend);
+  setup.oscillator.setIncrement((double) tableLength * periods / fftSize);
+
+  std::vector<double> x(fftSize), magnitudes(fftSize/2);
+  for(int n=0; n<fftSize; n++)    // one block to settle, then the measured block
+    setup.oscillator.getSample();
+  for(int n=0; n<fftSize; n++)
+    x[n] = setup.oscillator.getSample();
+
+  FourierTransformerRadix2 transformer;
+  transformer.setBlockSize(fftSize);
+  transformer.getRealSignalMagnitudes(&x[0], &magnitudes[0]);
+
+  int    maxBin = (int) (20000.0 * fftSize / oversampledRate);
+  double harmonicPower = 0.0, aliasPower = 0.0;
+  for(int k=1; k<=maxBin; k++)
+  {
+    double power = magnitudes[k] * magnitudes[k];
+    if( k % periods == 0 )
+      harmonicPower += power;
+    else
+      aliasPower += power;
+  }
+  return 10.0 * log10(aliasPower / harmonicPower);
+}
+
+static void printAliasing()
+{
+  static const double frequencies[] = { 55.0, 262.0, 1000.0, 4000.0 };
+  static const int numFrequencies = sizeof(frequencies) / sizeof(frequencies[0]);
+  static const double blends[] = { 0.0, 1.0 };
+  static const char* blendNames[] = { "saw", "square" };
+
+  printf("aliasing below 20 kHz relative to the harmonics (dB):\n");
+  for(int b=0; b<2; b++)
+  {
+    for(int f=0; f<numFrequencies; f++)
+    {
+      int periods = (int) floor(frequencies[f] * fftSize / oversampledRate + 0.5);
+      printf("  %-6s %7.1f Hz:", blendNames[b], periods * oversampledRate / fftSize);
+      for(int e=0; e<numEngines; e++)
+        printf("  %s %6.1f", engineNames[e], measureAliasing(e, blends[b], periods));
+      printf("\n");
+    }
+  }
+}
+
+//-------------------------------------------------------------------------------------------------
+// CPU and memory:
+
+static void printOscillatorTimings()
+{
+  static const int numSamples = 8000000;
+  printf("ns per oscillator sample (262 Hz, blend 0.5, with updateWaveTables per sample):\n");
+  for(int e=0; e<numEngines; e++)
+  {
+    OscillatorSetup setup(e, 0.5);
+    setup.oscillator.setFrequency(262.0);
+    setup.oscillator.calculateIncrement();
+    volatile double sink = 0.0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for(int n=0; n<numSamples; n++)
+    {
+      setup.oscillator.updateWaveTables();
+      sink = setup.oscillator.getSample();
+    }
+    (void) sink;
+    printf("  %-10s %6.2f\n", engineNames[e], 1.e9 * getSeconds(start) / numSamples);
+  }
+}
+
+static void printSynthTimings()
+{
+  static const int numSeconds = 10;
+  int numSamples = numSeconds * (int) sampleRate;
+  printf("ns per Open303 output sample (a note every 1/8 second):\n");
+  for(int e=0; e<numEngines; e++)
+  {
+    Open303 synth;
+    synth.setSampleRate(sampleRate);
+    synth.setOscillatorEngine(e);
+    synth.setWaveform(0.5);
+    int samplesPerNote = (int) sampleRate / 8;
+    volatile double sink = 0.0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for(int n=0; n<numSamples; n++)
+    {
+      if( n % samplesPerNote == 0 )
+        synth.noteOn(36 + (n/samplesPerNote) % 24, 100);
+      sink = synth.getSample();
+    }
+    (void) sink;
+    printf("  %-10s %6.1f\n", engineNames[e], 1.e9 * getSeconds(start) / numSamples);
+  }
+}
+
+static void printMemory()
+{
+  // WAVETABLE reads both tables, PREBLENDED renders its table from both and then reads only that
+  // one, POLYBLEP uses none:
+  static const int numTablesRendered[numEngines] = { 2, 0, 3 };
+  static const int numTablesRead[numEngines]     = { 2, 0, 1 };
+  printf("table memory (%d bytes per MipMappedWaveTable):\n", (int) sizeof(MipMappedWaveTable));
+  for(int e=0; e<numEngines; e++)
+    printf("  %-10s rendered %7d bytes, read per sample from %d table(s)\n", engineNames[e],
+      numTablesRendered[e] * (int) sizeof(MipMappedWaveTable), numTablesRead[e]);
+}
+
+int main()
+{
+  printMemory();
+  printOscillatorTimings();
+  printSynthTimings();
+  printAliasing();
+  return 0;
+}
@@ -0,0 +1,111 @@
+// This benchmark measures the time it takes to build the wavetables: a complete table set (the
+// prototype waveform plus the FFT/iFFTs of the mip-map) for the 303 waveforms, the construction of
+// a MipMappedWaveTable and of an Open303 (which builds three of them) and the FourierTransformer
+// operations involved. Each time is the minimum over a number of runs.
+//
+// TableSetBenchmarkCompact is built with OPEN303_COMPACT_WAVETABLES, where the shortened mip-map
+// levels are computed with short iFFTs.
+
+#include "../Source/DSPCode/rosic_Open303.h"
+#include <chrono>
+#include <stdio.h>
+#include <vector>
+using namespace rosic;
+
+static const int numRuns = 200;
+
+static double getMicroseconds(std::chrono::steady_clock::time_point start)
+{
+  std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+
+// the minimum time over the runs of a function:
+template<class Function>
+static double measure(Function function)
+{
+  double minTime = 1.e300;
+  for(int r=0; r<numRuns; r++)
+  {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    function();
+    double time = getMicroseconds(start);
+    if( time < minTime )
+      minTime = time;
+  }
+  return minTime;
+}
+
+static void printTableSetTimes()
+{
+  static const int waveforms[] = { MipMappedWaveTable::SQUARE303, MipMappedWaveTable::SAW303 };
+  static const char* names[]   = { "SQUARE303", "SAW303" };
+  for(int w=0; w<2; w++)
+  {
+    MipMappedWaveTable* table = new MipMappedWaveTable;
+    table->setWaveform(waveforms[w]);
+    table->updateTables();
+    double time = measure([table]()
+    {
+      table->set303SquarePhaseShift(table->get303SquarePhaseShift()); // marks it as dirty
+      table->updateTables();
+    });
+    printf("table set build, %-10s %8.1f us\n", names[w], time);
+    delete table;
+  }
+}
+
+static void printConstructionTimes()
+{
+  double time = measure([]()
+  {
+    MipMappedWaveTable* table = new MipMappedWaveTable;
+    delete table;
+  });
+  printf("MipMappedWaveTable construction %8.1f us\n", time);
+
+  time = measure([]()
+  {
+    Open303* synth = new Open303;
+    delete synth;
+  });
+  printf("Open303 construction            %8.1f us\n", time);
+}
+
+static void printFourierTransformerTimes()
+{
+  static const int blockSize = 2048;
+  double time = measure([]()
+  {
+    FourierTransformerRadix2* transformer = new FourierTransformerRadix2;
+    transformer->setBlockSize(blockSize);
+    delete transformer;
+  });
+  printf("FourierTransformer setup (%d)  %8.1f us\n", blockSize, time);
+
+  FourierTransformerRadix2 transformer;
+  transformer.setBlockSize(blockSize);
+  std::vector<double> spectrum(blockSize), signal(blockSize);
+  for(int k=0; k<blockSize; k++)
+    spectrum[k] = 1.0 / (k+1);
+  time = measure([&]()
+  {
+    transformer.transformSymmetricSpectrum(&spectrum[0], &signal[0]);
+  });
+  printf("inverse real FFT (%d)          %8.1f us\n", blockSize, time);
+}
+
+int main()
+{
+#ifdef OPEN303_COMPACT_WAVETABLES
+  printf("compact table layout\n");
+#else
+  printf("full-length table layout\n");
+#endif
+  printf("sizeof(MipMappedWaveTable) %d bytes, sizeof(Open303) %d bytes\n",
+    (int) sizeof(MipMappedWaveTable), (int) sizeof(Open303));
+  printTableSetTimes();
+  printConstructionTimes();
+  printFourierTransformerTimes();
+  return 0;
+}
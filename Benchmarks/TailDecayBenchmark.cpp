@@ -0,0 +1,111 @@
+// This benchmark measures the time it takes to render the decay tail of a released note, after
+// the signal has decayed into the range of the denormal (subnormal) numbers - that's where the
+// recursive filters become slow on many CPUs when denormals are not flushed to zero. The tail is
+// rendered sample by sample without a DenormalGuard, sample by sample inside a guard and with
+// processBlock (which creates a guard itself).
+//
+// TailDecayBenchmarkNoFlushing is built with ROSIC_NO_DENORMAL_FLUSHING, i.e. like for platforms
+// without a flush-to-zero mode: the guards do nothing and the filters add TINY to their outputs.
+
+#include "../Source/DSPCode/rosic_Open303.h"
+#include "../Source/DSPCode/rosic_DenormalGuard.h"
+#include <chrono>
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+using namespace rosic;
+
+static const double sampleRate      = 44100.0;
+static const int    numDecaySeconds = 40;
+static const int    numTailSeconds  = 20;
+
+enum renderModes
+{
+  SAMPLES,
+  SAMPLES_GUARDED,
+  BLOCKS,
+
+  NUM_RENDER_MODES
+};
+
+static const char* renderModeNames[NUM_RENDER_MODES] =
+{
+  "getSample", "getSample with DenormalGuard", "processBlock"
+};
+
+// plays and releases a note and renders (without flushing) long enough for the output to decay
+// into the denormal range - returns the peak of the last second:
+static double renderIntoTail(Open303& synth)
+{
+  synth.setSampleRate(sampleRate);
+  synth.setDecay(400.0);
+  synth.setResonance(80.0);
+  synth.setAmpRelease(100.0);
+  synth.noteOn(36, 100);
+  int numSamplesPerSecond = (int) sampleRate;
+  for(int n=0; n<numSamplesPerSecond/2; n++)
+    synth.getSample();
+  synth.noteOn(36, 0);
+
+  double peak = 0.0;
+  for(int s=0; s<numDecaySeconds; s++)
+  {
+    peak = 0.0;
+    for(int n=0; n<numSamplesPerSecond; n++)
+      peak = fmax(peak, fabs(synth.getSample()));
+  }
+  return peak;
+}
+
+static double renderTail(Open303& synth, int mode)
+{
+  static const int blockSize = 64;
+  double block[blockSize];
+  int numBlocks = numTailSeconds * (int) sampleRate / blockSize;
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  volatile double sink = 0.0;
+  if( mode == SAMPLES )
+  {
+    for(int b=0; b<numBlocks; b++)
+      for(int n=0; n<blockSize; n++)
+        sink = synth.getSample();
+  }
+  else if( mode == SAMPLES_GUARDED )
+  {
+    DenormalGuard denormalGuard;
+    for(int b=0; b<numBlocks; b++)
+      for(int n=0; n<blockSize; n++)
+        sink = synth.getSample();
+  }
+  else
+  {
+    for(int b=0; b<numBlocks; b++)
+    {
+      synth.processBlock(block, blockSize);
+      sink = block[blockSize-1];
+    }
+  }
+  (void) sink;
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+
+int main()
+{
+#ifdef ROSIC_FLUSHES_DENORMALS
+  printf("denormals are flushed to zero inside the guards\n");
+#else
+  printf("no flush-to-zero mode - the filters add TINY\n");
+#endif
+
+  for(int mode=0; mode<NUM_RENDER_MODES; mode++)
+  {
+    Open303 synth;
+    double peak = renderIntoTail(synth);
+    double time = renderTail(synth, mode);
+    printf("%-30s %d s of tail (peak before: %.3g): %.3f s (%.0f times real time)\n",
+      renderModeNames[mode], numTailSeconds, peak, time, numTailSeconds / time);
+  }
+  return 0;
+}
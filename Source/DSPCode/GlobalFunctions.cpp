@@ -1,3 +1,3 @@
-#include "GlobalFunctions.h"
-
-
+#include "GlobalFunctions.h"
+
+
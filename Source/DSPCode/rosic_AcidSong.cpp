@@ -0,0 +1,135 @@
+#include "rosic_AcidSong.h"
+using namespace rosic;
+
+//-------------------------------------------------------------------------------------------------
+// construction/destruction:
+
+AcidSong::AcidSong()
+{
+  lengthInSamples = 0;
+  rootKey         = 36;
+}
+
+//-------------------------------------------------------------------------------------------------
+// setup:
+
+void AcidSong::addEntry(int pattern, int numRepeats, double bpm, int transpose)
+{
+  entries.push_back(Entry());
+  setEntry(getNumEntries()-1, pattern, numRepeats, bpm, transpose);
+}
+
+void AcidSong::setEntry(int index, int pattern, int numRepeats, double bpm, int transpose)
+{
+  if( index < 0 || index >= getNumEntries() )
+  {
+    DEBUG_BREAK; // index out of range
+    return;
+  }
+  entries[index].pattern    = pattern;
+  entries[index].numRepeats = rmax(numRepeats, 0);
+  entries[index].bpm        = bpm;
+  entries[index].transpose  = transpose;
+}
+
+void AcidSong::removeEntry(int index)
+{
+  if( index >= 0 && index < getNumEntries() )
+    entries.erase(entries.begin()+index);
+}
+
+void AcidSong::clear()
+{
+  entries.clear();
+  events.clear();
+  barStarts.clear();
+  lengthInSamples = 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+// others:
+
+void AcidSong::compile(AcidSequencer& sequencer, double sampleRate)
+{
+  events.clear();
+  barStarts.clear();
+
+  // flatten the chain into a sequence of steps, such that we can look ahead to the next note
+  // across pattern boundaries:
+  struct Step
+  {
+    AcidNote note;
+    double   duration;   // in samples
+    double   gateLength; // in steps
+    int      transpose;
+  };
+  std::vector<Step> steps;
+  for(unsigned int e=0; e<entries.size(); e++)
+  {
+    AcidPattern* pattern = sequencer.getPattern(entries[e].pattern);
+    if( pattern == NULL || entries[e].bpm <= 0.0 )
+      continue;
+    Step step;
+    step.duration   = sampleRate * beatsToSeconds(0.25, entries[e].bpm);
+    step.gateLength = pattern->getStepLength();
+    step.transpose  = entries[e].transpose;
+    for(int r=0; r<entries[e].numRepeats; r++)
+    {
+      for(int s=0; s<pattern->getNumSteps(); s++)
+      {
+        step.note = *pattern->getNote(s);
+        steps.push_back(step);
+      }
+    }
+  }
+
+  // create the events - this mimics the logic in Open303::getSample:
+  double position       = 0.0;  // exact position of the current step in samples
+  int    pendingRelease = -1;   // position of the scheduled note-off, if any
+  bool   slideIn        = false;
+  Event  event;
+  for(unsigned int i=0; i<steps.size(); i++)
+  {
+    int start = roundToInt(position);
+    if( i % stepsPerBar == 0 )
+      barStarts.push_back(start);
+
+    const AcidNote& note = steps[i].note;
+    if( note.gate )
+    {
+      // a new note cancels a note-off that is scheduled for a later time:
+      if( pendingRelease >= 0 && pendingRelease <= start )
+      {
+        event.sample = pendingRelease;
+        event.type   = RELEASE;
+        events.push_back(event);
+      }
+      pendingRelease = -1;
+
+      int key = sequencer.getClosestPermissibleKey(note.key);
+      key     = clip(key + 12*note.octave + steps[i].transpose + rootKey, 0, 127);
+      event.sample = start;
+      event.type   = slideIn ? SLIDE : TRIGGER;
+      event.key    = key;
+      event.accent = note.accent;
+      events.push_back(event);
+
+      if( note.slide && i+1 < steps.size() && steps[i+1].note.gate )
+        slideIn = true;
+      else
+      {
+        slideIn        = false;
+        pendingRelease = start + roundToInt(steps[i].gateLength * steps[i].duration);
+      }
+    }
+    position += steps[i].duration;
+  }
+  if( pendingRelease >= 0 )
+  {
+    event.sample = pendingRelease;
+    event.type   = RELEASE;
+    events.push_back(event);
+  }
+
+  lengthInSamples = roundToInt(position);
+}
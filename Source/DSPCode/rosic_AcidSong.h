@@ -0,0 +1,138 @@
+#ifndef rosic_AcidSong_h
+#define rosic_AcidSong_h
+
+// rosic-indcludes:
+#include "rosic_AcidSequencer.h"
+
+#include <vector>
+
+namespace rosic
+{
+
+  /**
+
+  This is a class for representing a song, i.e. a chain of patterns of an AcidSequencer where each
+  entry of the chain specifies which pattern is played, how many times it is repeated and with
+  which tempo and transposition.
+
+  Before the song can be played, it must be compiled via compile(). This reads the patterns and
+  the permissible keys from the sequencer and turns them into one contiguous timeline of note
+  events (trigger, slide, release) with absolute sample positions - so playback (see
+  AcidSongPlayer) never needs to look into the patterns. Compilation allocates memory and should
+  hence be done outside the audio thread. The song has to be re-compiled after changes of the
+  chain, the patterns or the sample rate.
+
+  The step positions are computed by accumulating the exact (fractional) step durations and
+  rounding each position individually, such that there is no timing drift, even with changing
+  tempi. A bar in the timeline comprises 16 steps (16th notes), regardless of the lengths of the
+  patterns.
+
+  */
+
+  class AcidSong
+  {
+
+  public:
+
+    /** Enumeration of the types of the compiled events. */
+    enum eventTypes
+    {
+      TRIGGER = 0, // start a new note
+      SLIDE,       // slide from the current note to a new one
+      RELEASE      // release the current note
+    };
+
+    /** An entry of the chain. */
+    struct Entry
+    {
+      int    pattern;    // index of the pattern in the sequencer
+      int    numRepeats; // number of times that the pattern is played
+      double bpm;        // tempo in beats per minute
+      int    transpose;  // transposition in semitones
+    };
+
+    /** A compiled note event. */
+    struct Event
+    {
+      int  sample; // position in samples from the start of the song
+      int  type;   // @see eventTypes
+      int  key;    // the MIDI key for triggers and slides
+      bool accent; // the accent for triggers and slides
+    };
+
+    //---------------------------------------------------------------------------------------------
+    // construction/destruction:
+
+    /** Constructor. */
+    AcidSong();
+
+    //---------------------------------------------------------------------------------------------
+    // setup:
+
+    /** Appends an entry to the chain. */
+    void addEntry(int pattern, int numRepeats, double bpm, int transpose);
+
+    /** Replaces an existing entry of the chain. */
+    void setEntry(int index, int pattern, int numRepeats, double bpm, int transpose);
+
+    /** Removes an entry from the chain. */
+    void removeEntry(int index);
+
+    /** Removes all entries from the chain (and the compiled timeline). */
+    void clear();
+
+    /** Sets the MIDI key to which the keys of the patterns refer (the note which would be held in
+    the sequencer mode of Open303). */
+    void setRootKey(int newRootKey) { rootKey = newRootKey; }
+
+    //---------------------------------------------------------------------------------------------
+    // inquiry:
+
+    /** Returns the number of entries in the chain. */
+    int getNumEntries() const { return (int) entries.size(); }
+
+    /** Returns one of the entries of the chain. */
+    const Entry& getEntry(int index) const { return entries[index]; }
+
+    /** Returns the root key @see setRootKey */
+    int getRootKey() const { return rootKey; }
+
+    /** Returns the number of events in the compiled timeline. */
+    int getNumEvents() const { return (int) events.size(); }
+
+    /** Returns a pointer to the compiled events (sorted by time). */
+    const Event* getEvents() const { return events.empty() ? NULL : &events[0]; }
+
+    /** Returns the length of the compiled song in samples. */
+    int getLengthInSamples() const { return lengthInSamples; }
+
+    /** Returns the number of (possibly incomplete) bars in the compiled song. */
+    int getNumBars() const { return (int) barStarts.size(); }
+
+    /** Returns the start position of a bar in samples. */
+    int getBarStart(int bar) const { return barStarts[bar]; }
+
+    //---------------------------------------------------------------------------------------------
+    // others:
+
+    /** Compiles the chain into the timeline of events for the given sample rate, using the
+    patterns and permissible keys of the sequencer. */
+    void compile(AcidSequencer& sequencer, double sampleRate);
+
+    //=============================================================================================
+
+  protected:
+
+    static const int stepsPerBar = 16;
+
+    std::vector<Entry> entries;
+    std::vector<Event> events;
+    std::vector<int>   barStarts;
+    int                lengthInSamples;
+    int                rootKey;
+
+  };
+
+} // end namespace rosic
+
+#endif // rosic_AcidSong_h
@@ -0,0 +1,155 @@
+#include "rosic_AcidSongPlayer.h"
+#include "rosic_DenormalGuard.h"
+using namespace rosic;
+
+//-------------------------------------------------------------------------------------------------
+// construction/destruction:
+
+AcidSongPlayer::AcidSongPlayer()
+{
+  song      = NULL;
+  synth     = NULL;
+  position  = 0;
+  nextEvent = 0;
+  looping   = false;
+  noteIsOn  = false;
+}
+
+//-------------------------------------------------------------------------------------------------
+// setup:
+
+void AcidSongPlayer::setSynth(Open303* newSynth)
+{
+  synth    = newSynth;
+  noteIsOn = false;
+}
+
+void AcidSongPlayer::setSong(const AcidSong* newSong)
+{
+  song = newSong;
+  seekToSample(0);
+}
+
+//-------------------------------------------------------------------------------------------------
+// inquiry:
+
+bool AcidSongPlayer::isFinished() const
+{
+  if( song == NULL )
+    return true;
+  return !looping && position >= song->getLengthInSamples()
+    && nextEvent >= song->getNumEvents();
+}
+
+//-------------------------------------------------------------------------------------------------
+// audio processing:
+
+void AcidSongPlayer::render(double* buffer, int numSamples)
+{
+  DenormalGuard denormalGuard;
+
+  if( song == NULL || synth == NULL )
+  {
+    for(int n=0; n<numSamples; n++)
+      buffer[n] = 0.0;
+    return;
+  }
+
+  const AcidSong::Event* events    = song->getEvents();
+  int                    numEvents = song->getNumEvents();
+  int                    length    = song->getLengthInSamples();
+
+  int n = 0;
+  while( n < numSamples )
+  {
+    // apply all events that are due:
+    while( nextEvent < numEvents && events[nextEvent].sample <= position )
+      applyEvent(events[nextEvent++]);
+
+    // wrap around at the end of the song - the remaining events (note-offs which are scheduled
+    // beyond the end) are applied before:
+    if( looping && length > 0 && position >= length )
+    {
+      while( nextEvent < numEvents )
+        applyEvent(events[nextEvent++]);
+      position  = 0;
+      nextEvent = 0;
+      continue;
+    }
+
+    // render up to the event horizon:
+    int horizon = numSamples - n;
+    if( nextEvent < numEvents )
+      horizon = rmin(horizon, events[nextEvent].sample - position);
+    if( looping && length > 0 )
+      horizon = rmin(horizon, length - position);
+    synth->processBlock(&buffer[n], horizon);
+    n        += horizon;
+    position += horizon;
+  }
+}
+
+//-------------------------------------------------------------------------------------------------
+// event handling:
+
+void AcidSongPlayer::seekToSample(int newPosition)
+{
+  if( synth != NULL && noteIsOn )
+    synth->releaseNote(0);
+  noteIsOn = false;
+
+  position  = rmax(newPosition, 0);
+  nextEvent = 0;
+  if( song == NULL )
+    return;
+
+  // binary search for the first event at or after the new position:
+  const AcidSong::Event* events = song->getEvents();
+  int lo = 0;
+  int hi = song->getNumEvents();
+  while( lo < hi )
+  {
+    int mid = (lo+hi) / 2;
+    if( events[mid].sample < position )
+      lo = mid+1;
+    else
+      hi = mid;
+  }
+  nextEvent = lo;
+}
+
+void AcidSongPlayer::seekToBar(int bar)
+{
+  if( song == NULL || bar < 0 || bar >= song->getNumBars() )
+    return;
+  seekToSample(song->getBarStart(bar));
+}
+
+void AcidSongPlayer::applyEvent(const AcidSong::Event& event)
+{
+  switch(event.type)
+  {
+  case AcidSong::TRIGGER:
+    {
+      synth->triggerNote(event.key, event.accent);
+      noteIsOn = true;
+    }
+    break;
+  case AcidSong::SLIDE:
+    {
+      if( noteIsOn )
+        synth->slideToNote(event.key, event.accent);
+      else
+        synth->triggerNote(event.key, event.accent);
+      noteIsOn = true;
+    }
+    break;
+  case AcidSong::RELEASE:
+    {
+      if( noteIsOn )
+        synth->releaseNote(event.key);
+      noteIsOn = false;
+    }
+    break;
+  }
+}
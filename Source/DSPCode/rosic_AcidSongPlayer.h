@@ -0,0 +1,97 @@
+#ifndef rosic_AcidSongPlayer_h
+#define rosic_AcidSongPlayer_h
+
+// rosic-indcludes:
+#include "rosic_AcidSong.h"
+#include "rosic_Open303.h"
+
+namespace rosic
+{
+
+  /**
+
+  This is a class for playing a compiled AcidSong on an Open303. It walks through the song's
+  timeline with the event-horizon approach: the samples up to the next event are rendered in one
+  tight loop without any checks, then the event is applied to the synth (via triggerNote,
+  slideToNote or releaseNote) and so on. The synth's own sequencer is not used and should be
+  switched off.
+
+  The player may be positioned to any sample or bar. Seeking releases a sounding note and
+  continues with the events from the new position on (a slide at that position becomes a
+  trigger). Rendering does not allocate memory, so it may be called from the audio thread. The
+  song must not be re-compiled while it's being played.
+
+  */
+
+  class AcidSongPlayer
+  {
+
+  public:
+
+    //---------------------------------------------------------------------------------------------
+    // construction/destruction:
+
+    /** Constructor. */
+    AcidSongPlayer();
+
+    //---------------------------------------------------------------------------------------------
+    // setup:
+
+    /** Sets the synth to be played. The player does not take ownership. */
+    void setSynth(Open303* newSynth);
+
+    /** Sets the (compiled) song to be played and moves to its start. The player does not take
+    ownership. */
+    void setSong(const AcidSong* newSong);
+
+    /** Switches looping of the song on or off. */
+    void setLooping(bool shouldLoop) { looping = shouldLoop; }
+
+    //---------------------------------------------------------------------------------------------
+    // inquiry:
+
+    /** Returns the current playback position in samples. */
+    int getPosition() const { return position; }
+
+    /** Returns true when looping is switched on. */
+    bool isLooping() const { return looping; }
+
+    /** Returns true when the end of the song has been reached (never when looping). */
+    bool isFinished() const;
+
+    //---------------------------------------------------------------------------------------------
+    // audio processing:
+
+    /** Renders the given number of samples into the buffer. When there's no song or synth, the
+    buffer is filled with zeros. After the end of a song (without looping), the synth keeps
+    running, so the release tail of the last note is rendered. */
+    void render(double* buffer, int numSamples);
+
+    //---------------------------------------------------------------------------------------------
+    // event handling:
+
+    /** Moves the playback position to the given sample. */
+    void seekToSample(int newPosition);
+
+    /** Moves the playback position to the start of the given bar. */
+    void seekToBar(int bar);
+
+    //=============================================================================================
+
+  protected:
+
+    /** Applies an event to the synth. */
+    void applyEvent(const AcidSong::Event& event);
+
+    const AcidSong* song;
+    Open303*        synth;
+    int             position;  // playback position in samples
+    int             nextEvent; // index of the next event to apply
+    bool            looping;
+    bool            noteIsOn;  // true when a triggered note was not yet released
+
+  };
+
+} // end namespace rosic
+
+#endif // rosic_AcidSongPlayer_h
@@ -0,0 +1,341 @@
+#include "rosic_AudioFileWriter.h"
+#include "rosic_RealFunctions.h"
+#include "rosic_NumberManipulations.h"
+
+#include <string.h>
+
+#ifndef _WIN32
+  #include <sys/mman.h>
+  #include <unistd.h>
+#endif
+
+using namespace rosic;
+
+//-------------------------------------------------------------------------------------------------
+// helpers for little endian numbers:
+
+static void write16(unsigned char* p, unsigned int x)
+{
+  p[0] = (unsigned char) ( x       & 0xFF);
+  p[1] = (unsigned char) ((x >> 8) & 0xFF);
+}
+
+static void write32(unsigned char* p, UINT64 x)
+{
+  for(int i=0; i<4; i++)
+    p[i] = (unsigned char) ((x >> (8*i)) & 0xFF);
+}
+
+static void write64(unsigned char* p, UINT64 x)
+{
+  for(int i=0; i<8; i++)
+    p[i] = (unsigned char) ((x >> (8*i)) & 0xFF);
+}
+
+//-------------------------------------------------------------------------------------------------
+// construction/destruction:
+
+AudioFileWriter::AudioFileWriter()
+{
+  file              = NULL;
+  blockSizes[0]     = blockSizes[1]   = 0;
+  blockPending[0]   = blockPending[1] = false;
+  quit              = false;
+  ioError           = false;
+  fillIndex         = 0;
+  fillPosition      = 0;
+  numFramesPerBlock = 65536;
+  numChannels       = 1;
+  bytesPerSample    = 2;
+  format            = PCM_16;
+  sampleRate        = 44100;
+  memoryMapped      = false;
+  dataOffset        = 0;
+  numFramesWritten  = 0;
+  numWaits          = 0;
+  maxRiffSize       = 0xFFFFFFFF;
+}
+
+AudioFileWriter::~AudioFileWriter()
+{
+  close();
+}
+
+//-------------------------------------------------------------------------------------------------
+// setup:
+
+void AudioFileWriter::setBlockSize(int newNumFrames)
+{
+  if( newNumFrames >= 1 )
+    numFramesPerBlock = newNumFrames;
+}
+
+bool AudioFileWriter::open(const char* path, int newSampleRate, int newNumChannels,
+                           int newFormat, bool useMemoryMapping)
+{
+  close();
+  if( newSampleRate <= 0 || newNumChannels < 1 || newNumChannels > 0xFFFF
+    || newFormat < PCM_16 || newFormat > FLOAT_32 )
+    return false;
+
+  sampleRate     = newSampleRate;
+  numChannels    = newNumChannels;
+  format         = newFormat;
+  bytesPerSample = format == PCM_16 ? 2 : (format == PCM_24 ? 3 : 4);
+#ifdef _WIN32
+  memoryMapped   = false;
+#else
+  memoryMapped   = useMemoryMapping;
+#endif
+
+  file = fopen(path, memoryMapped ? "w+b" : "wb"); // shared mappings need read access
+  if( file == NULL )
+    return false;
+
+  // the header for an empty file is written first and updated in close():
+  ioError = !writeHeader(0) || fflush(file) != 0;
+  if( ioError )
+  {
+    fclose(file);
+    file = NULL;
+    return false;
+  }
+
+  size_t blockSize = (size_t) numFramesPerBlock * numChannels * bytesPerSample;
+  for(int i=0; i<2; i++)
+  {
+    blocks[i].resize(blockSize);
+    blockSizes[i]   = 0;
+    blockPending[i] = false;
+  }
+  quit             = false;
+  fillIndex        = 0;
+  fillPosition     = 0;
+  dataOffset       = getHeaderSize();
+  numFramesWritten = 0;
+  numWaits         = 0;
+  ioThread         = std::thread(&AudioFileWriter::ioLoop, this);
+  return true;
+}
+
+bool AudioFileWriter::close()
+{
+  if( file == NULL )
+    return true;
+
+  // hand over the partially filled block and let the I/O thread finish:
+  if( fillPosition > 0 )
+    submitBlock();
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    quit = true;
+  }
+  blockStateChanged.notify_all();
+  ioThread.join();
+
+  // RIFF chunks have an even size, so an odd number of data bytes needs a pad byte:
+  UINT64 dataSize = numFramesWritten * numChannels * bytesPerSample;
+  bool   ok       = !ioError;
+  if( ok && (dataSize & 1) )
+  {
+    unsigned char pad = 0;
+    ok = writeData(&pad, 1);
+  }
+  ok = ok && fseek(file, 0, SEEK_SET) == 0 && writeHeader(dataSize);
+  ok = (fclose(file) == 0) && ok;
+  file = NULL;
+
+  for(int i=0; i<2; i++)
+    std::vector<unsigned char>().swap(blocks[i]); // frees the memory
+  return ok;
+}
+
+//-------------------------------------------------------------------------------------------------
+// inquiry:
+
+bool AudioFileWriter::hasError() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return ioError;
+}
+
+//-------------------------------------------------------------------------------------------------
+// audio processing:
+
+bool AudioFileWriter::write(const double* frames, int numFrames)
+{
+  if( file == NULL || hasError() )
+    return false;
+
+  int numSamples = numFrames * numChannels;
+  for(int n=0; n<numSamples; n++)
+  {
+    unsigned char* p = &blocks[fillIndex][fillPosition];
+    double         x = frames[n];
+    switch( format )
+    {
+    case PCM_16:
+      {
+        write16(p, (unsigned int) roundToInt(32767.0 * clip(x, -1.0, 1.0)));
+      }
+      break;
+    case PCM_24:
+      {
+        int i = roundToInt(8388607.0 * clip(x, -1.0, 1.0));
+        p[0]  = (unsigned char) ( i        & 0xFF);
+        p[1]  = (unsigned char) ((i >> 8)  & 0xFF);
+        p[2]  = (unsigned char) ((i >> 16) & 0xFF);
+      }
+      break;
+    case FLOAT_32:
+      {
+        float f = (float) x;
+        UINT32 bits;
+        memcpy(&bits, &f, 4);
+        write32(p, bits);
+      }
+      break;
+    }
+    fillPosition += bytesPerSample;
+    if( fillPosition == blocks[fillIndex].size() )
+      submitBlock();
+  }
+
+  numFramesWritten += numFrames;
+  return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+// internal functions:
+
+void AudioFileWriter::submitBlock()
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  blockSizes[fillIndex]   = fillPosition;
+  blockPending[fillIndex] = true;
+  blockStateChanged.notify_all();
+
+  fillIndex    = 1 - fillIndex;
+  fillPosition = 0;
+  if( blockPending[fillIndex] )
+  {
+    numWaits++;
+    while( blockPending[fillIndex] )
+      blockStateChanged.wait(lock);
+  }
+}
+
+void AudioFileWriter::ioLoop()
+{
+  int writeIndex = 0; // blocks are submitted alternately, so they are drained alternately
+  std::unique_lock<std::mutex> lock(mutex);
+  while( true )
+  {
+    while( !blockPending[writeIndex] && !quit )
+      blockStateChanged.wait(lock);
+    if( !blockPending[writeIndex] )
+      return; // quit and nothing left to write
+
+    // write without holding the lock, so the render thread can fill the other block meanwhile:
+    lock.unlock();
+    bool ok = ioError || writeData(&blocks[writeIndex][0], blockSizes[writeIndex]);
+    lock.lock();
+
+    ioError                  = !ok;
+    blockPending[writeIndex] = false;
+    writeIndex               = 1 - writeIndex;
+    blockStateChanged.notify_all();
+  }
+}
+
+bool AudioFileWriter::writeData(const unsigned char* data, size_t size)
+{
+#ifndef _WIN32
+  if( memoryMapped )
+  {
+    // grow the file and copy the block into a mapping of its range (which has to start at a page
+    // boundary):
+    int    fd         = fileno(file);
+    UINT64 pageSize   = (UINT64) sysconf(_SC_PAGESIZE);
+    UINT64 mapOffset  = dataOffset - dataOffset % pageSize;
+    size_t mapSize    = (size_t) (dataOffset - mapOffset) + size;
+    if( ftruncate(fd, (off_t) (dataOffset + size)) != 0 )
+      return false;
+    void* p = mmap(NULL, mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, (off_t) mapOffset);
+    if( p == MAP_FAILED )
+      return false;
+    memcpy((unsigned char*) p + (dataOffset - mapOffset), data, size);
+    munmap(p, mapSize);
+    dataOffset += size;
+    return true;
+  }
+#endif
+  if( fwrite(data, 1, size, file) != size )
+    return false;
+  dataOffset += size;
+  return true;
+}
+
+int AudioFileWriter::getHeaderSize() const
+{
+  // RIFF header, JUNK/ds64 chunk, fmt chunk (with cbSize for float), fact chunk for float, data
+  // chunk header:
+  if( format == FLOAT_32 )
+    return 12 + 36 + 26 + 12 + 8;
+  else
+    return 12 + 36 + 24 + 8;
+}
+
+bool AudioFileWriter::writeHeader(UINT64 dataSize)
+{
+  unsigned char header[12 + 36 + 26 + 12 + 8];
+  int    headerSize  = getHeaderSize();
+  UINT64 riffSize    = headerSize - 8 + dataSize + (dataSize & 1);
+  UINT64 numFrames   = dataSize / (numChannels * bytesPerSample);
+  bool   isRF64      = riffSize > maxRiffSize;
+  int    fmtSize     = format == FLOAT_32 ? 18 : 16;
+  int    blockAlign  = numChannels * bytesPerSample;
+  unsigned char* p   = header;
+
+  memcpy(p, isRF64 ? "RF64" : "RIFF", 4);
+  write32(p+4, isRF64 ? 0xFFFFFFFF : riffSize);
+  memcpy(p+8, "WAVE", 4);
+  p += 12;
+
+  // the JUNK chunk reserves the space for the ds64 chunk (sizes of the RIFF and data chunks and
+  // the number of frames, no table):
+  memset(p, 0, 36);
+  memcpy(p, isRF64 ? "ds64" : "JUNK", 4);
+  write32(p+4, 28);
+  if( isRF64 )
+  {
+    write64(p+8,  riffSize);
+    write64(p+16, dataSize);
+    write64(p+24, numFrames);
+  }
+  p += 36;
+
+  memcpy(p, "fmt ", 4);
+  write32(p+4,  fmtSize);
+  write16(p+8,  format == FLOAT_32 ? 3 : 1); // WAVE_FORMAT_IEEE_FLOAT or WAVE_FORMAT_PCM
+  write16(p+10, numChannels);
+  write32(p+12, sampleRate);
+  write32(p+16, (UINT64) sampleRate * blockAlign);
+  write16(p+20, blockAlign);
+  write16(p+22, 8*bytesPerSample);
+  p += 24;
+  if( format == FLOAT_32 )
+  {
+    write16(p, 0); // cbSize
+    p += 2;
+    memcpy(p, "fact", 4);
+    write32(p+4, 4);
+    write32(p+8, isRF64 ? 0xFFFFFFFF : numFrames);
+    p += 12;
+  }
+
+  memcpy(p, "data", 4);
+  write32(p+4, isRF64 ? 0xFFFFFFFF : dataSize);
+
+  return fwrite(header, 1, headerSize, file) == (size_t) headerSize;
+}
@@ -0,0 +1,143 @@
+#ifndef rosic_AudioFileWriter_h
+#define rosic_AudioFileWriter_h
+
+// rosic-indcludes:
+#include "GlobalDefinitions.h"
+
+#include <stdio.h>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace rosic
+{
+
+  /**
+
+  This is a class for streaming long offline renders into WAV files with 16 or 24 bit integer or
+  32 bit float samples. Files that end up larger than 4 GB are written as RF64 (EBU Tech 3306):
+  the header reserves space for the ds64 chunk in a JUNK chunk, which is converted when the file is
+  closed - so short files are plain WAV files and long ones don't need to be rewritten.
+
+  Writing is asynchronous and double-buffered: write() only converts the samples into one of two
+  blocks, and a full block is handed over to a dedicated I/O thread which drains it to disk while
+  the renderer fills the other one. So the rendering and disk I/O overlap and the render thread
+  never calls into the file system - it only waits when it's faster than the disk and both blocks
+  are full (counted by getNumWaits()). Optionally, the I/O thread copies the blocks into memory
+  mappings of the file instead of writing them (POSIX systems only, elsewhere this is the same as
+  the normal mode).
+
+  */
+
+  class AudioFileWriter
+  {
+
+  public:
+
+    /** Sample formats of the file. */
+    enum sampleFormats
+    {
+      PCM_16 = 0,
+      PCM_24,
+      FLOAT_32
+    };
+
+    //---------------------------------------------------------------------------------------------
+    // construction/destruction:
+
+    /** Constructor. */
+    AudioFileWriter();
+
+    /** Destructor. Closes the file, if any. */
+    ~AudioFileWriter();
+
+    //---------------------------------------------------------------------------------------------
+    // setup:
+
+    /** Sets the size of each of the two blocks in frames. Takes effect when the next file is
+    opened. */
+    void setBlockSize(int newNumFrames);
+
+    /** Creates the file and starts the I/O thread. Returns false when the file can't be created or
+    the arguments are invalid. */
+    bool open(const char* path, int sampleRate, int numChannels, int format,
+      bool useMemoryMapping = false);
+
+    /** Flushes the remaining samples, waits for the I/O thread, finalizes the header and closes
+    the file. Returns false when an I/O error occurred at any time. */
+    bool close();
+
+    //---------------------------------------------------------------------------------------------
+    // inquiry:
+
+    /** Returns true when a file is open. */
+    bool isOpen() const { return file != NULL; }
+
+    /** Returns the number of frames that were passed to write() since the file was opened. */
+    UINT64 getNumFramesWritten() const { return numFramesWritten; }
+
+    /** Returns how often write() had to wait for the I/O thread since the file was opened. */
+    int getNumWaits() const { return numWaits; }
+
+    /** Returns true when the I/O thread has encountered an error. */
+    bool hasError() const;
+
+    //---------------------------------------------------------------------------------------------
+    // audio processing:
+
+    /** Writes the given number of frames (numChannels interleaved samples each). Samples are
+    clipped to -1...+1 for the integer formats. Returns false when there's no open file or an I/O
+    error occurred. */
+    bool write(const double* frames, int numFrames);
+
+    //=============================================================================================
+
+  protected:
+
+    /** Hands the block that is currently filled over to the I/O thread and switches to the other
+    one (waiting until it has been drained). */
+    void submitBlock();
+
+    /** The function of the I/O thread. */
+    void ioLoop();
+
+    /** Writes a block of bytes at the end of the data (called from the I/O thread). */
+    bool writeData(const unsigned char* data, size_t size);
+
+    /** Writes the header for the given size of the sample data, as RF64 when necessary. */
+    bool writeHeader(UINT64 dataSize);
+
+    /** Returns the size of the header in bytes. */
+    int getHeaderSize() const;
+
+    FILE*                      file;
+    std::thread                ioThread;
+    mutable std::mutex         mutex;           // guards the variables used by both threads
+    std::condition_variable    blockStateChanged;
+    std::vector<unsigned char> blocks[2];
+    size_t                     blockSizes[2];   // number of bytes to write for submitted blocks
+    bool                       blockPending[2]; // true while a block waits for the I/O thread
+    bool                       quit;
+    bool                       ioError;
+    int                        fillIndex;       // block that is currently filled by write()
+    size_t                     fillPosition;    // bytes filled so far
+    int                        numFramesPerBlock, numChannels, bytesPerSample, format, sampleRate;
+    bool                       memoryMapped;
+    UINT64                     dataOffset;      // file offset for the next block (I/O thread)
+    UINT64                     numFramesWritten;
+    int                        numWaits;
+    UINT64                     maxRiffSize;     // larger files are written as RF64 - the 4 GB
+                                                // limit of RIFF, subclasses may lower it (tests)
+
+  private:
+
+    // file handles and threads are not supposed to be copied:
+    AudioFileWriter(const AudioFileWriter&);
+    AudioFileWriter& operator=(const AudioFileWriter&);
+
+  };
+
+} // end namespace rosic
+
+#endif // rosic_AudioFileWriter_h
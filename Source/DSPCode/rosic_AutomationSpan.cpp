@@ -0,0 +1,111 @@
+#include "rosic_AutomationSpan.h"
+#include <string.h> // for memcpy
+using namespace rosic;
+
+//-------------------------------------------------------------------------------------------------
+// construction/destruction:
+
+AutomationSpan::AutomationSpan()
+{
+  clear();
+}
+
+AutomationSpan::~AutomationSpan()
+{
+
+}
+
+//-------------------------------------------------------------------------------------------------
+// setup:
+
+void AutomationSpan::setBuffer(const double* newValues)
+{
+  values         = newValues;
+  positions      = NULL;
+  numBreakpoints = 0;
+  offset         = 0;
+  interpolate    = false;
+}
+
+void AutomationSpan::setBreakpoints(const int* newPositions, const double* newValues,
+                                    int newNumBreakpoints, bool shouldInterpolate)
+{
+  values         = newValues;
+  positions      = newPositions;
+  numBreakpoints = newNumBreakpoints;
+  offset         = 0;
+  interpolate    = shouldInterpolate;
+}
+
+void AutomationSpan::clear()
+{
+  values         = NULL;
+  positions      = NULL;
+  numBreakpoints = 0;
+  offset         = 0;
+  interpolate    = false;
+}
+
+//-------------------------------------------------------------------------------------------------
+// processing:
+
+void AutomationSpan::getValues(int start, double previousValue, double* buffer,
+                               int numSamples) const
+{
+  start += offset;
+
+  if( positions == NULL )
+  {
+    memcpy(buffer, values+start, numSamples*sizeof(double));
+    return;
+  }
+
+  // find the first breakpoint behind the start:
+  int j = 0;
+  while( j < numBreakpoints && positions[j] <= start )
+    j++;
+
+  // the segment from the previous breakpoint (or the sample before the start) to breakpoint j:
+  int    x0 = start-1;
+  double y0 = previousValue;
+  if( j > 0 )
+  {
+    x0 = positions[j-1];
+    y0 = values[j-1];
+  }
+
+  int n = 0;
+  while( n < numSamples )
+  {
+    int x = start+n;
+    if( j < numBreakpoints && x == positions[j] )
+    {
+      x0 = x;
+      y0 = values[j];
+      j++;
+      while( j < numBreakpoints && positions[j] == x ) // several breakpoints at one position
+        y0 = values[j++];
+    }
+
+    if( j < numBreakpoints )
+    {
+      int end = rmin(positions[j], start+numSamples);
+      if( interpolate )
+      {
+        double slope = (values[j]-y0) / (positions[j]-x0);
+        for(; x<end; x++)
+          buffer[n++] = y0 + slope*(x-x0);
+      }
+      else
+      {
+        for(; x<end; x++)
+          buffer[n++] = y0;
+      }
+    }
+    else // the last breakpoint holds:
+    {
+      for(; n<numSamples; n++)
+        buffer[n] = y0;
+    }
+  }
+}
@@ -0,0 +1,87 @@
+#ifndef rosic_AutomationSpan_h
+#define rosic_AutomationSpan_h
+
+// rosic-indcludes:
+#include "rosic_FunctionTemplates.h"
+
+namespace rosic
+{
+
+  /**
+
+  This is a class for passing the automation of a parameter over a block of samples to
+  Open303::processBlock. The values are given either as a dense buffer with one value per sample
+  or as sparse breakpoints (a value at a sample position), between which the value is either held
+  (steps, like MIDI controllers) or ramped linearly. The span doesn't copy the data - it just
+  points to the caller's arrays, which must stay valid while the span is used.
+
+  The positions are counted from the start of the span. Usually, the span covers the block that
+  is passed to processBlock, but when the caller splits a block into sub-blocks (for example at
+  note events), it may set the offset of each sub-block within the span (@see setOffset).
+
+  */
+
+  class AutomationSpan
+  {
+
+  public:
+
+    //---------------------------------------------------------------------------------------------
+    // construction/destruction:
+
+    /** Constructor. Creates an empty span. */
+    AutomationSpan();
+
+    /** Destructor. */
+    ~AutomationSpan();
+
+    //---------------------------------------------------------------------------------------------
+    // setup:
+
+    /** Lets the span read its values from a buffer with one value per sample. */
+    void setBuffer(const double* newValues);
+
+    /** Lets the span compute its values from breakpoints at the given (ascending) positions. With
+    interpolation, the value ramps linearly from each breakpoint to the next one - and from the
+    parameter's value before the span to the first breakpoint. Without, each breakpoint's value
+    holds from its position on and the parameter keeps its value before the first one. In both
+    cases, the value of the last breakpoint holds up to the end of the span. */
+    void setBreakpoints(const int* newPositions, const double* newValues, int newNumBreakpoints,
+                        bool shouldInterpolate);
+
+    /** Sets the position within the span that corresponds to the first sample of the block that
+    is rendered next. */
+    void setOffset(int newOffset) { offset = newOffset; }
+
+    /** Removes the data, such that the span is empty (and leaves its parameter alone). */
+    void clear();
+
+    //---------------------------------------------------------------------------------------------
+    // inquiry:
+
+    /** Returns true when the span has no data. */
+    bool isEmpty() const { return values == NULL || (positions != NULL && numBreakpoints <= 0); }
+
+    //---------------------------------------------------------------------------------------------
+    // processing:
+
+    /** Writes the values for numSamples samples into the buffer, starting at the given position
+    (relative to the offset). The previousValue is the parameter's value at the sample before the
+    start, which is where the ramp to the first breakpoint begins. */
+    void getValues(int start, double previousValue, double* buffer, int numSamples) const;
+
+    //=============================================================================================
+
+  protected:
+
+    const double* values;          // the dense buffer or the values of the breakpoints
+    const int*    positions;       // the positions of the breakpoints (NULL for a dense buffer)
+    int           numBreakpoints;
+    int           offset;
+    bool          interpolate;
+
+  };
+
+} // end namespace rosic
+
+#endif // rosic_AutomationSpan_h
@@ -1,85 +1,234 @@
-#include "rosic_BlendOscillator.h"
-using namespace rosic;
-
-//-------------------------------------------------------------------------------------------------
-// construction/destruction:
-
-BlendOscillator::BlendOscillator()
-{
-  // init member variables:
-  tableLengthDbl       = (double) MipMappedWaveTable::tableLength;  // typecasted version
-  sampleRate           = 44100.0;
-  freq                 = 440.0;
-  increment            = (tableLengthDbl*freq)/sampleRate;
-  phaseIndex           = 0.0;
-  startIndex           = 0.0;
-  waveTable1           = NULL;
-  waveTable2           = NULL;
-
-  // somewhat redundant:
-  setSampleRate(44100.0);          // sampleRate = 44100 Hz by default
-  setFrequency (440.0);            // frequency = 440 Hz by default
-  setStartPhase(0.0);              // sartPhase = 0 by default
-
-  setWaveForm1(MipMappedWaveTable::SAW);
-  setWaveForm2(MipMappedWaveTable::SQUARE);
-
-  resetPhase();
-}
-
-BlendOscillator::~BlendOscillator()
-{
-
-}
-
-//-------------------------------------------------------------------------------------------------
-// parameter settings:
-
-void BlendOscillator::setSampleRate(double newSampleRate)
-{
-  if( newSampleRate > 0.0 )
-    sampleRate = newSampleRate;
-  sampleRateRec = 1.0 / sampleRate;
-  increment = tableLengthDbl*freq*sampleRateRec;
-}
-
-void BlendOscillator::setWaveForm1(int newWaveForm1)
-{
-  if( waveTable1 != NULL )
-    waveTable1->setWaveform(newWaveForm1);
-}
-
-void BlendOscillator::setWaveForm2(int newWaveForm2)
-{
-  if( waveTable2 != NULL )
-    waveTable2->setWaveform(newWaveForm2);
-}
-
-void BlendOscillator::setWaveTable1(MipMappedWaveTable* newWaveTable1)
-{
-  waveTable1 = newWaveTable1;
-}
-
-void BlendOscillator::setWaveTable2(MipMappedWaveTable* newWaveTable2)
-{
-  waveTable2 = newWaveTable2;
-}
-
-void BlendOscillator::setStartPhase(double StartPhase)
-{
-  if( (StartPhase>=0) && (StartPhase<=360) )
-    startIndex = (StartPhase/360.0)*tableLengthDbl;
-}
-
-//-------------------------------------------------------------------------------------------------
-// event processing:
-
-void BlendOscillator::resetPhase()
-{
-  phaseIndex = startIndex;
-}
-
-void BlendOscillator::setPhase(double PhaseIndex)
-{
-  phaseIndex = startIndex+PhaseIndex;
-}
+#include "rosic_BlendOscillator.h"
+using namespace rosic;
+
+//-------------------------------------------------------------------------------------------------
+// construction/destruction:
+
+BlendOscillator::BlendOscillator()
+{
+  // init member variables:
+  tableLengthDbl       = (double) MipMappedWaveTable::tableLength;  // typecasted version
+  tableLengthRec       = 1.0 / tableLengthDbl;
+  sampleRate           = 44100.0;
+  freq                 = 440.0;
+  increment            = (tableLengthDbl*freq)/sampleRate;
+  phaseIndex           = 0.0;
+  startIndex           = 0.0;
+  blend                = 0.0;
+  waveTable1           = NULL;
+  waveTable2           = NULL;
+  engine               = WAVETABLE;
+  blendedTable         = NULL;
+  blendedFactor        = 0.0;
+  blendedGeneration1   = 0;
+  blendedGeneration2   = 0;
+  numBlendedLevels     = 0;
+  blendedTableReady    = false;
+
+  // same defaults as in MipMappedWaveTable:
+  squareDrive          = dB2amp(36.9);
+  squareOffset         = 4.37;
+  squareShift          = 0.5;
+  updateSquareShape();
+
+  // somewhat redundant:
+  setSampleRate(44100.0);          // sampleRate = 44100 Hz by default
+  setFrequency (440.0);            // frequency = 440 Hz by default
+  setStartPhase(0.0);              // sartPhase = 0 by default
+
+  setWaveForm1(MipMappedWaveTable::SAW);
+  setWaveForm2(MipMappedWaveTable::SQUARE);
+
+  resetPhase();
+}
+
+BlendOscillator::~BlendOscillator()
+{
+
+}
+
+//-------------------------------------------------------------------------------------------------
+// parameter settings:
+
+void BlendOscillator::setSampleRate(double newSampleRate)
+{
+  if( newSampleRate > 0.0 )
+    sampleRate = newSampleRate;
+  sampleRateRec = 1.0 / sampleRate;
+  increment = tableLengthDbl*freq*sampleRateRec;
+}
+
+void BlendOscillator::setWaveForm1(int newWaveForm1)
+{
+  if( waveTable1 != NULL )
+    waveTable1->setWaveform(newWaveForm1);
+}
+
+void BlendOscillator::setWaveForm2(int newWaveForm2)
+{
+  if( waveTable2 != NULL )
+    waveTable2->setWaveform(newWaveForm2);
+}
+
+void BlendOscillator::setWaveTable1(MipMappedWaveTable* newWaveTable1)
+{
+  waveTable1 = newWaveTable1;
+}
+
+void BlendOscillator::setWaveTable2(MipMappedWaveTable* newWaveTable2)
+{
+  waveTable2 = newWaveTable2;
+}
+
+void BlendOscillator::setBlendedWaveTable(MipMappedWaveTable* newBlendedWaveTable)
+{
+  blendedTable = newBlendedWaveTable;
+}
+
+void BlendOscillator::setEngine(int newEngine)
+{
+  if( newEngine >= WAVETABLE && newEngine <= PREBLENDED )
+    engine = newEngine;
+}
+
+void BlendOscillator::setTanhShaperDriveFor303Square(double newDrive)
+{
+  squareDrive = dB2amp(newDrive);
+  updateSquareShape();
+}
+
+void BlendOscillator::setTanhShaperOffsetFor303Square(double newOffset)
+{
+  squareOffset = newOffset;
+  updateSquareShape();
+}
+
+void BlendOscillator::set303SquarePhaseShift(double newShift)
+{
+  squareShift  = newShift/360.0;
+  squareShift -= floor(squareShift);
+  updateSquareShape();
+}
+
+void BlendOscillator::setStartPhase(double StartPhase)
+{
+  if( (StartPhase>=0) && (StartPhase<=360) )
+    startIndex = (StartPhase/360.0)*tableLengthDbl;
+}
+
+//-------------------------------------------------------------------------------------------------
+// event processing:
+
+void BlendOscillator::resetPhase()
+{
+  phaseIndex = startIndex;
+}
+
+void BlendOscillator::setPhase(double PhaseIndex)
+{
+  phaseIndex = startIndex+PhaseIndex;
+}
+
+//-------------------------------------------------------------------------------------------------
+// state persistence:
+
+void BlendOscillator::saveState(StateWriter& writer) const
+{
+  writer.writeDouble(phaseIndex);
+  writer.writeDouble(freq);
+  writer.writeDouble(increment);
+}
+
+void BlendOscillator::loadState(StateReader& reader)
+{
+  phaseIndex = reader.readDouble();
+  freq       = reader.readDouble();
+  increment  = reader.readDouble();
+}
+
+bool BlendOscillator::isStateValid(StateReader& reader) const
+{
+  double newPhaseIndex = reader.readDouble();
+  double newFreq       = reader.readDouble();
+  double newIncrement  = reader.readDouble();
+
+  // the comparisons are false for NaNs, too:
+  return newPhaseIndex >= 0.0 && newPhaseIndex < tableLengthDbl
+      && newFreq       >= 0.0 && newFreq       <= sampleRate
+      && newIncrement  >= 0.0 && newIncrement  <  tableLengthDbl;
+}
+
+//-------------------------------------------------------------------------------------------------
+// internal functions:
+
+// integral of the hard clipper clip(u, -1, 1) with respect to u:
+static double clipIntegral(double u)
+{
+  if( fabs(u) <= 1.0 )
+    return 0.5*u*u;
+  else
+    return fabs(u) - 0.5;
+}
+
+// phase (0...1) at which the 303 saw (rising from 0 to 1 in the 1st half of the cycle and from -1
+// to 0 in the 2nd half) has the given value:
+static double sawPhase(double value)
+{
+  if( value >= 0.0 )
+    return 0.5*value;
+  else
+    return 1.0 + 0.5*value;
+}
+
+void BlendOscillator::updateSquareShape()
+{
+  // the hard clipper clip(c*u, -1, 1) with c = 0.769 is the best approximation of tanh(u) in the
+  // least squares sense:
+  clipperDrive  = 0.769 * squareDrive;
+  clipperOffset = 0.769 * squareOffset;
+
+  // the clipper's input u = -(drive*saw + offset) falls linearly with the saw - at the start of
+  // the cycle (saw = -1) and at its end (saw = +1), it is:
+  double u0 = clipperDrive - clipperOffset;
+  double u1 = -clipperDrive - clipperOffset;
+
+  // the saw is uniformly distributed over -1...+1, so the DC is the mean of the clipper's output
+  // over the range u1...u0:
+  squareDC         = (clipIntegral(u0) - clipIntegral(u1)) / (u0 - u1);
+  squareJumpHeight = clip(u0, -1.0, 1.0) - clip(u1, -1.0, 1.0);
+
+  // the ramp lies between the saw values where u passes +1 and -1 - there's a corner only where
+  // this happens inside the saw's range:
+  double s1 = (-1.0-clipperOffset) / clipperDrive;
+  double s2 = ( 1.0-clipperOffset) / clipperDrive;
+  squareCorner1 = sawPhase(clip(s1, -1.0, 1.0));
+  squareCorner2 = sawPhase(clip(s2, -1.0, 1.0));
+  squareSlope1  = (s1 > -1.0 && s1 < 1.0) ? -2*clipperDrive : 0.0;
+  squareSlope2  = (s2 > -1.0 && s2 < 1.0) ?  2*clipperDrive : 0.0;
+}
+
+void BlendOscillator::updateBlendedTable()
+{
+  if( blendedTable == NULL || waveTable1 == NULL || waveTable2 == NULL )
+    return;
+
+  // start over when the blend factor or one of the source tables has changed since we started:
+  if(    blend                               != blendedFactor
+      || waveTable1->getNumMipMapGenerations() != blendedGeneration1
+      || waveTable2->getNumMipMapGenerations() != blendedGeneration2 )
+  {
+    blendedFactor      = blend;
+    blendedGeneration1 = waveTable1->getNumMipMapGenerations();
+    blendedGeneration2 = waveTable2->getNumMipMapGenerations();
+    numBlendedLevels   = 0;
+    blendedTableReady  = false;
+  }
+
+  if( numBlendedLevels < MipMappedWaveTable::numTables )
+  {
+    blendedTable->renderWeightedSum(*waveTable1, 1.0-blendedFactor, *waveTable2,
+      0.5*blendedFactor, numBlendedLevels);  // 0.5: same scaling as in getSample
+    numBlendedLevels++;
+    blendedTableReady = numBlendedLevels == MipMappedWaveTable::numTables;
+  }
+}
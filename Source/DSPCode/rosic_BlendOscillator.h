@@ -1,170 +1,382 @@
-#ifndef rosic_BlendOscillator_h
-#define rosic_BlendOscillator_h
-
-// rosic-indcludes:
-#include "rosic_MipMappedWaveTable.h"
-
-namespace rosic
-{
-
-  /**
-
-  This is an oscillator that can continuously blend between two waveforms - this is more efficient
-  than using two separate oscillators because the phase-accumulator has to be calculated only once
-  for both waveforms.
-
-  */
-
-  class BlendOscillator
-  {
-
-  public:
-
-    //---------------------------------------------------------------------------------------------
-    // construction/destruction:
-
-    /** Constructor. */
-    BlendOscillator();
-
-    /** Destructor. */
-    ~BlendOscillator();
-
-    //---------------------------------------------------------------------------------------------
-    // parameter settings:
-
-    /** Sets the sample-rateRate(). */
-    void setSampleRate(double newSampleRate);
-
-    /** Sets the 1st waveform of the oscillator. */
-    void setWaveForm1(int newWaveForm1);
-
-    /** Sets the 2nd waveform of the oscillator. */
-    void setWaveForm2(int newWaveForm2);
-
-    /** Set start phase (range 0 - 360 degrees). */
-    void setStartPhase(double StartPhase);
-
-    /** An object of class WaveTable should be passed with this function which will be used in the 
-    oscillator. Not to have "our own" WaveTable-object as member-variable avoids the need to have 
-    the same waveform for different synth-voices multiple times in the memory. This function sets 
-    the 1st wavetable. */
-    void setWaveTable1(MipMappedWaveTable* newWaveTable1);
-
-    /** Sets the 2nd wavetable. @see setWaveTable1 */
-    void setWaveTable2(MipMappedWaveTable* newWaveTable2);
-
-    /** Sets the blend/mix factor between the two waveforms. The value is expected between 0...1
-    where 0 means waveform1 only, 1 means waveform2 only - in between there will be a linear blend
-    between the two waveforms. */
-    void setBlendFactor(double newBlendFactor) { blend = newBlendFactor; }
-
-    /** Sets the frequency of the oscillator. */
-    INLINE void setFrequency(double newFrequency);
-
-    /** Sets the pulse width (or symmetry) of the oscillator. */
-    INLINE void setPulseWidth(double newPulseWidth);
-
-    /** Sets the phase increment from outside. */
-    INLINE void setIncrement(double newIncrement) { increment = newIncrement; }
-
-    //---------------------------------------------------------------------------------------------
-    // inquiry:
-
-    /** Returns the blend/mix factor between the two waveforms as a value between 0...1 where 0 
-    means waveform1 only, 1 means waveform2 only - in between there will be a linear blend between 
-    the two waveforms. */
-    double getBlendFactor() const { return blend; }
-
-    /** Returns the phase increment. */
-    INLINE double getIncrement() const { return increment; }
-
-    //---------------------------------------------------------------------------------------------
-    // audio processing:
-
-    /** Calculates one output sample at a time. */
-    INLINE double getSample();
-
-    //---------------------------------------------------------------------------------------------
-    // others:
-
-    /** Calculates the phase-increments for first and second half-period according to freq and 
-    pulseWidth. */
-    INLINE void calculateIncrement();
-
-    /** Resets the phaseIndex to startIndex. */
-    void resetPhase();
-
-    /** Reset the phaseIndex to startIndex+PhaseIndex. */
-    void setPhase(double PhaseIndex);
-
-    //=============================================================================================
-
-  protected:
-
-    double tableLengthDbl;    // tableLength as double variable
-    double phaseIndex;        // current phase index
-    double freq;              // frequency of the oscillator
-    double increment;         // phase increment per sample
-    double blend;             // the blend factor between the two waveforms
-    double startIndex;        // start-phase-index of the osc (range: 0 - tableLength)
-    double sampleRate;        // the samplerate
-    double sampleRateRec;     // 1/sampleRate
-
-    MipMappedWaveTable *waveTable1, *waveTable2; // the 2 wavetables between which we blend
-
-  };
-
-  //-----------------------------------------------------------------------------------------------
-  // inlined functions:
-
-  INLINE void BlendOscillator::setFrequency(double newFrequency)
-  {
-    if( (newFrequency > 0.0) && (newFrequency < 20000.0) )
-      freq = newFrequency;
-  }
-
-  INLINE void BlendOscillator::setPulseWidth(double newPulseWidth)
-  {
-    waveTable1->setSymmetry(0.01*newPulseWidth);
-    waveTable2->setSymmetry(0.01*newPulseWidth);
-  }
-
-  INLINE void BlendOscillator::calculateIncrement()
-  {
-    increment = tableLengthDbl*freq*sampleRateRec;
-  }
-
-  INLINE double BlendOscillator::getSample()
-  {
-    double out1, out2;
-    int    tableNumber;
-
-    if( waveTable1 == NULL || waveTable2 == NULL )
-      return 0.0;
-
-    // from this increment, decide which table is to be used:
-    tableNumber  = ((int)EXPOFDBL(increment));
-    //tableNumber += 1;           // generate frequencies up to nyquist/2 on the highest note
-    tableNumber += 2;             // generate frequencies up to nyquist/4 on the highest note
-                                  // \todo: make this number adjustable from outside
-
-    // wraparound if necessary:
-    while( phaseIndex>=tableLengthDbl )
-      phaseIndex -= tableLengthDbl;
-
-    int    intIndex = floorInt(phaseIndex);
-    double frac     = phaseIndex  - (double) intIndex;
-    out1 = (1.0-blend) * waveTable1->getValueLinear(intIndex, frac, tableNumber);
-    out2 =      blend  * waveTable2->getValueLinear(intIndex, frac, tableNumber);
-    
-    out2 *= 0.5; // \todo: this is preliminary to scale the square in AciDevil we need to
-                 // implement something more general here (like a kind of crest-compensation in 
-                 // the wavetable-class)
-
-    phaseIndex += increment;
-    return out1 + out2;
-  }
-
-} // end namespace rosic
-
-#endif // rosic_BlendOscillator_h
+#ifndef rosic_BlendOscillator_h
+#define rosic_BlendOscillator_h
+
+// rosic-indcludes:
+#include "rosic_MipMappedWaveTable.h"
+#include "rosic_StateStream.h"
+
+namespace rosic
+{
+
+  /**
+
+  This is an oscillator that can continuously blend between two waveforms - this is more efficient
+  than using two separate oscillators because the phase-accumulator has to be calculated only once
+  for both waveforms.
+
+  There are two engines to choose from. The WAVETABLE engine reads the waveforms from two
+  MipMappedWaveTable objects (which are passed in from outside). The POLYBLEP engine needs no
+  tables at all - it synthesizes the blend between the 303 saw (MipMappedWaveTable::SAW303) and
+  the 303 square (MipMappedWaveTable::SQUARE303) analytically. The tanh-shaper of the square is
+  approximated by a hard clipper: the square then consists of a jump (where the underlying saw
+  wraps around) and a linear ramp between two corners (where the scaled saw enters and leaves the
+  clipping range). The jumps of saw and square are band-limited by PolyBLEP residuals and the
+  corners of the square by PolyBLAMP residuals (2-point polynomial versions). The square's DC is
+  subtracted analytically, like the mip-mapped tables do by zeroing the DC bin. The waveform
+  settings of the tables (setWaveForm1/2, setPulseWidth) are ignored by this engine - the
+  square's shape parameters are set via the setters below.
+
+  The PREBLENDED engine reads from a third table (passed in via setBlendedWaveTable) that holds
+  the blend of the two tables (including the 0.5 scaling of the 2nd waveform) such that the inner
+  loop needs only one table lookup instead of two. This table is rebuilt whenever the blend factor
+  or one of the two source tables changes - one mip-map level per call to updateWaveTables, so the
+  work is spread over several samples. Until the rebuild is complete (and while the blend factor
+  keeps moving), the engine reads the two source tables like the WAVETABLE engine does.
+
+  */
+
+  class BlendOscillator
+  {
+
+  public:
+
+    /** Enumeration of the available oscillator engines. */
+    enum engines
+    {
+      WAVETABLE = 0,
+      POLYBLEP,
+      PREBLENDED
+    };
+
+    //---------------------------------------------------------------------------------------------
+    // construction/destruction:
+
+    /** Constructor. */
+    BlendOscillator();
+
+    /** Destructor. */
+    ~BlendOscillator();
+
+    //---------------------------------------------------------------------------------------------
+    // parameter settings:
+
+    /** Sets the sample-rateRate(). */
+    void setSampleRate(double newSampleRate);
+
+    /** Sets the 1st waveform of the oscillator. */
+    void setWaveForm1(int newWaveForm1);
+
+    /** Sets the 2nd waveform of the oscillator. */
+    void setWaveForm2(int newWaveForm2);
+
+    /** Set start phase (range 0 - 360 degrees). */
+    void setStartPhase(double StartPhase);
+
+    /** An object of class WaveTable should be passed with this function which will be used in the 
+    oscillator. Not to have "our own" WaveTable-object as member-variable avoids the need to have 
+    the same waveform for different synth-voices multiple times in the memory. This function sets 
+    the 1st wavetable. */
+    void setWaveTable1(MipMappedWaveTable* newWaveTable1);
+
+    /** Sets the 2nd wavetable. @see setWaveTable1 */
+    void setWaveTable2(MipMappedWaveTable* newWaveTable2);
+
+    /** Sets the blend/mix factor between the two waveforms. The value is expected between 0...1
+    where 0 means waveform1 only, 1 means waveform2 only - in between there will be a linear blend
+    between the two waveforms. */
+    void setBlendFactor(double newBlendFactor)
+    {
+      if( newBlendFactor != blend )
+        blendedTableReady = false;
+      blend = newBlendFactor;
+    }
+
+    /** Sets the table that is used by the PREBLENDED engine to store the blend of the two
+    wavetables. Its contents are overwritten by the oscillator. The state of the rendering is kept,
+    so when the table is replaced, the new one should either be a copy of the old one (like when
+    the owner of oscillator and tables is copied) or this should be called before the first call to
+    updateWaveTables. */
+    void setBlendedWaveTable(MipMappedWaveTable* newBlendedWaveTable);
+
+    /** Sets the frequency of the oscillator. */
+    INLINE void setFrequency(double newFrequency);
+
+    /** Sets the pulse width (or symmetry) of the oscillator. */
+    INLINE void setPulseWidth(double newPulseWidth);
+
+    /** Sets the phase increment from outside. */
+    INLINE void setIncrement(double newIncrement) { increment = newIncrement; }
+
+    /** Chooses the engine that produces the waveforms. See the enumeration for available engines.
+    When switching to WAVETABLE, the tables are rendered lazily in the next call to
+    updateWaveTables (if their parameters were changed in the meantime). */
+    void setEngine(int newEngine);
+
+    /** Sets the drive (in dB) of the tanh-shaper for the 303 square of the POLYBLEP engine. @see
+    MipMappedWaveTable::setTanhShaperDriveFor303Square */
+    void setTanhShaperDriveFor303Square(double newDrive);
+
+    /** Sets the offset of the tanh-shaper for the 303 square of the POLYBLEP engine. @see
+    MipMappedWaveTable::setTanhShaperOffsetFor303Square */
+    void setTanhShaperOffsetFor303Square(double newOffset);
+
+    /** Sets the phase shift (in degrees) of the 303 square with respect to the saw for the
+    POLYBLEP engine. @see MipMappedWaveTable::set303SquarePhaseShift */
+    void set303SquarePhaseShift(double newShift);
+
+    //---------------------------------------------------------------------------------------------
+    // inquiry:
+
+    /** Returns the blend/mix factor between the two waveforms as a value between 0...1 where 0 
+    means waveform1 only, 1 means waveform2 only - in between there will be a linear blend between 
+    the two waveforms. */
+    double getBlendFactor() const { return blend; }
+
+    /** Returns the phase increment. */
+    INLINE double getIncrement() const { return increment; }
+
+    /** Returns the currently chosen engine. @see engines */
+    int getEngine() const { return engine; }
+
+    //---------------------------------------------------------------------------------------------
+    // audio processing:
+
+    /** Calculates one output sample at a time. */
+    INLINE double getSample();
+
+    /** Calculates one output sample for an external phase index that is advanced by the given
+    increment (instead of our own phase and increment) - used for the lanes of UnisonLanes which
+    all read the same tables. */
+    INLINE double getSample(double* phase, double phaseIncrement) const;
+
+    /** Calculates one output sample of the POLYBLEP engine. */
+    INLINE double getSamplePolyBlep(double* phase, double phaseIncrement) const;
+
+    //---------------------------------------------------------------------------------------------
+    // others:
+
+    /** Calculates the phase-increments for first and second half-period according to freq and 
+    pulseWidth. */
+    INLINE void calculateIncrement();
+
+    /** Re-renders the mip-maps of both wavetables, if some of their parameters were changed since 
+    the last rendering. @see MipMappedWaveTable::updateTables() In PREBLENDED mode, it also
+    renders the next level of the blended table, if that is out of date. */
+    INLINE void updateWaveTables();
+
+    /** Resets the phaseIndex to startIndex. */
+    void resetPhase();
+
+    /** Reset the phaseIndex to startIndex+PhaseIndex. */
+    void setPhase(double PhaseIndex);
+
+    /** Writes the phase, frequency and increment into the stream (the wavetables are not
+    included - they are determined by the waveform parameters). */
+    void saveState(StateWriter& writer) const;
+
+    /** Reads phase, frequency and increment back from the stream. @see saveState */
+    void loadState(StateReader& reader);
+
+    /** Reads a state like loadState does, but only returns whether it can be loaded: the phase
+    must be a valid index into the table and frequency and increment must be in their ranges. */
+    bool isStateValid(StateReader& reader) const;
+
+    //=============================================================================================
+
+  protected:
+
+    double tableLengthDbl;    // tableLength as double variable
+    double tableLengthRec;    // 1/tableLength
+    double phaseIndex;        // current phase index
+    double freq;              // frequency of the oscillator
+    double increment;         // phase increment per sample
+    double blend;             // the blend factor between the two waveforms
+    double startIndex;        // start-phase-index of the osc (range: 0 - tableLength)
+    double sampleRate;        // the samplerate
+    double sampleRateRec;     // 1/sampleRate
+    int    engine;            // the engine that produces the waveforms (@see engines)
+
+    MipMappedWaveTable *waveTable1, *waveTable2; // the 2 wavetables between which we blend
+
+    // the pre-blended table for the PREBLENDED engine and the state of its rendering:
+    MipMappedWaveTable *blendedTable;
+    double blendedFactor;      // blend factor for which the table is (being) rendered
+    int    blendedGeneration1; // number of mip-map generations of waveTable1 at that time
+    int    blendedGeneration2; // number of mip-map generations of waveTable2 at that time
+    int    numBlendedLevels;   // number of levels that are rendered already
+    bool   blendedTableReady;  // true, when all levels are rendered for the current blend factor
+
+    // parameters of the 303 square for the POLYBLEP engine and quantities derived from them in
+    // updateSquareShape (phases are normalized to 0...1):
+    double squareDrive;       // drive of the tanh-shaper as raw factor
+    double squareOffset;      // offset of the tanh-shaper
+    double squareShift;       // phase shift of the square with respect to the saw
+    double clipperDrive;      // drive of the clipper that approximates the tanh-shaper
+    double clipperOffset;     // offset of the clipper that approximates the tanh-shaper
+    double squareDC;          // mean value of the clipped square
+    double squareJumpHeight;  // height of the jump in the square
+    double squareCorner1;     // phase where the ramp starts
+    double squareCorner2;     // phase where the ramp ends
+    double squareSlope1;      // change of slope at corner 1 (zero when there's no such corner)
+    double squareSlope2;      // change of slope at corner 2 (zero when there's no such corner)
+
+    // internal functions:
+    void updateSquareShape();  // calculates the derived quantities of the square
+    void updateBlendedTable(); // renders the next level of the blended table, if necessary
+
+    /** Wraps a difference between two phases in -1...+1 into the range -0.5...+0.5. */
+    static INLINE double wrapPhaseDifference(double d);
+
+    friend class UnisonLanes;
+
+  };
+
+  //-----------------------------------------------------------------------------------------------
+  // inlined functions:
+
+  INLINE void BlendOscillator::setFrequency(double newFrequency)
+  {
+    if( (newFrequency > 0.0) && (newFrequency < 20000.0) )
+      freq = newFrequency;
+  }
+
+  INLINE void BlendOscillator::setPulseWidth(double newPulseWidth)
+  {
+    waveTable1->setSymmetry(0.01*newPulseWidth);
+    waveTable2->setSymmetry(0.01*newPulseWidth);
+  }
+
+  INLINE void BlendOscillator::calculateIncrement()
+  {
+    increment = tableLengthDbl*freq*sampleRateRec;
+  }
+
+  INLINE void BlendOscillator::updateWaveTables()
+  {
+    if( engine == POLYBLEP )
+      return;
+    if( waveTable1 != NULL )
+      waveTable1->updateTables();
+    if( waveTable2 != NULL )
+      waveTable2->updateTables();
+    if( engine == PREBLENDED && (!blendedTableReady
+      || waveTable1->getNumMipMapGenerations() != blendedGeneration1
+      || waveTable2->getNumMipMapGenerations() != blendedGeneration2) )
+      updateBlendedTable();
+  }
+
+  INLINE double BlendOscillator::getSample()
+  {
+    return getSample(&phaseIndex, increment);
+  }
+
+  INLINE double BlendOscillator::getSample(double* phase, double phaseIncrement) const
+  {
+    double out1, out2;
+    int    tableNumber;
+
+    if( engine == POLYBLEP )
+      return getSamplePolyBlep(phase, phaseIncrement);
+
+    if( waveTable1 == NULL || waveTable2 == NULL )
+      return 0.0;
+
+    // from this increment, decide which table is to be used:
+    tableNumber  = ((int)EXPOFDBL(phaseIncrement));
+    //tableNumber += 1;           // generate frequencies up to nyquist/2 on the highest note
+    tableNumber += 2;             // generate frequencies up to nyquist/4 on the highest note
+                                  // \todo: make this number adjustable from outside
+
+    tableNumber  = clip(tableNumber, 0, MipMappedWaveTable::numTables-1);
+
+    // wraparound if necessary:
+    while( *phase>=tableLengthDbl )
+      *phase -= tableLengthDbl;
+
+    // the tables with less bandwidth may be shorter, so we must scale the phase index:
+    double index    = *phase * MipMappedWaveTable::getIndexScaler(tableNumber);
+    int    intIndex = floorInt(index);
+    double frac     = index - (double) intIndex;
+    if( engine == PREBLENDED && blendedTableReady )
+    {
+      *phase += phaseIncrement;
+      return blendedTable->getValueLinear(intIndex, frac, tableNumber);
+    }
+    out1 = (1.0-blend) * waveTable1->getValueLinear(intIndex, frac, tableNumber);
+    out2 =      blend  * waveTable2->getValueLinear(intIndex, frac, tableNumber);
+    
+    out2 *= 0.5; // \todo: this is preliminary to scale the square in AciDevil we need to
+                 // implement something more general here (like a kind of crest-compensation in 
+                 // the wavetable-class)
+
+    *phase += phaseIncrement;
+    return out1 + out2;
+  }
+
+  INLINE double BlendOscillator::getSamplePolyBlep(double* phase, double phaseIncrement) const
+  {
+    while( *phase>=tableLengthDbl )
+      *phase -= tableLengthDbl;
+
+    // normalized phase 0...1 (the jump of the tabulated saw lies half a table sample before the
+    // middle of the table, so we shift by half a sample to stay aligned with the WAVETABLE engine):
+    double p = (*phase+0.5) * tableLengthRec;
+    if( p >= 1.0 )
+      p -= 1.0;
+    double dt = phaseIncrement * tableLengthRec;   // normalized increment
+    double x, d;
+
+    // naive saw (jumping from +1 to -1 at p = 0.5) with the PolyBLEP residual for its jump:
+    double saw = p < 0.5 ? 2*p : 2*p-2;
+    d = p - 0.5;
+    if( fabs(d) < dt )
+    {
+      x    = d / dt;
+      saw += x < 0.0 ? -(1+x)*(1+x) : (1-x)*(1-x);
+    }
+
+    // naive square: the saw with shifted phase, scaled and offset, then clipped:
+    double q = p - squareShift;
+    if( q < 0.0 )
+      q += 1.0;
+    double sq = -(clipperDrive * (q < 0.5 ? 2*q : 2*q-2) + clipperOffset);
+    sq = clip(sq, -1.0, 1.0) - squareDC;
+
+    // PolyBLEP residual for its jump and PolyBLAMP residuals for the corners of the ramp (the
+    // phase differences to the corners are wrapped into -0.5...+0.5):
+    d = q - 0.5;
+    if( fabs(d) < dt )
+    {
+      x   = d / dt;
+      sq += x < 0.0 ? 0.5*squareJumpHeight*(1+x)*(1+x) : -0.5*squareJumpHeight*(1-x)*(1-x);
+    }
+    d = wrapPhaseDifference(q - squareCorner1);
+    if( fabs(d) < dt )
+    {
+      x   = 1.0 - fabs(d / dt);
+      sq += (squareSlope1*dt/6) * x*x*x;
+    }
+    d = wrapPhaseDifference(q - squareCorner2);
+    if( fabs(d) < dt )
+    {
+      x   = 1.0 - fabs(d / dt);
+      sq += (squareSlope2*dt/6) * x*x*x;
+    }
+
+    *phase += phaseIncrement;
+    return (1.0-blend)*saw + blend*0.5*sq;  // 0.5: same scaling as in getSample
+  }
+
+  INLINE double BlendOscillator::wrapPhaseDifference(double d)
+  {
+    if( d >= 0.5 )
+      return d - 1.0;
+    else if( d < -0.5 )
+      return d + 1.0;
+    else
+      return d;
+  }
+
+} // end namespace rosic
+
+#endif // rosic_BlendOscillator_h
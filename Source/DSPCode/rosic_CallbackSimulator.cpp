@@ -0,0 +1,280 @@
+#include "rosic_CallbackSimulator.h"
+#include "rosic_DenormalGuard.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+using namespace rosic;
+
+//-------------------------------------------------------------------------------------------------
+// construction/destruction:
+
+CallbackSimulator::CallbackSimulator()
+{
+  synth             = NULL;
+  rack              = NULL;
+  midiFileRenderer  = NULL;
+  sampleRate        = 44100.0;
+  blockSize         = 256;
+  paced             = false;
+  numDeadlineMisses = 0;
+}
+
+CallbackSimulator::~CallbackSimulator()
+{
+
+}
+
+//-------------------------------------------------------------------------------------------------
+// setup:
+
+void CallbackSimulator::setSynth(Open303* newSynth)
+{
+  synth = newSynth;
+  rack  = NULL;
+  if( synth != NULL )
+    synth->setSampleRate(sampleRate);
+}
+
+void CallbackSimulator::setRack(Open303Rack* newRack)
+{
+  rack  = newRack;
+  synth = NULL;
+  if( rack != NULL )
+    rack->setSampleRate(sampleRate);
+}
+
+void CallbackSimulator::setSampleRate(double newSampleRate)
+{
+  if( newSampleRate <= 0.0 )
+    return;
+  sampleRate = newSampleRate;
+  if( synth != NULL )
+    synth->setSampleRate(sampleRate);
+  if( rack != NULL )
+    rack->setSampleRate(sampleRate);
+}
+
+void CallbackSimulator::setBlockSize(int newBlockSize)
+{
+  blockSize = rmax(newBlockSize, 1);
+}
+
+//-------------------------------------------------------------------------------------------------
+// recorded input:
+
+void CallbackSimulator::addNoteEvent(double time, int instance, int noteNumber, int velocity)
+{
+  Event event;
+  event.time       = time;
+  event.instance   = instance;
+  event.noteNumber = noteNumber;
+  event.velocity   = velocity;
+  event.setter     = NULL;
+  event.value      = 0.0;
+  insertEvent(event);
+}
+
+void CallbackSimulator::addParameterEvent(double time, int instance, ParameterSetter setter,
+                                          double value)
+{
+  Event event;
+  event.time       = time;
+  event.instance   = instance;
+  event.noteNumber = 0;
+  event.velocity   = 0;
+  event.setter     = setter;
+  event.value      = value;
+  insertEvent(event);
+}
+
+void CallbackSimulator::clearEvents()
+{
+  events.clear();
+}
+
+//-------------------------------------------------------------------------------------------------
+// processing:
+
+void CallbackSimulator::run(double duration)
+{
+  typedef std::chrono::steady_clock Clock;
+
+  // allocate everything before the first callback:
+  int numCallbacks = rmax((int) ceil(duration * sampleRate / blockSize), 0);
+  renderTimes.assign(numCallbacks, 0.0);
+  latencies.assign(numCallbacks, 0.0);
+  numDeadlineMisses = 0;
+  int numBuses = rack != NULL ? rack->getNumBuses() : 1;
+  outputBuffer.assign(numBuses*blockSize, 0.0);
+  busPointers.resize(numBuses);
+  for(int b=0; b<numBuses; b++)
+    busPointers[b] = &outputBuffer[b*blockSize];
+
+  if( synth == NULL && rack == NULL )
+    return;
+
+  DenormalGuard denormalGuard;
+
+  double period     = getBlockPeriod();
+  double clock      = 0.0; // simulated time at which the previous callback has finished
+  int    eventIndex = 0;
+  Clock::time_point startTime = Clock::now();
+  for(int k=0; k<numCallbacks; k++)
+  {
+    // the callback can't start before it's due or before the previous one has finished:
+    double dueTime = k * period;
+    double begin   = rmax(dueTime, clock);
+    if( paced )
+    {
+      std::this_thread::sleep_until(startTime + std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(begin)));
+    }
+
+    Clock::time_point callbackStart = Clock::now();
+    {
+      RealTimeScope realTimeScope;
+
+      // render the block in pieces between the events:
+      INT64 blockStart = (INT64) k * blockSize;
+      int   n          = 0;
+      while( n < blockSize )
+      {
+        while( eventIndex < (int) events.size() )
+        {
+          INT64 eventSample = (INT64) floor(events[eventIndex].time * sampleRate + 0.5);
+          if( eventSample > blockStart + n )
+            break;
+          applyEvent(events[eventIndex]);
+          eventIndex++;
+        }
+        int horizon = blockSize - n;
+        if( eventIndex < (int) events.size() )
+        {
+          INT64 eventSample = (INT64) floor(events[eventIndex].time * sampleRate + 0.5);
+          horizon = (int) rmin((INT64) horizon, eventSample - (blockStart + n));
+        }
+        render(horizon);
+        n += horizon;
+      }
+    }
+    double renderTime =
+      std::chrono::duration<double>(Clock::now() - callbackStart).count();
+
+    // the clock stays simulated in paced mode, too - a late wake-up from the sleep is a matter of
+    // the OS scheduler and not of the engine:
+    clock = begin + renderTime;
+
+    renderTimes[k] = renderTime;
+    latencies[k]   = clock - dueTime;
+    if( latencies[k] > period )
+      numDeadlineMisses++;
+  }
+}
+
+//-------------------------------------------------------------------------------------------------
+// inquiry:
+
+double CallbackSimulator::getRenderTimePercentile(double percentage) const
+{
+  return getPercentile(renderTimes, percentage);
+}
+
+double CallbackSimulator::getLatencyPercentile(double percentage) const
+{
+  return getPercentile(latencies, percentage);
+}
+
+void CallbackSimulator::getRenderTimeHistogram(int* counts, int numBins, double maxTime) const
+{
+  int i;
+  for(i=0; i<numBins; i++)
+    counts[i] = 0;
+  if( numBins < 1 || maxTime <= 0.0 )
+    return;
+  for(i=0; i<getNumCallbacks(); i++)
+  {
+    int bin = (int) (renderTimes[i] * numBins / maxTime);
+    counts[rmin(bin, numBins-1)]++;
+  }
+}
+
+void CallbackSimulator::getStatistics(Statistics* statistics) const
+{
+  statistics->numCallbacks      = getNumCallbacks();
+  statistics->numDeadlineMisses = numDeadlineMisses;
+  statistics->blockPeriod       = getBlockPeriod();
+  statistics->meanRenderTime    = 0.0;
+  statistics->maxRenderTime     = 0.0;
+  statistics->maxLatency        = 0.0;
+  for(int i=0; i<getNumCallbacks(); i++)
+  {
+    statistics->meanRenderTime += renderTimes[i];
+    statistics->maxRenderTime   = rmax(statistics->maxRenderTime, renderTimes[i]);
+    statistics->maxLatency      = rmax(statistics->maxLatency,    latencies[i]);
+  }
+  if( getNumCallbacks() > 0 )
+    statistics->meanRenderTime /= getNumCallbacks();
+  statistics->p99RenderTime  = getRenderTimePercentile(99.0);
+  statistics->p999RenderTime = getRenderTimePercentile(99.9);
+  statistics->p99Latency     = getLatencyPercentile(99.0);
+  statistics->p999Latency    = getLatencyPercentile(99.9);
+}
+
+//-------------------------------------------------------------------------------------------------
+// internal functions:
+
+void CallbackSimulator::insertEvent(const Event& event)
+{
+  events.insert(std::upper_bound(events.begin(), events.end(), event, isEarlier), event);
+}
+
+void CallbackSimulator::applyEvent(const Event& event)
+{
+  int first = 0;
+  int last  = 0;
+  if( rack != NULL )
+  {
+    if( event.instance < 0 )
+      last = rack->getNumInstances()-1;
+    else if( event.instance < rack->getNumInstances() )
+      first = last = event.instance;
+    else
+      return;
+  }
+
+  for(int i=first; i<=last; i++)
+  {
+    Open303* target = rack != NULL ? rack->getInstance(i) : synth;
+    if( event.setter != NULL )
+      (target->*event.setter)(event.value);
+    else
+      target->noteOn(event.noteNumber, event.velocity);
+  }
+}
+
+void CallbackSimulator::render(int numSamples)
+{
+  if( rack != NULL )
+    rack->processBlock(&busPointers[0], numSamples);
+  else if( midiFileRenderer != NULL )
+    midiFileRenderer->render(busPointers[0], numSamples);
+  else
+    synth->processBlock(busPointers[0], numSamples);
+}
+
+//-------------------------------------------------------------------------------------------------
+// static functions:
+
+double CallbackSimulator::getPercentile(const std::vector<double>& values, double percentage)
+{
+  if( values.empty() )
+    return 0.0;
+
+  // nearest rank:
+  std::vector<double> sorted(values);
+  std::sort(sorted.begin(), sorted.end());
+  int rank = (int) ceil(0.01 * clip(percentage, 0.0, 100.0) * sorted.size());
+  return sorted[clip(rank-1, 0, (int) sorted.size()-1)];
+}
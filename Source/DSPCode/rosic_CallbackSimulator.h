@@ -0,0 +1,211 @@
+#ifndef rosic_CallbackSimulator_h
+#define rosic_CallbackSimulator_h
+
+// rosic-indcludes:
+#include "rosic_Open303Rack.h"
+#include "rosic_MidiFileRenderer.h"
+
+#include <vector>
+
+namespace rosic
+{
+
+  /**
+
+  This is a class for measuring the timing behaviour of Open303 without audio hardware. It calls
+  the engine like an audio device would - one callback per block of a given size at a given sample
+  rate - and measures the time that each callback takes. The device is represented by a simulated
+  clock: callback k becomes due at k times the block period and its output is needed one period
+  later. When a callback starts late (because the previous one has overrun) or takes longer than
+  that, it misses its deadline - that is what an xrun in production is.
+
+  The engine may be a single Open303 (@see setSynth) or an Open303Rack with many instances (@see
+  setRack). The input is replayed from a list of recorded events (notes and parameter changes at
+  given times for given instances) which are applied at their exact sample positions by splitting
+  the callback's block there. For a single Open303, a MidiFileRenderer may be used instead, such
+  that recorded MIDI files can be replayed. Patterns that run in the synth's own sequencer just
+  keep running.
+
+  By default, the callbacks are run back to back and only the clock is simulated, which is
+  fastest. In paced mode (@see setPaced), the simulator sleeps until each callback's due time like
+  a real device, so the caches and the CPU's clock frequency see the same idle periods as in
+  production - which is often what makes the rare slow callbacks show up. The deadlines are still
+  evaluated on the simulated clock, so a late wake-up from the sleep doesn't count.
+
+  The results of the last run are the render time of each callback (from which percentiles and
+  histograms are computed), the latency of each callback (the time from its due time to its end,
+  which includes the delay due to overruns of the previous callbacks) and the number of deadline
+  misses.
+
+  */
+
+  class CallbackSimulator
+  {
+
+  public:
+
+    /** Type of the Open303 member functions that can be used for parameter changes, for example
+    &Open303::setCutoff. */
+    typedef void (Open303::*ParameterSetter)(double);
+
+    /** The results of a run as returned by getStatistics(). All times are in seconds. */
+    struct Statistics
+    {
+      int    numCallbacks;
+      int    numDeadlineMisses;
+      double blockPeriod;       // the time budget for each callback
+      double meanRenderTime;
+      double p99RenderTime;     // 99th percentile
+      double p999RenderTime;    // 99.9th percentile
+      double maxRenderTime;
+      double p99Latency;
+      double p999Latency;
+      double maxLatency;
+    };
+
+    //---------------------------------------------------------------------------------------------
+    // construction/destruction:
+
+    /** Constructor. */
+    CallbackSimulator();
+
+    /** Destructor. */
+    ~CallbackSimulator();
+
+    //---------------------------------------------------------------------------------------------
+    // setup:
+
+    /** Sets a single Open303 as the engine to be driven (the simulator does not take ownership).
+    Replaces a rack that was set before. */
+    void setSynth(Open303* newSynth);
+
+    /** Sets a rack of Open303 instances as the engine to be driven (the simulator does not take
+    ownership). Replaces a single synth that was set before. */
+    void setRack(Open303Rack* newRack);
+
+    /** Sets a MidiFileRenderer that renders the single synth (which must have been passed to
+    the renderer via MidiFileRenderer::setSynth) - the callbacks then call its render function
+    instead of rendering the synth directly. Pass NULL to render the synth directly again. */
+    void setMidiFileRenderer(MidiFileRenderer* newRenderer) { midiFileRenderer = newRenderer; }
+
+    /** Sets the sample rate for the simulated device and the engine. */
+    void setSampleRate(double newSampleRate);
+
+    /** Sets the number of samples per callback. */
+    void setBlockSize(int newBlockSize);
+
+    /** Switches between back-to-back callbacks (false, the default) and callbacks that are paced
+    by the real time clock (true). */
+    void setPaced(bool shouldBePaced) { paced = shouldBePaced; }
+
+    //---------------------------------------------------------------------------------------------
+    // recorded input:
+
+    /** Adds a note event (velocity zero means note-off) at the given time (in seconds from the
+    start of the run) for the given instance of the rack (ignored for a single synth). The events
+    may be added in any order. */
+    void addNoteEvent(double time, int instance, int noteNumber, int velocity);
+
+    /** Adds a parameter change at the given time for the given instance of the rack (ignored for
+    a single synth). A negative instance index applies the change to all instances. */
+    void addParameterEvent(double time, int instance, ParameterSetter setter, double value);
+
+    /** Removes all events. */
+    void clearEvents();
+
+    //---------------------------------------------------------------------------------------------
+    // processing:
+
+    /** Simulates the callbacks for the given duration (in seconds) and measures them. The events
+    are replayed from the start (but the engine is not reset, so several runs may be appended to
+    each other). The output of the engine is discarded. */
+    void run(double duration);
+
+    //---------------------------------------------------------------------------------------------
+    // inquiry (about the last run):
+
+    /** Returns the number of callbacks in the last run. */
+    int getNumCallbacks() const { return (int) renderTimes.size(); }
+
+    /** Returns the number of callbacks that missed their deadline. */
+    int getNumDeadlineMisses() const { return numDeadlineMisses; }
+
+    /** Returns the time budget for each callback, i.e. the block size divided by the sample
+    rate. */
+    double getBlockPeriod() const { return blockSize / sampleRate; }
+
+    /** Returns the time that a callback took (in seconds). */
+    double getRenderTime(int callbackIndex) const { return renderTimes[callbackIndex]; }
+
+    /** Returns the time from the moment the callback became due until its end (in seconds). */
+    double getLatency(int callbackIndex) const { return latencies[callbackIndex]; }
+
+    /** Returns the render time that is not exceeded by the given percentage of the callbacks,
+    for example 99.9. */
+    double getRenderTimePercentile(double percentage) const;
+
+    /** Returns the latency that is not exceeded by the given percentage of the callbacks. */
+    double getLatencyPercentile(double percentage) const;
+
+    /** Fills the histogram of the render times - the range from zero to maxTime (in seconds) is
+    divided into numBins bins of equal width. Render times above maxTime are counted in the last
+    bin. */
+    void getRenderTimeHistogram(int* counts, int numBins, double maxTime) const;
+
+    /** Fills the passed structure with the summary of the last run. */
+    void getStatistics(Statistics* statistics) const;
+
+    //=============================================================================================
+
+  protected:
+
+    /** A recorded event. */
+    struct Event
+    {
+      double          time;
+      int             instance;
+      int             noteNumber, velocity; // for note events
+      ParameterSetter setter;               // for parameter changes (NULL for note events)
+      double          value;
+    };
+
+    /** Comparison function for keeping the events sorted by time. */
+    static bool isEarlier(const Event& a, const Event& b) { return a.time < b.time; }
+
+    /** Inserts the event behind all events with the same or an earlier time. */
+    void insertEvent(const Event& event);
+
+    /** Applies an event to the engine. */
+    void applyEvent(const Event& event);
+
+    /** Renders the given number of samples (without events in between). */
+    void render(int numSamples);
+
+    /** Returns the percentile of the values. */
+    static double getPercentile(const std::vector<double>& values, double percentage);
+
+    Open303*          synth;
+    Open303Rack*      rack;
+    MidiFileRenderer* midiFileRenderer;
+    double            sampleRate;
+    int               blockSize;
+    bool              paced;
+
+    std::vector<Event>   events;        // sorted by time
+    std::vector<double>  renderTimes, latencies;
+    int                  numDeadlineMisses;
+
+    std::vector<double>  outputBuffer;  // numBuses * blockSize samples
+    std::vector<double*> busPointers;
+
+  private:
+
+    // simulators are not supposed to be copied:
+    CallbackSimulator(const CallbackSimulator&);
+    CallbackSimulator& operator=(const CallbackSimulator&);
+
+  };
+
+} // end namespace rosic
+
+#endif // rosic_CallbackSimulator_h
@@ -0,0 +1,95 @@
+#include "rosic_DenormalGuard.h"
+using namespace rosic;
+
+// the platforms are those for which GlobalDefinitions.h defines ROSIC_FLUSHES_DENORMALS:
+#if !defined(ROSIC_FLUSHES_DENORMALS)
+  // no flush-to-zero mode - the filters add TINY instead (see ANTI_DENORMAL)
+#elif defined(__aarch64__) || defined(__arm__)
+  #define ROSIC_DENORMALS_FPCR
+#else
+  #include <xmmintrin.h>
+  #define ROSIC_DENORMALS_MXCSR
+#endif
+
+// bits in the control registers:
+static const unsigned int mxcsrFlushToZero      = 0x8000;    // FTZ: flush denormal results to zero
+static const unsigned int mxcsrDenormalsAreZero = 0x0040;    // DAZ: treat denormal inputs as zero
+static const UINT64       fpcrFlushToZero       = 0x1000000; // FZ: both of the above on ARM
+
+//-------------------------------------------------------------------------------------------------
+// access to the control registers:
+
+static UINT64 getControlRegister()
+{
+#if defined(ROSIC_DENORMALS_MXCSR)
+  return _mm_getcsr();
+#elif defined(ROSIC_DENORMALS_FPCR) && defined(__aarch64__)
+  UINT64 r;
+  __asm__ __volatile__("mrs %0, fpcr" : "=r"(r));
+  return r;
+#elif defined(ROSIC_DENORMALS_FPCR)
+  unsigned int r;
+  __asm__ __volatile__("vmrs %0, fpscr" : "=r"(r));
+  return r;
+#else
+  return 0;
+#endif
+}
+
+static void setControlRegister(UINT64 value)
+{
+#if defined(ROSIC_DENORMALS_MXCSR)
+  _mm_setcsr((unsigned int) value);
+#elif defined(ROSIC_DENORMALS_FPCR) && defined(__aarch64__)
+  __asm__ __volatile__("msr fpcr, %0" : : "r"(value));
+#elif defined(ROSIC_DENORMALS_FPCR)
+  __asm__ __volatile__("vmsr fpscr, %0" : : "r"((unsigned int) value));
+#else
+  (void) value;
+#endif
+}
+
+static UINT64 getFlushBits()
+{
+#if defined(ROSIC_DENORMALS_MXCSR)
+  return mxcsrFlushToZero | mxcsrDenormalsAreZero;
+#elif defined(ROSIC_DENORMALS_FPCR)
+  return fpcrFlushToZero;
+#else
+  return 0;
+#endif
+}
+
+//-------------------------------------------------------------------------------------------------
+// construction/destruction:
+
+DenormalGuard::DenormalGuard()
+{
+  savedState = getControlRegister();
+  UINT64 bits = getFlushBits();
+  if( bits != 0 && (savedState & bits) != bits ) // avoid the (serializing) write when possible
+    setControlRegister(savedState | bits);
+}
+
+DenormalGuard::~DenormalGuard()
+{
+  // restore only the flush bits and leave the (sticky) exception flags raised in between alone:
+  UINT64 bits    = getFlushBits();
+  UINT64 current = getControlRegister();
+  if( (current & bits) != (savedState & bits) )
+    setControlRegister((current & ~bits) | (savedState & bits));
+}
+
+//-------------------------------------------------------------------------------------------------
+// inquiry:
+
+bool DenormalGuard::isSupported()
+{
+  return getFlushBits() != 0;
+}
+
+bool DenormalGuard::isActive()
+{
+  UINT64 bits = getFlushBits();
+  return bits != 0 && (getControlRegister() & bits) == bits;
+}
@@ -0,0 +1,72 @@
+#ifndef rosic_DenormalGuard_h
+#define rosic_DenormalGuard_h
+
+// rosic-indcludes:
+#include "GlobalDefinitions.h"
+
+namespace rosic
+{
+
+  /**
+
+  This is a class that switches the floating point unit of the calling thread into a mode where
+  denormal (subnormal) numbers are flushed to zero for the lifetime of the object and restores the
+  previous mode in the destructor. Recursive filters (TeeBeeFilter, OnePoleFilter, BiquadFilter,
+  LeakyIntegrator, etc.) produce states that decay exponentially towards zero when the input
+  becomes silent and on many CPUs each arithmetic operation on such tiny numbers takes a slow
+  microcode path which shows up as CPU spikes during decay tails. Objects of this class are
+  created on the stack at the entry points of block rendering (like Open303VST::processReplacing,
+  AcidSongPlayer::render, the worker threads of ParameterSweep, etc.), so there's no need to add
+  a small offset (TINY) to the filter states per sample anymore. Open303::getSample and
+  Open303::processBlock create a guard themselves, such that hosts calling them directly are
+  protected, too.
+
+  Supported are x86/x64 (SSE control register MXCSR: flush-to-zero and denormals-are-zero),
+  AArch64 (FPCR) and 32-bit ARM with VFP (FPSCR) - on these, the flush-to-zero bit affects inputs
+  and outputs alike and GlobalDefinitions.h defines ROSIC_FLUSHES_DENORMALS. On other platforms
+  (like WebAssembly, where the mode cannot be changed), the guard does nothing and the recursive
+  filters add TINY to their outputs instead (see ANTI_DENORMAL).
+
+  Note that the mode is a per-thread state - each thread that renders audio needs its own guard.
+
+  */
+
+  class DenormalGuard
+  {
+
+  public:
+
+    //---------------------------------------------------------------------------------------------
+    // construction/destruction:
+
+    /** Constructor. Saves the current floating point mode and switches flush-to-zero on. */
+    DenormalGuard();
+
+    /** Destructor. Restores the floating point mode that was active before the construction. */
+    ~DenormalGuard();
+
+    //---------------------------------------------------------------------------------------------
+    // inquiry:
+
+    /** Returns true when denormal flushing is supported on this platform (i.e. the guard is not
+    just a no-op). */
+    static bool isSupported();
+
+    /** Returns true when denormals are currently flushed to zero on the calling thread. */
+    static bool isActive();
+
+  protected:
+
+    UINT64 savedState; // content of the control register before the construction
+
+  private:
+
+    // guards restore the state of the thread that created them and are not supposed to be copied:
+    DenormalGuard(const DenormalGuard& other);
+    DenormalGuard& operator=(const DenormalGuard& other);
+
+  };
+
+} // end namespace rosic
+
+#endif // rosic_DenormalGuard_h
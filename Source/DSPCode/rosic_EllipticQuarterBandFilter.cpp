@@ -1,20 +1,59 @@
-#include "rosic_EllipticQuarterBandFilter.h"
-using namespace rosic;
-
-//-------------------------------------------------------------------------------------------------
-// construction/destruction:
-
-EllipticQuarterBandFilter::EllipticQuarterBandFilter()
-{
-  reset();  
-}
-
-//-------------------------------------------------------------------------------------------------
-// parameter settings:
-
-void EllipticQuarterBandFilter::reset()
-{
-  for(int i=0; i<12; i++)
-    w[i] = 0.0;
-}
-
+#include "rosic_EllipticQuarterBandFilter.h"
+using namespace rosic;
+
+//-------------------------------------------------------------------------------------------------
+// coefficients of the sections (low Q first):
+
+const double EllipticQuarterBandFilter::b0[numSections] =
+  { 0.016780659875746895, 0.094597630510386929, 0.2906948429243274,
+    0.52578571168441313, 0.70505070819977667, 0.79922265546174676 };
+const double EllipticQuarterBandFilter::b1[numSections] =
+  { 0.022947305590395987, -0.035133895519811859, -0.29936460777069362,
+    -0.66650720657910956, -0.9608991410965132, -1.1173330262261589 };
+const double EllipticQuarterBandFilter::b2[numSections] =
+  { 0.016780659875746898, 0.094597630510387387, 0.29069484292431808,
+    0.52578571168450239, 0.70505070819942905, 0.79922265546202731 };
+const double EllipticQuarterBandFilter::a1[numSections] =
+  { 1.5863116563427277, 1.5620957211226623, 1.531070091521082,
+    1.5080939953919845, 1.4983265465583293, 1.5032624542821613 };
+const double EllipticQuarterBandFilter::a2[numSections] =
+  { -0.64282028168485539, -0.71615708662362476, -0.81309516959903383,
+    -0.89315821218179048, -0.94752882186102183, -0.98437473897977634 };
+
+//-------------------------------------------------------------------------------------------------
+// construction/destruction:
+
+EllipticQuarterBandFilter::EllipticQuarterBandFilter()
+{
+  reset();
+}
+
+//-------------------------------------------------------------------------------------------------
+// parameter settings:
+
+void EllipticQuarterBandFilter::reset()
+{
+  for(int k=0; k<numSections; k++)
+    s1[k] = s2[k] = 0.0;
+}
+
+//-------------------------------------------------------------------------------------------------
+// state persistence:
+
+void EllipticQuarterBandFilter::saveState(StateWriter& writer) const
+{
+  for(int k=0; k<numSections; k++)
+  {
+    writer.writeDouble(s1[k]);
+    writer.writeDouble(s2[k]);
+  }
+}
+
+void EllipticQuarterBandFilter::loadState(StateReader& reader)
+{
+  for(int k=0; k<numSections; k++)
+  {
+    s1[k] = reader.readDouble();
+    s2[k] = reader.readDouble();
+  }
+}
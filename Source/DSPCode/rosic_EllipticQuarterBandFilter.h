@@ -1,103 +1,128 @@
-#ifndef rosic_EllipticQuarterBandFilter_h
-#define rosic_EllipticQuarterBandFilter_h
-
-#include <string.h> // for memmove
-
-// rosic-indcludes:
-#include "GlobalDefinitions.h"
-
-namespace rosic
-{
-
-  /**
-
-  This is an elliptic subband filter of 12th order using a Direct Form II implementation structure.
-
-  */
-
-  class EllipticQuarterBandFilter
-  {
-
-  public:
-
-    //---------------------------------------------------------------------------------------------
-    // construction/destruction:
-
-    /** Constructor. */
-    EllipticQuarterBandFilter();   
-
-    //---------------------------------------------------------------------------------------------
-    // parameter settings:
-
-    /** Resets the filter state. */
-    void reset();
-
-    //---------------------------------------------------------------------------------------------
-    // audio processing:
-
-    /** Calculates a single filtered output-sample. */
-    INLINE double getSample(double in);
-
-    //=============================================================================================
-
-  protected:
-
-    // state buffer:
-    double w[12];
-
-  };
-
-  //-----------------------------------------------------------------------------------------------
-  // inlined functions:
-
-  INLINE double EllipticQuarterBandFilter::getSample(double in)
-  {
-    const double a01 =   -9.1891604652189471;
-    const double a02 =   40.177553696870497;
-    const double a03 = -110.11636661771178;
-    const double a04 =  210.18506612078195;
-    const double a05 = -293.84744771903240;
-    const double a06 =  308.16345558359234;
-    const double a07 = -244.06786780384243;
-    const double a08 =  144.81877911392738;
-    const double a09 =  -62.770692151724198;
-    const double a10 =   18.867762095902137;
-    const double a11 =   -3.5327094230551848;
-    const double a12 =    0.31183189275203149;
-
-    const double b00 =    0.00013671732099945628;
-    const double b01 =   -0.00055538501265606384;
-    const double b02 =    0.0013681887636296387;
-    const double b03 =   -0.0022158566490711852;
-    const double b04 =    0.0028320091007278322;
-    const double b05 =   -0.0029776933151090413;
-    const double b06 =    0.0030283628243514991;    
-    const double b07 =   -0.0029776933151090413;
-    const double b08 =    0.0028320091007278331;
-    const double b09 =   -0.0022158566490711861;
-    const double b10 =    0.0013681887636296393;    
-    const double b11 =   -0.00055538501265606384;
-    const double b12 =    0.00013671732099945636;
-
-    // calculate intermediate and output sample via direct form II - the parentheses facilitate 
-    // out-of-order execution of the independent additions (for performance optimization):
-    double tmp =   (in + TINY)
-                 - ( (a01*w[0] + a02*w[1] ) + (a03*w[2]  + a04*w[3]   ) ) 
-                 - ( (a05*w[4] + a06*w[5] ) + (a07*w[6]  + a08*w[7]   ) )
-                 - ( (a09*w[8] + a10*w[9] ) + (a11*w[10] +  a12*w[11] ) );
-   
-    double y =     b00*tmp 
-                 + ( (b01*w[0] + b02*w[1])  +  (b03*w[2]  + b04*w[3]  ) )  
-                 + ( (b05*w[4] + b06*w[5])  +  (b07*w[6]  + b08*w[7]  ) )
-                 + ( (b09*w[8] + b10*w[9])  +  (b11*w[10] + b12*w[11] ) );
-
-    // update state variables:
-    memmove(&w[1], &w[0], 11*sizeof(double));
-    w[0] = tmp;
-
-    return y;
-  }
-
-} // end namespace rosic
-
-#endif // rosic_EllipticQuarterBandFilter_h
+#ifndef rosic_EllipticQuarterBandFilter_h
+#define rosic_EllipticQuarterBandFilter_h
+
+// rosic-indcludes:
+#include "GlobalDefinitions.h"
+#include "rosic_StateStream.h"
+
+namespace rosic
+{
+
+  /**
+
+  This is an elliptic subband filter of 12th order, intended to be used as anti-aliasing filter for
+  decimation by a factor of 4. It is realized as a cascade of 6 biquad sections (second order
+  sections, SOS) in transposed direct form II. The sections were obtained by factoring the
+  numerator and denominator of the original 12th order direct form II transfer function (whose
+  coefficients went up to +-308) into conjugate pairs of zeros and poles (in 60 digit arithmetic),
+  pairing each pole-pair with its nearest zero-pair, ordering the sections from low to high Q and
+  scaling each section to unit gain at DC - and the first one additionally by the DC gain of the
+  direct form (which is 1 - 4.2e-12). The frequency response matches the exact transfer function
+  of the direct form coefficients within 2.e-14 (absolute, checked by
+  Tests/EllipticQuarterBandFilterTest.cpp) - the direct form realization itself is off by 4.e-9 -
+  and the coefficients are all below 2 in magnitude which makes the structure robust against
+  coefficient quantization (so it would also work in single precision).
+
+  The coefficients are stored as separate arrays per coefficient (structure of arrays), such that
+  the independent sections can be evaluated side by side in SIMD lanes. getSampleDecimated
+  processes a whole block of oversampled input samples section by section - the dependency chain
+  then runs only along the samples within a section while the work of different sections on
+  different samples may overlap in the CPU's pipeline.
+
+  */
+
+  class EllipticQuarterBandFilter
+  {
+
+  public:
+
+    //---------------------------------------------------------------------------------------------
+    // construction/destruction:
+
+    /** Constructor. */
+    EllipticQuarterBandFilter();
+
+    //---------------------------------------------------------------------------------------------
+    // parameter settings:
+
+    /** Resets the filter state. */
+    void reset();
+
+    /** Writes the 2 state variables of each of the sections into the stream. */
+    void saveState(StateWriter& writer) const;
+
+    /** Reads the state variables back from the stream. @see saveState */
+    void loadState(StateReader& reader);
+
+    //---------------------------------------------------------------------------------------------
+    // audio processing:
+
+    /** Calculates a single filtered output-sample. */
+    INLINE double getSample(double in);
+
+    /** Filters a block of 'factor' consecutive input samples and returns the last output sample
+    - this is all that a decimator by 'factor' needs. The buffer is used as scratch space and
+    contains the filtered block afterwards. The result is identical to calling getSample 'factor'
+    times. */
+    INLINE double getSampleDecimated(double* buffer, int factor);
+
+    //=============================================================================================
+
+    static const int numSections = 6;
+
+  protected:
+
+    // coefficients of the sections (the feedback coefficients a1, a2 are stored with the sign
+    // inverted, as in BiquadFilter):
+    static const double b0[numSections], b1[numSections], b2[numSections];
+    static const double a1[numSections], a2[numSections];
+
+    // state variables of the sections:
+    double s1[numSections], s2[numSections];
+
+  };
+
+  //-----------------------------------------------------------------------------------------------
+  // inlined functions:
+
+  INLINE double EllipticQuarterBandFilter::getSample(double in)
+  {
+    double x = ANTI_DENORMAL(in);
+    for(int k=0; k<numSections; k++)
+    {
+      double y = b0[k]*x + s1[k];
+      s1[k]    = b1[k]*x + a1[k]*y + s2[k];
+      s2[k]    = b2[k]*x + a2[k]*y;
+      x        = y;
+    }
+    return x;
+  }
+
+  INLINE double EllipticQuarterBandFilter::getSampleDecimated(double* buffer, int factor)
+  {
+#ifndef ROSIC_FLUSHES_DENORMALS
+    for(int n=0; n<factor; n++)
+      buffer[n] = ANTI_DENORMAL(buffer[n]);
+#endif
+    for(int k=0; k<numSections; k++)
+    {
+      double cb0 = b0[k], cb1 = b1[k], cb2 = b2[k], ca1 = a1[k], ca2 = a2[k];
+      double t1  = s1[k];
+      double t2  = s2[k];
+      for(int n=0; n<factor; n++)
+      {
+        double x  = buffer[n];
+        double y  = cb0*x + t1;
+        t1        = cb1*x + ca1*y + t2;
+        t2        = cb2*x + ca2*y;
+        buffer[n] = y;
+      }
+      s1[k] = t1;
+      s2[k] = t2;
+    }
+    return buffer[factor-1];
+  }
+
+} // end namespace rosic
+
+#endif // rosic_EllipticQuarterBandFilter_h
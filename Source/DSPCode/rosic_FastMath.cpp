@@ -0,0 +1,182 @@
+#include "rosic_FastMath.h"
+#include "rosic_FastMathVectorOps.h"
+
+using namespace rosic;
+
+typedef FastMathVectorOps Ops;
+typedef Ops::VD           VD;
+
+//-------------------------------------------------------------------------------------------------
+// array functions:
+
+/** Runs the functor over the buffers in groups of numLanes values - a remainder is padded into a
+temporary group, so all values go through the same code. The functor loads from the inputs at the
+given position and stores the results there, so in-place operation is fine. */
+template<class Functor>
+static void processInGroups(Functor& f, int length)
+{
+  int n = 0;
+  for(; n <= length-Ops::numLanes; n += Ops::numLanes)
+    f.process(n);
+  if( n < length )
+    f.processRemainder(n, length-n);
+}
+
+struct Exp2Functor
+{
+  const double* x;
+  double*       y;
+
+  void process(int n)
+  {
+    VD em1, e;
+    exp2Kernel<Ops>(Ops::load(x+n), &em1, &e);
+    Ops::store(y+n, e);
+  }
+
+  void processRemainder(int n, int num)
+  {
+    double in[Ops::numLanes] = { 0 }, out[Ops::numLanes];
+    memcpy(in, x+n, num*sizeof(double));
+    VD em1, e;
+    exp2Kernel<Ops>(Ops::load(in), &em1, &e);
+    Ops::store(out, e);
+    memcpy(y+n, out, num*sizeof(double));
+  }
+};
+
+struct Log2Functor
+{
+  const double* x;
+  double*       y;
+
+  void process(int n)
+  {
+    Ops::store(y+n, log2Kernel<Ops>(Ops::load(x+n)));
+  }
+
+  void processRemainder(int n, int num)
+  {
+    double in[Ops::numLanes], out[Ops::numLanes];
+    for(int i=0; i<Ops::numLanes; i++)
+      in[i] = 1.0;
+    memcpy(in, x+n, num*sizeof(double));
+    Ops::store(out, log2Kernel<Ops>(Ops::load(in)));
+    memcpy(y+n, out, num*sizeof(double));
+  }
+};
+
+struct PowFunctor
+{
+  const double* x;
+  const double* y;
+  double*       z;
+
+  static INLINE VD pow(VD x, VD y)
+  {
+    VD em1, e;
+    exp2Kernel<Ops>(Ops::mul(y, log2Kernel<Ops>(x)), &em1, &e);
+    return e;
+  }
+
+  void process(int n)
+  {
+    Ops::store(z+n, pow(Ops::load(x+n), Ops::load(y+n)));
+  }
+
+  void processRemainder(int n, int num)
+  {
+    double in1[Ops::numLanes], in2[Ops::numLanes] = { 0 }, out[Ops::numLanes];
+    for(int i=0; i<Ops::numLanes; i++)
+      in1[i] = 1.0;
+    memcpy(in1, x+n, num*sizeof(double));
+    memcpy(in2, y+n, num*sizeof(double));
+    Ops::store(out, pow(Ops::load(in1), Ops::load(in2)));
+    memcpy(z+n, out, num*sizeof(double));
+  }
+};
+
+struct TanhFunctor
+{
+  const double* x;
+  double*       y;
+
+  void process(int n)
+  {
+    Ops::store(y+n, tanhKernel<Ops>(Ops::load(x+n)));
+  }
+
+  void processRemainder(int n, int num)
+  {
+    double in[Ops::numLanes] = { 0 }, out[Ops::numLanes];
+    memcpy(in, x+n, num*sizeof(double));
+    Ops::store(out, tanhKernel<Ops>(Ops::load(in)));
+    memcpy(y+n, out, num*sizeof(double));
+  }
+};
+
+struct SinCosFunctor
+{
+  const double* x;
+  double*       s;
+  double*       c;
+
+  void process(int n)
+  {
+    VD sv, cv;
+    sinCosKernel<Ops>(Ops::load(x+n), &sv, &cv);
+    if( s != NULL )
+      Ops::store(s+n, sv);
+    if( c != NULL )
+      Ops::store(c+n, cv);
+  }
+
+  void processRemainder(int n, int num)
+  {
+    double in[Ops::numLanes] = { 0 }, sOut[Ops::numLanes], cOut[Ops::numLanes];
+    memcpy(in, x+n, num*sizeof(double));
+    VD sv, cv;
+    sinCosKernel<Ops>(Ops::load(in), &sv, &cv);
+    Ops::store(sOut, sv);
+    Ops::store(cOut, cv);
+    if( s != NULL )
+      memcpy(s+n, sOut, num*sizeof(double));
+    if( c != NULL )
+      memcpy(c+n, cOut, num*sizeof(double));
+  }
+};
+
+void rosic::exp2Fast(const double* x, double* result, int length)
+{
+  Exp2Functor f = { x, result };
+  processInGroups(f, length);
+}
+
+void rosic::log2Fast(const double* x, double* result, int length)
+{
+  Log2Functor f = { x, result };
+  processInGroups(f, length);
+}
+
+void rosic::powFast(const double* x, const double* y, double* result, int length)
+{
+  PowFunctor f = { x, y, result };
+  processInGroups(f, length);
+}
+
+void rosic::tanhFast(const double* x, double* result, int length)
+{
+  TanhFunctor f = { x, result };
+  processInGroups(f, length);
+}
+
+void rosic::sinCosFast(const double* x, double* sinResult, double* cosResult, int length)
+{
+  SinCosFunctor f = { x, sinResult, cosResult };
+  processInGroups(f, length);
+}
+
+const char* rosic::getFastMathInstructionSet()
+{
+  return Ops::getName();
+}
@@ -0,0 +1,285 @@
+#ifndef rosic_FastMath_h
+#define rosic_FastMath_h
+
+// standard library includes:
+#include <string.h>
+
+// rosic includes:
+#include "GlobalDefinitions.h"
+
+namespace rosic
+{
+
+  /**
+
+  Fast replacements for the libm functions that appear in the per-sample paths and in the table
+  generation. Each function exists as an inlined scalar version and as a version for arrays which
+  processes several values at once with SIMD instructions - AVX2 (4 lanes), SSE2 or NEON on
+  AArch64 (2 lanes each) or WebAssembly SIMD (2 lanes, when compiled with -msimd128), whichever is
+  available at compile time, with a scalar loop as fallback. Both versions use the same kernels,
+  so they compute the same results (unless the compiler contracts multiplies and adds into fused
+  operations differently).
+
+  Accuracy contracts (maximum errors over the given ranges, measured against the long double
+  functions of libm; ulp = unit in the last place):
+
+  exp2Fast(x):    x in -1022...1023: relative error < 2e-16 (about 1 ulp). Arguments below the
+                  range give 2^-1022 (no denormals), above the range 2^1023 (no infinity).
+  log2Fast(x):    x positive and normal: absolute error < 2.5e-16 for results in -1...1, relative
+                  error < 1.5e-16 outside. Zero, negative, denormal, infinite and NaN arguments
+                  give unspecified results.
+  powFast(x, y):  computed as exp2Fast(y*log2Fast(x)), so x must be positive and normal. The
+                  relative error grows with the magnitude of the result's exponent: it's below
+                  (1 + |y*log2(x)|) * 3e-16.
+  tanhFast(x):    all finite x: absolute error < 2e-16, relative error < 5e-16.
+  sinCosFast(x):  |x| up to 2^20*pi: absolute error < 2e-16. Beyond that, the range reduction
+                  loses accuracy.
+
+  */
+
+  /** Computes 2^x. */
+  INLINE double exp2Fast(double x);
+
+  /** Computes the base 2 logarithm of x. */
+  INLINE double log2Fast(double x);
+
+  /** Computes x^y for positive x. */
+  INLINE double powFast(double x, double y);
+
+  /** Computes the hyperbolic tangent of x. */
+  INLINE double tanhFast(double x);
+
+  /** Computes sine and cosine of x. */
+  INLINE void sinCosFast(double x, double* sinResult, double* cosResult);
+
+  /** Computes 2^x for all values in the buffer. The result may be the same buffer as x. */
+  void exp2Fast(const double* x, double* result, int length);
+
+  /** Computes the base 2 logarithm for all values in the buffer. */
+  void log2Fast(const double* x, double* result, int length);
+
+  /** Computes x[n]^y[n] for all values in the buffers. */
+  void powFast(const double* x, const double* y, double* result, int length);
+
+  /** Computes the hyperbolic tangent for all values in the buffer. */
+  void tanhFast(const double* x, double* result, int length);
+
+  /** Computes sine and cosine for all values in the buffer. One of the results may be NULL when
+  it's not needed. */
+  void sinCosFast(const double* x, double* sinResult, double* cosResult, int length);
+
+  /** Returns the name of the instruction set that is used for the array functions. */
+  const char* getFastMathInstructionSet();
+
+  //===============================================================================================
+  // implementation:
+
+  /** The elementary operations on which the fast math kernels are built, for scalars. The array
+  functions use structs with the same members for SIMD vectors of doubles (VD) and of 64-bit
+  integers holding their bit patterns (VI). */
+  struct FastMathScalarOps
+  {
+    typedef double VD;
+    typedef UINT64 VI;
+
+    static INLINE VD set(double x)         { return x;   }
+    static INLINE VD add(VD a, VD b)       { return a+b; }
+    static INLINE VD sub(VD a, VD b)       { return a-b; }
+    static INLINE VD mul(VD a, VD b)       { return a*b; }
+    static INLINE VD div(VD a, VD b)       { return a/b; }
+    static INLINE VD min(VD a, VD b)       { return a < b ? a : b; }
+    static INLINE VD max(VD a, VD b)       { return a > b ? a : b; }
+
+    static INLINE VI setInt(UINT64 x)      { return x;   }
+    static INLINE VI addInt(VI a, VI b)    { return a+b; }
+    static INLINE VI subInt(VI a, VI b)    { return a-b; }
+    static INLINE VI andInt(VI a, VI b)    { return a&b; }
+    static INLINE VI orInt(VI a, VI b)     { return a|b; }
+    static INLINE VI xorInt(VI a, VI b)    { return a^b; }
+    static INLINE VI shiftLeft52(VI a)     { return a << 52; }
+    static INLINE VI shiftRight52(VI a)    { return a >> 52; }
+    static INLINE VI shiftLeft62(VI a)     { return a << 62; }
+
+    static INLINE VI asInt(VD x)    { VI i; memcpy(&i, &x, 8); return i; }
+    static INLINE VD asDouble(VI i) { VD x; memcpy(&x, &i, 8); return x; }
+  };
+
+  /** Adding this to a double in -2^51...2^51 rounds it to an integer which then sits in the low
+  bits of the mantissa. */
+  #define FASTMATH_ROUNDING_MAGIC 6755399441055744.0 // 1.5 * 2^52
+
+  /** Computes 2^x - 1 and 2^x for x in -1022...1023 (clipping x to that range). Writing
+  2^x = 2^n * 2^f with integer n and f in -0.5...0.5, the polynomial p1 approximates 2^f - 1 (the
+  Taylor series up to the last term above 1e-17) and 2^n is assembled in the exponent bits. */
+  template<class Ops>
+  INLINE void exp2Kernel(typename Ops::VD x, typename Ops::VD* expm1Result,
+                         typename Ops::VD* expResult)
+  {
+    typedef typename Ops::VD VD;
+
+    x     = Ops::min(Ops::max(x, Ops::set(-1022.0)), Ops::set(1023.0));
+    VD r  = Ops::add(x, Ops::set(FASTMATH_ROUNDING_MAGIC));
+    VD n  = Ops::sub(r, Ops::set(FASTMATH_ROUNDING_MAGIC));
+    VD f  = Ops::sub(x, n);
+
+    // coefficients ln(2)^k / k!:
+    VD p1 = Ops::set(1.36914888539041241e-12);
+    p1 = Ops::add(Ops::mul(p1, f), Ops::set(2.56784359934881958e-11));
+    p1 = Ops::add(Ops::mul(p1, f), Ops::set(4.44553827187081007e-10));
+    p1 = Ops::add(Ops::mul(p1, f), Ops::set(7.05491162080112088e-09));
+    p1 = Ops::add(Ops::mul(p1, f), Ops::set(1.01780860092396960e-07));
+    p1 = Ops::add(Ops::mul(p1, f), Ops::set(1.32154867901443053e-06));
+    p1 = Ops::add(Ops::mul(p1, f), Ops::set(1.52527338040598377e-05));
+    p1 = Ops::add(Ops::mul(p1, f), Ops::set(1.54035303933816061e-04));
+    p1 = Ops::add(Ops::mul(p1, f), Ops::set(1.33335581464284411e-03));
+    p1 = Ops::add(Ops::mul(p1, f), Ops::set(9.61812910762847688e-03));
+    p1 = Ops::add(Ops::mul(p1, f), Ops::set(5.55041086648215762e-02));
+    p1 = Ops::add(Ops::mul(p1, f), Ops::set(2.40226506959100694e-01));
+    p1 = Ops::add(Ops::mul(p1, f), Ops::set(6.93147180559945286e-01));
+    p1 = Ops::mul(p1, f);
+
+    VD scale     = Ops::asDouble(Ops::addInt(Ops::shiftLeft52(Ops::asInt(r)),
+                                             Ops::setInt(1023ULL << 52)));
+    *expResult   = Ops::add(Ops::mul(p1, scale), scale);
+    *expm1Result = Ops::add(Ops::mul(p1, scale), Ops::sub(scale, Ops::set(1.0)));
+  }
+
+  /** Computes the base 2 logarithm of positive normal numbers. Writing x = 2^e * m with m in
+  sqrt(0.5)...sqrt(2) (found by integer arithmetic on the bit pattern), ln(m) is computed from the
+  series 2*atanh(s) with s = (m-1)/(m+1). */
+  template<class Ops>
+  INLINE typename Ops::VD log2Kernel(typename Ops::VD x)
+  {
+    typedef typename Ops::VD VD;
+    typedef typename Ops::VI VI;
+
+    // adding the offset moves mantissas above sqrt(2) into the next exponent:
+    VI j = Ops::addInt(Ops::asInt(x), Ops::setInt(0x3FF0000000000000ULL - 0x3FE6A09E667F3BCDULL));
+
+    // exponent (still biased) converted to double via the rounding magic:
+    VD e = Ops::asDouble(Ops::orInt(Ops::shiftRight52(j), Ops::setInt(0x4330000000000000ULL)));
+    e    = Ops::sub(e, Ops::set(4503599627370496.0 + 1023.0)); // 2^52 + bias
+
+    VD m = Ops::asDouble(Ops::addInt(Ops::andInt(j, Ops::setInt(0x000FFFFFFFFFFFFFULL)),
+                                     Ops::setInt(0x3FE6A09E667F3BCDULL)));
+    VD s = Ops::div(Ops::sub(m, Ops::set(1.0)), Ops::add(m, Ops::set(1.0)));
+    VD z = Ops::mul(s, s);
+
+    // coefficients 1/(2k+1):
+    VD p = Ops::set(1.0/23);
+    p = Ops::add(Ops::mul(p, z), Ops::set(1.0/21));
+    p = Ops::add(Ops::mul(p, z), Ops::set(1.0/19));
+    p = Ops::add(Ops::mul(p, z), Ops::set(1.0/17));
+    p = Ops::add(Ops::mul(p, z), Ops::set(1.0/15));
+    p = Ops::add(Ops::mul(p, z), Ops::set(1.0/13));
+    p = Ops::add(Ops::mul(p, z), Ops::set(1.0/11));
+    p = Ops::add(Ops::mul(p, z), Ops::set(1.0/9));
+    p = Ops::add(Ops::mul(p, z), Ops::set(1.0/7));
+    p = Ops::add(Ops::mul(p, z), Ops::set(1.0/5));
+    p = Ops::add(Ops::mul(p, z), Ops::set(1.0/3));
+    p = Ops::mul(p, z);
+
+    // log2(m) = 2/ln(2) * (s + s*p):
+    VD lnm = Ops::add(s, Ops::mul(s, p));
+    return Ops::add(e, Ops::mul(lnm, Ops::set(2.0*ONE_OVER_LN2)));
+  }
+
+  /** Computes tanh(|x|) = (e^(2|x|)-1) / (e^(2|x|)+1) via exp2Kernel (which provides e^(2|x|)-1
+  without cancellation for small x) and copies the sign of x. */
+  template<class Ops>
+  INLINE typename Ops::VD tanhKernel(typename Ops::VD x)
+  {
+    typedef typename Ops::VD VD;
+    typedef typename Ops::VI VI;
+
+    VI sign = Ops::andInt(Ops::asInt(x), Ops::setInt(0x8000000000000000ULL));
+    VD a    = Ops::asDouble(Ops::andInt(Ops::asInt(x), Ops::setInt(0x7FFFFFFFFFFFFFFFULL)));
+    a       = Ops::min(a, Ops::set(20.0)); // tanh(20) rounds to 1
+
+    VD em1, e;
+    exp2Kernel<Ops>(Ops::mul(a, Ops::set(2.0*ONE_OVER_LN2)), &em1, &e);
+    VD t = Ops::div(em1, Ops::add(em1, Ops::set(2.0)));
+    return Ops::asDouble(Ops::orInt(Ops::asInt(t), sign));
+  }
+
+  /** Computes sine and cosine. The argument is reduced to y = x - k*pi/2 with y in -pi/4...pi/4
+  (subtracting pi/2 in three parts, such that the products with k up to 2^20 are exact), sine and
+  cosine of y are approximated by the polynomials from fdlibm's kernels and the results are swapped
+  and negated according to the quadrant k mod 4. */
+  template<class Ops>
+  INLINE void sinCosKernel(typename Ops::VD x, typename Ops::VD* sinResult,
+                           typename Ops::VD* cosResult)
+  {
+    typedef typename Ops::VD VD;
+    typedef typename Ops::VI VI;
+
+    VD r = Ops::add(Ops::mul(x, Ops::set(2.0/PI)), Ops::set(FASTMATH_ROUNDING_MAGIC));
+    VD k = Ops::sub(r, Ops::set(FASTMATH_ROUNDING_MAGIC));
+    VD y = Ops::sub(x, Ops::mul(k, Ops::set(1.57079632673412561417e+00)));
+    y    = Ops::sub(y, Ops::mul(k, Ops::set(6.07710050630396597660e-11)));
+    y    = Ops::sub(y, Ops::mul(k, Ops::set(2.02226624871116645580e-21)));
+    VD z = Ops::mul(y, y);
+
+    VD ps = Ops::set(1.58969099521155010221e-10);
+    ps = Ops::add(Ops::mul(ps, z), Ops::set(-2.50507602534068634195e-08));
+    ps = Ops::add(Ops::mul(ps, z), Ops::set( 2.75573137070700676789e-06));
+    ps = Ops::add(Ops::mul(ps, z), Ops::set(-1.98412698298579493134e-04));
+    ps = Ops::add(Ops::mul(ps, z), Ops::set( 8.33333333332248946124e-03));
+    ps = Ops::add(Ops::mul(ps, z), Ops::set(-1.66666666666666324348e-01));
+    VD s = Ops::add(y, Ops::mul(Ops::mul(y, z), ps));
+
+    VD pc = Ops::set(-1.13596475577881948265e-11);
+    pc = Ops::add(Ops::mul(pc, z), Ops::set( 2.08757232129817482790e-09));
+    pc = Ops::add(Ops::mul(pc, z), Ops::set(-2.75573143513906633035e-07));
+    pc = Ops::add(Ops::mul(pc, z), Ops::set( 2.48015872894767294178e-05));
+    pc = Ops::add(Ops::mul(pc, z), Ops::set(-1.38888888888741095749e-03));
+    pc = Ops::add(Ops::mul(pc, z), Ops::set( 4.16666666666666019037e-02));
+    VD c = Ops::add(Ops::sub(Ops::set(1.0), Ops::mul(Ops::set(0.5), z)),
+                    Ops::mul(Ops::mul(z, z), pc));
+
+    // the low bits of r hold k (plus an even offset) - swap sine and cosine in odd quadrants and
+    // flip the signs in the quadrants where they are negative:
+    VI ki   = Ops::asInt(r);
+    VI odd  = Ops::subInt(Ops::setInt(0), Ops::andInt(ki, Ops::setInt(1))); // all bits set if odd
+    VI si   = Ops::asInt(s);
+    VI ci   = Ops::asInt(c);
+    VI swap = Ops::andInt(odd, Ops::xorInt(si, ci));
+    si      = Ops::xorInt(si, swap);
+    ci      = Ops::xorInt(ci, swap);
+    si      = Ops::xorInt(si, Ops::shiftLeft62(Ops::andInt(ki, Ops::setInt(2))));
+    ci      = Ops::xorInt(ci, Ops::shiftLeft62(Ops::andInt(Ops::addInt(ki, Ops::setInt(1)),
+                                                           Ops::setInt(2))));
+    *sinResult = Ops::asDouble(si);
+    *cosResult = Ops::asDouble(ci);
+  }
+
+  INLINE double exp2Fast(double x)
+  {
+    double em1, e;
+    exp2Kernel<FastMathScalarOps>(x, &em1, &e);
+    return e;
+  }
+
+  INLINE double log2Fast(double x)
+  {
+    return log2Kernel<FastMathScalarOps>(x);
+  }
+
+  INLINE double powFast(double x, double y)
+  {
+    return exp2Fast(y*log2Fast(x));
+  }
+
+  INLINE double tanhFast(double x)
+  {
+    return tanhKernel<FastMathScalarOps>(x);
+  }
+
+  INLINE void sinCosFast(double x, double* sinResult, double* cosResult)
+  {
+    sinCosKernel<FastMathScalarOps>(x, sinResult, cosResult);
+  }
+
+} // end namespace rosic
+
+#endif // rosic_FastMath_h
@@ -0,0 +1,2 @@
+#include "rosic_FastMathVectorOps.h"
+using namespace rosic;
@@ -0,0 +1,188 @@
+#ifndef rosic_FastMathVectorOps_h
+#define rosic_FastMathVectorOps_h
+
+// rosic-indcludes:
+#include "rosic_FastMath.h"
+
+#if defined(__AVX2__)
+  #include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+  #include <arm_neon.h>
+#elif defined(__wasm_simd128__)
+  #include <wasm_simd128.h>
+#endif
+
+namespace rosic
+{
+
+  /**
+
+  The elementary operations of FastMathScalarOps for the SIMD vectors of the instruction set that
+  is available at compile time (AVX2, SSE2, NEON on AArch64 or WebAssembly SIMD, with the scalar
+  operations as fallback). In addition to the members of FastMathScalarOps, each struct has the
+  number of lanes, load and store functions for (unaligned) arrays of that many doubles and the
+  name of the instruction set. This is used by the array functions of FastMath and by other
+  classes that process several independent signals in the lanes of the vectors (such as
+  UnisonLanes).
+
+  */
+
+#if defined(__AVX2__)
+
+  struct FastMathVectorOps
+  {
+    typedef __m256d VD;
+    typedef __m256i VI;
+    static const int numLanes = 4;
+
+    static INLINE VD load(const double* p)     { return _mm256_loadu_pd(p);  }
+    static INLINE void store(double* p, VD x)  { _mm256_storeu_pd(p, x);     }
+
+    static INLINE VD set(double x)             { return _mm256_set1_pd(x);   }
+    static INLINE VD add(VD a, VD b)           { return _mm256_add_pd(a, b); }
+    static INLINE VD sub(VD a, VD b)           { return _mm256_sub_pd(a, b); }
+    static INLINE VD mul(VD a, VD b)           { return _mm256_mul_pd(a, b); }
+    static INLINE VD div(VD a, VD b)           { return _mm256_div_pd(a, b); }
+    static INLINE VD min(VD a, VD b)           { return _mm256_min_pd(a, b); }
+    static INLINE VD max(VD a, VD b)           { return _mm256_max_pd(a, b); }
+
+    static INLINE VI setInt(UINT64 x)          { return _mm256_set1_epi64x((long long) x); }
+    static INLINE VI addInt(VI a, VI b)        { return _mm256_add_epi64(a, b);  }
+    static INLINE VI subInt(VI a, VI b)        { return _mm256_sub_epi64(a, b);  }
+    static INLINE VI andInt(VI a, VI b)        { return _mm256_and_si256(a, b);  }
+    static INLINE VI orInt(VI a, VI b)         { return _mm256_or_si256(a, b);   }
+    static INLINE VI xorInt(VI a, VI b)        { return _mm256_xor_si256(a, b);  }
+    static INLINE VI shiftLeft52(VI a)         { return _mm256_slli_epi64(a, 52); }
+    static INLINE VI shiftRight52(VI a)        { return _mm256_srli_epi64(a, 52); }
+    static INLINE VI shiftLeft62(VI a)         { return _mm256_slli_epi64(a, 62); }
+
+    static INLINE VI asInt(VD x)               { return _mm256_castpd_si256(x); }
+    static INLINE VD asDouble(VI i)            { return _mm256_castsi256_pd(i); }
+
+    static const char* getName() { return "AVX2"; }
+  };
+
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+
+  struct FastMathVectorOps
+  {
+    typedef __m128d VD;
+    typedef __m128i VI;
+    static const int numLanes = 2;
+
+    static INLINE VD load(const double* p)     { return _mm_loadu_pd(p);  }
+    static INLINE void store(double* p, VD x)  { _mm_storeu_pd(p, x);     }
+
+    static INLINE VD set(double x)             { return _mm_set1_pd(x);   }
+    static INLINE VD add(VD a, VD b)           { return _mm_add_pd(a, b); }
+    static INLINE VD sub(VD a, VD b)           { return _mm_sub_pd(a, b); }
+    static INLINE VD mul(VD a, VD b)           { return _mm_mul_pd(a, b); }
+    static INLINE VD div(VD a, VD b)           { return _mm_div_pd(a, b); }
+    static INLINE VD min(VD a, VD b)           { return _mm_min_pd(a, b); }
+    static INLINE VD max(VD a, VD b)           { return _mm_max_pd(a, b); }
+
+    static INLINE VI setInt(UINT64 x)          { return _mm_set1_epi64x((long long) x); }
+    static INLINE VI addInt(VI a, VI b)        { return _mm_add_epi64(a, b);  }
+    static INLINE VI subInt(VI a, VI b)        { return _mm_sub_epi64(a, b);  }
+    static INLINE VI andInt(VI a, VI b)        { return _mm_and_si128(a, b);  }
+    static INLINE VI orInt(VI a, VI b)         { return _mm_or_si128(a, b);   }
+    static INLINE VI xorInt(VI a, VI b)        { return _mm_xor_si128(a, b);  }
+    static INLINE VI shiftLeft52(VI a)         { return _mm_slli_epi64(a, 52); }
+    static INLINE VI shiftRight52(VI a)        { return _mm_srli_epi64(a, 52); }
+    static INLINE VI shiftLeft62(VI a)         { return _mm_slli_epi64(a, 62); }
+
+    static INLINE VI asInt(VD x)               { return _mm_castpd_si128(x); }
+    static INLINE VD asDouble(VI i)            { return _mm_castsi128_pd(i); }
+
+    static const char* getName() { return "SSE2"; }
+  };
+
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+
+  struct FastMathVectorOps
+  {
+    typedef float64x2_t VD;
+    typedef uint64x2_t  VI;
+    static const int numLanes = 2;
+
+    static INLINE VD load(const double* p)     { return vld1q_f64(p);     }
+    static INLINE void store(double* p, VD x)  { vst1q_f64(p, x);         }
+
+    static INLINE VD set(double x)             { return vdupq_n_f64(x);   }
+    static INLINE VD add(VD a, VD b)           { return vaddq_f64(a, b);  }
+    static INLINE VD sub(VD a, VD b)           { return vsubq_f64(a, b);  }
+    static INLINE VD mul(VD a, VD b)           { return vmulq_f64(a, b);  }
+    static INLINE VD div(VD a, VD b)           { return vdivq_f64(a, b);  }
+    static INLINE VD min(VD a, VD b)           { return vminq_f64(a, b);  }
+    static INLINE VD max(VD a, VD b)           { return vmaxq_f64(a, b);  }
+
+    static INLINE VI setInt(UINT64 x)          { return vdupq_n_u64(x);   }
+    static INLINE VI addInt(VI a, VI b)        { return vaddq_u64(a, b);  }
+    static INLINE VI subInt(VI a, VI b)        { return vsubq_u64(a, b);  }
+    static INLINE VI andInt(VI a, VI b)        { return vandq_u64(a, b);  }
+    static INLINE VI orInt(VI a, VI b)         { return vorrq_u64(a, b);  }
+    static INLINE VI xorInt(VI a, VI b)        { return veorq_u64(a, b);  }
+    static INLINE VI shiftLeft52(VI a)         { return vshlq_n_u64(a, 52); }
+    static INLINE VI shiftRight52(VI a)        { return vshrq_n_u64(a, 52); }
+    static INLINE VI shiftLeft62(VI a)         { return vshlq_n_u64(a, 62); }
+
+    static INLINE VI asInt(VD x)               { return vreinterpretq_u64_f64(x); }
+    static INLINE VD asDouble(VI i)            { return vreinterpretq_f64_u64(i); }
+
+    static const char* getName() { return "NEON"; }
+  };
+
+#elif defined(__wasm_simd128__)
+
+  struct FastMathVectorOps
+  {
+    typedef v128_t VD;
+    typedef v128_t VI;
+    static const int numLanes = 2;
+
+    static INLINE VD load(const double* p)     { return wasm_v128_load(p);     }
+    static INLINE void store(double* p, VD x)  { wasm_v128_store(p, x);        }
+
+    static INLINE VD set(double x)             { return wasm_f64x2_splat(x);   }
+    static INLINE VD add(VD a, VD b)           { return wasm_f64x2_add(a, b);  }
+    static INLINE VD sub(VD a, VD b)           { return wasm_f64x2_sub(a, b);  }
+    static INLINE VD mul(VD a, VD b)           { return wasm_f64x2_mul(a, b);  }
+    static INLINE VD div(VD a, VD b)           { return wasm_f64x2_div(a, b);  }
+    static INLINE VD min(VD a, VD b)           { return wasm_f64x2_pmin(a, b); }
+    static INLINE VD max(VD a, VD b)           { return wasm_f64x2_pmax(a, b); }
+
+    static INLINE VI setInt(UINT64 x)          { return wasm_i64x2_splat((long long) x); }
+    static INLINE VI addInt(VI a, VI b)        { return wasm_i64x2_add(a, b);  }
+    static INLINE VI subInt(VI a, VI b)        { return wasm_i64x2_sub(a, b);  }
+    static INLINE VI andInt(VI a, VI b)        { return wasm_v128_and(a, b);   }
+    static INLINE VI orInt(VI a, VI b)         { return wasm_v128_or(a, b);    }
+    static INLINE VI xorInt(VI a, VI b)        { return wasm_v128_xor(a, b);   }
+    static INLINE VI shiftLeft52(VI a)         { return wasm_i64x2_shl(a, 52); }
+    static INLINE VI shiftRight52(VI a)        { return wasm_u64x2_shr(a, 52); }
+    static INLINE VI shiftLeft62(VI a)         { return wasm_i64x2_shl(a, 62); }
+
+    static INLINE VI asInt(VD x)               { return x; }
+    static INLINE VD asDouble(VI i)            { return i; }
+
+    static const char* getName() { return "WASM SIMD"; }
+  };
+
+#else
+
+  struct FastMathVectorOps : public FastMathScalarOps
+  {
+    static const int numLanes = 1;
+
+    static INLINE VD load(const double* p)     { return *p; }
+    static INLINE void store(double* p, VD x)  { *p = x;    }
+
+    static const char* getName() { return "scalar"; }
+  };
+
+#endif
+
+} // end namespace rosic
+
+#endif // rosic_FastMathVectorOps_h
@@ -0,0 +1,2 @@
+#include "rosic_FilterCascade.h"
+using namespace rosic;
@@ -0,0 +1,95 @@
+#ifndef rosic_FilterCascade_h
+#define rosic_FilterCascade_h
+
+// rosic-indcludes:
+#include "rosic_OnePoleFilter.h"
+#include "rosic_BiquadFilter.h"
+
+namespace rosic
+{
+
+  /**
+
+  This class provides fused block processing kernels for series connections of filters. Instead of
+  running each filter over the whole buffer in turn (which would write and re-read the buffer once
+  per filter) or calling the filters' getSample functions one after another per sample (which
+  loads and stores the coefficients and states for every sample), the kernels copy the
+  coefficients and states of all filters in the chain into local variables, run the whole chain
+  per sample in a single pass over the buffer and write the states back at the end. The results
+  are identical to calling the filters' getSample functions in series.
+
+  Open303 uses this for its post-filter chain (allpass -> highpass -> notch) which runs at the
+  base rate after the oversampled section.
+
+  */
+
+  class FilterCascade
+  {
+
+  public:
+
+    //---------------------------------------------------------------------------------------------
+    // audio processing:
+
+    /** Runs the buffer through two one-pole filters in series. The output buffer may be the same
+    as the input buffer. */
+    static INLINE void processBlock(OnePoleFilter& f1, OnePoleFilter& f2, const double* in,
+      double* out, int numSamples);
+
+    /** Runs the buffer through two one-pole filters and a biquad in series. The output buffer may
+    be the same as the input buffer. */
+    static INLINE void processBlock(OnePoleFilter& f1, OnePoleFilter& f2, BiquadFilter& f3,
+      const double* in, double* out, int numSamples);
+
+  };
+
+  //-----------------------------------------------------------------------------------------------
+  // inlined functions:
+
+  INLINE void FilterCascade::processBlock(OnePoleFilter& f1, OnePoleFilter& f2, const double* in,
+    double* out, int numSamples)
+  {
+    double b10 = f1.b0, b11 = f1.b1, a11 = f1.a1, x11 = f1.x1, y11 = f1.y1;
+    double b20 = f2.b0, b21 = f2.b1, a21 = f2.a1, x21 = f2.x1, y21 = f2.y1;
+    for(int n=0; n<numSamples; n++)
+    {
+      double x = in[n];
+      y11      = ANTI_DENORMAL(b10*x   + b11*x11 + a11*y11);
+      x11      = x;
+      y21      = ANTI_DENORMAL(b20*y11 + b21*x21 + a21*y21);
+      x21      = y11;
+      out[n]   = y21;
+    }
+    f1.x1 = x11; f1.y1 = y11;
+    f2.x1 = x21; f2.y1 = y21;
+  }
+
+  INLINE void FilterCascade::processBlock(OnePoleFilter& f1, OnePoleFilter& f2, BiquadFilter& f3,
+    const double* in, double* out, int numSamples)
+  {
+    double b10 = f1.b0, b11 = f1.b1, a11 = f1.a1, x11 = f1.x1, y11 = f1.y1;
+    double b20 = f2.b0, b21 = f2.b1, a21 = f2.a1, x21 = f2.x1, y21 = f2.y1;
+    double b30 = f3.b0, b31 = f3.b1, b32 = f3.b2, a31 = f3.a1, a32 = f3.a2;
+    double x31 = f3.x1, x32 = f3.x2, y31 = f3.y1, y32 = f3.y2;
+    for(int n=0; n<numSamples; n++)
+    {
+      double x = in[n];
+      y11      = ANTI_DENORMAL(b10*x   + b11*x11 + a11*y11);
+      x11      = x;
+      y21      = ANTI_DENORMAL(b20*y11 + b21*x21 + a21*y21);
+      x21      = y11;
+      double y = ANTI_DENORMAL(b30*y21 + b31*x31 + b32*x32 + a31*y31 + a32*y32);
+      x32      = x31;
+      x31      = y21;
+      y32      = y31;
+      y31      = y;
+      out[n]   = y;
+    }
+    f1.x1 = x11; f1.y1 = y11;
+    f2.x1 = x21; f2.y1 = y21;
+    f3.x1 = x31; f3.x2 = x32; f3.y1 = y31; f3.y2 = y32;
+  }
+
+} // end namespace rosic
+
+#endif // rosic_FilterCascade_h
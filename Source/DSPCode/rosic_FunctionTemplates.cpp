@@ -1,12 +1,12 @@
-#include "rosic_FunctionTemplates.h"
-using namespace rosic;
-
-
-
-
-
-
-
-
-
-
+#include "rosic_FunctionTemplates.h"
+using namespace rosic;
+
+
+
+
+
+
+
+
+
+
@@ -0,0 +1,153 @@
+#include "rosic_IncrementalRenderer.h"
+#include "rosic_DenormalGuard.h"
+using namespace rosic;
+
+//-------------------------------------------------------------------------------------------------
+// construction/destruction:
+
+IncrementalRenderer::IncrementalRenderer()
+{
+  edited.resize(AcidPattern::getMaxNumSteps(), false);
+  threshold          = 0.0;
+  numSamplesRendered = 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+// processing:
+
+void IncrementalRenderer::render(int numSamples)
+{
+  initialState.resize(synth.getStateSize());
+  synth.saveState(&initialState[0], (int) initialState.size());
+
+  output.assign(numSamples > 0 ? numSamples : 0, 0.0);
+  checkpoints.clear();
+  for(unsigned int i=0; i<edited.size(); i++)
+    edited[i] = false;
+
+  renderRange(0, (int) output.size(), true, NULL, NULL);
+  numSamplesRendered = (int) output.size();
+}
+
+void IncrementalRenderer::rerender()
+{
+  if( initialState.empty() )
+    return;
+  synth.loadState(&initialState[0], (int) initialState.size());
+  render((int) output.size());
+}
+
+void IncrementalRenderer::stepWasEdited(int step)
+{
+  if( step >= 0 && step < (int) edited.size() )
+    edited[step] = true;
+}
+
+int IncrementalRenderer::update()
+{
+  numSamplesRendered = 0;
+
+  // find the first checkpoint whose step is affected by the edits:
+  int numCheckpoints = (int) checkpoints.size();
+  int j = 0;
+  while( j < numCheckpoints && !isAffected(checkpoints[j].step) )
+    j++;
+
+  while( j < numCheckpoints )
+  {
+    Checkpoint& cp = checkpoints[j];
+    synth.loadState(&cp.state[0], (int) cp.state.size());
+
+    // render the segments from there on until we have reconverged with the cached render:
+    while( true )
+    {
+      int    endSample = getSegmentEnd(j);
+      double maxDiff, peak;
+      renderRange(checkpoints[j].sample, endSample, false, &maxDiff, &peak);
+      numSamplesRendered += endSample - checkpoints[j].sample;
+
+      int step = checkpoints[j].step;
+      j++;
+      if( j >= numCheckpoints )
+        break;
+
+      // at the boundary - compare and update the checkpoint:
+      std::vector<unsigned char>& cachedState = checkpoints[j].state;
+      tmpState.resize(synth.getStateSize());
+      synth.saveState(&tmpState[0], (int) tmpState.size());
+      bool sameState = tmpState == cachedState;
+      if( !sameState )
+        cachedState = tmpState;
+
+      // a step with matching output counts as evidence for reconvergence only when it's well
+      // above the threshold (by 60 dB) - in a (nearly) silent step, a differing oscillator phase
+      // would go unnoticed:
+      bool sameOutput = !isAffected(step) && maxDiff <= threshold && peak >= 1000.0*threshold;
+      if( !isAffected(checkpoints[j].step) && (sameState || sameOutput) )
+        break; // reconverged - the cached render is valid until the next affected step
+    }
+
+    // skip ahead to the next occurrence of an affected step:
+    while( j < numCheckpoints && !isAffected(checkpoints[j].step) )
+      j++;
+  }
+
+  for(unsigned int i=0; i<edited.size(); i++)
+    edited[i] = false;
+  return numSamplesRendered;
+}
+
+void IncrementalRenderer::renderRange(int startSample, int endSample, bool recordCheckpoints,
+                                      double* maxDiff, double* peak)
+{
+  DenormalGuard denormalGuard;
+
+  double d            = 0.0;
+  double p            = 0.0;
+  int    lastBoundary = -2;
+  for(int n=startSample; n<endSample; n++)
+  {
+    // the sequencer stays at a boundary as long as it doesn't advance (for example, when the synth
+    // is idle), so we record only the first sample of such a run:
+    if( recordCheckpoints && synth.sequencer.isAtStepBoundary() )
+    {
+      if( lastBoundary != n-1 )
+      {
+        Checkpoint cp;
+        cp.sample = n;
+        cp.step   = synth.sequencer.getCurrentStep();
+        cp.state.resize(synth.getStateSize());
+        synth.saveState(&cp.state[0], (int) cp.state.size());
+        checkpoints.push_back(cp);
+      }
+      lastBoundary = n;
+    }
+
+    double y  = synth.getSample();
+    d         = rmax(d, fabs(y-output[n]));
+    p         = rmax(p, fabs(y));
+    output[n] = y;
+  }
+
+  if( maxDiff != NULL )
+    *maxDiff = d;
+  if( peak != NULL )
+    *peak = p;
+}
+
+bool IncrementalRenderer::isAffected(int step)
+{
+  AcidPattern* pattern = synth.sequencer.getPattern(synth.sequencer.getActivePattern());
+  int numSteps = pattern->getNumSteps();
+  if( step < 0 || step >= numSteps )
+    return false;
+  return edited[step] || edited[(step+1) % numSteps];
+}
+
+int IncrementalRenderer::getSegmentEnd(int checkpointIndex) const
+{
+  if( checkpointIndex+1 < (int) checkpoints.size() )
+    return checkpoints[checkpointIndex+1].sample;
+  else
+    return (int) output.size();
+}
@@ -0,0 +1,135 @@
+#ifndef rosic_IncrementalRenderer_h
+#define rosic_IncrementalRenderer_h
+
+// rosic-indcludes:
+#include "rosic_Open303.h"
+
+#include <vector>
+
+namespace rosic
+{
+
+  /**
+
+  This is a class for offline rendering of a sequenced Open303 that supports fast previews of
+  pattern edits. During a full render, it stores a checkpoint of the engine's runtime state (as
+  produced by Open303::saveState, typically a few hundred bytes) at every step boundary of the
+  sequencer. When steps of the active pattern are edited afterwards, update() restores the
+  checkpoint before the first affected step and re-renders from there only until the output has
+  reconverged with the cached render - which is detected either by a bitwise identical state at a
+  step boundary or by the output of a complete step deviating by no more than a threshold from the
+  cached one. The rendering then skips ahead to the next occurrence of an edited step (patterns are
+  looped, so an edited step typically recurs many times in a long render).
+
+  Usage: set up the embedded synth (parameters, pattern, sequencer mode), start the sequencer and
+  trigger the note that the sequencer transposes, call render(), then after each edit of the
+  pattern call stepWasEdited() for the edited steps and update(). Changes of the parameters, the
+  tempo or the pattern length affect the whole render, so rerender() should be called then.
+
+  */
+
+  class IncrementalRenderer
+  {
+
+  public:
+
+    //---------------------------------------------------------------------------------------------
+    // construction/destruction:
+
+    /** Constructor. */
+    IncrementalRenderer();
+
+    //---------------------------------------------------------------------------------------------
+    // parameter settings:
+
+    /** Sets the maximum absolute difference between the new and the cached output over a complete
+    (and audible) step for the renders to be considered as reconverged. With zero, only bitwise
+    identical states are accepted - this guarantees that the result is exactly the same as a full
+    re-render, but the decaying filter and envelope states usually keep the renders from
+    reconverging before the end. A small threshold (like 1.e-6) lets edits of accents reconverge
+    after a couple of steps. Edits that change the pitch of a note (keys, gates, slides) will
+    typically not reconverge at all, because the oscillator's phase is never reset in sequencer
+    mode - re-rendering then starts at the first affected step but runs until the end. */
+    void setConvergenceThreshold(double newThreshold) { threshold = newThreshold; }
+
+    //---------------------------------------------------------------------------------------------
+    // inquiry:
+
+    /** Returns the convergence threshold @see setConvergenceThreshold. */
+    double getConvergenceThreshold() const { return threshold; }
+
+    /** Returns the number of rendered samples. */
+    int getNumSamples() const { return (int) output.size(); }
+
+    /** Returns a pointer to the rendered output. */
+    const double* getOutput() const { return output.empty() ? NULL : &output[0]; }
+
+    /** Returns the number of stored checkpoints (i.e. step boundaries in the render). */
+    int getNumCheckpoints() const { return (int) checkpoints.size(); }
+
+    /** Returns the number of samples that were rendered in the last call to update() or
+    render(). */
+    int getNumSamplesRendered() const { return numSamplesRendered; }
+
+    //---------------------------------------------------------------------------------------------
+    // processing:
+
+    /** Renders numSamples samples, starting from the current state of the synth which is stored
+    as initial state for subsequent calls to rerender(). */
+    void render(int numSamples);
+
+    /** Renders everything again from the initial state - to be called after changes that affect
+    the whole render. */
+    void rerender();
+
+    /** Marks a step of the active pattern as edited. */
+    void stepWasEdited(int step);
+
+    /** Re-renders the parts of the output that are affected by the steps that were marked as
+    edited since the last call and clears the marks. Returns the number of re-rendered samples. */
+    int update();
+
+    //---------------------------------------------------------------------------------------------
+    // embedded objects:
+
+    /** The synth that is used for rendering - set up its parameters and its pattern directly. */
+    Open303 synth;
+
+  protected:
+
+    /** Renders output samples from startSample to endSample (exclusive) and optionally reports
+    the maximum absolute difference to the previously stored samples and the peak level of the new
+    ones in that range. When recordCheckpoints is true, a checkpoint is appended at each step
+    boundary. */
+    void renderRange(int startSample, int endSample, bool recordCheckpoints, double* maxDiff,
+      double* peak);
+
+    /** Returns true when the given step of the active pattern is affected by the edits, i.e. when
+    it was edited itself or when its successor was edited (a note's slide depends on the gate of
+    the next note). */
+    bool isAffected(int step);
+
+    /** Returns the sample where the segment that starts at the given checkpoint ends. */
+    int getSegmentEnd(int checkpointIndex) const;
+
+    struct Checkpoint
+    {
+      int                        sample; // the sample at which the step begins
+      int                        step;   // the step that is played there
+      std::vector<unsigned char> state;  // the engine state before rendering that sample
+    };
+
+    std::vector<double>        output;
+    std::vector<Checkpoint>    checkpoints;
+    std::vector<unsigned char> initialState;
+    std::vector<unsigned char> tmpState;
+
+    std::vector<bool>          edited; // flags for the edited steps
+    double                     threshold;
+    int                        numSamplesRendered;
+
+  };
+
+} // end namespace rosic
+
+#endif // rosic_IncrementalRenderer_h
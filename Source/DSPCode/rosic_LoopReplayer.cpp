@@ -0,0 +1,318 @@
+#include "rosic_LoopReplayer.h"
+#include <string.h> // for memcpy, memcmp
+using namespace rosic;
+
+//-------------------------------------------------------------------------------------------------
+// construction/destruction:
+
+LoopReplayer::LoopReplayer()
+{
+  synth              = NULL;
+  tolerance          = 1.e-4;
+  seamTolerance      = 1.e-3; // -60 dB
+  maxLoopLength      = 352800; // 8 seconds at 44.1 kHz
+  checkpointInterval = 1024;
+  seamLength         = 2;
+  stateCapacity      = 0;
+  enabled            = true;
+  recordIndex        = 0;
+  loopIndex          = 1;
+  recording          = false;
+  checkingSeam       = false;
+  replaying          = false;
+  boundaryHandled    = false;
+  seamPosition       = 0;
+  replayPosition     = 0;
+  settingsSize       = -1;
+  numRenderedSamples = 0;
+  numReplayedSamples = 0;
+  for(int r=0; r<2; r++)
+  {
+    recordings[r].startControlSize = 0;
+    recordings[r].numCheckpoints   = 0;
+    recordings[r].length           = 0;
+  }
+}
+
+LoopReplayer::~LoopReplayer()
+{
+
+}
+
+//-------------------------------------------------------------------------------------------------
+// setup:
+
+void LoopReplayer::setSynth(Open303* newSynth)
+{
+  invalidate();
+  synth        = newSynth;
+  settingsSize = -1;
+  allocateBuffers();
+}
+
+void LoopReplayer::setMaxLoopLength(int newMaxLength)
+{
+  invalidate();
+  maxLoopLength = rmax(newMaxLength, 1);
+  allocateBuffers();
+}
+
+void LoopReplayer::setCheckpointInterval(int newInterval)
+{
+  invalidate();
+  checkpointInterval = rmax(newInterval, 1);
+  allocateBuffers();
+}
+
+void LoopReplayer::setSeamLength(int newLength)
+{
+  invalidate();
+  seamLength = rmax(newLength, 1);
+}
+
+//-------------------------------------------------------------------------------------------------
+// audio processing:
+
+void LoopReplayer::processBlock(double* buffer, int numSamples)
+{
+  if( synth == NULL )
+  {
+    for(int n=0; n<numSamples; n++)
+      buffer[n] = 0.0;
+    return;
+  }
+
+  if( haveSettingsChanged() || (replaying && !enabled) )
+    invalidate();
+
+  AcidSequencer& seq = synth->sequencer;
+  int n = 0;
+  while( n < numSamples )
+  {
+    int numLeft = numSamples - n;
+
+    if( replaying )
+    {
+      LoopRecording& loop = recordings[loopIndex];
+      int length = rmin(numLeft, loop.length-replayPosition);
+      memcpy(buffer+n, &loop.audio[replayPosition], length*sizeof(double));
+      replayPosition += length;
+      if( replayPosition >= loop.length )
+        replayPosition = 0;
+      numReplayedSamples += length;
+      n += length;
+      continue;
+    }
+
+    // without a running sequencer, there are no loops (and an idle synth doesn't advance the
+    // sequencer):
+    if( !enabled || synth->isIdle() || seq.getSequencerMode() == AcidSequencer::OFF
+      || !seq.isRunning() )
+    {
+      restartDetection();
+      renderLive(buffer+n, numLeft);
+      return;
+    }
+
+    if( seq.isAtStepBoundary() && seq.getCurrentStep() == 0 && !boundaryHandled )
+    {
+      boundaryHandled = true;
+      handleLoopBoundary();
+      if( replaying )
+        continue;
+    }
+
+    // render up to the next step boundary (which might be a loop boundary), checkpoint or the end
+    // of the seam, whichever comes first:
+    int length = rmin(numLeft, rmax(seq.getNumSamplesToNextStep(), 1));
+    if( recording )
+    {
+      LoopRecording& rec = recordings[recordIndex];
+      int c = rec.length / checkpointInterval;
+      if( rec.length == c*checkpointInterval && rec.numCheckpoints == c )
+        takeCheckpoint(rec);
+      length = rmin(length, (c+1)*checkpointInterval - rec.length);
+      if( rec.length + length > maxLoopLength )
+        recording = false; // the loop is too long to be recorded
+    }
+    if( checkingSeam )
+      length = rmin(length, seamLength-seamPosition);
+
+    renderLive(buffer+n, length);
+    boundaryHandled = false;
+
+    if( recording )
+    {
+      LoopRecording& rec = recordings[recordIndex];
+      memcpy(&rec.audio[rec.length], buffer+n, length*sizeof(double));
+      rec.length += length;
+    }
+
+    if( checkingSeam )
+    {
+      const double* loopAudio = &recordings[loopIndex].audio[seamPosition];
+      for(int i=0; i<length; i++)
+      {
+        if( !(fabs(buffer[n+i]-loopAudio[i]) <= seamTolerance) )
+          checkingSeam = false;
+      }
+      seamPosition += length;
+      if( checkingSeam && seamPosition == seamLength )
+      {
+        // the live rendering has continued like the recorded loop, so we take over from here:
+        checkingSeam   = false;
+        recording      = false;
+        replaying      = true;
+        replayPosition = seamLength;
+      }
+    }
+
+    n += length;
+  }
+}
+
+//-------------------------------------------------------------------------------------------------
+// event handling:
+
+void LoopReplayer::noteOn(int noteNumber, int velocity)
+{
+  invalidate();
+  if( synth != NULL )
+    synth->noteOn(noteNumber, velocity);
+}
+
+void LoopReplayer::allNotesOff()
+{
+  invalidate();
+  if( synth != NULL )
+    synth->allNotesOff();
+}
+
+void LoopReplayer::setPitchBend(double newPitchBend)
+{
+  invalidate();
+  if( synth != NULL )
+    synth->setPitchBend(newPitchBend);
+}
+
+//-------------------------------------------------------------------------------------------------
+// others:
+
+void LoopReplayer::invalidate()
+{
+  if( replaying )
+    leaveReplay();
+  restartDetection();
+}
+
+//-------------------------------------------------------------------------------------------------
+// internal functions:
+
+void LoopReplayer::allocateBuffers()
+{
+  stateCapacity         = synth != NULL ? synth->getMaxStateSize() : 0;
+  int maxNumCheckpoints = maxLoopLength/checkpointInterval + 1;
+  for(int r=0; r<2; r++)
+  {
+    LoopRecording& rec = recordings[r];
+    rec.audio.resize(maxLoopLength);
+    rec.checkpoints.resize(maxNumCheckpoints*stateCapacity);
+    rec.checkpointSizes.resize(maxNumCheckpoints);
+    rec.startControlState.resize(stateCapacity);
+    rec.startControlSize = 0;
+    rec.numCheckpoints   = 0;
+    rec.length           = 0;
+  }
+  controlState.resize(stateCapacity);
+  catchUpBuffer.resize(checkpointInterval);
+}
+
+bool LoopReplayer::haveSettingsChanged()
+{
+  StateWriter writer(newSettings, maxSettingsSize);
+  synth->writeSettings(writer);
+  int size = writer.getNumBytesWritten();
+  if( writer.hasOverflowed() )
+  {
+    settingsSize = -1; // can't be compared, so we consider them changed in every call
+    return true;
+  }
+  if( size == settingsSize && memcmp(newSettings, settings, size) == 0 )
+    return false;
+  memcpy(settings, newSettings, size);
+  settingsSize = size;
+  return true;
+}
+
+void LoopReplayer::renderLive(double* buffer, int numSamples)
+{
+  synth->processBlock(buffer, numSamples);
+  numRenderedSamples += numSamples;
+}
+
+void LoopReplayer::handleLoopBoundary()
+{
+  LoopRecording& rec = recordings[recordIndex];
+  checkingSeam = false;
+
+  if( recording && rec.length > seamLength )
+  {
+    // compare the control state at the end of the loop that was recorded with the one at its
+    // start:
+    StateWriter writer(&controlState[0], stateCapacity);
+    writer.setReference(&rec.startControlState[0], rec.startControlSize);
+    synth->writeControlState(writer);
+    if( !writer.hasOverflowed() && writer.getNumBytesWritten() == rec.startControlSize
+      && writer.getMaxDeviation() <= tolerance )
+    {
+      loopIndex    = recordIndex;
+      recordIndex  = 1-recordIndex;
+      checkingSeam = true;
+      seamPosition = 0;
+    }
+  }
+
+  startRecording();
+}
+
+void LoopReplayer::startRecording()
+{
+  LoopRecording& rec = recordings[recordIndex];
+  rec.length         = 0;
+  rec.numCheckpoints = 0;
+
+  StateWriter writer(&rec.startControlState[0], stateCapacity);
+  synth->writeControlState(writer);
+  rec.startControlSize = writer.getNumBytesWritten();
+  recording            = !writer.hasOverflowed();
+}
+
+void LoopReplayer::takeCheckpoint(LoopRecording& rec)
+{
+  int c    = rec.numCheckpoints;
+  int size = synth->saveState(&rec.checkpoints[c*stateCapacity], stateCapacity);
+  if( size == 0 )
+  {
+    recording = false;
+    return;
+  }
+  rec.checkpointSizes[c] = size;
+  rec.numCheckpoints++;
+}
+
+void LoopReplayer::leaveReplay()
+{
+  // the checkpoints cover the whole loop because the recording went on up to its end:
+  LoopRecording& loop = recordings[loopIndex];
+  int c = rmin(replayPosition/checkpointInterval, loop.numCheckpoints-1);
+  if( synth->loadState(&loop.checkpoints[c*stateCapacity], loop.checkpointSizes[c]) )
+    renderLive(&catchUpBuffer[0], replayPosition - c*checkpointInterval);
+  replaying = false;
+}
+
+void LoopReplayer::restartDetection()
+{
+  recording       = false;
+  checkingSeam    = false;
+  boundaryHandled = false;
+}
@@ -0,0 +1,205 @@
+#ifndef rosic_LoopReplayer_h
+#define rosic_LoopReplayer_h
+
+// rosic-indcludes:
+#include "rosic_Open303.h"
+
+#include <vector>
+
+namespace rosic
+{
+
+  /**
+
+  This is a class for rendering an Open303 that plays a static pattern in its sequencer. After a
+  few loops of such a pattern, the envelopes, slew limiter and RCs have settled and every loop is
+  the same as the one before - so instead of rendering it again and again, we may just as well
+  replay the audio of one loop.
+
+  The replayer renders the synth live and records the audio of each pattern loop together with
+  checkpoints of the synth's state (every checkpointInterval samples). At each loop boundary, it
+  compares the synth's control state (@see Open303::writeControlState) with the one at the start
+  of the loop just recorded. When they agree within the tolerance, the loop is a candidate. The
+  audio rate states (oscillator phase and filter histories) are not compared because they don't
+  repeat: the oscillator runs freely through the notes, so its phase at the loop boundary is
+  different in every loop. A different phase just shifts the waveform within the notes, which is
+  inaudible - except at the seam, where the end of the loop would be followed by its own
+  beginning. So the candidate is only replayed when the first few samples of the next loop
+  (rendered live) agree with the beginning of the recorded loop within the seam tolerance, i.e.
+  when the recorded loop joins its own end without a jump or kink. That is the case when the seam
+  falls on silence or on a note onset that starts from silence (after that, the two differ by the
+  phase of the new note, which is fine).
+
+  While replaying, the synth is not rendered at all. The settings (@see Open303::writeSettings)
+  are compared with those of the recorded loop in each processBlock call and any change (a
+  parameter, the pattern, the tempo, etc.) ends the replay: the synth's state is restored from the
+  closest checkpoint before the current position in the loop and caught up to it by rendering
+  silently, so the live rendering continues seamlessly from the replayed audio. Events must be sent
+  through the replayer's noteOn, etc. functions (rather than to the synth directly) because they
+  have to be applied to a synth that is caught up. For the same reason, invalidate() must be
+  called before anything else is done with the synth's state.
+
+  */
+
+  class LoopReplayer
+  {
+
+  public:
+
+    //---------------------------------------------------------------------------------------------
+    // construction/destruction:
+
+    /** Constructor. */
+    LoopReplayer();
+
+    /** Destructor. */
+    ~LoopReplayer();
+
+    //---------------------------------------------------------------------------------------------
+    // setup:
+
+    /** Sets the synth to be rendered (the replayer does not take ownership). This allocates the
+    buffers for the recordings, so it should not be called on the audio thread. */
+    void setSynth(Open303* newSynth);
+
+    /** Sets the maximum length of a pattern loop that can be replayed in samples - longer loops
+    are always rendered live. This allocates the buffers for the recordings. */
+    void setMaxLoopLength(int newMaxLength);
+
+    /** Sets the distance between the checkpoints in samples. This determines the memory that is
+    needed for the checkpoints and the number of samples that have to be rendered when a replay
+    ends (up to checkpointInterval-1). This allocates the buffers for the recordings. */
+    void setCheckpointInterval(int newInterval);
+
+    /** Sets the tolerance for the comparison of the control states (the absolute difference for
+    values up to one and the relative difference for larger ones). */
+    void setTolerance(double newTolerance) { tolerance = newTolerance; }
+
+    /** Sets the tolerance for the comparison at the seam (the absolute difference of the output
+    samples). */
+    void setSeamTolerance(double newTolerance) { seamTolerance = newTolerance; }
+
+    /** Sets the number of samples after a loop boundary that are compared with the beginning of
+    the recorded loop before the replay starts - two samples catch jumps and kinks, more samples
+    would catch the (harmless) phase difference of a note that starts at the loop boundary. */
+    void setSeamLength(int newLength);
+
+    /** Switches the replay on or off - when it's off, the synth is always rendered live. */
+    void setEnabled(bool shouldBeEnabled) { enabled = shouldBeEnabled; }
+
+    //---------------------------------------------------------------------------------------------
+    // inquiry:
+
+    /** Returns true when the audio is currently replayed from a recorded loop. */
+    bool isReplaying() const { return replaying; }
+
+    /** Returns the length of the loop that is (or was last) replayed in samples. */
+    int getLoopLength() const { return recordings[loopIndex].length; }
+
+    /** Returns the number of samples that have been rendered by the synth (including the catch up
+    at the end of the replays) since construction. */
+    UINT64 getNumRenderedSamples() const { return numRenderedSamples; }
+
+    /** Returns the number of samples that have been replayed since construction. */
+    UINT64 getNumReplayedSamples() const { return numReplayedSamples; }
+
+    //---------------------------------------------------------------------------------------------
+    // audio processing:
+
+    /** Renders a block of output samples, either live or by replaying a recorded loop. Events
+    (noteOn, etc.) are supposed to be sent in between the calls. */
+    void processBlock(double* buffer, int numSamples);
+
+    //---------------------------------------------------------------------------------------------
+    // event handling:
+
+    /** Ends a replay and passes the note-on to the synth. */
+    void noteOn(int noteNumber, int velocity);
+
+    /** Ends a replay and turns all notes of the synth off. */
+    void allNotesOff();
+
+    /** Ends a replay and passes the pitchbend (in semitones) to the synth. */
+    void setPitchBend(double newPitchBend);
+
+    //---------------------------------------------------------------------------------------------
+    // others:
+
+    /** Ends a replay (restoring the synth's state for the current position in the loop) and starts
+    over with the detection at the next loop boundary. */
+    void invalidate();
+
+    //=============================================================================================
+
+  protected:
+
+    /** The audio of a pattern loop together with the synth's states during the loop. */
+    struct LoopRecording
+    {
+      std::vector<double>        audio;
+      std::vector<unsigned char> checkpoints;       // stateCapacity bytes for each checkpoint
+      std::vector<int>           checkpointSizes;
+      std::vector<unsigned char> startControlState; // the control state at the start of the loop
+      int                        startControlSize;
+      int                        numCheckpoints;
+      int                        length;
+    };
+
+    /** (Re)allocates the buffers of the recordings and starts over with the detection. */
+    void allocateBuffers();
+
+    /** Returns true when the settings of the synth differ from the ones in the previous call (and
+    stores the new ones). */
+    bool haveSettingsChanged();
+
+    /** Renders the synth into the buffer. */
+    void renderLive(double* buffer, int numSamples);
+
+    /** Called at the loop boundaries to check whether the loop that was recorded is a candidate
+    for being replayed and to start recording the next loop. */
+    void handleLoopBoundary();
+
+    /** Starts recording a new loop. */
+    void startRecording();
+
+    /** Stores the synth's state as next checkpoint of the recording. */
+    void takeCheckpoint(LoopRecording& recording);
+
+    /** Ends the replay and restores the state of the synth for the current position. */
+    void leaveReplay();
+
+    /** Forgets the current recording, such that the detection starts over. */
+    void restartDetection();
+
+    static const int maxSettingsSize = 1024;
+
+    Open303* synth;
+    double   tolerance, seamTolerance;
+    int      maxLoopLength, checkpointInterval, seamLength;
+    int      stateCapacity;     // bytes reserved for each checkpoint (the maximum state size)
+    bool     enabled;
+
+    LoopRecording recordings[2];
+    int           recordIndex;  // the recording that is currently written
+    int           loopIndex;    // the recording that is (about to be) replayed
+    bool          recording, checkingSeam, replaying, boundaryHandled;
+    int           seamPosition, replayPosition;
+
+    unsigned char settings[maxSettingsSize], newSettings[maxSettingsSize];
+    int           settingsSize;
+
+    std::vector<unsigned char> controlState;   // scratch space for the control state
+    std::vector<double>        catchUpBuffer;  // the output of the catch up is discarded here
+
+    UINT64 numRenderedSamples, numReplayedSamples;
+
+  private:
+
+    LoopReplayer(const LoopReplayer&);            // non-copyable
+    LoopReplayer& operator=(const LoopReplayer&);
+
+  };
+
+} // end namespace rosic
+
+#endif // rosic_LoopReplayer_h
@@ -0,0 +1,103 @@
+#include "rosic_MappedFile.h"
+
+#ifdef _WIN32
+  #include <windows.h>
+#else
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <fcntl.h>
+  #include <unistd.h>
+#endif
+
+using namespace rosic;
+
+//-------------------------------------------------------------------------------------------------
+// construction/destruction:
+
+MappedFile::MappedFile()
+{
+  data = NULL;
+  size = 0;
+#ifdef _WIN32
+  fileHandle    = NULL;
+  mappingHandle = NULL;
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+  close();
+}
+
+//-------------------------------------------------------------------------------------------------
+// setup:
+
+bool MappedFile::open(const char* path)
+{
+  close();
+
+#ifdef _WIN32
+  HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL, NULL);
+  if( file == INVALID_HANDLE_VALUE )
+    return false;
+  LARGE_INTEGER fileSize;
+  if( !GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0 )
+  {
+    CloseHandle(file);
+    return false;
+  }
+  HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+  if( mapping == NULL )
+  {
+    CloseHandle(file);
+    return false;
+  }
+  void* p = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  if( p == NULL )
+  {
+    CloseHandle(mapping);
+    CloseHandle(file);
+    return false;
+  }
+  fileHandle    = file;
+  mappingHandle = mapping;
+  data          = (const unsigned char*) p;
+  size          = (UINT64) fileSize.QuadPart;
+#else
+  int fd = ::open(path, O_RDONLY);
+  if( fd < 0 )
+    return false;
+  struct stat st;
+  if( fstat(fd, &st) != 0 || st.st_size == 0 )
+  {
+    ::close(fd);
+    return false;
+  }
+  void* p = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd); // the mapping stays valid without the descriptor
+  if( p == MAP_FAILED )
+    return false;
+  data = (const unsigned char*) p;
+  size = (UINT64) st.st_size;
+#endif
+
+  return true;
+}
+
+void MappedFile::close()
+{
+  if( data == NULL )
+    return;
+#ifdef _WIN32
+  UnmapViewOfFile(data);
+  CloseHandle((HANDLE) mappingHandle);
+  CloseHandle((HANDLE) fileHandle);
+  fileHandle    = NULL;
+  mappingHandle = NULL;
+#else
+  munmap((void*) data, (size_t) size);
+#endif
+  data = NULL;
+  size = 0;
+}
@@ -0,0 +1,79 @@
+#ifndef rosic_MappedFile_h
+#define rosic_MappedFile_h
+
+// rosic-indcludes:
+#include "GlobalDefinitions.h"
+
+#include <stddef.h>
+
+namespace rosic
+{
+
+  /**
+
+  This is a class for read-only memory mappings of complete files (via mmap on POSIX systems and
+  MapViewOfFile on Windows). Opening a file is O(1) regardless of its size - the operating system
+  reads the pages in when they are accessed for the first time, so the memory use is proportional
+  to the parts of the file that are actually touched.
+
+  */
+
+  class MappedFile
+  {
+
+  public:
+
+    //---------------------------------------------------------------------------------------------
+    // construction/destruction:
+
+    /** Constructor. */
+    MappedFile();
+
+    /** Destructor. Closes the mapping, if any. */
+    ~MappedFile();
+
+    //---------------------------------------------------------------------------------------------
+    // setup:
+
+    /** Maps the file with the given path into memory (closing a previous mapping). Returns false
+    when the file can't be opened, is empty or can't be mapped. */
+    bool open(const char* path);
+
+    /** Closes the mapping. */
+    void close();
+
+    //---------------------------------------------------------------------------------------------
+    // inquiry:
+
+    /** Returns true when a file is mapped. */
+    bool isOpen() const { return data != NULL; }
+
+    /** Returns a pointer to the mapped contents (NULL when no file is mapped). */
+    const unsigned char* getData() const { return data; }
+
+    /** Returns the size of the mapped file in bytes. */
+    UINT64 getSize() const { return size; }
+
+    //=============================================================================================
+
+  protected:
+
+    const unsigned char* data;
+    UINT64               size;
+
+#ifdef _WIN32
+    void* fileHandle;    // HANDLE of the file
+    void* mappingHandle; // HANDLE of the mapping object
+#endif
+
+  private:
+
+    // mappings are not supposed to be copied:
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+
+  };
+
+} // end namespace rosic
+
+#endif // rosic_MappedFile_h
@@ -0,0 +1,391 @@
+#include "rosic_MidiFileRenderer.h"
+#include "rosic_DenormalGuard.h"
+using namespace rosic;
+
+//-------------------------------------------------------------------------------------------------
+// construction/destruction:
+
+MidiFileRenderer::MidiFileRenderer()
+{
+  file            = NULL;
+  synth           = NULL;
+  format          = 0;
+  division        = 96;
+  secondsPerTick  = 0.5 / 96;
+  tempoTick       = 0;
+  tempoSeconds    = 0.0;
+  pitchBendRange  = 12.0;
+  position        = 0;
+  nextEventTime   = 0.0;
+  nextTrack       = -1;
+}
+
+MidiFileRenderer::~MidiFileRenderer()
+{
+  close();
+}
+
+//-------------------------------------------------------------------------------------------------
+// setup:
+
+static UINT32 readBigEndian(const unsigned char* p, int numBytes)
+{
+  UINT32 x = 0;
+  for(int i=0; i<numBytes; i++)
+    x = (x << 8) | p[i];
+  return x;
+}
+
+bool MidiFileRenderer::open(const char* path)
+{
+  close();
+  file = fopen(path, "rb");
+  if( file == NULL )
+    return false;
+
+  // header chunk:
+  unsigned char header[14];
+  if(    fread(header, 1, 14, file) != 14 || readBigEndian(header, 4) != 0x4D546864 // 'MThd'
+      || readBigEndian(header+4, 4) < 6 )
+  {
+    close();
+    return false;
+  }
+  format            = (int) readBigEndian(header+8,  2);
+  int numTracks     = (int) readBigEndian(header+10, 2);
+  division          = (int) readBigEndian(header+12, 2);
+  long chunkPos     = 8 + (long) readBigEndian(header+4, 4);
+  if( format > 1 || numTracks == 0 || (division & 0x7FFF) == 0 )
+  {
+    close();
+    return false;
+  }
+
+  // locate the track chunks (skipping unknown chunks):
+  unsigned char chunkHeader[8];
+  while( (int) tracks.size() < numTracks )
+  {
+    if( fseek(file, chunkPos, SEEK_SET) != 0 || fread(chunkHeader, 1, 8, file) != 8 )
+      break;
+    long length = (long) readBigEndian(chunkHeader+4, 4);
+    if( readBigEndian(chunkHeader, 4) == 0x4D54726B ) // 'MTrk'
+    {
+      Track track;
+      track.start = chunkPos + 8;
+      track.end   = track.start + length;
+      tracks.push_back(track);
+    }
+    chunkPos += 8 + length;
+  }
+  if( tracks.empty() )
+  {
+    close();
+    return false;
+  }
+
+  rewind();
+  return true;
+}
+
+void MidiFileRenderer::close()
+{
+  if( file != NULL )
+    fclose(file);
+  file      = NULL;
+  nextTrack = -1;
+  tracks.clear();
+}
+
+void MidiFileRenderer::rewind()
+{
+  if( division & 0x8000 )
+  {
+    // SMPTE time: frames per second (as negative number) in the high byte, ticks per frame in
+    // the low byte - 29 stands for 29.97 frames per second:
+    int    framesPerSecond = -(signed char) (division >> 8);
+    double frameRate       = framesPerSecond == 29 ? 29.97 : (double) framesPerSecond;
+    secondsPerTick         = 1.0 / (frameRate * (division & 0xFF));
+  }
+  else
+    secondsPerTick = 0.5 / division; // 120 BPM until the first tempo event
+  tempoTick    = 0;
+  tempoSeconds = 0.0;
+  position     = 0;
+
+  for(unsigned int t=0; t<tracks.size(); t++)
+  {
+    Track& track        = tracks[t];
+    track.filePos       = track.start;
+    track.bufferPos     = 0;
+    track.bufferLength  = 0;
+    track.nextTick      = 0;
+    track.runningStatus = 0;
+    track.finished      = false;
+    readDeltaTime(track);
+  }
+  findNextEvent();
+}
+
+//-------------------------------------------------------------------------------------------------
+// inquiry:
+
+double MidiFileRenderer::getTempo() const
+{
+  if( division & 0x8000 )
+    return 0.0; // SMPTE time has no tempo
+  return 60.0 / (secondsPerTick * division);
+}
+
+//-------------------------------------------------------------------------------------------------
+// audio processing:
+
+void MidiFileRenderer::render(double* buffer, int numSamples)
+{
+  DenormalGuard denormalGuard;
+
+  if( file == NULL || synth == NULL )
+  {
+    for(int n=0; n<numSamples; n++)
+      buffer[n] = 0.0;
+    return;
+  }
+
+  double sampleRate      = synth->getSampleRate();
+  INT64  nextEventSample = 0;
+
+  int n = 0;
+  while( n < numSamples )
+  {
+    // apply all events that are due:
+    while( nextTrack >= 0 )
+    {
+      nextEventSample = (INT64) floor(nextEventTime * sampleRate + 0.5);
+      if( nextEventSample > position )
+        break;
+      handleEvent(tracks[nextTrack]);
+      findNextEvent();
+    }
+
+    // render up to the event horizon:
+    INT64 horizon = numSamples - n;
+    if( nextTrack >= 0 )
+      horizon = rmin(horizon, nextEventSample - position);
+    synth->processBlock(&buffer[n], (int) horizon);
+    n        += (int) horizon;
+    position += horizon;
+  }
+}
+
+//-------------------------------------------------------------------------------------------------
+// internal functions:
+
+bool MidiFileRenderer::readByte(Track& track, unsigned char* byte)
+{
+  if( track.bufferPos >= track.bufferLength )
+  {
+    long numBytes = rmin(track.end - track.filePos, (long) sizeof(track.buffer));
+    if( numBytes <= 0 || fseek(file, track.filePos, SEEK_SET) != 0 )
+      return false;
+    track.bufferLength = (int) fread(track.buffer, 1, (size_t) numBytes, file);
+    track.bufferPos    = 0;
+    track.filePos     += track.bufferLength;
+    if( track.bufferLength <= 0 )
+      return false;
+  }
+  *byte = track.buffer[track.bufferPos++];
+  return true;
+}
+
+bool MidiFileRenderer::readVariableLength(Track& track, UINT32* value)
+{
+  *value = 0;
+  unsigned char byte;
+  for(int i=0; i<4; i++)
+  {
+    if( !readByte(track, &byte) )
+      return false;
+    *value = (*value << 7) | (byte & 0x7F);
+    if( (byte & 0x80) == 0 )
+      return true;
+  }
+  return false;
+}
+
+bool MidiFileRenderer::skipBytes(Track& track, UINT32 numBytes)
+{
+  // skip the buffered bytes first, the remaining ones by moving the file position:
+  UINT32 numBuffered = (UINT32) (track.bufferLength - track.bufferPos);
+  if( numBytes <= numBuffered )
+  {
+    track.bufferPos += (int) numBytes;
+    return true;
+  }
+  numBytes         -= numBuffered;
+  track.bufferPos   = track.bufferLength;
+  if( (long) numBytes > track.end - track.filePos )
+    return false;
+  track.filePos    += (long) numBytes;
+  return true;
+}
+
+void MidiFileRenderer::readDeltaTime(Track& track)
+{
+  UINT32 delta;
+  if( track.finished || !readVariableLength(track, &delta) )
+    track.finished = true;
+  else
+    track.nextTick += delta;
+}
+
+void MidiFileRenderer::handleEvent(Track& track)
+{
+  unsigned char status, data1 = 0, data2 = 0;
+  if( !readByte(track, &status) )
+  {
+    track.finished = true;
+    return;
+  }
+
+  if( status == 0xFF ) // meta event
+  {
+    unsigned char type;
+    UINT32        length;
+    if( !readByte(track, &type) || !readVariableLength(track, &length) )
+    {
+      track.finished = true;
+      return;
+    }
+    if( type == 0x2F ) // end of track
+    {
+      track.finished = true;
+      return;
+    }
+    if( type == 0x51 && length == 3 ) // tempo in microseconds per quarter note
+    {
+      unsigned char b[3];
+      for(int i=0; i<3; i++)
+      {
+        if( !readByte(track, &b[i]) )
+        {
+          track.finished = true;
+          return;
+        }
+      }
+      if( !(division & 0x8000) )
+      {
+        tempoSeconds   = tickToSeconds(track.nextTick);
+        tempoTick      = track.nextTick;
+        secondsPerTick = 1.e-6 * readBigEndian(b, 3) / division;
+      }
+    }
+    else if( !skipBytes(track, length) )
+    {
+      track.finished = true;
+      return;
+    }
+  }
+  else if( status == 0xF0 || status == 0xF7 ) // system exclusive
+  {
+    UINT32 length;
+    if( !readVariableLength(track, &length) || !skipBytes(track, length) )
+    {
+      track.finished = true;
+      return;
+    }
+  }
+  else // channel message
+  {
+    if( status < 0x80 )
+    {
+      // running status - the byte was the first data byte:
+      if( track.runningStatus == 0 )
+      {
+        track.finished = true;
+        return;
+      }
+      data1  = status;
+      status = track.runningStatus;
+    }
+    else if( !readByte(track, &data1) )
+    {
+      track.finished = true;
+      return;
+    }
+    track.runningStatus = status;
+
+    // program change and channel pressure have only one data byte:
+    unsigned char type = status & 0xF0;
+    if( type != 0xC0 && type != 0xD0 && !readByte(track, &data2) )
+    {
+      track.finished = true;
+      return;
+    }
+    handleChannelMessage(type, data1 & 0x7F, data2 & 0x7F);
+  }
+
+  readDeltaTime(track);
+}
+
+void MidiFileRenderer::handleChannelMessage(unsigned char status, unsigned char data1,
+                                            unsigned char data2)
+{
+  switch( status )
+  {
+  case 0x80:
+    {
+      synth->noteOn(data1, 0);
+    }
+    break;
+  case 0x90:
+    {
+      synth->noteOn(data1, data2); // zero velocity means note-off
+    }
+    break;
+  case 0xB0:
+    {
+      double value = data2 / 127.0;
+      switch( data1 )
+      {
+      case   7: synth->setVolume(   linToLin(value, 0.0, 1.0, -60.0,    0.0)); break;
+      case  74: synth->setCutoff(   linToExp(value, 0.0, 1.0, 314.0, 2394.0)); break;
+      case  71: synth->setResonance(linToLin(value, 0.0, 1.0,   0.0,  100.0)); break;
+      case  81: synth->setEnvMod(   linToLin(value, 0.0, 1.0,   0.0,  100.0)); break;
+      case 123:
+        {
+          for(int i=0; i<=127; i++)
+            synth->noteOn(i, 0);
+        }
+        break;
+      }
+    }
+    break;
+  case 0xE0:
+    {
+      // 14 bit value with the least significant 7 bits in the first data byte:
+      double bend = (double) ((data2 << 7) | data1) - 8192;
+      if( bend == -8192 )
+        bend = -8191; // for symmetry
+      synth->setPitchBend(bend/8191 * pitchBendRange);
+    }
+    break;
+  }
+}
+
+void MidiFileRenderer::findNextEvent()
+{
+  // the first track wins on equal ticks, so tempo changes in the conductor track of format 1
+  // files are applied before the notes at the same time:
+  nextTrack = -1;
+  for(unsigned int t=0; t<tracks.size(); t++)
+  {
+    if( !tracks[t].finished && (nextTrack < 0 || tracks[t].nextTick < tracks[nextTrack].nextTick) )
+      nextTrack = (int) t;
+  }
+  if( nextTrack >= 0 )
+    nextEventTime = tickToSeconds(tracks[nextTrack].nextTick);
+}
+
+double MidiFileRenderer::tickToSeconds(UINT64 tick) const
+{
+  return tempoSeconds + (double) (tick - tempoTick) * secondsPerTick;
+}
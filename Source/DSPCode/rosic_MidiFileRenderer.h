@@ -0,0 +1,158 @@
+#ifndef rosic_MidiFileRenderer_h
+#define rosic_MidiFileRenderer_h
+
+// rosic-indcludes:
+#include "rosic_Open303.h"
+
+#include <stdio.h>
+#include <vector>
+
+namespace rosic
+{
+
+  /**
+
+  This is a class for rendering Standard MIDI Files (format 0 and 1) offline through an Open303.
+  The file is streamed: each track has a small read buffer and a file position, the tracks are
+  merged in tick order on the fly and the tick times are converted to sample positions with the
+  tempo map that is built up while reading (tempo events may be in any track). So the memory use
+  does not depend on the length of the file, and rendering runs as fast as the synth allows.
+
+  The events are handled like in Open303VST::handleEvent: all channels are mapped to channel 1,
+  note-on/off go to noteOn, controller 123 turns all notes off, controllers 7, 74, 71 and 81 are
+  mapped to volume, cutoff, resonance and envelope modulation (with the ranges of the plugin's
+  parameters) and pitch bend is mapped to a range of +-12 semitones by default. Other events are
+  skipped. A track that turns out to be malformed while streaming is just not read any further.
+
+  */
+
+  class MidiFileRenderer
+  {
+
+  public:
+
+    //---------------------------------------------------------------------------------------------
+    // construction/destruction:
+
+    /** Constructor. */
+    MidiFileRenderer();
+
+    /** Destructor. */
+    ~MidiFileRenderer();
+
+    //---------------------------------------------------------------------------------------------
+    // setup:
+
+    /** Sets the synth to be played. The renderer does not take ownership. The synth's sample rate
+    is used for converting the event times into samples. */
+    void setSynth(Open303* newSynth) { synth = newSynth; }
+
+    /** Opens the MIDI file with the given path (closing a previously opened one) and moves to its
+    start. Returns false when the file can't be opened or has no valid header. */
+    bool open(const char* path);
+
+    /** Closes the file. */
+    void close();
+
+    /** Moves back to the start of the file. */
+    void rewind();
+
+    /** Sets the range of the pitch wheel in semitones. */
+    void setPitchBendRange(double newRange) { pitchBendRange = newRange; }
+
+    //---------------------------------------------------------------------------------------------
+    // inquiry:
+
+    /** Returns true when a file is open. */
+    bool isOpen() const { return file != NULL; }
+
+    /** Returns the format of the file (0 or 1). */
+    int getFormat() const { return format; }
+
+    /** Returns the number of tracks in the file. */
+    int getNumTracks() const { return (int) tracks.size(); }
+
+    /** Returns the current playback position in samples. */
+    INT64 getPosition() const { return position; }
+
+    /** Returns the current tempo in beats per minute. */
+    double getTempo() const;
+
+    /** Returns true when all events of the file have been rendered. */
+    bool isFinished() const { return nextTrack < 0; }
+
+    //---------------------------------------------------------------------------------------------
+    // audio processing:
+
+    /** Renders the given number of samples into the buffer. The synth is rendered in chunks up to
+    the next event. After the end of the file, the synth keeps running, so the release tail of the
+    last note is rendered. When there's no file or synth, the buffer is filled with zeros. */
+    void render(double* buffer, int numSamples);
+
+    //=============================================================================================
+
+  protected:
+
+    /** Read state of one track chunk. */
+    struct Track
+    {
+      long          start, end;    // file offsets of the chunk's data
+      long          filePos;       // file offset of the byte after the buffered ones
+      unsigned char buffer[256];
+      int           bufferPos, bufferLength;
+      UINT64        nextTick;      // absolute tick of the next event
+      unsigned char runningStatus;
+      bool          finished;
+    };
+
+    /** Reads the next byte of a track into the passed variable. Returns false at the end of the
+    track's chunk. */
+    bool readByte(Track& track, unsigned char* byte);
+
+    /** Reads a variable length quantity. Returns false when the track's chunk ends or the number
+    is too long. */
+    bool readVariableLength(Track& track, UINT32* value);
+
+    /** Skips the given number of bytes of a track. */
+    bool skipBytes(Track& track, UINT32 numBytes);
+
+    /** Reads the delta time of the next event of a track (marking the track as finished at its
+    end). */
+    void readDeltaTime(Track& track);
+
+    /** Reads the next event of a track and applies it to the synth. */
+    void handleEvent(Track& track);
+
+    /** Applies a channel message (with channel bits already removed) to the synth. */
+    void handleChannelMessage(unsigned char status, unsigned char data1, unsigned char data2);
+
+    /** Finds the track with the earliest next event and computes its time. */
+    void findNextEvent();
+
+    /** Converts an absolute tick into seconds with the tempo map read so far. */
+    double tickToSeconds(UINT64 tick) const;
+
+    FILE*              file;
+    std::vector<Track> tracks;
+    Open303*           synth;
+    int                format;
+    int                division;        // ticks per quarter note (or per SMPTE frame)
+    double             secondsPerTick;  // for the current tempo
+    UINT64             tempoTick;       // tick of the last tempo change
+    double             tempoSeconds;    // time of the last tempo change
+    double             pitchBendRange;
+    INT64              position;        // playback position in samples
+    double             nextEventTime;   // time of the next event in seconds
+    int                nextTrack;       // track with the next event or -1 at the end
+
+  private:
+
+    // file handles are not supposed to be copied:
+    MidiFileRenderer(const MidiFileRenderer&);
+    MidiFileRenderer& operator=(const MidiFileRenderer&);
+
+  };
+
+} // end namespace rosic
+
+#endif // rosic_MidiFileRenderer_h
@@ -1,227 +1,316 @@
-#ifndef rosic_MipMappedWaveTable_h
-#define rosic_MipMappedWaveTable_h
-
-// rosic-indcludes:
-#include "rosic_FunctionTemplates.h"
-#include "rosic_FourierTransformerRadix2.h"
-
-namespace rosic
-{
-
-  /**
-
-  This is a class for generating and storing a single-cycle-waveform in a lookup-table and 
-  retrieving values form it at arbitrary positions by means of interpolation.
-
-  */
-
-  class MipMappedWaveTable
-  {
-
-    // Oscillator and SuperOscillator classes need access to certain protected member-variables 
-    // (namely the tableLength and related quantities), so we declare them as friend-classes:
-    friend class Oscillator;
-    friend class BlendOscillator;
-    friend class SuperOscillator;
-    // \ todo: get rid of this by providing get-functions
-
-  public:
-
-    enum waveforms
-    {
-      SILENCE = 0,
-      SINE, 
-      TRIANGLE,
-      SQUARE,
-      SAW,
-      SQUARE303,
-      SAW303
-    };
-
-    //---------------------------------------------------------------------------------------------
-    // construction/destruction:
-
-    /** Constructor. */
-    MipMappedWaveTable();          
-
-    /** Destructor. */
-    ~MipMappedWaveTable();         
-
-    //---------------------------------------------------------------------------------------------
-    // parmeter-settings:
-
-    /** Selects a waveform from the set of built-in wavforms. The object generates the 
-    prototype-waveform by some algorithmic rules and renders various bandlimited version of it via 
-    FFT/iFFT. */
-    void setWaveform(int newWaveform);
-
-    /** Overloaded function to set the waveform form outside this class. This function expects a 
-    pointer to the prototype-waveform to be handed over along with the length of this waveform. It 
-    copies the values into the internal buffers and renders various bandlimited version via 
-    FFT/iFFT.
-    \todo: Interpolation for the case that lengthInSamples does not match the length of the 
-    internal table-length. */
-    void setWaveform(double* newWaveform, int lengthInSamples);
-
-    /** Sets the time symmetry between the first and second half-wave (as value between 0...1) - 
-    for a square wave, this is also known as pulse-width. Currently only implemented for square and 
-    saw waveforms. */
-    void setSymmetry(double newSymmetry);
-
-    // internal 'back-panel' parameters:
-
-    /** Sets the drive (in dB) for the tanh-shaper for 303-square waveform - internal parameter, to 
-    be scrapped eventually. */
-    void setTanhShaperDriveFor303Square(double newDrive)
-    { tanhShaperFactor = dB2amp(newDrive); fillWithSquare303(); }
-
-    /** Sets the offset (as raw value for the tanh-shaper for 303-square waveform - internal 
-    parameter, to be scrapped eventually. */
-    void setTanhShaperOffsetFor303Square(double newOffset)
-    { tanhShaperOffset = newOffset; fillWithSquare303(); }
-
-    /** Sets the phase shift of tanh-shaped square wave with respect to the saw-wave (in degrees)
-    - this is important when the two are mixed. */
-    void set303SquarePhaseShift(double newShift)
-    { squarePhaseShift = newShift; fillWithSquare303(); }
-
-    //---------------------------------------------------------------------------------------------
-    // inquiry:
-
-    /** Returns the drive (in dB) for the tanh-shaper for 303-square waveform - internal parameter, to 
-    be scrapped eventually. */
-    double getTanhShaperDriveFor303Square() const { return amp2dB(tanhShaperFactor); }
-
-    /** Returns the offset (as raw value for the tanh-shaper for 303-square waveform - internal 
-    parameter, to be scrapped eventually. */
-    double getTanhShaperOffsetFor303Square() const { return tanhShaperOffset; }
-
-    /** Returns the phase shift of tanh-shaped square wave with respect to the saw-wave (in degrees)
-    - this is important when the two are mixed. */
-    double get303SquarePhaseShift() const { return squarePhaseShift; }
-
-    //---------------------------------------------------------------------------------------------
-    // audio processing:
-
-    /** Returns the value at position 'integerPart+fractionalPart' of table 'tableIndex' with 
-    linear interpolation - this function may be preferred over 
-    getValueLinear(double phaseIndex, int tableIndex) when you want to calculate the integer and 
-    fractional part of the phase-index yourself. */
-    INLINE double getValueLinear(int integerPart, double fractionalPart, int tableIndex);
-
-    /** Returns the value at position 'phaseIndex' of table 'tableIndex' with linear 
-    interpolation - this function computes the integer and fractional part of the phaseIndex
-    internally. */
-    INLINE double getValueLinear(double phaseIndex, int tableIndex);
-
-  protected:
-
-    // functions to fill table with the built-in waveforms (these functions are
-    // called from setWaveform(int newWaveform):
-    void fillWithSine();
-    void fillWithTriangle();
-    void fillWithSquare();
-    void fillWithSaw();
-    void fillWithSquare303();
-    void fillWithSaw303();
-    void fillWithPeak();
-    void fillWithMoogSaw();
-
-    void initPrototypeTable();
-      // fills the "prototypeTable"-variable with all zeros
-
-    void initTableSet();
-      // fills the "tableSet"-variable with all zeros
-
-    void removeDC();
-      // removes dc-component from the waveform in the prototype-table
-
-    void normalize();
-      // normalizes the amplitude of the prototype-table to 1.0
-
-    void reverseTime();
-      // time-reverses the prototype-table
-
-    /** Renders the prototype waveform and generates the mip-map from that. */
-    void renderWaveform();
-
-    void generateMipMap();
-      // generates a multisample from the prototype table, where each of the
-      // successive tables contains one half of the spectrum of the previous one
-
-    static const int tableLength = 2048;
-      // Length of the lookup-table. The actual length of the allocated memory is 4 samples longer, 
-      // to store additional samples for the interpolator (which are the same values as at the 
-      // beginning of the buffer) */
-
-
-    double symmetry; // symmetry between 1st and 2nd half-wave
-
-    static const int numTables = 12;
-      // The Oscillator class uses a one table-per octave multisampling to avoid aliasing. With a 
-      // table-size of 8192 and a sample-sample rate of  44100, the 12th table will have a 
-      // fundamental frequency (the frequency where the increment is 1) of 11025 which is good for 
-      // the highest frequency. 
-
-    int    waveform;   // index of the currently chosen native waveform
-    double sampleRate; // the sampleRate
-
-    double prototypeTable[tableLength];
-      // this is the prototype-table with full bandwidth. one additional sample (same as 
-      // prototypeTable[0]) for linear interpolation without need for table wraparound at the last 
-      // sample (-> saves one if-statement each audio-cycle) ...and a three further addtional 
-      // samples for more elaborate interpolations like cubic (not implemented yet, also:
-      // the fillWith...()-functions don't support these samples yet). */
-
-    double tableSet[numTables][tableLength+4];
-      // The multisample for anti-aliased waveform generation. The 4 additional values are equal 
-      // to the first 4 values in the table for easier interpolation. The first index is for the 
-      // table-number - index 0 accesses the first version which has full bandwidth, index 1 
-      // accesses the second version which is bandlimited to Nyquist/2, 2->Nyquist/4, 
-      // 3->Nyquist/8, etc. */
-
-    // embedded objects:
-    FourierTransformerRadix2 fourierTransformer;
-
-    // internal parameters:
-    double tanhShaperFactor, tanhShaperOffset, squarePhaseShift;
-
-  };
-
-  //-----------------------------------------------------------------------------------------------
-  // inlined functions:
-    
-  INLINE double MipMappedWaveTable::getValueLinear(int integerPart, double fractionalPart, int tableIndex)
-  {
-    // ensure, that the table index is in the valid range:
-    if( tableIndex<=0 )
-      tableIndex = 0;
-    else if ( tableIndex>numTables )
-      tableIndex = 11;
-
-    return   (1.0-fractionalPart) * tableSet[tableIndex][integerPart] 
-           +      fractionalPart  * tableSet[tableIndex][integerPart+1];
-  }
-
-  INLINE double MipMappedWaveTable::getValueLinear(double phaseIndex, int tableIndex)
-  {
-    /*
-    // ensure, that the table index is in the valid range:
-    if( tableIndex<=0 )
-      tableIndex = 0;
-    else if ( tableIndex>numTables )
-      tableIndex = 11;
-      */
-
-    // calculate integer and fractional part of the phaseIndex:
-    int    intIndex = floorInt(phaseIndex);
-    double frac     = phaseIndex  - (double) intIndex;
-    return getValueLinear(intIndex, frac, tableIndex);
-
-    // lookup value in the table with linear interpolation and return it:
-    //return (1.0-frac)*tableSet[tableIndex][intIndex] + frac*tableSet[tableIndex][intIndex+1];
-  }
-
-} // end namespace rosic
-
-#endif // rosic_MipMappedWaveTable_h
+#ifndef rosic_MipMappedWaveTable_h
+#define rosic_MipMappedWaveTable_h
+
+// rosic-indcludes:
+#include "rosic_FunctionTemplates.h"
+#include "rosic_FourierTransformerRadix2.h"
+
+#include <vector>
+
+namespace rosic
+{
+
+  /**
+
+  This is a class for generating and storing a single-cycle-waveform in a lookup-table and 
+  retrieving values form it at arbitrary positions by means of interpolation.
+
+  The bandlimited versions (the levels of the mip-map) are stored as floats in one contiguous
+  block. By default, all tables have the full length, so the highest notes are interpolated from
+  heavily oversampled tables which keeps their aliasing low. When OPEN303_COMPACT_WAVETABLES is
+  defined, the tables for the higher levels are made shorter (each octave of bandlimiting halves
+  the number of harmonics): the first numFullLengthTables tables have the full length and each
+  further table has half the length of the previous one. This keeps the highest harmonic of every
+  shortened table at 1/8 of the table's Nyquist frequency (like in the last full-length table) and
+  reduces the memory of the tables from 98 kB to 41 kB - at the price of more aliasing on high
+  notes (-76 instead of -110 dB at 3.5 kHz). A phase index in the range 0...tableLength has to be
+  scaled by getIndexScaler(tableIndex) to index a (possibly) shortened table.
+
+  */
+
+  class MipMappedWaveTable
+  {
+
+    // Oscillator and SuperOscillator classes need access to certain protected member-variables 
+    // (namely the tableLength and related quantities), so we declare them as friend-classes:
+    friend class Oscillator;
+    friend class BlendOscillator;
+    friend class SuperOscillator;
+    // \ todo: get rid of this by providing get-functions
+
+  public:
+
+    enum waveforms
+    {
+      SILENCE = 0,
+      SINE, 
+      TRIANGLE,
+      SQUARE,
+      SAW,
+      SQUARE303,
+      SAW303,
+      USER       // a waveform that was passed in via setWaveform(double*, int)
+    };
+
+    //---------------------------------------------------------------------------------------------
+    // construction/destruction:
+
+    /** Constructor. */
+    MipMappedWaveTable();          
+
+    /** Destructor. */
+    ~MipMappedWaveTable();         
+
+    //---------------------------------------------------------------------------------------------
+    // parmeter-settings:
+
+    /** Selects a waveform from the set of built-in wavforms. The object generates the 
+    prototype-waveform by some algorithmic rules and renders various bandlimited version of it via 
+    FFT/iFFT. */
+    void setWaveform(int newWaveform);
+
+    /** Overloaded function to set the waveform form outside this class. This function expects a 
+    pointer to one cycle of the prototype-waveform to be handed over along with the length of this 
+    cycle which may be arbitrary. The cycle is periodically resampled to the internal table length 
+    via its spectrum (@see WaveformSpectrumCache) and the spectrum is kept for rendering the
+    bandlimited versions, which happens lazily in updateTables() like for the built-in waveforms.
+    The resampling allocates memory and takes some time (unless the same waveform was passed
+    before), so this function should not be called from the audio thread. It switches the 
+    waveform to USER. */
+    void setWaveform(double* newWaveform, int lengthInSamples);
+
+    /** Sets the time symmetry between the first and second half-wave (as value between 0...1) - 
+    for a square wave, this is also known as pulse-width. Currently only implemented for square and 
+    saw waveforms. */
+    void setSymmetry(double newSymmetry);
+
+    // internal 'back-panel' parameters:
+
+    /** Sets the drive (in dB) for the tanh-shaper for 303-square waveform - internal parameter, to 
+    be scrapped eventually. */
+    void setTanhShaperDriveFor303Square(double newDrive)
+    { tanhShaperFactor = dB2amp(newDrive); setDirty(); }
+
+    /** Sets the offset (as raw value for the tanh-shaper for 303-square waveform - internal 
+    parameter, to be scrapped eventually. */
+    void setTanhShaperOffsetFor303Square(double newOffset)
+    { tanhShaperOffset = newOffset; setDirty(); }
+
+    /** Sets the phase shift of tanh-shaped square wave with respect to the saw-wave (in degrees)
+    - this is important when the two are mixed. */
+    void set303SquarePhaseShift(double newShift)
+    { squarePhaseShift = newShift; setDirty(); }
+
+    //---------------------------------------------------------------------------------------------
+    // inquiry:
+
+    /** Returns the drive (in dB) for the tanh-shaper for 303-square waveform - internal parameter, to 
+    be scrapped eventually. */
+    double getTanhShaperDriveFor303Square() const { return amp2dB(tanhShaperFactor); }
+
+    /** Returns the offset (as raw value for the tanh-shaper for 303-square waveform - internal 
+    parameter, to be scrapped eventually. */
+    double getTanhShaperOffsetFor303Square() const { return tanhShaperOffset; }
+
+    /** Returns the phase shift of tanh-shaped square wave with respect to the saw-wave (in degrees)
+    - this is important when the two are mixed. */
+    double get303SquarePhaseShift() const { return squarePhaseShift; }
+
+    /** Returns true when some waveform parameter was changed since the mip-map was rendered the 
+    last time, i.e. the tables are out of date and updateTables() has yet to be called. */
+    bool isDirty() const { return dirty; }
+
+    /** Returns the number of times the mip-map was (re)generated since construction. Each 
+    generation involves one forward and numTables-1 inverse FFTs, so this is useful to verify that
+    parameter changes are batched as intended. */
+    int getNumMipMapGenerations() const { return numMipMapGenerations; }
+
+    //---------------------------------------------------------------------------------------------
+    // table updating:
+
+    /** The waveform setters don't render the tables immediately but only mark them as dirty - 
+    this function then re-renders the waveform and mip-map once, if necessary. It is called lazily 
+    by the oscillator before the next sample is produced, but may also be called explicitly to 
+    commit a batch of parameter changes (for example after loading a preset). */
+    void updateTables() { if( dirty ) renderWaveform(); }
+
+    /** Renders the level with the given index of the mip-map as weighted sum of the same levels
+    of two other tables, i.e. weight1*table1 + weight2*table2. The mip-map generation is linear,
+    so rendering all levels this way gives the same mip-map as rendering the weighted sum of the
+    two prototype waveforms - but without any FFT. The two source tables must be up to date. The
+    levels may be rendered one at a time to spread the work over several calls. */
+    void renderWeightedSum(const MipMappedWaveTable& table1, double weight1,
+      const MipMappedWaveTable& table2, double weight2, int tableIndex);
+
+    //---------------------------------------------------------------------------------------------
+    // audio processing:
+
+    /** Returns the value at position 'integerPart+fractionalPart' of table 'tableIndex' with 
+    linear interpolation - this function may be preferred over 
+    getValueLinear(double phaseIndex, int tableIndex) when you want to calculate the integer and 
+    fractional part of the phase-index yourself. Note that the position refers to the table 
+    'tableIndex' itself, i.e. the phase index must have been scaled by getIndexScaler(). */
+    INLINE double getValueLinear(int integerPart, double fractionalPart, int tableIndex);
+
+    /** Returns the value at position 'phaseIndex' of table 'tableIndex' with linear 
+    interpolation - this function computes the integer and fractional part of the phaseIndex
+    internally. */
+    INLINE double getValueLinear(double phaseIndex, int tableIndex);
+
+    /** Returns the factor by which a phase index in the range 0...tableLength has to be multiplied
+    to obtain the position within the table with given index (this is a power of 2 that is <= 1
+    because the tables with less bandwidth may be shorter). The table index must be in the range
+    0...numTables-1. */
+    static INLINE double getIndexScaler(int tableIndex) { return indexScalers[tableIndex]; }
+
+  protected:
+
+    // functions to fill table with the built-in waveforms (these functions are
+    // called from setWaveform(int newWaveform):
+    void fillWithSine();
+    void fillWithTriangle();
+    void fillWithSquare();
+    void fillWithSaw();
+    void fillWithSquare303();
+    void fillWithSaw303();
+    void fillWithPeak();
+    void fillWithMoogSaw();
+
+    void initPrototypeTable();
+      // fills the "prototypeTable"-variable with all zeros
+
+    void initTableSet();
+      // fills the "tableSet"-variable with all zeros
+
+    void removeDC();
+      // removes dc-component from the waveform in the prototype-table
+
+    void normalize();
+      // normalizes the amplitude of the prototype-table to 1.0
+
+    void reverseTime();
+      // time-reverses the prototype-table
+
+    /** Marks the tables as being out of date with respect to the waveform parameters. */
+    void setDirty() { dirty = true; }
+
+    /** Renders the prototype waveform and generates the mip-map from that. */
+    void renderWaveform();
+
+    void generateMipMap();
+      // generates a multisample from the prototype table, where each of the
+      // successive tables contains one half of the spectrum of the previous one
+
+    /** Generates the multisample from a spectrum (in the format of 
+    FourierTransformerRadix2::transformRealSignal) - the prototype table is obtained by the iFFT 
+    of the spectrum. */
+    void generateMipMapFromSpectrum(const double* spectrum);
+
+    /** Renders the bandlimited versions (tables 1...numTables-1) from the spectrum of the 
+    prototype which is modified in the process. Used by both of the functions above. */
+    void generateBandlimitedTables(double* spectrum);
+
+    /** Stores the passed values (as many as the table's length) in table 'tableIndex' of the 
+    tableSet (converted to float and with the additional samples for the interpolator). */
+    void storeTable(const double* values, int tableIndex);
+
+    static const int tableLength = 2048;
+      // Length of the lookup-table. The actual length of the allocated memory is 4 samples longer, 
+      // to store additional samples for the interpolator (which are the same values as at the 
+      // beginning of the buffer) */
+
+
+    double symmetry; // symmetry between 1st and 2nd half-wave
+
+    static const int numTables = 12;
+      // The Oscillator class uses a one table-per octave multisampling to avoid aliasing. With a 
+      // table-size of 8192 and a sample-sample rate of  44100, the 12th table will have a 
+      // fundamental frequency (the frequency where the increment is 1) of 11025 which is good for 
+      // the highest frequency. 
+
+#ifdef OPEN303_COMPACT_WAVETABLES
+    static const int numFullLengthTables = 4;
+#else
+    static const int numFullLengthTables = numTables;
+#endif
+      // Number of tables (starting with the one with full bandwidth) that have the full length. 
+      // The 4th table has harmonics up to 1/8 of its Nyquist frequency - in the compact layout, 
+      // each further table has half the length of the previous one and thereby keeps this ratio.
+
+    static const int tableSetLength = numFullLengthTables*(tableLength+4) 
+      + tableLength - (tableLength >> (numTables-numFullLengthTables)) 
+      + 4*(numTables-numFullLengthTables);
+      // Total length of all tables including the 4 additional samples per table (the lengths of
+      // the shortened tables form a geometric series).
+
+    static const int    tableOffsets[numTables];  // start positions of the tables in tableSet
+    static const int    tableLengths[numTables];  // lengths of the tables (without the 4 extra)
+    static const double indexScalers[numTables];  // tableLengths[t] / tableLength
+
+    int    waveform;   // index of the currently chosen native waveform
+    double sampleRate; // the sampleRate
+
+    double prototypeTable[tableLength];
+      // this is the prototype-table with full bandwidth. one additional sample (same as 
+      // prototypeTable[0]) for linear interpolation without need for table wraparound at the last 
+      // sample (-> saves one if-statement each audio-cycle) ...and a three further addtional 
+      // samples for more elaborate interpolations like cubic (not implemented yet, also:
+      // the fillWith...()-functions don't support these samples yet). */
+
+    alignas(16) float tableSet[tableSetLength];
+      // The multisample for anti-aliased waveform generation. Table t starts at tableOffsets[t] 
+      // and has tableLengths[t]+4 values, the 4 additional values are equal to the first 4 values 
+      // in the table for easier interpolation. Table 0 is the first version which has full 
+      // bandwidth, table 1 is the second version which is bandlimited to Nyquist/2, 
+      // 2->Nyquist/4, 3->Nyquist/8, etc. (Nyquist refers to the full-length table here). */
+
+    // embedded objects:
+    FourierTransformerRadix2 fourierTransformer;
+
+    // internal parameters:
+    double tanhShaperFactor, tanhShaperOffset, squarePhaseShift;
+
+    std::vector<double> userSpectrum; // spectrum of the USER waveform (empty, when there is none)
+
+    bool dirty;                // flag to indicate that the tables need to be re-rendered
+    int  numMipMapGenerations; // counts the calls to generateMipMap()
+
+  };
+
+  //-----------------------------------------------------------------------------------------------
+  // inlined functions:
+    
+  INLINE double MipMappedWaveTable::getValueLinear(int integerPart, double fractionalPart, int tableIndex)
+  {
+    // ensure, that the table index is in the valid range:
+    if( tableIndex<=0 )
+      tableIndex = 0;
+    else if ( tableIndex>=numTables )
+      tableIndex = numTables-1;
+
+    const float *table = &tableSet[tableOffsets[tableIndex]];
+    return   (1.0-fractionalPart) * table[integerPart] 
+           +      fractionalPart  * table[integerPart+1];
+  }
+
+  INLINE double MipMappedWaveTable::getValueLinear(double phaseIndex, int tableIndex)
+  {
+    // ensure, that the table index is in the valid range:
+    if( tableIndex<=0 )
+      tableIndex = 0;
+    else if ( tableIndex>=numTables )
+      tableIndex = numTables-1;
+
+    // calculate integer and fractional part of the phaseIndex (scaled to the table's length):
+    phaseIndex     *= indexScalers[tableIndex];
+    int    intIndex = floorInt(phaseIndex);
+    double frac     = phaseIndex  - (double) intIndex;
+    return getValueLinear(intIndex, frac, tableIndex);
+
+    // lookup value in the table with linear interpolation and return it:
+    //return (1.0-frac)*tableSet[tableIndex][intIndex] + frac*tableSet[tableIndex][intIndex+1];
+  }
+
+} // end namespace rosic
+
+#endif // rosic_MipMappedWaveTable_h
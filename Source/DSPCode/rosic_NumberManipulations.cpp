@@ -1,7 +1,7 @@
-#include "rosic_NumberManipulations.h"
-using namespace rosic;
-
-
-
-
-
+#include "rosic_NumberManipulations.h"
+using namespace rosic;
+
+
+
+
+
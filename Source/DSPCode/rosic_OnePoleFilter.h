@@ -1,128 +1,158 @@
-#ifndef rosic_OnePoleFilter_h
-#define rosic_OnePoleFilter_h
-
-// rosic-indcludes:
-#include "rosic_RealFunctions.h"
-
-namespace rosic
-{
-
-  /**
-
-  This is an implementation of a simple one-pole filter unit.
-
-  */
-
-  class OnePoleFilter
-  {
-
-  public:
-
-    /** This is an enumeration of the available filter modes. */
-    enum modes
-    {
-      BYPASS = 0,
-      LOWPASS,
-      HIGHPASS,
-      LOWSHELV,
-      HIGHSHELV,
-      ALLPASS
-    };
-    // \todo (maybe): let the user choose between LP/HP versions obtained via bilinear trafo and 
-    // impulse invariant trafo
-
-    //---------------------------------------------------------------------------------------------
-    // construction/destruction:
-
-    /** Constructor. */
-    OnePoleFilter();   
-
-    //---------------------------------------------------------------------------------------------
-    // parameter settings:
-
-    /** Sets the sample-rate. */
-    void setSampleRate(double newSampleRate);
-
-    /** Chooses the filter mode. See the enumeration for available modes. */
-    void setMode(int newMode);
-
-    /** Sets the cutoff-frequency for this filter. */
-    void setCutoff(double newCutoff);
-
-    /** This will set the time constant 'tau' for the case, when lowpass mode is chosen. This is 
-    the time, it takes for the impulse response to die away to 1/e = 0.368... or equivalently, the
-    time it takes for the step response to raise to 1-1/e = 0.632... */
-    void setLowpassTimeConstant(double newTimeConstant) { setCutoff(1.0/(2*PI*newTimeConstant)); }
-
-    /** Sets the gain factor for the shelving modes (this is not in decibels). */
-    void setShelvingGain(double newGain);
-
-    /** Sets the gain for the shelving modes in decibels. */
-    void setShelvingGainInDecibels(double newGain);
-
-    /** Sets the filter coefficients manually. */
-    void setCoefficients(double newB0, double newB1, double newA1);
-
-    /** Sets up the internal state variables for both channels. */
-    void setInternalState(double newX1, double newY1);
-
-    //---------------------------------------------------------------------------------------------
-    // inquiry
-
-    /** Returns the cutoff-frequency. */
-    double getCutoff() const { return cutoff; }
-
-    //---------------------------------------------------------------------------------------------
-    // audio processing:
-
-    /** Calculates a single filtered output-sample. */
-    INLINE double getSample(double in);
-
-    //---------------------------------------------------------------------------------------------
-    // others:
-
-    /** Resets the internal buffers (for the \f$ x[n-1], y[n-1] \f$-samples) to zero. */
-    void reset();
-
-    //=============================================================================================
-
-  protected:
-
-    // buffering:
-    double x1, y1;
-
-    // filter coefficients:
-    double b0; // feedforward coeffs
-    double b1;
-    double a1; // feedback coeff
-
-    // filter parameters:
-    double cutoff;
-    double shelvingGain;
-    int    mode;  
-
-    double sampleRate; 
-    double sampleRateRec;  // reciprocal of the sampleRate
-
-    // internal functions:
-    void calcCoeffs();  // calculates filter coefficients from filter parameters
-
-  };
-
-  //-----------------------------------------------------------------------------------------------
-  // inlined functions:
-
-  INLINE double OnePoleFilter::getSample(double in)
-  {
-    // calculate the output sample:
-    y1 = b0*in + b1*x1 + a1*y1 + TINY;
-
-    // update the buffer variables:
-    x1 = in;
-
-    return y1;
-  }
-
-} // end namespace rosic
-
-#endif // rosic_OnePoleFilter_h
+#ifndef rosic_OnePoleFilter_h
+#define rosic_OnePoleFilter_h
+
+// rosic-indcludes:
+#include "rosic_RealFunctions.h"
+#include "rosic_StateStream.h"
+
+namespace rosic
+{
+
+  /**
+
+  This is an implementation of a simple one-pole filter unit.
+
+  */
+
+  class OnePoleFilter
+  {
+
+  public:
+
+    /** This is an enumeration of the available filter modes. */
+    enum modes
+    {
+      BYPASS = 0,
+      LOWPASS,
+      HIGHPASS,
+      LOWSHELV,
+      HIGHSHELV,
+      ALLPASS
+    };
+    // \todo (maybe): let the user choose between LP/HP versions obtained via bilinear trafo and 
+    // impulse invariant trafo
+
+    //---------------------------------------------------------------------------------------------
+    // construction/destruction:
+
+    /** Constructor. */
+    OnePoleFilter();   
+
+    //---------------------------------------------------------------------------------------------
+    // parameter settings:
+
+    /** Sets the sample-rate. */
+    void setSampleRate(double newSampleRate);
+
+    /** Chooses the filter mode. See the enumeration for available modes. */
+    void setMode(int newMode);
+
+    /** Sets the cutoff-frequency for this filter. */
+    void setCutoff(double newCutoff);
+
+    /** This will set the time constant 'tau' for the case, when lowpass mode is chosen. This is 
+    the time, it takes for the impulse response to die away to 1/e = 0.368... or equivalently, the
+    time it takes for the step response to raise to 1-1/e = 0.632... */
+    void setLowpassTimeConstant(double newTimeConstant) { setCutoff(1.0/(2*PI*newTimeConstant)); }
+
+    /** Sets the gain factor for the shelving modes (this is not in decibels). */
+    void setShelvingGain(double newGain);
+
+    /** Sets the gain for the shelving modes in decibels. */
+    void setShelvingGainInDecibels(double newGain);
+
+    /** Sets the filter coefficients manually. */
+    void setCoefficients(double newB0, double newB1, double newA1);
+
+    /** Sets up the internal state variables for both channels. */
+    void setInternalState(double newX1, double newY1);
+
+    //---------------------------------------------------------------------------------------------
+    // inquiry
+
+    /** Returns the cutoff-frequency. */
+    double getCutoff() const { return cutoff; }
+
+    //---------------------------------------------------------------------------------------------
+    // audio processing:
+
+    /** Calculates a single filtered output-sample. */
+    INLINE double getSample(double in);
+
+    /** Filters a block of samples - the result is the same as calling getSample for each sample,
+    but coefficients and state are held in registers during the loop. The output buffer may be
+    the same as the input buffer. */
+    INLINE void processBlock(const double* in, double* out, int numSamples);
+
+    //---------------------------------------------------------------------------------------------
+    // others:
+
+    /** Resets the internal buffers (for the \f$ x[n-1], y[n-1] \f$-samples) to zero. */
+    void reset();
+
+    /** Writes the buffered samples x[n-1], y[n-1] into the stream. */
+    void saveState(StateWriter& writer) const;
+
+    /** Reads the buffered samples back from the stream. @see saveState */
+    void loadState(StateReader& reader);
+
+    //=============================================================================================
+
+  protected:
+
+    // buffering:
+    double x1, y1;
+
+    // filter coefficients:
+    double b0; // feedforward coeffs
+    double b1;
+    double a1; // feedback coeff
+
+    // filter parameters:
+    double cutoff;
+    double shelvingGain;
+    int    mode;  
+
+    double sampleRate; 
+    double sampleRateRec;  // reciprocal of the sampleRate
+
+    // internal functions:
+    void calcCoeffs();  // calculates filter coefficients from filter parameters
+
+    friend class FilterCascade;
+    friend class UnisonLanes;
+
+  };
+
+  //-----------------------------------------------------------------------------------------------
+  // inlined functions:
+
+  INLINE double OnePoleFilter::getSample(double in)
+  {
+    // calculate the output sample:
+    y1 = ANTI_DENORMAL(b0*in + b1*x1 + a1*y1);
+
+    // update the buffer variables:
+    x1 = in;
+
+    return y1;
+  }
+
+  INLINE void OnePoleFilter::processBlock(const double* in, double* out, int numSamples)
+  {
+    double cb0 = b0, cb1 = b1, ca1 = a1;
+    double x = x1, y = y1;
+    for(int n=0; n<numSamples; n++)
+    {
+      double xn = in[n];
+      y         = ANTI_DENORMAL(cb0*xn + cb1*x + ca1*y);
+      x         = xn;
+      out[n]    = y;
+    }
+    x1 = x;
+    y1 = y;
+  }
+
+} // end namespace rosic
+
+#endif // rosic_OnePoleFilter_h
@@ -1,331 +1,881 @@
-#include "rosic_Open303.h"
-
-using namespace rosic;
-
-//-------------------------------------------------------------------------------------------------
-// construction/destruction:
-
-Open303::Open303()
-{
-  tuning           =   440.0;
-  ampScaler        =     1.0;
-  oscFreq          =   440.0;
-  sampleRate       = 44100.0;
-  level            =   -12.0;
-  levelByVel       =    12.0;
-  accent           =     0.0;
-  slideTime        =    60.0;
-  cutoff           =  1000.0;
-  envUpFraction    =     2.0/3.0;
-  normalAttack     =     3.0;
-  accentAttack     =     3.0;
-  normalDecay      =  1000.0;
-  accentDecay      =   200.0;
-  normalAmpRelease =     1.0;
-  accentAmpRelease =    50.0;
-  accentGain       =     0.0;
-  pitchWheelFactor =     1.0;
-  currentNote      =    -1;
-  noteOffCountDown =     0;
-  slideToNextNote  = false;
-  idle             = true;
-
-  setEnvMod(25.0);
-
-  oscillator.setWaveTable1(&waveTable1);
-  oscillator.setWaveForm1(MipMappedWaveTable::SAW303);
-  oscillator.setWaveTable2(&waveTable2);
-  oscillator.setWaveForm2(MipMappedWaveTable::SQUARE303);
-
-  //mainEnv.setNormalizeSum(true);
-  mainEnv.setNormalizeSum(false);
-
-  ampEnv.setAttack(0.0);
-  ampEnv.setDecay(1230.0);
-  ampEnv.setSustainLevel(0.0);
-  ampEnv.setRelease(0.5);
-  ampEnv.setTauScale(1.0);
-
-  pitchSlewLimiter.setTimeConstant(60.0);
-  //ampDeClicker.setTimeConstant(2.0);
-  ampDeClicker.setMode(BiquadFilter::LOWPASS12);
-  ampDeClicker.setGain( amp2dB(sqrt(0.5)) );
-  ampDeClicker.setFrequency(200.0);
-
-  rc1.setTimeConstant(0.0);
-  rc2.setTimeConstant(15.0);
-
-  highpass1.setMode(OnePoleFilter::HIGHPASS);
-  highpass2.setMode(OnePoleFilter::HIGHPASS);
-  allpass.setMode(OnePoleFilter::ALLPASS);
-  notch.setMode(BiquadFilter::BANDREJECT);
-
-  setSampleRate(sampleRate);
-
-  // tweakables:
-  oscillator.setPulseWidth(50.0);
-  highpass1.setCutoff(44.486);
-  highpass2.setCutoff(24.167);
-  allpass.setCutoff(14.008);
-  notch.setFrequency(7.5164);
-  notch.setBandwidth(4.7);
-
-  filter.setFeedbackHighpassCutoff(150.0);
-}
-
-Open303::~Open303()
-{
-
-}
-
-//-------------------------------------------------------------------------------------------------
-// parameter settings:
-
-void Open303::setSampleRate(double newSampleRate)
-{
-  mainEnv.setSampleRate         (       newSampleRate);
-  ampEnv.setSampleRate          (       newSampleRate);
-  pitchSlewLimiter.setSampleRate((float)newSampleRate);
-  ampDeClicker.setSampleRate(    (float)newSampleRate);
-  rc1.setSampleRate(             (float)newSampleRate);
-  rc2.setSampleRate(             (float)newSampleRate);
-  sequencer.setSampleRate(              newSampleRate);
-
-  highpass2.setSampleRate     (         newSampleRate);
-  allpass.setSampleRate       (         newSampleRate);
-  notch.setSampleRate         (         newSampleRate);
-
-  highpass1.setSampleRate     (  oversampling*newSampleRate);
-
-  oscillator.setSampleRate    (  oversampling*newSampleRate);
-  filter.setSampleRate        (  oversampling*newSampleRate);
-}
-
-void Open303::setCutoff(double newCutoff)
-{
-  cutoff = newCutoff;
-  calculateEnvModScalerAndOffset();
-}
-
-void Open303::setEnvMod(double newEnvMod)
-{
-  envMod = newEnvMod;
-  calculateEnvModScalerAndOffset();
-}
-
-void Open303::setAccent(double newAccent)
-{
-  accent = 0.01 * newAccent;
-}
-
-void Open303::setVolume(double newLevel)
-{
-  level     = newLevel;
-  ampScaler = dB2amp(level);
-}
-
-void Open303::setSlideTime(double newSlideTime)
-{
-  if( newSlideTime >= 0.0 )
-  {
-    slideTime = newSlideTime;
-    pitchSlewLimiter.setTimeConstant((float)(0.2*slideTime));  // \todo: tweak the scaling constant
-  }
-}
-
-void Open303::setPitchBend(double newPitchBend)
-{
-  pitchWheelFactor = pitchOffsetToFreqFactor(newPitchBend);
-}
-
-//------------------------------------------------------------------------------------------------------------
-// others:
-
-void Open303::noteOn(int noteNumber, int velocity)
-{
-  if( sequencer.modeWasChanged() )
-    allNotesOff();
-
-  if( sequencer.getSequencerMode() != AcidSequencer::OFF )
-  {
-    if( velocity == 0 )
-    {
-      sequencer.stop();
-      releaseNote(currentNote);
-      currentNote = -1;
-    }
-    else
-    {
-      sequencer.start();
-      noteOffCountDown = std::numeric_limits<int>::max();
-      slideToNextNote  = false;
-      currentNote      = noteNumber;
-    }
-    idle = false;
-    return;
-  }
-
-  if( velocity == 0 ) // velocity zero indicates note-off events
-  {
-    MidiNoteEvent releasedNote(noteNumber, 0);
-    noteList.remove(releasedNote);
-    if( noteList.empty() )
-    {
-      currentNote = -1;
-    }
-    else
-    {
-      currentNote = noteList.front().getKey();
-    }
-    releaseNote(noteNumber);
-  }
-  else // velocity was not zero, so this is an actual note-on
-  {
-    // check if the note-list is empty (indicating that currently no note is playing) - if so,
-    // trigger a new note, otherwise, slide to the new note:
-    if( noteList.empty() )
-      triggerNote(noteNumber, velocity >= 100);
-    else
-      slideToNote(noteNumber, velocity >= 100);
-
-    currentNote = noteNumber;
-
-    // and we need to add the new note to our list, of course:
-    MidiNoteEvent newNote(noteNumber, velocity);
-    noteList.push_front(newNote);
-  }
-  idle = false;
-}
-
-void Open303::allNotesOff()
-{
-  noteList.clear();
-  ampEnv.noteOff();
-  currentNote = -1;
-}
-
-void Open303::triggerNote(int noteNumber, bool hasAccent)
-{
-  // retrigger osc and reset filter buffers only if amplitude is near zero (to avoid clicks):
-  if( idle )
-  {
-    oscillator.resetPhase();
-    filter.reset();
-    highpass1.reset();
-    highpass2.reset();
-    allpass.reset();
-    notch.reset();
-    antiAliasFilter.reset();
-    ampDeClicker.reset();
-  }
-
-  if( hasAccent )
-  {
-    accentGain = accent;
-    setMainEnvDecay(accentDecay);
-    ampEnv.setRelease(accentAmpRelease);
-  }
-  else
-  {
-    accentGain = 0.0;
-    setMainEnvDecay(normalDecay);
-    ampEnv.setRelease(normalAmpRelease);
-  }
-
-  oscFreq = pitchToFreq(noteNumber, tuning);
-  pitchSlewLimiter.setState(oscFreq);
-  mainEnv.trigger();
-  ampEnv.noteOn(true);
-  idle = false;
-}
-
-void Open303::slideToNote(int noteNumber, bool hasAccent)
-{
-  oscFreq = pitchToFreq(noteNumber, tuning);
-
-  if( hasAccent )
-  {
-    accentGain = accent;
-    setMainEnvDecay(accentDecay);
-    ampEnv.setRelease(accentAmpRelease);
-  }
-  else
-  {
-    accentGain = 0.0;
-    setMainEnvDecay(normalDecay);
-    ampEnv.setRelease(normalAmpRelease);
-  }
-  idle = false;
-}
-
-void Open303::releaseNote(int noteNumber)
-{
-  // check if the note-list is empty now. if so, trigger a release, otherwise slide to the note
-  // at the beginning of the list (this is the most recent one which is still in the list). this
-  // initiates a slide back to the most recent note that is still being held:
-  if( noteList.empty() )
-  {
-    ampEnv.noteOff();
-  }
-  else
-  {
-    // initiate slide back:
-    oscFreq     = pitchToFreq(currentNote);
-  }
-}
-
-void Open303::setMainEnvDecay(double newDecay)
-{
-  mainEnv.setDecayTimeConstant(newDecay);
-  updateNormalizer1();
-  updateNormalizer2();
-}
-
-void Open303::calculateEnvModScalerAndOffset()
-{
-  bool useMeasuredMapping = true; // might be shown as user parameter later
-  if( useMeasuredMapping == true )
-  {
-    // define some constants that arise from the measurements:
-    const double c0   = 3.138152786059267e+002;  // lowest nominal cutoff
-    const double c1   = 2.394411986817546e+003;  // highest nominal cutoff
-    const double oF   = 0.048292930943553;       // factor in line equation for offset
-    const double oC   = 0.294391201442418;       // constant in line equation for offset
-    const double sLoF = 3.773996325111173;       // factor in line eq. for scaler at low cutoff
-    const double sLoC = 0.736965594166206;       // constant in line eq. for scaler at low cutoff
-    const double sHiF = 4.194548788411135;       // factor in line eq. for scaler at high cutoff
-    const double sHiC = 0.864344900642434;       // constant in line eq. for scaler at high cutoff
-
-    // do the calculation of the scaler and offset:
-    double e   = linToLin(envMod, 0.0, 100.0, 0.0, 1.0);
-    double c   = expToLin(cutoff, c0,   c1,   0.0, 1.0);
-    double sLo = sLoF*e + sLoC;
-    double sHi = sHiF*e + sHiC;
-    envScaler  = (1-c)*sLo + c*sHi;
-    envOffset  =  oF*c + oC;
-  }
-  else
-  {
-    double upRatio   = pitchOffsetToFreqFactor(      envUpFraction *envMod);
-    double downRatio = pitchOffsetToFreqFactor(-(1.0-envUpFraction)*envMod);
-    envScaler        = upRatio - downRatio;
-    if( envScaler != 0.0 ) // avoid division by zero
-      envOffset = - (downRatio - 1.0) / (upRatio - downRatio);
-    else
-      envOffset = 0.0;
-  }
-}
-
-void Open303::updateNormalizer1()
-{
-  n1 = LeakyIntegrator::getNormalizer(mainEnv.getDecayTimeConstant(), rc1.getTimeConstant(),
-    sampleRate);
-  n1 = 1.0; // test
-}
-
-void Open303::updateNormalizer2()
-{
-  n2 = LeakyIntegrator::getNormalizer(mainEnv.getDecayTimeConstant(), rc2.getTimeConstant(),
-    sampleRate);
-  n2 = 1.0; // test
-}
+#include "rosic_Open303.h"
+#include "rosic_DenormalGuard.h"
+
+using namespace rosic;
+
+//-------------------------------------------------------------------------------------------------
+// construction/destruction:
+
+Open303::Open303()
+{
+  tuning           =   440.0;
+  ampScaler        =     1.0;
+  oscFreq          =   440.0;
+  sampleRate       = 44100.0;
+  level            =   -12.0;
+  levelByVel       =    12.0;
+  accent           =     0.0;
+  slideTime        =    60.0;
+  cutoff           =  1000.0;
+  envUpFraction    =     2.0/3.0;
+  normalAttack     =     3.0;
+  accentAttack     =     3.0;
+  normalDecay      =  1000.0;
+  accentDecay      =   200.0;
+  normalAmpRelease =     1.0;
+  accentAmpRelease =    50.0;
+  accentGain       =     0.0;
+  pitchWheelFactor =     1.0;
+  n1               =     1.0;
+  n2               =     1.0;
+  unisonDetune     =     0.0;
+  cutoffSpread     =     0.0;
+  currentNote      =    -1;
+  numHeldNotes     =     0;
+  noteOffCountDown =     0;
+  slideToNextNote  = false;
+  idle             = true;
+
+  setEnvMod(25.0);
+
+  oscillator.setWaveTable1(&waveTable1);
+  oscillator.setWaveForm1(MipMappedWaveTable::SAW303);
+  oscillator.setWaveTable2(&waveTable2);
+  oscillator.setWaveForm2(MipMappedWaveTable::SQUARE303);
+  oscillator.setBlendedWaveTable(&blendedWaveTable);
+
+  //mainEnv.setNormalizeSum(true);
+  mainEnv.setNormalizeSum(false);
+
+  ampEnv.setAttack(0.0);
+  ampEnv.setDecay(1230.0);
+  ampEnv.setSustainLevel(0.0);
+  ampEnv.setRelease(0.5);
+  ampEnv.setTauScale(1.0);
+
+  pitchSlewLimiter.setTimeConstant(60.0);
+  //ampDeClicker.setTimeConstant(2.0);
+  ampDeClicker.setMode(BiquadFilter::LOWPASS12);
+  ampDeClicker.setGain( amp2dB(sqrt(0.5)) );
+  ampDeClicker.setFrequency(200.0);
+
+  rc1.setTimeConstant(0.0);
+  rc2.setTimeConstant(15.0);
+
+  highpass1.setMode(OnePoleFilter::HIGHPASS);
+  highpass2.setMode(OnePoleFilter::HIGHPASS);
+  allpass.setMode(OnePoleFilter::ALLPASS);
+  notch.setMode(BiquadFilter::BANDREJECT);
+
+  setSampleRate(sampleRate);
+
+  // tweakables:
+  oscillator.setPulseWidth(50.0);
+  highpass1.setCutoff(44.486);
+  highpass2.setCutoff(24.167);
+  allpass.setCutoff(14.008);
+  notch.setFrequency(7.5164);
+  notch.setBandwidth(4.7);
+
+  filter.setFeedbackHighpassCutoff(150.0);
+
+  // render the wavetables now, such that this doesn't happen lazily in the first getSample call:
+  updateWaveTables();
+}
+
+Open303::Open303(const Open303& other)
+: waveTable1(other.waveTable1), waveTable2(other.waveTable2),
+  blendedWaveTable(other.blendedWaveTable), oscillator(other.oscillator),
+  filter(other.filter), unison(other.unison), ampEnv(other.ampEnv), mainEnv(other.mainEnv),
+  pitchSlewLimiter(other.pitchSlewLimiter), ampDeClicker(other.ampDeClicker), rc1(other.rc1),
+  rc2(other.rc2), highpass1(other.highpass1), highpass2(other.highpass2), allpass(other.allpass),
+  notch(other.notch), antiAliasFilter(other.antiAliasFilter), sequencer(other.sequencer),
+  profiler(other.profiler)
+{
+  copyVariablesFrom(other);
+
+  // the copied oscillator still points to the other instance's tables:
+  oscillator.setWaveTable1(&waveTable1);
+  oscillator.setWaveTable2(&waveTable2);
+  oscillator.setBlendedWaveTable(&blendedWaveTable);
+}
+
+Open303::~Open303()
+{
+
+}
+
+Open303& Open303::operator=(const Open303& other)
+{
+  if( this == &other )
+    return *this;
+
+  waveTable1       = other.waveTable1;
+  waveTable2       = other.waveTable2;
+  blendedWaveTable = other.blendedWaveTable;
+  oscillator       = other.oscillator;
+  filter           = other.filter;
+  unison           = other.unison;
+  ampEnv           = other.ampEnv;
+  mainEnv          = other.mainEnv;
+  pitchSlewLimiter = other.pitchSlewLimiter;
+  ampDeClicker     = other.ampDeClicker;
+  rc1              = other.rc1;
+  rc2              = other.rc2;
+  highpass1        = other.highpass1;
+  highpass2        = other.highpass2;
+  allpass          = other.allpass;
+  notch            = other.notch;
+  antiAliasFilter  = other.antiAliasFilter;
+  sequencer        = other.sequencer;
+  profiler         = other.profiler;
+  copyVariablesFrom(other);
+
+  oscillator.setWaveTable1(&waveTable1);
+  oscillator.setWaveTable2(&waveTable2);
+  oscillator.setBlendedWaveTable(&blendedWaveTable);
+  return *this;
+}
+
+//-------------------------------------------------------------------------------------------------
+// parameter settings:
+
+void Open303::setSampleRate(double newSampleRate)
+{
+  sampleRate = newSampleRate;
+
+  mainEnv.setSampleRate         (       newSampleRate);
+  ampEnv.setSampleRate          (       newSampleRate);
+  pitchSlewLimiter.setSampleRate((float)newSampleRate);
+  ampDeClicker.setSampleRate(    (float)newSampleRate);
+  rc1.setSampleRate(             (float)newSampleRate);
+  rc2.setSampleRate(             (float)newSampleRate);
+  sequencer.setSampleRate(              newSampleRate);
+
+  highpass2.setSampleRate     (         newSampleRate);
+  allpass.setSampleRate       (         newSampleRate);
+  notch.setSampleRate         (         newSampleRate);
+
+  highpass1.setSampleRate     (  oversampling*newSampleRate);
+
+  oscillator.setSampleRate    (  oversampling*newSampleRate);
+  filter.setSampleRate        (  oversampling*newSampleRate);
+}
+
+void Open303::setCutoff(double newCutoff)
+{
+  cutoff = newCutoff;
+  calculateEnvModScalerAndOffset();
+}
+
+void Open303::setEnvMod(double newEnvMod)
+{
+  envMod = newEnvMod;
+  calculateEnvModScalerAndOffset();
+}
+
+void Open303::setAccent(double newAccent)
+{
+  accent = 0.01 * newAccent;
+}
+
+void Open303::setVolume(double newLevel)
+{
+  level     = newLevel;
+  ampScaler = dB2amp(level);
+}
+
+void Open303::setNumUnisonLanes(int newNumLanes)
+{
+  // the lanes are only used in the TB_303 filter mode (see isUnisonActive), but we keep the
+  // setting in the other modes:
+  unison.setNumLanes(newNumLanes);
+  updateUnisonSpreads();
+}
+
+void Open303::setUnisonDetune(double newDetune)
+{
+  unisonDetune = newDetune;
+  updateUnisonSpreads();
+}
+
+void Open303::setUnisonCutoffSpread(double newSpread)
+{
+  cutoffSpread = newSpread;
+  updateUnisonSpreads();
+}
+
+void Open303::setSlideTime(double newSlideTime)
+{
+  if( newSlideTime >= 0.0 )
+  {
+    slideTime = newSlideTime;
+    pitchSlewLimiter.setTimeConstant((float)(0.2*slideTime));  // \todo: tweak the scaling constant
+  }
+}
+
+void Open303::setPitchBend(double newPitchBend)
+{
+  pitchWheelFactor = pitchOffsetToFreqFactor(newPitchBend);
+}
+
+//-------------------------------------------------------------------------------------------------
+// state persistence:
+
+int Open303::getStateSize() const
+{
+  StateWriter writer(NULL, 0); // only counts the bytes
+  writeState(writer);
+  return writer.getNumBytesWritten();
+}
+
+int Open303::getMaxStateSize() const
+{
+  return getStateSize() + (maxNumHeldNotes-numHeldNotes) * 8; // 2 ints per held note
+}
+
+int Open303::saveState(unsigned char* buffer, int bufferSize) const
+{
+  StateWriter writer(buffer, bufferSize);
+  writeState(writer);
+  if( writer.hasOverflowed() )
+    return 0;
+  return writer.getNumBytesWritten();
+}
+
+bool Open303::loadState(const unsigned char* buffer, int numBytes)
+{
+  StateReader reader(buffer, numBytes);
+  if( reader.readInt() != stateMagic || reader.readInt() != stateVersion )
+    return false;
+
+  // read our own variables into temporaries first, such that we can bail out without having
+  // touched anything when the data turns out to be invalid:
+  double newOscFreq          = reader.readDouble();
+  double newPitchWheelFactor = reader.readDouble();
+  double newAccentGain       = reader.readDouble();
+  double newMainEnvDecay     = reader.readDouble();
+  double newAmpRelease       = reader.readDouble();
+  int    newCurrentNote      = reader.readInt();
+  int    newNoteOffCountDown = reader.readInt();
+  bool   newSlideToNextNote  = reader.readBool();
+  bool   newIdle             = reader.readBool();
+  int    newNumHeldNotes     = reader.readInt();
+  if( newCurrentNote < -1 || newCurrentNote > 127 )
+    return false;
+  if( newNumHeldNotes < 0 || newNumHeldNotes > maxNumHeldNotes )
+    return false;
+  MidiNoteEvent newHeldNotes[maxNumHeldNotes];
+  for(int i=0; i<newNumHeldNotes; i++)
+  {
+    int key = reader.readInt();
+    int vel = reader.readInt();
+    if( key < 0 || key > 127 || vel < 0 || vel > 127 )
+      return false;
+    newHeldNotes[i] = MidiNoteEvent(key, vel);
+  }
+
+  // the rest of the data must match the (fixed) size of the states of the embedded objects and
+  // the indices in them must be in range:
+  StateWriter sizeCounter(NULL, 0);
+  saveEmbeddedStates(sizeCounter);
+  if( reader.hasFailed() || reader.getNumBytesLeft() != sizeCounter.getNumBytesWritten() )
+    return false;
+  if( !areEmbeddedStatesValid(reader) )
+    return false;
+
+  oscFreq          = newOscFreq;
+  pitchWheelFactor = newPitchWheelFactor;
+  accentGain       = newAccentGain;
+  currentNote      = newCurrentNote;
+  noteOffCountDown = newNoteOffCountDown;
+  slideToNextNote  = newSlideToNextNote;
+  idle             = newIdle;
+  numHeldNotes     = newNumHeldNotes;
+  for(int i=0; i<numHeldNotes; i++)
+    heldNotes[i] = newHeldNotes[i];
+  setMainEnvDecay(newMainEnvDecay);
+  ampEnv.setRelease(newAmpRelease);
+
+  loadEmbeddedStates(reader);
+  return true;
+}
+
+void Open303::writeControlState(StateWriter& writer) const
+{
+  writeNoteVariables(writer);
+  ampEnv.saveState(writer);
+  mainEnv.saveState(writer);
+  pitchSlewLimiter.saveState(writer);
+  ampDeClicker.saveState(writer);
+  rc1.saveState(writer);
+  rc2.saveState(writer);
+  sequencer.saveState(writer);
+}
+
+void Open303::writeSettings(StateWriter& writer)
+{
+  // the active pattern - steps with closed gate don't play anything, so their content is
+  // irrelevant:
+  AcidPattern* pat = sequencer.getPattern(sequencer.getActivePattern());
+  writer.writeInt(sequencer.getSequencerMode());
+  writer.writeDouble(sequencer.getTempo());
+  writer.writeDouble(pat->getStepLength());
+  writer.writeInt(pat->getNumSteps());
+  for(int i=0; i<pat->getNumSteps(); i++)
+  {
+    writer.writeBool(pat->getGate(i));
+    if( pat->getGate(i) )
+    {
+      writer.writeInt(pat->getKey(i));
+      writer.writeInt(pat->getOctave(i));
+      writer.writeBool(pat->getAccent(i));
+      writer.writeBool(pat->getSlide(i));
+    }
+  }
+  for(int k=0; k<=12; k++)
+    writer.writeBool(sequencer.isKeyPermissible(k));
+
+  // the parameters:
+  writer.writeDouble(getSampleRate());
+  writer.writeDouble(getWaveform());
+  writer.writeDouble(getTuning());
+  writer.writeDouble(getCutoff());
+  writer.writeDouble(getResonance());
+  writer.writeDouble(getEnvMod());
+  writer.writeDouble(getDecay());
+  writer.writeDouble(getAccent());
+  writer.writeDouble(getVolume());
+  writer.writeDouble(getAmpSustain());
+  writer.writeDouble(getTanhShaperDrive());
+  writer.writeDouble(getTanhShaperOffset());
+  writer.writeDouble(getPreFilterHighpass());
+  writer.writeDouble(getFeedbackHighpass());
+  writer.writeDouble(getPostFilterHighpass());
+  writer.writeDouble(getSquarePhaseShift());
+  writer.writeDouble(getSlideTime());
+  writer.writeDouble(getNormalAttack());
+  writer.writeDouble(getAccentAttack());
+  writer.writeDouble(getAccentDecay());
+  writer.writeDouble(getAmpDecay());
+  writer.writeDouble(getAmpRelease());
+  writer.writeInt(unison.getNumLanes());
+  for(int l=0; l<unison.getNumLanes(); l++)
+  {
+    writer.writeDouble(unison.getLaneDetune(l));
+    writer.writeDouble(unison.getLaneStartPhase(l));
+    writer.writeDouble(unison.getLaneCutoffOffset(l));
+  }
+  writer.writeInt(getOscillatorEngine());
+  writer.writeInt(filter.getMode());
+  writer.writeDouble(filter.getDrive());
+}
+
+void Open303::writeState(StateWriter& writer) const
+{
+  writer.writeInt(stateMagic);
+  writer.writeInt(stateVersion);
+  writeNoteVariables(writer);
+  saveEmbeddedStates(writer);
+}
+
+void Open303::writeNoteVariables(StateWriter& writer) const
+{
+  // the note related variables, including those settings of the envelopes that depend on whether
+  // the current note is accented:
+  writer.writeDouble(oscFreq);
+  writer.writeDouble(pitchWheelFactor);
+  writer.writeDouble(accentGain);
+  writer.writeDouble(mainEnv.getDecayTimeConstant());
+  writer.writeDouble(ampEnv.getRelease());
+  writer.writeInt(currentNote);
+  writer.writeInt(noteOffCountDown);
+  writer.writeBool(slideToNextNote);
+  writer.writeBool(idle);
+  writer.writeInt(numHeldNotes);
+  for(int i=0; i<numHeldNotes; i++)
+  {
+    writer.writeInt(heldNotes[i].getKey());
+    writer.writeInt(heldNotes[i].getVelocity());
+  }
+}
+
+//-------------------------------------------------------------------------------------------------
+// audio processing:
+
+void Open303::processBlock(double* buffer, int numSamples)
+{
+  processBlock(buffer, numSamples, NULL);
+}
+
+void Open303::processBlock(double* buffer, int numSamples,
+                           const AutomationSpan* const* automation)
+{
+  RealTimeScope realTimeScope;
+  DenormalGuard denormalGuard; // cheap when the caller has already switched flushing on
+
+  bool automated[NUM_AUTOMATABLE_PARAMETERS];
+  bool anyAutomated = false;
+  for(int p=0; p<NUM_AUTOMATABLE_PARAMETERS; p++)
+  {
+    automated[p] = automation != NULL && automation[p] != NULL && !automation[p]->isEmpty();
+    anyAutomated = anyAutomated || automated[p];
+  }
+
+  if( idle && !anyAutomated )
+  {
+    for(int n=0; n<numSamples; n++)
+      buffer[n] = 0.0;
+    return;
+  }
+
+  // the values before the block, where the ramps to the first breakpoints start:
+  double previous[NUM_AUTOMATABLE_PARAMETERS];
+  previous[CUTOFF]    = getCutoff();
+  previous[RESONANCE] = getResonance();
+  previous[ENV_MOD]   = getEnvMod();
+  previous[ACCENT]    = getAccent();
+  previous[VOLUME]    = getVolume();
+  double resonance    = previous[RESONANCE]; // the value that was last passed to the filter
+
+  double ampEnvOut[maxBlockSize], gains[maxBlockSize];
+  double values[NUM_AUTOMATABLE_PARAMETERS][maxBlockSize];
+  double v[NUM_AUTOMATABLE_PARAMETERS];
+  int    p;
+  for(int start=0; start<numSamples; start+=maxBlockSize)
+  {
+    double* out = buffer + start;
+    int     n   = rmin(maxBlockSize, numSamples-start);
+
+    for(p=0; p<NUM_AUTOMATABLE_PARAMETERS; p++)
+    {
+      v[p] = 0.0;
+      if( automated[p] )
+      {
+        automation[p]->getValues(start, previous[p], values[p], n);
+        previous[p] = values[p][n-1];
+      }
+    }
+
+    if( idle )
+    {
+      // nothing to render, but the parameters have to end up at the automated values:
+      for(p=0; p<NUM_AUTOMATABLE_PARAMETERS; p++)
+        v[p] = previous[p];
+      applyAutomation(automated, v, &resonance);
+      for(int i=0; i<n; i++)
+        out[i] = 0.0;
+      continue;
+    }
+
+    profiler.beginSample();
+    if( anyAutomated )
+    {
+      for(int i=0; i<n; i++)
+      {
+        for(p=0; p<NUM_AUTOMATABLE_PARAMETERS; p++)
+        {
+          if( automated[p] )
+            v[p] = values[p][i];
+        }
+        applyAutomation(automated, v, &resonance);
+        gains[i] = ampScaler;
+        out[i]   = getDecimatedSample(&ampEnvOut[i]);
+      }
+    }
+    else
+    {
+      for(int i=0; i<n; i++)
+        out[i] = getDecimatedSample(&ampEnvOut[i]);
+    }
+
+    // the base rate filters run as block kernels over the chunk:
+    ampDeClicker.processBlock(ampEnvOut, ampEnvOut, n);
+    FilterCascade::processBlock(allpass, highpass2, notch, out, out, n);
+    if( anyAutomated )
+    {
+      for(int i=0; i<n; i++)
+      {
+        out[i] *= ampEnvOut[i];
+        out[i] *= gains[i];
+      }
+    }
+    else
+    {
+      for(int i=0; i<n; i++)
+      {
+        out[i] *= ampEnvOut[i];
+        out[i] *= ampScaler;
+      }
+    }
+    profiler.endStage(StageProfiler::POST_FILTERS);
+    profiler.endSample(n);
+  }
+}
+
+//------------------------------------------------------------------------------------------------------------
+// others:
+
+void Open303::noteOn(int noteNumber, int velocity)
+{
+  RealTimeScope realTimeScope;
+
+  if( sequencer.modeWasChanged() )
+    allNotesOff();
+
+  if( sequencer.getSequencerMode() != AcidSequencer::OFF )
+  {
+    if( velocity == 0 )
+    {
+      sequencer.stop();
+      releaseNote(currentNote);
+      currentNote = -1;
+    }
+    else
+    {
+      sequencer.start();
+      noteOffCountDown = std::numeric_limits<int>::max();
+      slideToNextNote  = false;
+      currentNote      = noteNumber;
+    }
+    idle = false;
+    return;
+  }
+
+  if( velocity == 0 ) // velocity zero indicates note-off events
+  {
+    MidiNoteEvent releasedNote(noteNumber, 0);
+    removeNote(releasedNote);
+    if( numHeldNotes == 0 )
+    {
+      currentNote = -1;
+    }
+    else
+    {
+      currentNote = heldNotes[numHeldNotes-1].getKey();
+    }
+    releaseNote(noteNumber);
+  }
+  else // velocity was not zero, so this is an actual note-on
+  {
+    // check if the note-list is empty (indicating that currently no note is playing) - if so,
+    // trigger a new note, otherwise, slide to the new note:
+    if( numHeldNotes == 0 )
+      triggerNote(noteNumber, velocity >= 100);
+    else
+      slideToNote(noteNumber, velocity >= 100);
+
+    currentNote = noteNumber;
+
+    // and we need to add the new note to our list, of course:
+    MidiNoteEvent newNote(noteNumber, velocity);
+    pushNote(newNote);
+  }
+  idle = false;
+}
+
+void Open303::allNotesOff()
+{
+  RealTimeScope realTimeScope;
+
+  numHeldNotes = 0;
+  ampEnv.noteOff();
+  currentNote = -1;
+}
+
+void Open303::triggerNote(int noteNumber, bool hasAccent)
+{
+  // retrigger osc and reset filter buffers only if amplitude is near zero (to avoid clicks):
+  if( idle )
+  {
+    oscillator.resetPhase();
+    filter.reset();
+    unison.resetPhases(oscillator);
+    unison.reset();
+    highpass1.reset();
+    highpass2.reset();
+    allpass.reset();
+    notch.reset();
+    antiAliasFilter.reset();
+    ampDeClicker.reset();
+  }
+
+  if( hasAccent )
+  {
+    accentGain = accent;
+    setMainEnvDecay(accentDecay);
+    ampEnv.setRelease(accentAmpRelease);
+  }
+  else
+  {
+    accentGain = 0.0;
+    setMainEnvDecay(normalDecay);
+    ampEnv.setRelease(normalAmpRelease);
+  }
+
+  oscFreq = pitchToFreq(noteNumber, tuning);
+  pitchSlewLimiter.setState(oscFreq);
+  mainEnv.trigger();
+  ampEnv.noteOn(true);
+  idle = false;
+}
+
+void Open303::slideToNote(int noteNumber, bool hasAccent)
+{
+  oscFreq = pitchToFreq(noteNumber, tuning);
+
+  if( hasAccent )
+  {
+    accentGain = accent;
+    setMainEnvDecay(accentDecay);
+    ampEnv.setRelease(accentAmpRelease);
+  }
+  else
+  {
+    accentGain = 0.0;
+    setMainEnvDecay(normalDecay);
+    ampEnv.setRelease(normalAmpRelease);
+  }
+  idle = false;
+}
+
+void Open303::releaseNote(int noteNumber)
+{
+  // check if the note-list is empty now. if so, trigger a release, otherwise slide to the note
+  // at the beginning of the list (this is the most recent one which is still in the list). this
+  // initiates a slide back to the most recent note that is still being held:
+  if( numHeldNotes == 0 )
+  {
+    ampEnv.noteOff();
+  }
+  else
+  {
+    // initiate slide back:
+    oscFreq     = pitchToFreq(currentNote);
+  }
+}
+
+void Open303::copyVariablesFrom(const Open303& other)
+{
+  tuning           = other.tuning;
+  ampScaler        = other.ampScaler;
+  oscFreq          = other.oscFreq;
+  sampleRate       = other.sampleRate;
+  level            = other.level;
+  levelByVel       = other.levelByVel;
+  accent           = other.accent;
+  slideTime        = other.slideTime;
+  cutoff           = other.cutoff;
+  envMod           = other.envMod;
+  envUpFraction    = other.envUpFraction;
+  envOffset        = other.envOffset;
+  envScaler        = other.envScaler;
+  normalAttack     = other.normalAttack;
+  accentAttack     = other.accentAttack;
+  normalDecay      = other.normalDecay;
+  accentDecay      = other.accentDecay;
+  normalAmpRelease = other.normalAmpRelease;
+  accentAmpRelease = other.accentAmpRelease;
+  accentGain       = other.accentGain;
+  pitchWheelFactor = other.pitchWheelFactor;
+  n1               = other.n1;
+  n2               = other.n2;
+  unisonDetune     = other.unisonDetune;
+  cutoffSpread     = other.cutoffSpread;
+  currentNote      = other.currentNote;
+  noteOffCountDown = other.noteOffCountDown;
+  slideToNextNote  = other.slideToNextNote;
+  idle             = other.idle;
+  numHeldNotes     = other.numHeldNotes;
+  for(int i=0; i<numHeldNotes; i++)
+    heldNotes[i] = other.heldNotes[i];
+}
+
+void Open303::pushNote(const MidiNoteEvent& note)
+{
+  // a key that is pressed again moves to the top of the stack (this is equivalent to keeping 
+  // duplicates, because releasing a key removes all of its entries):
+  removeNote(note);
+  if( numHeldNotes < maxNumHeldNotes )
+    heldNotes[numHeldNotes++] = note;
+}
+
+void Open303::removeNote(const MidiNoteEvent& note)
+{
+  int j = 0;
+  for(int i=0; i<numHeldNotes; i++)
+  {
+    if( !(heldNotes[i] == note) )
+      heldNotes[j++] = heldNotes[i];
+  }
+  numHeldNotes = j;
+}
+
+void Open303::saveEmbeddedStates(StateWriter& writer) const
+{
+  oscillator.saveState(writer);
+  filter.saveState(writer);
+  unison.saveState(writer);
+  ampEnv.saveState(writer);
+  mainEnv.saveState(writer);
+  pitchSlewLimiter.saveState(writer);
+  ampDeClicker.saveState(writer);
+  rc1.saveState(writer);
+  rc2.saveState(writer);
+  highpass1.saveState(writer);
+  highpass2.saveState(writer);
+  allpass.saveState(writer);
+  notch.saveState(writer);
+  antiAliasFilter.saveState(writer);
+  sequencer.saveState(writer);
+}
+
+void Open303::loadEmbeddedStates(StateReader& reader)
+{
+  oscillator.loadState(reader);
+  filter.loadState(reader);
+  unison.loadState(reader);
+  ampEnv.loadState(reader);
+  mainEnv.loadState(reader);
+  pitchSlewLimiter.loadState(reader);
+  ampDeClicker.loadState(reader);
+  rc1.loadState(reader);
+  rc2.loadState(reader);
+  highpass1.loadState(reader);
+  highpass2.loadState(reader);
+  allpass.loadState(reader);
+  notch.loadState(reader);
+  antiAliasFilter.loadState(reader);
+  sequencer.loadState(reader);
+}
+
+// advances the reader over the state of an embedded object that has no indices to check:
+template<class T>
+static void skipState(StateReader& reader, const T& object)
+{
+  StateWriter sizeCounter(NULL, 0);
+  object.saveState(sizeCounter);
+  reader.skip(sizeCounter.getNumBytesWritten());
+}
+
+bool Open303::areEmbeddedStatesValid(StateReader reader) const
+{
+  // in the same order as in saveEmbeddedStates:
+  bool valid = oscillator.isStateValid(reader);
+  skipState(reader, filter);
+  valid = unison.isStateValid(reader, oscillator) && valid;
+  skipState(reader, ampEnv);
+  skipState(reader, mainEnv);
+  skipState(reader, pitchSlewLimiter);
+  skipState(reader, ampDeClicker);
+  skipState(reader, rc1);
+  skipState(reader, rc2);
+  skipState(reader, highpass1);
+  skipState(reader, highpass2);
+  skipState(reader, allpass);
+  skipState(reader, notch);
+  skipState(reader, antiAliasFilter);
+  valid = sequencer.isStateValid(reader) && valid;
+  return valid && !reader.hasFailed() && reader.getNumBytesLeft() == 0;
+}
+
+void Open303::setMainEnvDecay(double newDecay)
+{
+  mainEnv.setDecayTimeConstant(newDecay);
+  updateNormalizer1();
+  updateNormalizer2();
+}
+
+void Open303::calculateEnvModScalerAndOffset()
+{
+  bool useMeasuredMapping = true; // might be shown as user parameter later
+  if( useMeasuredMapping == true )
+  {
+    // define some constants that arise from the measurements:
+    const double c0   = 3.138152786059267e+002;  // lowest nominal cutoff
+    const double c1   = 2.394411986817546e+003;  // highest nominal cutoff
+    const double oF   = 0.048292930943553;       // factor in line equation for offset
+    const double oC   = 0.294391201442418;       // constant in line equation for offset
+    const double sLoF = 3.773996325111173;       // factor in line eq. for scaler at low cutoff
+    const double sLoC = 0.736965594166206;       // constant in line eq. for scaler at low cutoff
+    const double sHiF = 4.194548788411135;       // factor in line eq. for scaler at high cutoff
+    const double sHiC = 0.864344900642434;       // constant in line eq. for scaler at high cutoff
+
+    // do the calculation of the scaler and offset:
+    double e   = linToLin(envMod, 0.0, 100.0, 0.0, 1.0);
+    double c   = expToLin(cutoff, c0,   c1,   0.0, 1.0);
+    double sLo = sLoF*e + sLoC;
+    double sHi = sHiF*e + sHiC;
+    envScaler  = (1-c)*sLo + c*sHi;
+    envOffset  =  oF*c + oC;
+  }
+  else
+  {
+    double upRatio   = pitchOffsetToFreqFactor(      envUpFraction *envMod);
+    double downRatio = pitchOffsetToFreqFactor(-(1.0-envUpFraction)*envMod);
+    envScaler        = upRatio - downRatio;
+    if( envScaler != 0.0 ) // avoid division by zero
+      envOffset = - (downRatio - 1.0) / (upRatio - downRatio);
+    else
+      envOffset = 0.0;
+  }
+}
+
+void Open303::updateNormalizer1()
+{
+  n1 = LeakyIntegrator::getNormalizer(mainEnv.getDecayTimeConstant(), rc1.getTimeConstant(),
+    sampleRate);
+  n1 = 1.0; // test
+}
+
+void Open303::updateNormalizer2()
+{
+  n2 = LeakyIntegrator::getNormalizer(mainEnv.getDecayTimeConstant(), rc2.getTimeConstant(),
+    sampleRate);
+  n2 = 1.0; // test
+}
+
+void Open303::applyAutomation(const bool* automated, const double* values, double* resonance)
+{
+  bool envMappingChanged = false;
+  if( automated[CUTOFF] && values[CUTOFF] != cutoff )
+  {
+    cutoff            = values[CUTOFF];
+    envMappingChanged = true;
+  }
+  if( automated[ENV_MOD] && values[ENV_MOD] != envMod )
+  {
+    envMod            = values[ENV_MOD];
+    envMappingChanged = true;
+  }
+  if( envMappingChanged )
+    calculateEnvModScalerAndOffset();
+
+  if( automated[RESONANCE] && values[RESONANCE] != *resonance )
+  {
+    *resonance = values[RESONANCE];
+    filter.setResonance(*resonance);
+  }
+
+  if( automated[ACCENT] )
+    accent = 0.01 * values[ACCENT];
+
+  if( automated[VOLUME] && values[VOLUME] != level )
+  {
+    level     = values[VOLUME];
+    ampScaler = dB2amp(level);
+  }
+}
+
+void Open303::updateUnisonSpreads()
+{
+  int numLanes = unison.getNumLanes();
+  for(int l=0; l<numLanes; l++)
+  {
+    double position = 0.0; // -1...+1 from the lowest to the highest lane
+    if( numLanes > 1 )
+      position = 2.0*l/(numLanes-1) - 1.0;
+    unison.setLaneDetune(      l, position*unisonDetune);
+    unison.setLaneCutoffOffset(l, position*cutoffSpread);
+  }
+}
@@ -1,414 +1,655 @@
-#ifndef rosic_Open303_h
-#define rosic_Open303_h
-
-#include "rosic_MidiNoteEvent.h"
-#include "rosic_BlendOscillator.h"
-#include "rosic_BiquadFilter.h"
-#include "rosic_TeeBeeFilter.h"
-#include "rosic_AnalogEnvelope.h"
-#include "rosic_DecayEnvelope.h"
-#include "rosic_LeakyIntegrator.h"
-#include "rosic_EllipticQuarterBandFilter.h"
-#include "rosic_AcidSequencer.h"
-
-#include <list>
-#include <limits>
-
-namespace rosic
-{
-
-  /**
-
-  This is a monophonic bass-synth that aims to emulate the sound of the famous Roland TB 303 and
-  goes a bit beyond.
-
-  */
-
-  class Open303
-  {
-
-  public:
-
-    //-----------------------------------------------------------------------------------------------
-    // construction/destruction:
-
-    /** Constructor. */
-    Open303();
-
-    /** Destructor. */
-    ~Open303();
-
-    //-----------------------------------------------------------------------------------------------
-    // parameter settings:
-
-    /** Sets the sample-rate (in Hz). */
-    void setSampleRate(double newSampleRate);
-
-    /** Sets up the waveform continuously between saw and square - the input should be in the range
-    0...1 where 0 means pure saw and 1 means pure square. */
-    void setWaveform(double newWaveform) { oscillator.setBlendFactor(newWaveform); }
-
-    /** Sets the master tuning frequency for note A4 (usually 440 Hz). */
-    void setTuning(double newTuning) { tuning = newTuning; }
-
-    /** Sets the filter's nominal cutoff frequency (in Hz). */
-    void setCutoff(double newCutoff);
-
-    /** Sets the resonance amount for the filter. */
-    void setResonance(double newResonance) { filter.setResonance(newResonance); }
-
-    /** Sets the modulation depth of the filter's cutoff frequency by the filter-envelope generator
-    (in percent). */
-    void setEnvMod(double newEnvMod);
-
-    /** Sets the main envelope's decay time for non-accented notes (in milliseconds).
-    Devil Fish provides range of 30...3000 ms for this parameter. On the normal 303, this
-    parameter had a range of 200...2000 ms.  */
-    void setDecay(double newDecay) { normalDecay = newDecay; }
-
-    /** Sets the accent (in percent).  */
-    void setAccent(double newAccent);
-
-    /** Sets the master volume level (in dB). */
-    void setVolume(double newVolume);
-
-    //  from here: parameter settings which were not available to the user in the 303:
-
-    /** Sets the amplitudes envelope's sustain level in decibels. Devil Fish uses the second half
-    of the range of the (amplitude) decay pot for this and lets the user adjust it between 0
-    and 100% of the full volume. In the normal 303, this parameter was fixed to zero. */
-    void setAmpSustain(double newAmpSustain) { ampEnv.setSustainInDecibels(newAmpSustain); }
-
-    /** Sets the drive (in dB) for the tanh-shaper for 303-square waveform - internal parameter, to
-    be scrapped eventually. */
-    void setTanhShaperDrive(double newDrive)
-    { waveTable2.setTanhShaperDriveFor303Square(newDrive); }
-
-    /** Sets the offset (as raw value for the tanh-shaper for 303-square waveform - internal
-    parameter, to be scrapped eventually. */
-    void setTanhShaperOffset(double newOffset)
-    { waveTable2.setTanhShaperOffsetFor303Square(newOffset); }
-
-    /** Sets the cutoff frequency for the highpass before the main filter. */
-    void setPreFilterHighpass(double newCutoff) { highpass1.setCutoff(newCutoff); }
-
-    /** Sets the cutoff frequency for the highpass inside the feedback loop of the main filter. */
-    void setFeedbackHighpass(double newCutoff) { filter.setFeedbackHighpassCutoff(newCutoff); }
-
-    /** Sets the cutoff frequency for the highpass after the main filter. */
-    void setPostFilterHighpass(double newCutoff) { highpass2.setCutoff(newCutoff); }
-
-    /** Sets the phase shift of tanh-shaped square wave with respect to the saw-wave (in degrees)
-    - this is important when the two are mixed. */
-    void setSquarePhaseShift(double newShift) { waveTable2.set303SquarePhaseShift(newShift); }
-
-    /** Sets the slide-time (in ms). The TB-303 had a slide time of 60 ms. */
-    void setSlideTime(double newSlideTime);
-
-    /** Sets the filter envelope's attack time for non-accented notes (in milliseconds).
-    Devil Fish provides range of 0.3...30 ms for this parameter. */
-    void setNormalAttack(double newNormalAttack)
-    {
-      normalAttack = newNormalAttack;
-      rc1.setTimeConstant(normalAttack);
-    }
-
-    /** Sets the filter envelope's attack time for accented notes (in milliseconds). In the
-    Devil Fish, accented notes have a fixed attack time of 3 ms.  */
-    void setAccentAttack(double newAccentAttack)
-    {
-      accentAttack = newAccentAttack;
-      rc2.setTimeConstant(accentAttack);
-    }
-
-    /** Sets the filter envelope's decay time for accented notes (in milliseconds).
-    Devil Fish provides range of 30...3000 ms for this parameter. On the normal 303, this
-    parameter was fixed to 200 ms.  */
-    void setAccentDecay(double newAccentDecay) { accentDecay = newAccentDecay; }
-
-    /** Sets the amplitudes envelope's decay time (in milliseconds). Devil Fish provides range of
-    16...3000 ms for this parameter. On the normal 303, this parameter was fixed to
-    approximately 3-4 seconds.  */
-    void setAmpDecay(double newAmpDecay) { ampEnv.setDecay(newAmpDecay); }
-
-    /** Sets the amplitudes envelope's release time (in milliseconds). On the normal 303, this
-    parameter was fixed to .....  */
-    void setAmpRelease(double newAmpRelease)
-    {
-      normalAmpRelease = newAmpRelease;
-      ampEnv.setRelease(newAmpRelease);
-    }
-
-    //-----------------------------------------------------------------------------------------------
-    // inquiry:
-
-    /** Returns the waveform as a continuous value between 0...1 where 0 means pure saw and 1 means
-    pure square. */
-    double getWaveform() const { return oscillator.getBlendFactor(); }
-
-    /** Sets the master tuning frequency for note A4 (usually 440 Hz). */
-    double getTuning() const { return tuning; }
-
-    /** Returns the filter's nominal cutoff frequency (in Hz). */
-    double getCutoff() const { return cutoff; }
-
-    /** Returns the filter's resonance amount (in percent) */
-    double getResonance() const { return filter.getResonance(); }
-
-    /** Returns the modulation depth of the filter's cutoff frequency by the filter-envelope
-    generator (in percent). */
-    double getEnvMod() const { return envMod; }
-
-    /** Returns the filter envelope's decay time for non-accented notes (in milliseconds). */
-    double getDecay() const { return normalDecay; }
-
-    /** Returns the accent (in percent). */
-    double getAccent() const { return 100.0 * accent; }
-
-    /** Returns the master volume level (in dB). */
-    double getVolume() const { return level; }
-
-    //  from here: parameters which were not available to the user in the 303:
-
-    /** Returns the amplitudes envelope's sustain level (in dB). */
-    double getAmpSustain() const { return amp2dB(ampEnv.getSustain()); }
-
-    /** Returns the drive (in dB) for the tanh-shaper for 303-square waveform - internal parameter,
-    to be scrapped eventually. */
-    double getTanhShaperDrive() const
-    { return waveTable2.getTanhShaperDriveFor303Square(); }
-
-    /** Returns the offset (as raw value for the tanh-shaper for 303-square waveform - internal
-    parameter, to be scrapped eventually. */
-    double getTanhShaperOffset() const
-    { return waveTable2.getTanhShaperOffsetFor303Square(); }
-
-    /** Returns the cutoff frequency for the highpass before the main filter. */
-    double getPreFilterHighpass() const { return highpass1.getCutoff(); }
-
-    /** Retruns the cutoff frequency for the highpass inside the feedback loop of the main
-    filter. */
-    double getFeedbackHighpass() const { return filter.getFeedbackHighpassCutoff(); }
-
-    /** Returns the cutoff frequency for the highpass after the main filter. */
-    double getPostFilterHighpass() const { return highpass2.getCutoff(); }
-
-    /** Returns the phase shift of tanh-shaped square wave with respect to the saw-wave (in degrees)
-    - this is important when the two are mixed. */
-    double getSquarePhaseShift() const { return waveTable2.get303SquarePhaseShift(); }
-
-    /** Returns the slide-time (in ms). */
-    double getSlideTime() const { return slideTime; }
-
-    /** Returns the filter envelope's attack time for non-accented notes (in milliseconds). */
-    double getNormalAttack() const { return normalAttack; }
-
-    /** Returns the filter envelope's attack time for non-accented notes (in milliseconds). */
-    double getAccentAttack() const { return accentAttack; }
-
-    /** Returns the filter envelope's decay time for non-accented notes (in milliseconds). */
-    double getAccentDecay() const { return accentDecay; }
-
-    /** Returns the amplitudes envelope's decay time (in milliseconds). */
-    double getAmpDecay() const { return ampEnv.getDecay(); }
-
-    /** Returns the amplitudes envelope's release time (in milliseconds). */
-    double getAmpRelease() const { return normalAmpRelease; }
-
-    //-----------------------------------------------------------------------------------------------
-    // audio processing:
-
-    /** Calculates onse output sample at a time. */
-    double getSample();
-
-    //-----------------------------------------------------------------------------------------------
-    // event handling:
-
-    /** Accepts note-on events (note offs are also handled here as note ons with velocity zero). */
-    void noteOn(int noteNumber, int velocity);
-
-    /** Turns all possibly running notes off. */
-    void allNotesOff();
-
-    /** Sets the pitchbend value in semitones. */
-    void setPitchBend(double newPitchBend);
-
-    //-----------------------------------------------------------------------------------------------
-    // embedded objects:
-
-    MipMappedWaveTable        waveTable1, waveTable2;
-    BlendOscillator           oscillator;
-    TeeBeeFilter              filter;
-    AnalogEnvelope            ampEnv;
-    DecayEnvelope             mainEnv;
-    LeakyIntegrator           pitchSlewLimiter;
-    //LeakyIntegrator           ampDeClicker;
-    BiquadFilter              ampDeClicker;
-    LeakyIntegrator           rc1, rc2;
-    OnePoleFilter             highpass1, highpass2, allpass;
-    BiquadFilter              notch;
-    EllipticQuarterBandFilter antiAliasFilter;
-    AcidSequencer             sequencer;
-
-
-    //update: expose these methods to expand sequencing possibilities
-
-    /** Triggers a note (called either directly in noteOn or in getSample when the sequencer is
-    used). */
-    void triggerNote(int noteNumber, bool hasAccent);
-
-    /** Slides to a note (called either directly in noteOn or in getSample when the sequencer is
-    used). */
-    void slideToNote(int noteNumber, bool hasAccent);
-
-    /** Releases a note (called either directly in noteOn or in getSample when the sequencer is
-    used). */
-    void releaseNote(int noteNumber);
-
-  protected:
-
-    /** Sets the decay-time of the main envelope and updates the normalizers n1, n2 accordingly. */
-    void setMainEnvDecay(double newDecay);
-
-    void calculateEnvModScalerAndOffset();
-
-    /** Updates the normalizer n1 according to the time-constant of rc1 and the decay-time of the
-    main envelope generator. */
-    void updateNormalizer1();
-
-    /** Updates the normalizer n2 according to the time-constant of rc2 and the decay-time of the
-    main envelope generator. */
-    void updateNormalizer2();
-
-    static const int oversampling = 4;
-
-    double tuning;           // master tunung for A4 in Hz
-    double ampScaler;        // final volume as raw factor
-    double oscFreq;          // frequecy of the oscillator (without pitchbend)
-    double sampleRate;       // the (non-oversampled) sample rate
-    double level;            // master volume level (in dB)
-    double levelByVel;       // velocity dependence of the level (in dB)
-    double accent;           // scales all "byVel" parameters
-    double slideTime;        // the time to slide from one note to another (in ms)
-    double cutoff;           // nominal cutoff frequency of the filter
-    double envMod;           // strength of the envelope modulation in percent
-    double envUpFraction;    // fraction of the envelope that goes upward
-    double envOffset;        // offset for the normalized envelope ('bipolarity' parameter)
-    double envScaler;        // scale-factor for the normalized envelope (derived from envMod)
-    double normalAttack;     // attack time for the filter envelope on non-accented notes
-    double accentAttack;     // attack time for the filter envelope on accented notes
-    double normalDecay;      // decay time for the filter envelope on non-accented notes
-    double accentDecay;      // decay time for the filter envelope on accented notes
-    double normalAmpRelease; // amp-env release time for non-accented notes
-    double accentAmpRelease; // amp-env release time for accented notes
-    double accentGain;       // between 0.0...1.0 - to scale the 3rd amp-envelope on accents
-    double pitchWheelFactor; // scale factor for oscillator frequency from pitch-wheel
-    double n1, n2;           // normalizers for the RCs that are driven by the MEG
-    int    currentNote;      // note which is currently played (-1 if none)
-    int    noteOffCountDown; // a countdown variable till next note-off in sequencer mode
-    bool   slideToNextNote;  // indicate that we need to slide to the next note in sequencer mode
-    bool   idle;             // flag to indicate that we have currently nothing to do in getSample
-
-    std::list<MidiNoteEvent> noteList;
-
-  };
-
-  //-------------------------------------------------------------------------------------------------
-  // inlined functions:
-
-  inline double Open303::getSample()
-  {
-    //if( sequencer.getSequencerMode() == AcidSequencer::OFF && ampEnv.endIsReached() )
-    //  return 0.0;
-    if( idle )
-      return 0.0;
-
-    // check the sequencer if we have some note to trigger:
-    if( sequencer.getSequencerMode() != AcidSequencer::OFF )
-    {
-      noteOffCountDown--;
-      if( noteOffCountDown == 0 || sequencer.isRunning() == false )
-        releaseNote(currentNote);
-
-      AcidNote *note = sequencer.getNote();
-      if( note != NULL )
-      {
-        if( note->gate == true && currentNote != -1)
-        {
-          int key = note->key + 12*note->octave + currentNote;
-          key = clip(key, 0, 127);
-
-          if( !slideToNextNote )
-            triggerNote(key, note->accent);
-          else
-            slideToNote(key, note->accent);
-
-          AcidNote* nextNote = sequencer.getNextScheduledNote();
-          if( note->slide && nextNote->gate == true )
-          {
-            noteOffCountDown = std::numeric_limits<int>::max();
-            slideToNextNote  = true;
-          }
-          else
-          {
-            noteOffCountDown = sequencer.getStepLengthInSamples();
-            slideToNextNote  = false;
-          }
-        }
-      }
-    }
-
-    // calculate instantaneous oscillator frequency and set up the oscillator:
-    double instFreq = pitchSlewLimiter.getSample(oscFreq);
-    oscillator.setFrequency(instFreq*pitchWheelFactor);
-    oscillator.calculateIncrement();
-
-    // calculate instantaneous cutoff frequency from the nominal cutoff and all its modifiers and
-    // set up the filter:
-    double mainEnvOut = mainEnv.getSample();
-    double tmp1       = n1 * rc1.getSample(mainEnvOut);
-    double tmp2       = 0.0;
-    if( accentGain > 0.0 )
-      tmp2 = mainEnvOut;
-    tmp2 = n2 * rc2.getSample(tmp2);
-    tmp1 = envScaler * ( tmp1 - envOffset );  // seems not to work yet
-    tmp2 = accentGain*tmp2;
-    double instCutoff = cutoff * pow(2.0, tmp1+tmp2);
-    filter.setCutoff(instCutoff);
-
-    double ampEnvOut = ampEnv.getSample();
-    //ampEnvOut += 0.45*filterEnvOut + accentGain*6.8*filterEnvOut;
-    if( ampEnv.isNoteOn() )
-      ampEnvOut += (0.45 + 4 * accentGain) * mainEnvOut;
-    ampEnvOut = ampDeClicker.getSample(ampEnvOut);
-
-    // oversampled calculations:
-    double tmp;
-    for(int i=1; i<=oversampling; i++)
-    {
-      tmp  = -oscillator.getSample();         // the raw oscillator signal
-      tmp  = highpass1.getSample(tmp);        // pre-filter highpass
-      tmp  = filter.getSample(tmp);           // now it's filtered
-      tmp  = antiAliasFilter.getSample(tmp);  // anti-aliasing filtered
-
-    }
-
-    // these filters may actually operate without oversampling (but only if we reset them in
-    // triggerNote - avoid clicks)
-    tmp  = allpass.getSample(tmp);
-    tmp  = highpass2.getSample(tmp);
-    tmp  = notch.getSample(tmp);
-    tmp *= ampEnvOut;                       // amplified
-    tmp *= ampScaler;
-
-    // find out whether we may switch ourselves off for the next call:
-    idle = false;
-    //idle = (sequencer.getSequencerMode() == AcidSequencer::OFF && ampEnv.endIsReached()
-    //        && fabs(tmp) < 0.000001); // ampEnvOut < 0.000001;
-
-    return tmp;
-  }
-
-}
-
-#endif
+#ifndef rosic_Open303_h
+#define rosic_Open303_h
+
+#include "rosic_MidiNoteEvent.h"
+#include "rosic_BlendOscillator.h"
+#include "rosic_FilterCascade.h"
+#include "rosic_TeeBeeFilter.h"
+#include "rosic_UnisonLanes.h"
+#include "rosic_AutomationSpan.h"
+#include "rosic_AnalogEnvelope.h"
+#include "rosic_DecayEnvelope.h"
+#include "rosic_LeakyIntegrator.h"
+#include "rosic_EllipticQuarterBandFilter.h"
+#include "rosic_AcidSequencer.h"
+#include "rosic_StageProfiler.h"
+#include "rosic_RealTimeScope.h"
+#include "rosic_DenormalGuard.h"
+#include "rosic_FastMath.h"
+
+#include <limits>
+
+namespace rosic
+{
+
+  /**
+
+  This is a monophonic bass-synth that aims to emulate the sound of the famous Roland TB 303 and
+  goes a bit beyond.
+
+  */
+
+  class Open303
+  {
+
+  public:
+
+    /** Enumeration of the parameters that can be automated sample accurately in processBlock. */
+    enum automatableParameters
+    {
+      CUTOFF = 0,
+      RESONANCE,
+      ENV_MOD,
+      ACCENT,
+      VOLUME,
+
+      NUM_AUTOMATABLE_PARAMETERS
+    };
+
+    //-----------------------------------------------------------------------------------------------
+    // construction/destruction:
+
+    /** Constructor. */
+    Open303();
+
+    /** Copy constructor. Creates an independent clone with the same parameters and the same
+    runtime state, such that it will produce the same output as the original from here on. The
+    oscillator of the clone is re-connected to the clone's own wavetables. */
+    Open303(const Open303& other);
+
+    /** Destructor. */
+    ~Open303();
+
+    /** Assignment operator. @see Open303(const Open303&) */
+    Open303& operator=(const Open303& other);
+
+    //-----------------------------------------------------------------------------------------------
+    // parameter settings:
+
+    /** Sets the sample-rate (in Hz). */
+    void setSampleRate(double newSampleRate);
+
+    /** Sets up the waveform continuously between saw and square - the input should be in the range
+    0...1 where 0 means pure saw and 1 means pure square. */
+    void setWaveform(double newWaveform) { oscillator.setBlendFactor(newWaveform); }
+
+    /** Sets the master tuning frequency for note A4 (usually 440 Hz). */
+    void setTuning(double newTuning) { tuning = newTuning; }
+
+    /** Sets the filter's nominal cutoff frequency (in Hz). */
+    void setCutoff(double newCutoff);
+
+    /** Sets the resonance amount for the filter. */
+    void setResonance(double newResonance) { filter.setResonance(newResonance); }
+
+    /** Sets the modulation depth of the filter's cutoff frequency by the filter-envelope generator
+    (in percent). */
+    void setEnvMod(double newEnvMod);
+
+    /** Sets the main envelope's decay time for non-accented notes (in milliseconds).
+    Devil Fish provides range of 30...3000 ms for this parameter. On the normal 303, this
+    parameter had a range of 200...2000 ms.  */
+    void setDecay(double newDecay) { normalDecay = newDecay; }
+
+    /** Sets the accent (in percent).  */
+    void setAccent(double newAccent);
+
+    /** Sets the master volume level (in dB). */
+    void setVolume(double newVolume);
+
+    //  from here: parameter settings which were not available to the user in the 303:
+
+    /** Sets the amplitudes envelope's sustain level in decibels. Devil Fish uses the second half
+    of the range of the (amplitude) decay pot for this and lets the user adjust it between 0
+    and 100% of the full volume. In the normal 303, this parameter was fixed to zero. */
+    void setAmpSustain(double newAmpSustain) { ampEnv.setSustainInDecibels(newAmpSustain); }
+
+    /** Sets the drive (in dB) for the tanh-shaper for 303-square waveform - internal parameter, to
+    be scrapped eventually. */
+    void setTanhShaperDrive(double newDrive)
+    {
+      waveTable2.setTanhShaperDriveFor303Square(newDrive);
+      oscillator.setTanhShaperDriveFor303Square(newDrive);
+    }
+
+    /** Sets the offset (as raw value for the tanh-shaper for 303-square waveform - internal
+    parameter, to be scrapped eventually. */
+    void setTanhShaperOffset(double newOffset)
+    {
+      waveTable2.setTanhShaperOffsetFor303Square(newOffset);
+      oscillator.setTanhShaperOffsetFor303Square(newOffset);
+    }
+
+    /** Sets the cutoff frequency for the highpass before the main filter. */
+    void setPreFilterHighpass(double newCutoff) { highpass1.setCutoff(newCutoff); }
+
+    /** Sets the cutoff frequency for the highpass inside the feedback loop of the main filter. */
+    void setFeedbackHighpass(double newCutoff) { filter.setFeedbackHighpassCutoff(newCutoff); }
+
+    /** Sets the cutoff frequency for the highpass after the main filter. */
+    void setPostFilterHighpass(double newCutoff) { highpass2.setCutoff(newCutoff); }
+
+    /** Sets the phase shift of tanh-shaped square wave with respect to the saw-wave (in degrees)
+    - this is important when the two are mixed. */
+    void setSquarePhaseShift(double newShift)
+    {
+      waveTable2.set303SquarePhaseShift(newShift);
+      oscillator.set303SquarePhaseShift(newShift);
+    }
+
+    /** Chooses the oscillator engine as one of the values in BlendOscillator::engines. The
+    POLYBLEP engine synthesizes the waveforms analytically such that the wavetables are neither
+    rendered nor read (they are still kept for switching back to the WAVETABLE engine). The
+    PREBLENDED engine reads a single table that holds the blend of saw and square, as long as the
+    waveform knob doesn't move. */
+    void setOscillatorEngine(int newEngine) { oscillator.setEngine(newEngine); }
+
+    /** Sets the number of unison lanes (1...UnisonLanes::maxNumLanes). With more than one lane,
+    oscillator, pre-filter highpass and filter are rendered once per lane (with the detune and
+    cutoff spreads below), whereas the sequencer, the envelopes and the cutoff modulation are
+    shared by the lanes. The lanes only emulate the TB_303 mode of the filter - in the other modes,
+    a single voice is rendered through the filter (the number of lanes is kept for switching back
+    to TB_303). @see UnisonLanes */
+    void setNumUnisonLanes(int newNumLanes);
+
+    /** Sets the detune of the outermost unison lanes (in cents) - the lanes are spread evenly
+    between -newDetune and +newDetune. */
+    void setUnisonDetune(double newDetune);
+
+    /** Sets the cutoff offset of the outermost unison lanes (in semitones) - the lanes are spread
+    evenly between -newSpread and +newSpread. */
+    void setUnisonCutoffSpread(double newSpread);
+
+    /** Sets the slide-time (in ms). The TB-303 had a slide time of 60 ms. */
+    void setSlideTime(double newSlideTime);
+
+    /** Sets the filter envelope's attack time for non-accented notes (in milliseconds).
+    Devil Fish provides range of 0.3...30 ms for this parameter. */
+    void setNormalAttack(double newNormalAttack)
+    {
+      normalAttack = newNormalAttack;
+      rc1.setTimeConstant(normalAttack);
+    }
+
+    /** Sets the filter envelope's attack time for accented notes (in milliseconds). In the
+    Devil Fish, accented notes have a fixed attack time of 3 ms.  */
+    void setAccentAttack(double newAccentAttack)
+    {
+      accentAttack = newAccentAttack;
+      rc2.setTimeConstant(accentAttack);
+    }
+
+    /** Sets the filter envelope's decay time for accented notes (in milliseconds).
+    Devil Fish provides range of 30...3000 ms for this parameter. On the normal 303, this
+    parameter was fixed to 200 ms.  */
+    void setAccentDecay(double newAccentDecay) { accentDecay = newAccentDecay; }
+
+    /** Sets the amplitudes envelope's decay time (in milliseconds). Devil Fish provides range of
+    16...3000 ms for this parameter. On the normal 303, this parameter was fixed to
+    approximately 3-4 seconds.  */
+    void setAmpDecay(double newAmpDecay) { ampEnv.setDecay(newAmpDecay); }
+
+    /** Sets the amplitudes envelope's release time (in milliseconds). On the normal 303, this
+    parameter was fixed to .....  */
+    void setAmpRelease(double newAmpRelease)
+    {
+      normalAmpRelease = newAmpRelease;
+      ampEnv.setRelease(newAmpRelease);
+    }
+
+    //-----------------------------------------------------------------------------------------------
+    // inquiry:
+
+    /** Returns the sample-rate (in Hz). */
+    double getSampleRate() const { return sampleRate; }
+
+    /** Returns the waveform as a continuous value between 0...1 where 0 means pure saw and 1 means
+    pure square. */
+    double getWaveform() const { return oscillator.getBlendFactor(); }
+
+    /** Sets the master tuning frequency for note A4 (usually 440 Hz). */
+    double getTuning() const { return tuning; }
+
+    /** Returns the filter's nominal cutoff frequency (in Hz). */
+    double getCutoff() const { return cutoff; }
+
+    /** Returns the filter's resonance amount (in percent) */
+    double getResonance() const { return filter.getResonance(); }
+
+    /** Returns the modulation depth of the filter's cutoff frequency by the filter-envelope
+    generator (in percent). */
+    double getEnvMod() const { return envMod; }
+
+    /** Returns the filter envelope's decay time for non-accented notes (in milliseconds). */
+    double getDecay() const { return normalDecay; }
+
+    /** Returns the accent (in percent). */
+    double getAccent() const { return 100.0 * accent; }
+
+    /** Returns the master volume level (in dB). */
+    double getVolume() const { return level; }
+
+    //  from here: parameters which were not available to the user in the 303:
+
+    /** Returns the amplitudes envelope's sustain level (in dB). */
+    double getAmpSustain() const { return amp2dB(ampEnv.getSustain()); }
+
+    /** Returns the drive (in dB) for the tanh-shaper for 303-square waveform - internal parameter,
+    to be scrapped eventually. */
+    double getTanhShaperDrive() const
+    { return waveTable2.getTanhShaperDriveFor303Square(); }
+
+    /** Returns the offset (as raw value for the tanh-shaper for 303-square waveform - internal
+    parameter, to be scrapped eventually. */
+    double getTanhShaperOffset() const
+    { return waveTable2.getTanhShaperOffsetFor303Square(); }
+
+    /** Returns the cutoff frequency for the highpass before the main filter. */
+    double getPreFilterHighpass() const { return highpass1.getCutoff(); }
+
+    /** Retruns the cutoff frequency for the highpass inside the feedback loop of the main
+    filter. */
+    double getFeedbackHighpass() const { return filter.getFeedbackHighpassCutoff(); }
+
+    /** Returns the cutoff frequency for the highpass after the main filter. */
+    double getPostFilterHighpass() const { return highpass2.getCutoff(); }
+
+    /** Returns the phase shift of tanh-shaped square wave with respect to the saw-wave (in degrees)
+    - this is important when the two are mixed. */
+    double getSquarePhaseShift() const { return waveTable2.get303SquarePhaseShift(); }
+
+    /** Returns the oscillator engine. @see setOscillatorEngine */
+    int getOscillatorEngine() const { return oscillator.getEngine(); }
+
+    /** Returns the number of unison lanes. */
+    int getNumUnisonLanes() const { return unison.getNumLanes(); }
+
+    /** Returns the detune of the outermost unison lanes (in cents). */
+    double getUnisonDetune() const { return unisonDetune; }
+
+    /** Returns the cutoff offset of the outermost unison lanes (in semitones). */
+    double getUnisonCutoffSpread() const { return cutoffSpread; }
+
+    /** Returns the slide-time (in ms). */
+    double getSlideTime() const { return slideTime; }
+
+    /** Returns the filter envelope's attack time for non-accented notes (in milliseconds). */
+    double getNormalAttack() const { return normalAttack; }
+
+    /** Returns the filter envelope's attack time for non-accented notes (in milliseconds). */
+    double getAccentAttack() const { return accentAttack; }
+
+    /** Returns the filter envelope's decay time for non-accented notes (in milliseconds). */
+    double getAccentDecay() const { return accentDecay; }
+
+    /** Returns the amplitudes envelope's decay time (in milliseconds). */
+    double getAmpDecay() const { return ampEnv.getDecay(); }
+
+    /** Returns the amplitudes envelope's release time (in milliseconds). */
+    double getAmpRelease() const { return normalAmpRelease; }
+
+    /** Returns true as long as no note has been triggered yet - the synth produces silence then,
+    and the sequencer doesn't advance. */
+    bool isIdle() const { return idle; }
+
+    //-----------------------------------------------------------------------------------------------
+    // audio processing:
+
+    /** Calculates onse output sample at a time. Denormals are flushed to zero during the call (via
+    a DenormalGuard, which is cheap when the caller holds one around its loop already). */
+    double getSample();
+
+    /** Renders a block of output samples - the result is the same as calling getSample for each
+    sample, but the base rate filters after the oversampled section (the amplitude declicker and
+    the allpass -> highpass -> notch chain) run as block kernels over the whole block. Denormals
+    are flushed to zero during the call (via a DenormalGuard). Events (noteOn, etc.) are supposed
+    to be sent in between the calls, so hosts split their buffers at the event positions. */
+    void processBlock(double* buffer, int numSamples);
+
+    /** Renders a block of output samples with sample accurate automation of the parameters in
+    automatableParameters. The automation array has an entry for each of these (indexed by the
+    enum) and each entry may be NULL or an empty span, in which case the parameter isn't automated.
+    The values of the spans are in the units of the corresponding setters (setCutoff, etc.). The
+    result is the same as splitting the block into single samples and calling the setters in
+    between, but the values are applied directly in the render loop (and only when they change).
+    After the call, the parameters have the values of the last sample. */
+    void processBlock(double* buffer, int numSamples, const AutomationSpan* const* automation);
+
+    //-----------------------------------------------------------------------------------------------
+    // event handling:
+
+    /** Accepts note-on events (note offs are also handled here as note ons with velocity zero). */
+    void noteOn(int noteNumber, int velocity);
+
+    /** Turns all possibly running notes off. */
+    void allNotesOff();
+
+    /** Sets the pitchbend value in semitones. */
+    void setPitchBend(double newPitchBend);
+
+    //-----------------------------------------------------------------------------------------------
+    // others:
+
+    /** Commits pending changes of the waveform parameters (tanh-shaper drive and offset, square
+    phase shift, pulse width) by re-rendering the dirty wavetables at most once each. This happens
+    lazily in getSample anyway, but hosts may call it explicitly after loading a preset to keep the
+    rendering out of the audio thread. */
+    void updateWaveTables() { oscillator.updateWaveTables(); }
+
+    //-----------------------------------------------------------------------------------------------
+    // state persistence:
+
+    /** Returns the number of bytes that saveState() needs for the current state. */
+    int getStateSize() const;
+
+    /** Returns the number of bytes that saveState() needs at most, i.e. for the current state with
+    the maximum number of held notes. */
+    int getMaxStateSize() const;
+
+    /** Writes the complete runtime state of the synth into the buffer in a compact, versioned 
+    binary format. This includes the filter histories, oscillator phase, envelopes, slew limiter,
+    sequencer position and held notes, but not the parameters (which the host is supposed to 
+    restore via the setters). Returns the number of bytes written or 0 when the buffer is too 
+    small. */
+    int saveState(unsigned char* buffer, int bufferSize) const;
+
+    /** Restores the runtime state from a buffer that was filled by saveState(). An instance with
+    the same parameter settings will then continue to produce exactly the same output as the one
+    from which the state was saved. Returns false (and leaves the state untouched) when the data
+    is invalid or stems from an incompatible version. */
+    bool loadState(const unsigned char* buffer, int numBytes);
+
+    /** Writes the part of the runtime state that evolves at control rate into the stream: the note
+    related variables, held notes, envelopes, slew limiter, RCs, declicker and the sequencer
+    position. The audio rate states (oscillator phase, filter histories) are left out. This can't
+    be read back - it's meant to be compared with an earlier control state to find out whether the
+    synth has reached a steady state (@see StateWriter::setReference). */
+    void writeControlState(StateWriter& writer) const;
+
+    /** Writes all settings that determine the output for a given runtime state into the stream:
+    the active pattern (without the content of the steps with closed gate), the sequencer mode and
+    tempo, the permissible keys, the user parameters and the settings of the embedded objects that
+    are set directly (like the filter's mode). This can't be read back either - it's meant for
+    detecting changes by comparing or hashing the data. */
+    void writeSettings(StateWriter& writer);
+
+    //-----------------------------------------------------------------------------------------------
+    // embedded objects:
+
+    MipMappedWaveTable        waveTable1, waveTable2, blendedWaveTable;
+    BlendOscillator           oscillator;
+    TeeBeeFilter              filter;
+    UnisonLanes               unison;
+    AnalogEnvelope            ampEnv;
+    DecayEnvelope             mainEnv;
+    LeakyIntegrator           pitchSlewLimiter;
+    //LeakyIntegrator           ampDeClicker;
+    BiquadFilter              ampDeClicker;
+    LeakyIntegrator           rc1, rc2;
+    OnePoleFilter             highpass1, highpass2, allpass;
+    BiquadFilter              notch;
+    EllipticQuarterBandFilter antiAliasFilter;
+    AcidSequencer             sequencer;
+
+    /** Accumulates the time spent in the processing stages of getSample - this is compiled to
+    nothing unless OPEN303_PROFILE_STAGES is defined. Other threads may poll the statistics via
+    profiler.getSnapshot(). */
+    StageProfiler             profiler;
+
+
+    //update: expose these methods to expand sequencing possibilities
+
+    /** Triggers a note (called either directly in noteOn or in getSample when the sequencer is
+    used). */
+    void triggerNote(int noteNumber, bool hasAccent);
+
+    /** Slides to a note (called either directly in noteOn or in getSample when the sequencer is
+    used). */
+    void slideToNote(int noteNumber, bool hasAccent);
+
+    /** Releases a note (called either directly in noteOn or in getSample when the sequencer is
+    used). */
+    void releaseNote(int noteNumber);
+
+  protected:
+
+    /** Sets the decay-time of the main envelope and updates the normalizers n1, n2 accordingly. */
+    void setMainEnvDecay(double newDecay);
+
+    void calculateEnvModScalerAndOffset();
+
+    /** Updates the normalizer n1 according to the time-constant of rc1 and the decay-time of the
+    main envelope generator. */
+    void updateNormalizer1();
+
+    /** Updates the normalizer n2 according to the time-constant of rc2 and the decay-time of the
+    main envelope generator. */
+    void updateNormalizer2();
+
+    /** Applies the values of the automated parameters (as indicated by the automated array) for
+    one sample, doing only the computations for those that have changed. The resonance is tracked
+    in the passed variable because the filter doesn't store it as is. */
+    void applyAutomation(const bool* automated, const double* values, double* resonance);
+
+    /** Sets up the detunes and cutoff offsets of the unison lanes according to the spreads. */
+    void updateUnisonSpreads();
+
+    /** Returns true when the voice is rendered by the unison lanes - that requires more than one
+    lane and the TB_303 mode of the filter (the only one the lanes emulate). */
+    bool isUnisonActive() const
+    {
+      return unison.getNumLanes() > 1 && filter.getMode() == TeeBeeFilter::TB_303;
+    }
+
+    /** Writes the header, our own note related variables and the states of the embedded objects
+    into the stream. */
+    void writeState(StateWriter& writer) const;
+
+    /** Writes our own note related variables (including the held notes) into the stream. */
+    void writeNoteVariables(StateWriter& writer) const;
+
+    /** Writes the states of the embedded objects into the stream. */
+    void saveEmbeddedStates(StateWriter& writer) const;
+
+    /** Reads the states of the embedded objects from the stream. */
+    void loadEmbeddedStates(StateReader& reader);
+
+    /** Returns true when the states of the embedded objects in the stream can be loaded, i.e. when
+    the indices in them (sequencer step, oscillator phases) are in range. The reader is passed by
+    value, so the caller's read position stays where it is. */
+    bool areEmbeddedStatesValid(StateReader reader) const;
+
+    /** Copies our own (non-object) member variables from another instance - used by the copy
+    constructor and assignment operator. */
+    void copyVariablesFrom(const Open303& other);
+
+    /** Puts a note on top of the stack of held notes (removing an older entry for the same key, if
+    any). */
+    void pushNote(const MidiNoteEvent& note);
+
+    /** Removes all entries for the key of the given note from the stack of held notes. */
+    void removeNote(const MidiNoteEvent& note);
+
+    /** Runs the per-sample part of getSample (sequencer, envelopes and the oversampled section
+    with oscillator, filter and decimator) and returns the signal before the post-filters. The
+    raw amplitude envelope (before the declicker) is returned in ampEnvOut. */
+    INLINE double getDecimatedSample(double* ampEnvOut);
+
+    static const int oversampling = 4;
+    static const int maxBlockSize    = 64; // processBlock works on chunks of at most this size
+    static const int maxNumHeldNotes = 128; // one for each MIDI key
+    static const int stateMagic      = 0x33303353; // 'S303' - identifies our state data
+    static const int stateVersion    = 3;          // increment when the state format changes
+
+    double tuning;           // master tunung for A4 in Hz
+    double ampScaler;        // final volume as raw factor
+    double oscFreq;          // frequecy of the oscillator (without pitchbend)
+    double sampleRate;       // the (non-oversampled) sample rate
+    double level;            // master volume level (in dB)
+    double levelByVel;       // velocity dependence of the level (in dB)
+    double accent;           // scales all "byVel" parameters
+    double slideTime;        // the time to slide from one note to another (in ms)
+    double cutoff;           // nominal cutoff frequency of the filter
+    double envMod;           // strength of the envelope modulation in percent
+    double envUpFraction;    // fraction of the envelope that goes upward
+    double envOffset;        // offset for the normalized envelope ('bipolarity' parameter)
+    double envScaler;        // scale-factor for the normalized envelope (derived from envMod)
+    double normalAttack;     // attack time for the filter envelope on non-accented notes
+    double accentAttack;     // attack time for the filter envelope on accented notes
+    double normalDecay;      // decay time for the filter envelope on non-accented notes
+    double accentDecay;      // decay time for the filter envelope on accented notes
+    double normalAmpRelease; // amp-env release time for non-accented notes
+    double accentAmpRelease; // amp-env release time for accented notes
+    double accentGain;       // between 0.0...1.0 - to scale the 3rd amp-envelope on accents
+    double pitchWheelFactor; // scale factor for oscillator frequency from pitch-wheel
+    double n1, n2;           // normalizers for the RCs that are driven by the MEG
+    double unisonDetune;     // detune of the outermost unison lanes (in cents)
+    double cutoffSpread;     // cutoff offset of the outermost unison lanes (in semitones)
+    int    currentNote;      // note which is currently played (-1 if none)
+    int    noteOffCountDown; // a countdown variable till next note-off in sequencer mode
+    bool   slideToNextNote;  // indicate that we need to slide to the next note in sequencer mode
+    bool   idle;             // flag to indicate that we have currently nothing to do in getSample
+
+    // the stack of currently held notes (the most recent one at the end) - this is a fixed size
+    // array rather than a std::list to avoid memory allocation on the audio thread:
+    MidiNoteEvent heldNotes[maxNumHeldNotes];
+    int           numHeldNotes;
+
+  };
+
+  //-------------------------------------------------------------------------------------------------
+  // inlined functions:
+
+  inline double Open303::getSample()
+  {
+    RealTimeScope realTimeScope;
+
+    //if( sequencer.getSequencerMode() == AcidSequencer::OFF && ampEnv.endIsReached() )
+    //  return 0.0;
+    if( idle )
+      return 0.0;
+
+    DenormalGuard denormalGuard; // writes the mode only when the caller hasn't
+    profiler.beginSample();
+
+    double ampEnvOut;
+    double tmp = getDecimatedSample(&ampEnvOut);
+
+    // these filters may actually operate without oversampling (but only if we reset them in
+    // triggerNote - avoid clicks)
+    ampEnvOut = ampDeClicker.getSample(ampEnvOut);
+    tmp  = allpass.getSample(tmp);
+    tmp  = highpass2.getSample(tmp);
+    tmp  = notch.getSample(tmp);
+    tmp *= ampEnvOut;                       // amplified
+    tmp *= ampScaler;
+    profiler.endStage(StageProfiler::POST_FILTERS);
+    profiler.endSample();
+
+    // find out whether we may switch ourselves off for the next call:
+    idle = false;
+    //idle = (sequencer.getSequencerMode() == AcidSequencer::OFF && ampEnv.endIsReached()
+    //        && fabs(tmp) < 0.000001); // ampEnvOut < 0.000001;
+
+    return tmp;
+  }
+
+  INLINE double Open303::getDecimatedSample(double* ampEnvOut)
+  {
+    // check the sequencer if we have some note to trigger:
+    if( sequencer.getSequencerMode() != AcidSequencer::OFF )
+    {
+      noteOffCountDown--;
+      if( noteOffCountDown == 0 || sequencer.isRunning() == false )
+        releaseNote(currentNote);
+
+      AcidNote *note = sequencer.getNote();
+      if( note != NULL )
+      {
+        if( note->gate == true && currentNote != -1)
+        {
+          int key = note->key + 12*note->octave + currentNote;
+          key = clip(key, 0, 127);
+
+          if( !slideToNextNote )
+            triggerNote(key, note->accent);
+          else
+            slideToNote(key, note->accent);
+
+          AcidNote* nextNote = sequencer.getNextScheduledNote();
+          if( note->slide && nextNote->gate == true )
+          {
+            noteOffCountDown = std::numeric_limits<int>::max();
+            slideToNextNote  = true;
+          }
+          else
+          {
+            noteOffCountDown = sequencer.getStepLengthInSamples();
+            slideToNextNote  = false;
+          }
+        }
+      }
+    }
+    profiler.endStage(StageProfiler::SEQUENCER);
+
+    // re-render the wavetables, if some waveform parameters have been changed:
+    oscillator.updateWaveTables();
+
+    // calculate instantaneous oscillator frequency and set up the oscillator:
+    double instFreq = pitchSlewLimiter.getSample(oscFreq);
+    oscillator.setFrequency(instFreq*pitchWheelFactor);
+    oscillator.calculateIncrement();
+    profiler.endStage(StageProfiler::OSCILLATOR);
+
+    // calculate instantaneous cutoff frequency from the nominal cutoff and all its modifiers and
+    // set up the filter:
+    double mainEnvOut = mainEnv.getSample();
+    double tmp1       = n1 * rc1.getSample(mainEnvOut);
+    double tmp2       = 0.0;
+    if( accentGain > 0.0 )
+      tmp2 = mainEnvOut;
+    tmp2 = n2 * rc2.getSample(tmp2);
+    tmp1 = envScaler * ( tmp1 - envOffset );  // seems not to work yet
+    tmp2 = accentGain*tmp2;
+    double instCutoff = cutoff * exp2Fast(tmp1+tmp2);
+    bool   useUnison  = isUnisonActive();
+    if( useUnison )
+      unison.setCutoff(instCutoff, filter);
+    else
+      filter.setCutoff(instCutoff);
+
+    *ampEnvOut = ampEnv.getSample();
+    //*ampEnvOut += 0.45*filterEnvOut + accentGain*6.8*filterEnvOut;
+    if( ampEnv.isNoteOn() )
+      *ampEnvOut += (0.45 + 4 * accentGain) * mainEnvOut;
+    profiler.endStage(StageProfiler::ENVELOPES);
+
+    // oversampled calculations:
+    double tmp;
+    double oversampled[oversampling];
+    if( useUnison )
+    {
+      unison.render(oscillator, highpass1, oversampled, oversampling); // all lanes, summed
+      profiler.endStage(StageProfiler::FILTER);
+    }
+    else
+    {
+      for(int i=0; i<oversampling; i++)
+      {
+        tmp  = -oscillator.getSample();         // the raw oscillator signal
+        profiler.endStage(StageProfiler::OSCILLATOR);
+        tmp  = highpass1.getSample(tmp);        // pre-filter highpass
+        profiler.endStage(StageProfiler::PRE_HIGHPASS);
+        oversampled[i] = filter.getSample(tmp); // now it's filtered
+        profiler.endStage(StageProfiler::FILTER);
+      }
+    }
+    tmp = antiAliasFilter.getSampleDecimated(oversampled, oversampling); // anti-aliased, decimated
+    profiler.endStage(StageProfiler::DECIMATOR);
+
+    return tmp;
+  }
+
+}
+
+#endif
@@ -0,0 +1,340 @@
+#include "rosic_Open303Rack.h"
+#include "rosic_DenormalGuard.h"
+
+#include <chrono>
+
+#if defined(_WIN32)
+  #include <windows.h>
+#elif defined(__linux__)
+  #include <pthread.h>
+  #include <sched.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #include <emmintrin.h>
+#endif
+
+using namespace rosic;
+
+// tells the CPU that we are in a spin loop (saves power and avoids the penalty for the memory
+// order violation when the loop exits):
+static INLINE void cpuPause()
+{
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  _mm_pause();
+#elif defined(__aarch64__) && defined(__GNUC__)
+  __asm__ __volatile__("yield");
+#endif
+}
+
+static void pinToCore(std::thread& thread, int core)
+{
+#if defined(_WIN32)
+  SetThreadAffinityMask(thread.native_handle(), ((DWORD_PTR) 1) << core);
+#elif defined(__linux__)
+  cpu_set_t cpuSet;
+  CPU_ZERO(&cpuSet);
+  CPU_SET(core, &cpuSet);
+  pthread_setaffinity_np(thread.native_handle(), sizeof(cpu_set_t), &cpuSet);
+#endif
+}
+
+static double secondsSince(std::chrono::steady_clock::time_point startTime)
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now()-startTime).count();
+}
+
+//-------------------------------------------------------------------------------------------------
+// construction/destruction:
+
+Open303Rack::Open303Rack(int numInstances, int numBuses_, int numThreads, bool pinThreads)
+{
+  numBuses             = rmax(numBuses_, 1);
+  maxBlockSize         = 0;
+  outputStride         = 0;
+  groupSize            = 0;
+  numGroups            = 0;
+  numInstancesPerGroup = 1;
+  sampleRate           = 44100.0;
+  spinTime             = 0.002;
+  chunkLength          = 0;
+  chunkDuration        = 0.0;
+  generation           = 0;
+  numGroupsDone        = 0;
+  numParked            = 0;
+  quit                 = false;
+
+  for(int i=0; i<rmax(numInstances, 0); i++)
+  {
+    instances.push_back(new Open303);
+    instanceBuses.push_back(0);
+    instanceGains.push_back(1.0);
+  }
+
+  int numCores = rmax((int) std::thread::hardware_concurrency(), 1);
+  if( numThreads <= 0 )
+    numThreads = numCores;
+  for(int t=0; t<numThreads; t++)
+  {
+    ThreadState* state        = new ThreadState;
+    state->nextGroup          = 0;
+    state->beginGroup         = 0;
+    state->endGroup           = 0;
+    state->finishedGeneration = 0;
+    state->load               = 0.0;
+    state->numSteals          = 0;
+    threadStates.push_back(state);
+  }
+
+  setMaxBlockSize(512);
+  partition();
+
+  for(int t=1; t<numThreads; t++)
+  {
+    workers.push_back(std::thread(&Open303Rack::workerLoop, this, t));
+    if( pinThreads )
+      pinToCore(workers.back(), t % numCores);
+  }
+}
+
+Open303Rack::~Open303Rack()
+{
+  quit = true;
+  generation++;
+  {
+    std::lock_guard<std::mutex> lock(parkMutex);
+    parkCondition.notify_all();
+  }
+  for(unsigned int t=0; t<workers.size(); t++)
+    workers[t].join();
+
+  for(unsigned int t=0; t<threadStates.size(); t++)
+    delete threadStates[t];
+  for(unsigned int i=0; i<instances.size(); i++)
+    delete instances[i];
+}
+
+//-------------------------------------------------------------------------------------------------
+// setup:
+
+void Open303Rack::setSampleRate(double newSampleRate)
+{
+  if( newSampleRate <= 0.0 )
+    return;
+  sampleRate = newSampleRate;
+  for(unsigned int i=0; i<instances.size(); i++)
+    instances[i]->setSampleRate(sampleRate);
+}
+
+void Open303Rack::setMaxBlockSize(int newMaxBlockSize)
+{
+  waitForWorkers();
+  maxBlockSize = rmax(newMaxBlockSize, 1);
+  outputStride = (maxBlockSize+7) & ~7; // whole cache lines per instance
+  outputs.assign(instances.size()*outputStride, 0.0);
+}
+
+void Open303Rack::setGroupSize(int newGroupSize)
+{
+  waitForWorkers();
+  groupSize = rmax(newGroupSize, 0);
+  partition();
+}
+
+//-------------------------------------------------------------------------------------------------
+// parameter settings:
+
+void Open303Rack::setInstanceBus(int instanceIndex, int busIndex)
+{
+  instanceBuses[instanceIndex] = clip(busIndex, 0, numBuses-1);
+}
+
+void Open303Rack::setInstanceGain(int instanceIndex, double gain)
+{
+  instanceGains[instanceIndex] = gain;
+}
+
+//-------------------------------------------------------------------------------------------------
+// inquiry:
+
+double Open303Rack::getWorkerLoad(int threadIndex) const
+{
+  return threadStates[threadIndex]->load.load(std::memory_order_relaxed);
+}
+
+int Open303Rack::getWorkerNumSteals(int threadIndex) const
+{
+  return threadStates[threadIndex]->numSteals.load(std::memory_order_relaxed);
+}
+
+//-------------------------------------------------------------------------------------------------
+// processing:
+
+void Open303Rack::processBlock(double** buses, int numSamples)
+{
+  RealTimeScope realTimeScope;
+  DenormalGuard denormalGuard; // the calling thread renders groups and mixes, too
+
+  int numInstances = getNumInstances();
+  int numThreads   = getNumThreads();
+  int b, i, n, t;
+
+  for(int start=0; start<numSamples; start+=maxBlockSize)
+  {
+    // publish the chunk and reset the ranges - the release stores make the chunk visible to
+    // whichever thread claims a group from the range (even when it's late from the last chunk):
+    chunkLength   = rmin(maxBlockSize, numSamples-start);
+    chunkDuration.store(chunkLength/sampleRate, std::memory_order_relaxed);
+    numGroupsDone.store(0, std::memory_order_relaxed);
+    for(t=0; t<numThreads; t++)
+      threadStates[t]->nextGroup.store(threadStates[t]->beginGroup, std::memory_order_release);
+
+    // start the workers (the seq_cst operations on generation and numParked ensure that either we
+    // see a parking worker or it sees the new generation before it goes to sleep):
+    generation.fetch_add(1);
+    if( numParked.load() > 0 )
+    {
+      std::lock_guard<std::mutex> lock(parkMutex);
+      parkCondition.notify_all();
+    }
+
+    renderGroups(0);
+
+    // barrier - we yield only when the workers take very long, which means that they don't have
+    // a core of their own:
+    int numSpins = 0;
+    while( numGroupsDone.load(std::memory_order_acquire) < numGroups )
+    {
+      if( ++numSpins < 4096 )
+        cpuPause();
+      else
+        std::this_thread::yield();
+    }
+
+    // mix the instances into the buses:
+    for(b=0; b<numBuses; b++)
+    {
+      for(n=0; n<chunkLength; n++)
+        buses[b][start+n] = 0.0;
+    }
+    for(i=0; i<numInstances; i++)
+    {
+      double* out  = &outputs[i*outputStride];
+      double* bus  = buses[instanceBuses[i]] + start;
+      double  gain = instanceGains[i];
+      for(n=0; n<chunkLength; n++)
+        bus[n] += gain * out[n];
+    }
+  }
+}
+
+//-------------------------------------------------------------------------------------------------
+// internal functions:
+
+void Open303Rack::workerLoop(int threadIndex)
+{
+  DenormalGuard denormalGuard; // the mode is per thread
+
+  ThreadState* state = threadStates[threadIndex];
+  unsigned int lastGeneration = state->finishedGeneration.load();
+  while( true )
+  {
+    waitForBlock(lastGeneration);
+    if( quit.load() )
+      return;
+    lastGeneration = generation.load(std::memory_order_acquire);
+    renderGroups(threadIndex);
+    state->finishedGeneration.store(lastGeneration, std::memory_order_release);
+  }
+}
+
+void Open303Rack::waitForBlock(unsigned int lastGeneration)
+{
+  std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+  int numSpins = 0;
+  while( generation.load() == lastGeneration )
+  {
+    cpuPause();
+    if( ++numSpins % 256 == 0 && secondsSince(startTime) > spinTime )
+    {
+      std::unique_lock<std::mutex> lock(parkMutex);
+      numParked++;
+      while( generation.load() == lastGeneration )
+        parkCondition.wait(lock);
+      numParked--;
+    }
+  }
+}
+
+void Open303Rack::renderGroups(int threadIndex)
+{
+  RealTimeScope realTimeScope;
+
+  std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+  ThreadState* state = threadStates[threadIndex];
+  int numThreads = getNumThreads();
+  int g;
+
+  // our own range first, then the ranges of the others, starting with our neighbour:
+  while( (g = state->nextGroup.fetch_add(1, std::memory_order_acq_rel)) < state->endGroup )
+    renderGroup(g);
+  for(int i=1; i<numThreads; i++)
+  {
+    ThreadState* victim = threadStates[(threadIndex+i) % numThreads];
+    while( (g = victim->nextGroup.fetch_add(1, std::memory_order_acq_rel)) < victim->endGroup )
+    {
+      renderGroup(g);
+      state->numSteals.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  // update the load meter (only we write to it):
+  double duration = chunkDuration.load(std::memory_order_relaxed);
+  if( duration > 0.0 )
+  {
+    double load = state->load.load(std::memory_order_relaxed);
+    load += 0.05 * (secondsSince(startTime)/duration - load);
+    state->load.store(load, std::memory_order_relaxed);
+  }
+}
+
+void Open303Rack::renderGroup(int groupIndex)
+{
+  int start = groupIndex*numInstancesPerGroup;
+  int end   = rmin(start+numInstancesPerGroup, getNumInstances());
+  for(int i=start; i<end; i++)
+    instances[i]->processBlock(&outputs[i*outputStride], chunkLength);
+  numGroupsDone.fetch_add(1, std::memory_order_release);
+}
+
+void Open303Rack::partition()
+{
+  int numInstances = getNumInstances();
+  int numThreads   = getNumThreads();
+
+  numInstancesPerGroup = groupSize;
+  if( numInstancesPerGroup == 0 )
+    numInstancesPerGroup = (numInstances + 4*numThreads - 1) / (4*numThreads);
+  numInstancesPerGroup = rmax(numInstancesPerGroup, 1);
+  numGroups = (numInstances + numInstancesPerGroup - 1) / numInstancesPerGroup;
+
+  // contiguous ranges, such that adjacent groups are rendered by the same thread:
+  for(int t=0; t<numThreads; t++)
+  {
+    ThreadState* state = threadStates[t];
+    state->beginGroup  = (t    * numGroups) / numThreads;
+    state->endGroup    = ((t+1)* numGroups) / numThreads;
+    state->nextGroup   = state->endGroup;  // nothing to do until the next chunk starts
+  }
+}
+
+void Open303Rack::waitForWorkers()
+{
+  unsigned int currentGeneration = generation.load();
+  for(unsigned int t=1; t<threadStates.size(); t++)
+  {
+    while( threadStates[t]->finishedGeneration.load(std::memory_order_acquire)
+           != currentGeneration )
+      std::this_thread::yield();
+  }
+}
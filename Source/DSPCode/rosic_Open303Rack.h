@@ -0,0 +1,195 @@
+#ifndef rosic_Open303Rack_h
+#define rosic_Open303Rack_h
+
+// rosic-indcludes:
+#include "rosic_Open303.h"
+
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace rosic
+{
+
+  /**
+
+  This is a class for rendering many independent Open303 instances per audio callback on several
+  cores. The rack owns the instances and partitions them into groups of adjacent instances. Each
+  thread (the calling thread is one of them) owns a fixed range of groups, such that an instance
+  is normally rendered on the same core from block to block and its state stays in that core's
+  cache. A thread that has finished its own groups steals the remaining ones from the others, so
+  uneven loads (for example idle instances next to busy ones) are balanced within the block. The
+  block ends with a barrier, after which the calling thread mixes the instances' outputs into the
+  output buses (with a gain and a bus assignment per instance).
+
+  The worker threads are started in the constructor and optionally pinned to one core each. Between
+  blocks, they spin for a while (@see setSpinTime) and then park on a condition variable. Inside
+  processBlock, nothing is allocated and the calling thread never blocks - the only system calls
+  are the wake-up of parked workers (which happens only when they have been idle for longer than
+  the spin time) and a yield in the barrier when the workers don't finish within a while (which
+  happens only when there are more threads than free cores).
+
+  Each thread measures the time it spends rendering and reports it as a fraction of the real time
+  that the rendered blocks represent (@see getWorkerLoad).
+
+  The functions in the setup section reallocate or repartition the rack's data and must not be
+  called concurrently with processBlock. The instances themselves (@see getInstance) may be
+  controlled from the thread that calls processBlock, between the calls.
+
+  */
+
+  class Open303Rack
+  {
+
+  public:
+
+    //---------------------------------------------------------------------------------------------
+    // construction/destruction:
+
+    /** Constructor. Creates the given number of instances (all mixed into bus 0 with unit gain)
+    and numThreads-1 worker threads - the calling thread of processBlock is the remaining one.
+    When numThreads is zero or negative, one thread per hardware thread will be used. When
+    pinThreads is true, the worker threads are pinned to the cores 1, 2, ... (where supported,
+    i.e. on Windows and Linux) - core 0 is left to the audio thread of the host. */
+    Open303Rack(int numInstances, int numBuses = 1, int numThreads = 0, bool pinThreads = true);
+
+    /** Destructor. Stops the worker threads and deletes the instances. */
+    ~Open303Rack();
+
+    //---------------------------------------------------------------------------------------------
+    // setup:
+
+    /** Sets the sample rate for all instances. */
+    void setSampleRate(double newSampleRate);
+
+    /** Sets the maximum number of samples that the instances render in one go - processBlock
+    splits longer blocks into chunks of this size. The default is 512. */
+    void setMaxBlockSize(int newMaxBlockSize);
+
+    /** Sets the number of adjacent instances that form a group, i.e. the unit of work that is
+    handed to a thread. Zero (the default) chooses the size automatically such that each thread
+    owns about 4 groups. */
+    void setGroupSize(int newGroupSize);
+
+    /** Sets the time (in seconds) for which the worker threads spin after they have finished a
+    block before they park. When the time between the blocks is shorter than that, the workers
+    are woken without any system call. The default is 2 milliseconds. */
+    void setSpinTime(double newSpinTime) { spinTime = newSpinTime; }
+
+    //---------------------------------------------------------------------------------------------
+    // parameter settings:
+
+    /** Sets the output bus into which the instance is mixed. */
+    void setInstanceBus(int instanceIndex, int busIndex);
+
+    /** Sets the gain (as raw factor) with which the instance is mixed into its bus. */
+    void setInstanceGain(int instanceIndex, double gain);
+
+    //---------------------------------------------------------------------------------------------
+    // inquiry:
+
+    /** Returns one of the instances. */
+    Open303* getInstance(int index) const { return instances[index]; }
+
+    /** Returns the number of instances. */
+    int getNumInstances() const { return (int) instances.size(); }
+
+    /** Returns the number of output buses. */
+    int getNumBuses() const { return numBuses; }
+
+    /** Returns the number of threads, including the calling thread of processBlock. */
+    int getNumThreads() const { return (int) threadStates.size(); }
+
+    /** Returns the current number of groups. */
+    int getNumGroups() const { return numGroups; }
+
+    /** Returns the smoothed load of a thread (with index 0 being the calling thread of
+    processBlock), i.e. the time it spent rendering divided by the duration of the rendered
+    blocks. A value of 1 means that the thread alone would exhaust the real-time budget. May be
+    called from any thread. */
+    double getWorkerLoad(int threadIndex) const;
+
+    /** Returns the number of groups that a thread has stolen from the others since the
+    construction. May be called from any thread. */
+    int getWorkerNumSteals(int threadIndex) const;
+
+    //---------------------------------------------------------------------------------------------
+    // processing:
+
+    /** Renders a block of numSamples samples with all instances and writes the mix into the
+    buses (an array of getNumBuses() pointers to buffers of numSamples samples each). The
+    content of the buses is overwritten. Denormals are flushed to zero on the calling thread (and
+    on the workers) during the call. */
+    void processBlock(double** buses, int numSamples);
+
+  protected:
+
+    /** The state of one thread - padded to a cache line to avoid false sharing between the
+    threads. */
+    struct alignas(64) ThreadState
+    {
+      std::atomic<int>          nextGroup;          // next group of our range to be rendered
+      int                       beginGroup;         // first group of our range
+      int                       endGroup;           // one behind the last group of our range
+      std::atomic<unsigned int> finishedGeneration; // the last chunk we have worked on
+      std::atomic<double>       load;               // smoothed load
+      std::atomic<int>          numSteals;
+    };
+
+    /** The loop that is run by each worker thread. */
+    void workerLoop(int threadIndex);
+
+    /** Spins and then parks until a new block has been started (or the rack is being
+    destroyed). */
+    void waitForBlock(unsigned int lastGeneration);
+
+    /** Renders our own groups and then steals groups from the other threads until there are none
+    left. */
+    void renderGroups(int threadIndex);
+
+    /** Renders one group into the output buffers of its instances. */
+    void renderGroup(int groupIndex);
+
+    /** Assigns the ranges of groups to the threads. */
+    void partition();
+
+    /** Waits until the worker threads have finished their work on the current chunk (they may
+    still be looking for groups to steal after the last group is done). Called before the data
+    that they access is modified. */
+    void waitForWorkers();
+
+    std::vector<Open303*>     instances;
+    std::vector<int>          instanceBuses;
+    std::vector<double>       instanceGains;
+    std::vector<double>       outputs;       // the rendered chunk of each instance
+    std::vector<ThreadState*> threadStates;
+    std::vector<std::thread>  workers;
+
+    int    numBuses, maxBlockSize, outputStride, groupSize, numGroups, numInstancesPerGroup;
+    double sampleRate, spinTime;
+
+    // the current chunk - the length is read by the threads only after they have claimed a group
+    // (which synchronizes with the start of the chunk):
+    int                 chunkLength;
+    std::atomic<double> chunkDuration;
+
+    std::atomic<unsigned int> generation;      // incremented for each chunk
+    std::atomic<int>          numGroupsDone;   // in the current chunk
+    std::atomic<int>          numParked;       // number of parked worker threads
+    std::atomic<bool>         quit;
+    std::mutex                parkMutex;
+    std::condition_variable   parkCondition;
+
+  private:
+
+    // racks are not supposed to be copied:
+    Open303Rack(const Open303Rack&);
+    Open303Rack& operator=(const Open303Rack&);
+
+  };
+
+} // end namespace rosic
+
+#endif // rosic_Open303Rack_h
@@ -0,0 +1,215 @@
+#include "rosic_ParameterSweep.h"
+#include "rosic_DenormalGuard.h"
+
+#include <thread>
+#include <chrono>
+using namespace rosic;
+
+//=================================================================================================
+// class SweepNode:
+
+SweepNode::SweepNode(SweepNode* parent_, int numSamples_)
+{
+  parent      = parent_;
+  numSamples  = numSamples_ > 0 ? numSamples_ : 0;
+  startSample = parent != NULL ? parent->getTotalLength() : 0;
+  synth       = NULL;
+}
+
+SweepNode::~SweepNode()
+{
+  for(unsigned int i=0; i<children.size(); i++)
+    delete children[i];
+  delete synth;
+}
+
+//-------------------------------------------------------------------------------------------------
+// setup:
+
+void SweepNode::addParameterChange(ParameterSetter setter, double value)
+{
+  ParameterChange change;
+  change.setter = setter;
+  change.value  = value;
+  changes.push_back(change);
+}
+
+SweepNode* SweepNode::addChild(int numSamples)
+{
+  SweepNode* child = new SweepNode(this, numSamples);
+  children.push_back(child);
+  return child;
+}
+
+//-------------------------------------------------------------------------------------------------
+// inquiry:
+
+void SweepNode::getOutput(double* buffer) const
+{
+  // walk up to the root, each node copies its segment to its own position:
+  for(const SweepNode* node = this; node != NULL; node = node->parent)
+  {
+    for(int n=0; n<(int)node->segment.size(); n++)
+      buffer[node->startSample+n] = node->segment[n];
+  }
+}
+
+//-------------------------------------------------------------------------------------------------
+// processing:
+
+void SweepNode::render()
+{
+  for(unsigned int i=0; i<changes.size(); i++)
+    (synth->*changes[i].setter)(changes[i].value);
+
+  segment.resize(numSamples);
+  if( numSamples > 0 )
+    synth->processBlock(&segment[0], numSamples);
+
+  // fork the state at the divergence point - the last child takes over our synth:
+  int numChildren = (int) children.size();
+  for(int i=0; i<numChildren-1; i++)
+    children[i]->synth = new Open303(*synth);
+  if( numChildren > 0 )
+    children[numChildren-1]->synth = synth;
+  else
+    delete synth;
+  synth = NULL;
+}
+
+//=================================================================================================
+// class ParameterSweep:
+
+ParameterSweep::ParameterSweep(const Open303& prototype_, int prefixLength)
+: prototype(prototype_)
+{
+  root               = new SweepNode(NULL, prefixLength);
+  numPendingNodes    = 0;
+  numSamplesRendered = 0.0;
+  numSamplesUnshared = 0.0;
+  renderTime         = 0.0;
+  numThreadsUsed     = 0;
+  collectLeaves(root);
+}
+
+ParameterSweep::~ParameterSweep()
+{
+  delete root;
+}
+
+//-------------------------------------------------------------------------------------------------
+// setup:
+
+void ParameterSweep::addDimension(SweepNode::ParameterSetter setter, const double* values,
+                                  int numValues, int numSamples)
+{
+  collectLeaves(root);
+  std::vector<SweepNode*> oldLeaves = leaves;
+  for(unsigned int i=0; i<oldLeaves.size(); i++)
+  {
+    for(int j=0; j<numValues; j++)
+      oldLeaves[i]->addChild(numSamples)->addParameterChange(setter, values[j]);
+  }
+  collectLeaves(root);
+}
+
+//-------------------------------------------------------------------------------------------------
+// inquiry:
+
+double ParameterSweep::getSharingSpeedup() const
+{
+  if( numSamplesRendered <= 0.0 )
+    return 1.0;
+  return numSamplesUnshared / numSamplesRendered;
+}
+
+//-------------------------------------------------------------------------------------------------
+// processing:
+
+void ParameterSweep::render(int numThreads)
+{
+  std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+  // the tree may have been modified via SweepNode::addChild since the last call:
+  int numNodes = collectLeaves(root);
+
+  numSamplesRendered = 0.0;
+  numSamplesUnshared = 0.0;
+  std::vector<SweepNode*> stack(1, root);
+  while( !stack.empty() )
+  {
+    SweepNode* node = stack.back();
+    stack.pop_back();
+    numSamplesRendered += node->numSamples;
+    if( node->isLeaf() )
+      numSamplesUnshared += node->getTotalLength();
+    stack.insert(stack.end(), node->children.begin(), node->children.end());
+  }
+
+  if( numThreads <= 0 )
+    numThreads = (int) std::thread::hardware_concurrency();
+  numThreads     = clip(numThreads, 1, numNodes);
+  numThreadsUsed = numThreads;
+
+  root->synth     = new Open303(prototype);
+  numPendingNodes = numNodes;
+  readyNodes.clear();
+  readyNodes.push_back(root);
+
+  // the calling thread is one of the workers:
+  std::vector<std::thread> threads;
+  for(int i=1; i<numThreads; i++)
+    threads.push_back(std::thread(&ParameterSweep::workerLoop, this));
+  workerLoop();
+  for(unsigned int i=0; i<threads.size(); i++)
+    threads[i].join();
+
+  renderTime = std::chrono::duration<double>(std::chrono::steady_clock::now()-startTime).count();
+}
+
+void ParameterSweep::workerLoop()
+{
+  DenormalGuard denormalGuard; // the mode is per thread
+
+  std::unique_lock<std::mutex> lock(mutex);
+  while( true )
+  {
+    while( readyNodes.empty() && numPendingNodes > 0 )
+      nodeReady.wait(lock);
+    if( numPendingNodes == 0 )
+      return;
+
+    // take the most recently queued node - going depth-first limits the number of synth clones
+    // that are alive at the same time:
+    SweepNode* node = readyNodes.back();
+    readyNodes.pop_back();
+
+    lock.unlock();
+    node->render();
+    lock.lock();
+
+    readyNodes.insert(readyNodes.end(), node->children.begin(), node->children.end());
+    numPendingNodes--;
+    nodeReady.notify_all();
+  }
+}
+
+int ParameterSweep::collectLeaves(SweepNode* node)
+{
+  if( node == root )
+    leaves.clear();
+
+  if( node->parent != NULL )
+    node->startSample = node->parent->getTotalLength();
+
+  if( node->isLeaf() )
+  {
+    leaves.push_back(node);
+    return 1;
+  }
+
+  int numNodes = 1;
+  for(unsigned int i=0; i<node->children.size(); i++)
+    numNodes += collectLeaves(node->children[i]);
+  return numNodes;
+}
@@ -0,0 +1,233 @@
+#ifndef rosic_ParameterSweep_h
+#define rosic_ParameterSweep_h
+
+// rosic-indcludes:
+#include "rosic_Open303.h"
+
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+
+namespace rosic
+{
+
+  /**
+
+  This class represents one segment in the tree of a ParameterSweep. A node applies its parameter
+  changes to the state in which its parent has left the synth and then renders a given number of
+  samples. The output of a variation (i.e. a leaf) from time zero is the concatenation of the
+  segments along the path from the root to that leaf - nodes that share a parent share the
+  rendering of everything that precedes them.
+
+  Nodes are created and owned by the ParameterSweep (via addChild), so you never delete them
+  yourself.
+
+  */
+
+  class SweepNode
+  {
+
+    friend class ParameterSweep;
+
+  public:
+
+    /** Type of the Open303 member functions that can be used for parameter changes, for example
+    &Open303::setCutoff. */
+    typedef void (Open303::*ParameterSetter)(double);
+
+    //---------------------------------------------------------------------------------------------
+    // setup:
+
+    /** Adds a parameter change that is applied (in the order of addition) at the beginning of
+    this node's segment. */
+    void addParameterChange(ParameterSetter setter, double value);
+
+    /** Adds a child that continues from the end of this node's segment and renders numSamples
+    samples. Returns a pointer to the new child. */
+    SweepNode* addChild(int numSamples);
+
+    //---------------------------------------------------------------------------------------------
+    // inquiry:
+
+    /** Returns the parent of this node (NULL for the root). */
+    SweepNode* getParent() const { return parent; }
+
+    /** Returns the number of child nodes. */
+    int getNumChildren() const { return (int) children.size(); }
+
+    /** Returns one of the child nodes. */
+    SweepNode* getChild(int index) const { return children[index]; }
+
+    /** Returns true when this node has no children, i.e. it represents a complete variation. */
+    bool isLeaf() const { return children.empty(); }
+
+    /** Returns the length of this node's own segment in samples. */
+    int getNumSamples() const { return numSamples; }
+
+    /** Returns the time (in samples from the start of the render) where this node's segment
+    begins. */
+    int getStartSample() const { return startSample; }
+
+    /** Returns the length of the complete output along the path from the root up to the end of
+    this node's segment. */
+    int getTotalLength() const { return startSample + numSamples; }
+
+    /** Returns the rendered samples of this node's own segment (valid after
+    ParameterSweep::render). */
+    const double* getSegment() const { return segment.empty() ? NULL : &segment[0]; }
+
+    /** Copies the complete output along the path from the root up to the end of this node's
+    segment into the buffer, which must have room for getTotalLength() samples. */
+    void getOutput(double* buffer) const;
+
+  protected:
+
+    /** Constructor - nodes are created by their parent or by the ParameterSweep only. */
+    SweepNode(SweepNode* parent, int numSamples);
+
+    /** Destructor. Deletes the children. */
+    ~SweepNode();
+
+    /** Applies the parameter changes to our synth, renders our segment and hands clones of the
+    resulting state over to the children. */
+    void render();
+
+    struct ParameterChange
+    {
+      ParameterSetter setter;
+      double          value;
+    };
+
+    SweepNode*                   parent;
+    std::vector<SweepNode*>      children;
+    std::vector<ParameterChange> changes;
+    std::vector<double>          segment;     // our rendered output
+    int                          numSamples;  // length of our segment
+    int                          startSample; // start of our segment (sum of ancestor lengths)
+    Open303*                     synth;       // state to start from (owned, only during render)
+
+  private:
+
+    // nodes are not supposed to be copied:
+    SweepNode(const SweepNode&);
+    SweepNode& operator=(const SweepNode&);
+
+  };
+
+  /**
+
+  This is an engine for rendering many variations of parameter settings over the same pattern (or
+  MIDI input) without re-rendering the common parts for each of them. The variations are
+  organized as a tree: the root renders the shared prefix from a copy of a prototype synth once,
+  then the complete synth state is cloned at the divergence point for each child, which applies
+  its own parameter changes and renders its own segment - and so on. A grid like
+  cutoff x resonance x envMod is built by adding one dimension after another via addDimension(),
+  but arbitrary trees may be built via SweepNode::addChild as well.
+
+  The nodes are rendered by a pool of worker threads - each node becomes ready as soon as its
+  parent is done, so the branches fan out across the threads. After rendering, the sweep reports
+  the number of rendered samples compared to the number of samples that rendering each variation
+  from time zero would have taken, and the wall clock time.
+
+  Typical usage: set up a synth with pattern, sequencer mode and base parameters, create a sweep
+  from it with the length of the prefix, add dimensions like
+  addDimension(&Open303::setCutoff, cutoffs, 4, 22050), call render() and retrieve the variations
+  via getLeaf(i)->getOutput(buffer).
+
+  */
+
+  class ParameterSweep
+  {
+
+  public:
+
+    //---------------------------------------------------------------------------------------------
+    // construction/destruction:
+
+    /** Constructor. The prototype is copied and will be used as the starting point for the root
+    node which renders the shared prefix of prefixLength samples. */
+    ParameterSweep(const Open303& prototype, int prefixLength);
+
+    /** Destructor. */
+    ~ParameterSweep();
+
+    //---------------------------------------------------------------------------------------------
+    // setup:
+
+    /** Returns the root node, which renders the shared prefix. */
+    SweepNode* getRoot() { return root; }
+
+    /** Adds a dimension to the sweep: each current leaf gets numValues children which set the
+    given parameter to one of the values and render numSamples samples each. */
+    void addDimension(SweepNode::ParameterSetter setter, const double* values, int numValues,
+      int numSamples);
+
+    //---------------------------------------------------------------------------------------------
+    // inquiry:
+
+    /** Returns the number of leaves, i.e. the number of variations. */
+    int getNumLeaves() const { return (int) leaves.size(); }
+
+    /** Returns one of the leaves (in depth-first order). The list of leaves is updated by
+    render() and addDimension(). */
+    SweepNode* getLeaf(int index) const { return leaves[index]; }
+
+    /** Returns the number of samples that were actually rendered in the last call to render(). */
+    double getNumSamplesRendered() const { return numSamplesRendered; }
+
+    /** Returns the number of samples it would have taken to render each variation from time zero
+    separately. */
+    double getNumSamplesUnshared() const { return numSamplesUnshared; }
+
+    /** Returns the speedup due to the sharing of common segments, i.e. the ratio of
+    getNumSamplesUnshared() and getNumSamplesRendered(). The parallelization comes on top of
+    that. */
+    double getSharingSpeedup() const;
+
+    /** Returns the wall clock time that the last call to render() took (in seconds). */
+    double getRenderTime() const { return renderTime; }
+
+    /** Returns the number of worker threads that were used in the last call to render(). */
+    int getNumThreadsUsed() const { return numThreadsUsed; }
+
+    //---------------------------------------------------------------------------------------------
+    // processing:
+
+    /** Renders all nodes of the tree. When numThreads is zero or negative, one thread per
+    hardware thread will be used. */
+    void render(int numThreads = 0);
+
+  protected:
+
+    /** The loop that is run by each worker thread - it takes ready nodes from the queue, renders
+    them and puts their children into the queue, until all nodes are done. */
+    void workerLoop();
+
+    /** Updates the list of leaves and the start times of the nodes below the given one, returns
+    the number of nodes in that subtree. */
+    int collectLeaves(SweepNode* node);
+
+    Open303    prototype;
+    SweepNode* root;
+
+    std::vector<SweepNode*> leaves;
+    std::vector<SweepNode*> readyNodes;      // nodes whose parents are done (used as stack)
+    int                     numPendingNodes; // nodes that are not yet rendered completely
+
+    double numSamplesRendered, numSamplesUnshared, renderTime;
+    int    numThreadsUsed;
+
+    std::mutex              mutex;     // guards readyNodes and numPendingNodes
+    std::condition_variable nodeReady; // signalled when nodes were queued or all are done
+
+  private:
+
+    // sweeps are not supposed to be copied:
+    ParameterSweep(const ParameterSweep&);
+    ParameterSweep& operator=(const ParameterSweep&);
+
+  };
+
+} // end namespace rosic
+
+#endif // rosic_ParameterSweep_h
@@ -0,0 +1,269 @@
+#include "rosic_PatternBank.h"
+#include "rosic_NumberManipulations.h"
+
+#include <stdio.h>
+#include <vector>
+#include <algorithm>
+
+using namespace rosic;
+
+//-------------------------------------------------------------------------------------------------
+// helpers for little endian numbers:
+
+static unsigned int read16(const unsigned char* p)
+{
+  return p[0] | (p[1] << 8);
+}
+
+static UINT32 read32(const unsigned char* p)
+{
+  return (UINT32) p[0] | ((UINT32) p[1] << 8) | ((UINT32) p[2] << 16) | ((UINT32) p[3] << 24);
+}
+
+static void write16(unsigned char* p, unsigned int x)
+{
+  p[0] = (unsigned char) ( x       & 0xFF);
+  p[1] = (unsigned char) ((x >> 8) & 0xFF);
+}
+
+static void write32(unsigned char* p, UINT32 x)
+{
+  for(int i=0; i<4; i++)
+    p[i] = (unsigned char) ((x >> (8*i)) & 0xFF);
+}
+
+//-------------------------------------------------------------------------------------------------
+// construction/destruction:
+
+PatternBank::PatternBank()
+{
+  index       = NULL;
+  records     = NULL;
+  numPatterns = 0;
+}
+
+PatternBank::~PatternBank()
+{
+  close();
+}
+
+//-------------------------------------------------------------------------------------------------
+// setup:
+
+bool PatternBank::open(const char* path)
+{
+  close();
+  if( !file.open(path) )
+    return false;
+
+  int n;
+  if( checkHeader(file.getData(), file.getSize(), &n) != VALID )
+  {
+    file.close();
+    return false;
+  }
+  numPatterns = n;
+  index       = file.getData() + headerSize;
+  records     = index + 4*(size_t)numPatterns;
+  return true;
+}
+
+void PatternBank::close()
+{
+  file.close();
+  index       = NULL;
+  records     = NULL;
+  numPatterns = 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+// inquiry:
+
+UINT32 PatternBank::getPatternId(int i) const
+{
+  if( i < 0 || i >= numPatterns )
+    return 0;
+  return read32(index + 4*(size_t)i);
+}
+
+int PatternBank::findPattern(UINT32 id) const
+{
+  int lo = 0;
+  int hi = numPatterns-1;
+  while( lo <= hi )
+  {
+    int    mid   = lo + (hi-lo)/2;
+    UINT32 midId = read32(index + 4*(size_t)mid);
+    if( midId == id )
+      return mid;
+    else if( midId < id )
+      lo = mid+1;
+    else
+      hi = mid-1;
+  }
+  return -1;
+}
+
+bool PatternBank::getPattern(int i, AcidPattern* pattern) const
+{
+  const unsigned char* record = getRecord(i);
+  if( record == NULL || checkRecord(record) != VALID )
+    return false;
+
+  pattern->setNumSteps(record[0]);
+  pattern->setStepLength(read16(record+2) / 256.0);
+  for(int s=0; s<numNotes; s++)
+    decodeNote(read16(record+4+2*s), pattern->getNote(s));
+  return true;
+}
+
+const unsigned char* PatternBank::getRecord(int i) const
+{
+  if( i < 0 || i >= numPatterns )
+    return NULL;
+  return records + recordSize*(size_t)i;
+}
+
+//-------------------------------------------------------------------------------------------------
+// tools:
+
+unsigned int PatternBank::encodeNote(const AcidNote& note)
+{
+  unsigned int key    = (unsigned int) clip(note.key,    0, 12);
+  unsigned int octave = (unsigned int) clip(note.octave, -8, 7) & 0x0F;
+  return key | (octave << 4) | (note.accent << 8) | (note.slide << 9) | (note.gate << 10);
+}
+
+void PatternBank::decodeNote(unsigned int bits, AcidNote* note)
+{
+  int octave   = (bits >> 4) & 0x0F;
+  note->key    = bits & 0x0F;
+  note->octave = octave >= 8 ? octave-16 : octave;
+  note->accent = (bits & 0x100) != 0;
+  note->slide  = (bits & 0x200) != 0;
+  note->gate   = (bits & 0x400) != 0;
+}
+
+bool PatternBank::writeFile(const char* path, AcidPattern* patterns, const UINT32* ids,
+                            int numPatterns)
+{
+  // sort the patterns by their IDs and check uniqueness:
+  std::vector< std::pair<UINT32, int> > order(numPatterns);
+  for(int i=0; i<numPatterns; i++)
+    order[i] = std::make_pair(ids[i], i);
+  std::sort(order.begin(), order.end());
+  for(int i=1; i<numPatterns; i++)
+  {
+    if( order[i].first == order[i-1].first )
+      return false;
+  }
+
+  FILE* f = fopen(path, "wb");
+  if( f == NULL )
+    return false;
+
+  unsigned char header[headerSize];
+  write32(header,    fileMagic);
+  write16(header+4,  fileVersion);
+  write16(header+6,  recordSize);
+  write32(header+8,  (UINT32) numPatterns);
+  write32(header+12, 0);
+  bool ok = fwrite(header, headerSize, 1, f) == 1;
+
+  unsigned char id[4];
+  for(int i=0; i<numPatterns && ok; i++)
+  {
+    write32(id, order[i].first);
+    ok = fwrite(id, 4, 1, f) == 1;
+  }
+
+  unsigned char record[recordSize];
+  for(int i=0; i<numPatterns && ok; i++)
+  {
+    AcidPattern& p = patterns[order[i].second];
+    record[0] = (unsigned char) p.getNumSteps();
+    record[1] = 0;
+    write16(record+2, (unsigned int) clip(roundToInt(256.0*p.getStepLength()), 1, 256));
+    for(int s=0; s<numNotes; s++)
+      write16(record+4+2*s, encodeNote(*p.getNote(s)));
+    ok = fwrite(record, recordSize, 1, f) == 1;
+  }
+
+  ok = (fclose(f) == 0) && ok;
+  if( !ok )
+    remove(path);
+  return ok;
+}
+
+int PatternBank::validateFile(const char* path, int* badRecord)
+{
+  MappedFile f;
+  if( !f.open(path) )
+    return CANNOT_OPEN;
+
+  int n;
+  int result = checkHeader(f.getData(), f.getSize(), &n);
+  if( result != VALID )
+    return result;
+
+  const unsigned char* idx  = f.getData() + headerSize;
+  const unsigned char* recs = idx + 4*(size_t)n;
+  for(int i=1; i<n; i++)
+  {
+    if( read32(idx+4*(size_t)i) <= read32(idx+4*(size_t)(i-1)) )
+    {
+      if( badRecord != NULL )
+        *badRecord = i;
+      return UNSORTED_INDEX;
+    }
+  }
+
+  for(int i=0; i<n; i++)
+  {
+    result = checkRecord(recs + recordSize*(size_t)i);
+    if( result != VALID )
+    {
+      if( badRecord != NULL )
+        *badRecord = i;
+      return result;
+    }
+  }
+
+  return VALID;
+}
+
+int PatternBank::checkRecord(const unsigned char* record)
+{
+  unsigned int stepLength = read16(record+2);
+  if(    record[0] < 1 || record[0] > numNotes || record[1] != 0
+      || stepLength < 1 || stepLength > 256 )
+    return BAD_RECORD;
+  for(int s=0; s<numNotes; s++)
+  {
+    unsigned int bits = read16(record+4+2*s);
+    if( (bits & 0x0F) > 12 || (bits & 0xF800) != 0 )
+      return BAD_NOTE;
+  }
+  return VALID;
+}
+
+int PatternBank::checkHeader(const unsigned char* data, UINT64 size, int* n)
+{
+  *n = 0;
+  if( size < (UINT64) headerSize )
+    return BAD_HEADER;
+  if(    read32(data) != fileMagic || read16(data+4) != fileVersion
+      || read16(data+6) != recordSize || read32(data+12) != 0 )
+    return BAD_HEADER;
+
+  // the offsets into the data are computed as size_t, so the whole file must be addressable with
+  // it (which is not the case for huge banks on 32 bit systems):
+  UINT32 numRecords = read32(data+8);
+  if( numRecords > 0x7FFFFFFF
+    || size != (UINT64) headerSize + (UINT64) numRecords * (4 + recordSize)
+    || size > (UINT64) ((size_t) -1) )
+    return BAD_SIZE;
+
+  *n = (int) numRecords;
+  return VALID;
+}
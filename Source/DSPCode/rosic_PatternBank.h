@@ -0,0 +1,149 @@
+#ifndef rosic_PatternBank_h
+#define rosic_PatternBank_h
+
+// rosic-indcludes:
+#include "rosic_AcidPattern.h"
+#include "rosic_MappedFile.h"
+
+namespace rosic
+{
+
+  /**
+
+  This is a class for accessing banks of patterns that are stored in a compact binary file format
+  which is designed to be memory-mapped and read directly, without any parsing. Opening a bank only
+  checks its header and size, so it's O(1) regardless of the number of patterns, and the memory
+  use is proportional to the patterns that are actually accessed.
+
+  File format (all numbers are unsigned and little endian):
+
+  header (16 bytes):
+   magic 'P303' (4 bytes), version (2 bytes), record size (2 bytes, always 36), number of
+   patterns N (4 bytes), reserved (4 bytes, zero)
+
+  index (N*4 bytes):
+   the 32-bit IDs of the patterns in strictly ascending order - the pattern with the i-th ID is
+   stored in the i-th record
+
+  records (N*36 bytes), one per pattern:
+   number of steps (1 byte, 1...16), reserved (1 byte, zero), step length in units of 1/256 step
+   (2 bytes, 1...256), 16 notes of 2 bytes each
+
+  note (16 bits):
+   bits 0-3: key (0...12), bits 4-7: octave (two's complement, -8...7), bit 8: accent, bit 9:
+   slide, bit 10: gate, bits 11-15: reserved (zero)
+
+  Banks are created by writeFile() from AcidPattern objects. validateFile() checks all records of
+  a bank thoroughly, whereas open() only checks what's needed to access it safely - each record is
+  then checked when it's decoded by getPattern(), so a damaged record never reaches a pattern.
+
+  */
+
+  class PatternBank
+  {
+
+  public:
+
+    /** Error codes as returned by validateFile(). */
+    enum errorCodes
+    {
+      VALID = 0,
+      CANNOT_OPEN,      // file doesn't exist or can't be mapped
+      BAD_HEADER,       // wrong magic number, version or record size
+      BAD_SIZE,         // file size doesn't match the number of patterns
+      UNSORTED_INDEX,   // IDs are not strictly ascending
+      BAD_RECORD,       // invalid number of steps or step length or nonzero reserved bits
+      BAD_NOTE          // key out of range or nonzero reserved bits
+    };
+
+    //---------------------------------------------------------------------------------------------
+    // construction/destruction:
+
+    /** Constructor. */
+    PatternBank();
+
+    /** Destructor. */
+    ~PatternBank();
+
+    //---------------------------------------------------------------------------------------------
+    // setup:
+
+    /** Opens the bank file with the given path (closing a previously opened one). Returns false
+    when the file can't be mapped or its header or size is invalid. */
+    bool open(const char* path);
+
+    /** Closes the bank. */
+    void close();
+
+    //---------------------------------------------------------------------------------------------
+    // inquiry:
+
+    /** Returns true when a bank is open. */
+    bool isOpen() const { return file.isOpen(); }
+
+    /** Returns the number of patterns in the bank. */
+    int getNumPatterns() const { return numPatterns; }
+
+    /** Returns the ID of the pattern with the given index. */
+    UINT32 getPatternId(int index) const;
+
+    /** Returns the index of the pattern with the given ID (via binary search in the index) or -1
+    when there is no such pattern. */
+    int findPattern(UINT32 id) const;
+
+    /** Decodes the pattern with the given index into the passed AcidPattern (which may be one of
+    the patterns of an AcidSequencer). Returns false (and leaves the pattern as is) when the index
+    is out of range or the record is invalid (see validateFile()). */
+    bool getPattern(int index, AcidPattern* pattern) const;
+
+    /** Returns a pointer to the raw record of the pattern with the given index. */
+    const unsigned char* getRecord(int index) const;
+
+    //---------------------------------------------------------------------------------------------
+    // tools:
+
+    /** Encodes a note into its 16-bit representation. Keys are clipped to 0...12 and octaves to
+    -8...7. */
+    static unsigned int encodeNote(const AcidNote& note);
+
+    /** Decodes a note from its 16-bit representation. The bits are not checked, so the key may
+    come out as 13...15 - getPattern() checks the whole record before it decodes the notes. */
+    static void decodeNote(unsigned int bits, AcidNote* note);
+
+    /** Writes a bank file from the given patterns and their IDs (which must be unique, but
+    need not be sorted). The step lengths are quantized to 1/256 step and clipped to 1/256...1
+    step. Returns false when the IDs are not unique or the file can't be written. */
+    static bool writeFile(const char* path, AcidPattern* patterns, const UINT32* ids,
+      int numPatterns);
+
+    /** Checks a bank file thoroughly (header, size, order of the index and all records and notes)
+    and returns one of the errorCodes. When a record is invalid, its index is written into
+    badRecord (if not NULL). */
+    static int validateFile(const char* path, int* badRecord = NULL);
+
+    //=============================================================================================
+
+  protected:
+
+    /** Checks the header and size of the mapped data and returns one of the errorCodes. */
+    static int checkHeader(const unsigned char* data, UINT64 size, int* numPatterns);
+
+    /** Checks a record and its notes and returns VALID, BAD_RECORD or BAD_NOTE. */
+    static int checkRecord(const unsigned char* record);
+
+    static const UINT32 fileMagic   = 0x33303350; // 'P303'
+    static const int    fileVersion = 1;
+    static const int    headerSize  = 16;
+    static const int    recordSize  = 36;
+    static const int    numNotes    = 16;         // notes per record
+
+    MappedFile           file;
+    const unsigned char* index;   // start of the index in the mapping
+    const unsigned char* records; // start of the records in the mapping
+    int                  numPatterns;
+
+  };
+
+} // end namespace rosic
+
+#endif // rosic_PatternBank_h
@@ -1,3 +1,3 @@
-#include "rosic_RealFunctions.h"
-using namespace rosic;
-
+#include "rosic_RealFunctions.h"
+using namespace rosic;
+
@@ -0,0 +1,128 @@
+#include "rosic_RealTimeScope.h"
+using namespace rosic;
+
+#ifdef OPEN303_CHECK_REALTIME
+
+#include <atomic>
+#include <new>
+#include <stdlib.h>
+
+static thread_local int scopeDepth = 0;  // nesting depth of the calling thread's scopes
+static std::atomic<int> numViolations(0); // violations on all threads
+
+//-------------------------------------------------------------------------------------------------
+// replacements for the global allocation functions:
+
+void* operator new(size_t size)
+{
+  RealTimeScope::checkViolation();
+  void* p = malloc(size > 0 ? size : 1);
+  if( p == NULL )
+    throw std::bad_alloc();
+  return p;
+}
+
+void* operator new[](size_t size)
+{
+  return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+  RealTimeScope::checkViolation();
+  return malloc(size > 0 ? size : 1);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+  return operator new(size, std::nothrow);
+}
+
+void operator delete(void* p) noexcept
+{
+  if( p != NULL )
+    RealTimeScope::checkViolation();
+  free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+  operator delete(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+  operator delete(p);
+}
+
+void operator delete[](void* p, size_t) noexcept
+{
+  operator delete(p);
+}
+
+#endif
+
+//-------------------------------------------------------------------------------------------------
+// inquiry:
+
+bool RealTimeScope::isEnabled()
+{
+#ifdef OPEN303_CHECK_REALTIME
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool RealTimeScope::isInside()
+{
+#ifdef OPEN303_CHECK_REALTIME
+  return scopeDepth > 0;
+#else
+  return false;
+#endif
+}
+
+int RealTimeScope::getNumViolations()
+{
+#ifdef OPEN303_CHECK_REALTIME
+  return numViolations.load();
+#else
+  return 0;
+#endif
+}
+
+//-------------------------------------------------------------------------------------------------
+// others:
+
+void RealTimeScope::resetNumViolations()
+{
+#ifdef OPEN303_CHECK_REALTIME
+  numViolations.store(0);
+#endif
+}
+
+void RealTimeScope::checkViolation()
+{
+#ifdef OPEN303_CHECK_REALTIME
+  if( scopeDepth > 0 )
+  {
+    numViolations++;
+    DEBUG_BREAK; // something in the audio path allocates or frees memory
+  }
+#endif
+}
+
+void RealTimeScope::enter()
+{
+#ifdef OPEN303_CHECK_REALTIME
+  scopeDepth++;
+#endif
+}
+
+void RealTimeScope::leave()
+{
+#ifdef OPEN303_CHECK_REALTIME
+  scopeDepth--;
+#endif
+}
@@ -0,0 +1,99 @@
+#ifndef rosic_RealTimeScope_h
+#define rosic_RealTimeScope_h
+
+// rosic-indcludes:
+#include "GlobalDefinitions.h"
+
+// Define OPEN303_CHECK_REALTIME (for example via the compiler's command line) to switch the
+// real-time checks on. When it is not defined, RealTimeScope is an empty class with empty inlined
+// constructor and destructor, such that the scopes in the audio path compile to nothing.
+
+namespace rosic
+{
+
+  /**
+
+  This is a class for verifying that the audio path does not allocate or free memory. Objects of
+  this class are created on the stack at the entry points of the audio thread (like
+  Open303::getSample and Open303::noteOn) and mark the current thread as being inside a real-time
+  scope for their lifetime. When the checks are compiled in, the global operators new and delete
+  are replaced by versions that count each call that happens inside such a scope as a violation
+  (and try to break into the debugger). Hosts and offline tools can then drive the engine with
+  their MIDI and automation scenarios and assert that getNumViolations() stays at zero.
+
+  Note that the class itself only sees allocations through operator new/delete. Direct calls to
+  malloc/free, locks and system calls are detected by Tests/RealTimeTest.cpp, which hooks the
+  corresponding glibc functions, reports the calls inside the scopes as violations and fails on
+  them while it renders a set of note, controller and automation scenarios.
+
+  */
+
+  class RealTimeScope
+  {
+
+  public:
+
+    //---------------------------------------------------------------------------------------------
+    // construction/destruction:
+
+    /** Constructor. Enters the real-time scope. */
+    INLINE RealTimeScope();
+
+    /** Destructor. Leaves the real-time scope. */
+    INLINE ~RealTimeScope();
+
+    //---------------------------------------------------------------------------------------------
+    // inquiry:
+
+    /** Returns true when the checks were compiled in (i.e. OPEN303_CHECK_REALTIME is defined). */
+    static bool isEnabled();
+
+    /** Returns true when the calling thread is currently inside a real-time scope. */
+    static bool isInside();
+
+    /** Returns the number of violations (on all threads) since the last reset. */
+    static int getNumViolations();
+
+    //---------------------------------------------------------------------------------------------
+    // others:
+
+    /** Sets the violation counter back to zero. */
+    static void resetNumViolations();
+
+    /** Registers a violation, if the calling thread is inside a real-time scope. This is called by
+    the replaced allocation functions but may also be called by client code that wants to assert
+    that it's not invoked from the audio thread. */
+    static void checkViolation();
+
+  protected:
+
+    /** Increments/decrements the calling thread's nesting depth of real-time scopes. */
+    static void enter();
+    static void leave();
+
+  private:
+
+    // scopes are not supposed to be copied:
+    RealTimeScope(const RealTimeScope&);
+    RealTimeScope& operator=(const RealTimeScope&);
+
+  };
+
+  //-----------------------------------------------------------------------------------------------
+  // inlined functions:
+
+#ifdef OPEN303_CHECK_REALTIME
+
+  INLINE RealTimeScope::RealTimeScope()  { enter(); }
+  INLINE RealTimeScope::~RealTimeScope() { leave(); }
+
+#else
+
+  INLINE RealTimeScope::RealTimeScope()  {}
+  INLINE RealTimeScope::~RealTimeScope() {}
+
+#endif
+
+} // end namespace rosic
+
+#endif // rosic_RealTimeScope_h
@@ -0,0 +1,348 @@
+#include "rosic_RenderCache.h"
+#include "rosic_DenormalGuard.h"
+#include "rosic_MappedFile.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include <algorithm>
+
+#ifdef _WIN32
+  #include <windows.h>
+#else
+  #include <sys/stat.h>
+  #include <dirent.h>
+  #include <utime.h>
+#endif
+
+using namespace rosic;
+
+//-------------------------------------------------------------------------------------------------
+// platform specific file handling:
+
+/** Sets the modification time of the file to now. */
+static void touchFile(const std::string& path)
+{
+#ifdef _WIN32
+  HANDLE file = CreateFileA(path.c_str(), FILE_WRITE_ATTRIBUTES, FILE_SHARE_READ, NULL,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if( file == INVALID_HANDLE_VALUE )
+    return;
+  FILETIME now;
+  GetSystemTimeAsFileTime(&now);
+  SetFileTime(file, NULL, NULL, &now);
+  CloseHandle(file);
+#else
+  utime(path.c_str(), NULL);
+#endif
+}
+
+/** A file in the cache directory as found by listFiles. */
+struct FileInfo
+{
+  std::string name;
+  UINT64      size;
+  INT64       modificationTime;
+};
+
+static bool isNewerThan(const FileInfo& a, const FileInfo& b)
+{
+  return a.modificationTime > b.modificationTime;
+}
+
+/** Lists the files in the directory whose names end with the given extension. */
+static void listFiles(const std::string& directory, const char* extension,
+                      std::vector<FileInfo>& files)
+{
+  files.clear();
+  size_t extLength = strlen(extension);
+#ifdef _WIN32
+  WIN32_FIND_DATAA data;
+  HANDLE find = FindFirstFileA((directory + "\\*" + extension).c_str(), &data);
+  if( find == INVALID_HANDLE_VALUE )
+    return;
+  do
+  {
+    FileInfo info;
+    info.name             = data.cFileName;
+    info.size             = ((UINT64) data.nFileSizeHigh << 32) | data.nFileSizeLow;
+    info.modificationTime = ((INT64) data.ftLastWriteTime.dwHighDateTime << 32)
+                            | data.ftLastWriteTime.dwLowDateTime;
+    files.push_back(info);
+  } while( FindNextFileA(find, &data) );
+  FindClose(find);
+#else
+  DIR* dir = opendir(directory.c_str());
+  if( dir == NULL )
+    return;
+  struct dirent* e;
+  while( (e = readdir(dir)) != NULL )
+  {
+    std::string name = e->d_name;
+    if(    name.size() <= extLength
+        || name.compare(name.size()-extLength, extLength, extension) != 0 )
+      continue;
+    struct stat st;
+    if( stat((directory + "/" + name).c_str(), &st) != 0 || !S_ISREG(st.st_mode) )
+      continue;
+    FileInfo info;
+    info.name             = name;
+    info.size             = (UINT64) st.st_size;
+    info.modificationTime = (INT64) st.st_mtime;
+    files.push_back(info);
+  }
+  closedir(dir);
+#endif
+}
+
+//-------------------------------------------------------------------------------------------------
+// hashing:
+
+/** 64-bit FNV-1a hash. */
+static UINT64 hashBytes(const unsigned char* bytes, int numBytes)
+{
+  UINT64 h = 0xCBF29CE484222325ULL;
+  for(int i=0; i<numBytes; i++)
+  {
+    h ^= bytes[i];
+    h *= 0x100000001B3ULL;
+  }
+  return h;
+}
+
+/** Writes everything that determines the output of the synth into the stream. */
+static void writeCanonicalContent(Open303& synth, int numSamples, StateWriter& writer)
+{
+  writer.writeInt(numSamples);
+  synth.writeSettings(writer);
+}
+
+//-------------------------------------------------------------------------------------------------
+// construction/destruction:
+
+RenderCache::RenderCache(const char* directory_, UINT64 capacityInBytes)
+{
+  directory    = directory_;
+  capacity     = capacityInBytes;
+  sizeInBytes  = 0;
+  numHits      = 0;
+  numMisses    = 0;
+  numEvictions = 0;
+  scanDirectory();
+  evict();
+}
+
+RenderCache::~RenderCache()
+{
+
+}
+
+//-------------------------------------------------------------------------------------------------
+// parameter settings:
+
+void RenderCache::setCapacity(UINT64 newCapacityInBytes)
+{
+  capacity = newCapacityInBytes;
+  evict();
+}
+
+//-------------------------------------------------------------------------------------------------
+// inquiry:
+
+UINT64 RenderCache::computeKey(Open303& synth, int numSamples)
+{
+  StateWriter counter(NULL, 0);
+  writeCanonicalContent(synth, numSamples, counter);
+  int contentSize = counter.getNumBytesWritten();
+  int stateSize   = synth.getStateSize();
+
+  std::vector<unsigned char> bytes(contentSize + stateSize);
+  StateWriter writer(&bytes[0], contentSize);
+  writeCanonicalContent(synth, numSamples, writer);
+  synth.saveState(&bytes[contentSize], stateSize);
+
+  return hashBytes(&bytes[0], (int) bytes.size());
+}
+
+double RenderCache::getHitRate() const
+{
+  int numRequests = numHits + numMisses;
+  if( numRequests == 0 )
+    return 0.0;
+  return (double) numHits / (double) numRequests;
+}
+
+//-------------------------------------------------------------------------------------------------
+// processing:
+
+bool RenderCache::render(Open303& synth, float* buffer, int numSamples)
+{
+  UINT64 key = computeKey(synth, numSamples);
+  if( lookup(key, buffer, numSamples) )
+  {
+    numHits++;
+    return true;
+  }
+
+  numMisses++;
+  DenormalGuard denormalGuard;
+  for(int n=0; n<numSamples; n++)
+    buffer[n] = (float) synth.getSample();
+  store(key, buffer, numSamples);
+  return false;
+}
+
+bool RenderCache::lookup(UINT64 key, float* buffer, int numSamples)
+{
+  EntryIterator entry = findEntry(key);
+  if( entry == entries.end() )
+    return false;
+
+  std::string path = getPath(key);
+  MappedFile  file;
+  if( !file.open(path.c_str()) )
+  {
+    removeEntry(entry); // the file has vanished or is unreadable
+    return false;
+  }
+
+  // validate the header (magic, version, key, number of samples):
+  const unsigned char* data = file.getData();
+  int    magic, version, n;
+  UINT64 fileKey;
+  bool   valid = file.getSize() >= 20;
+  if( valid )
+  {
+    memcpy(&magic,   data,    4);
+    memcpy(&version, data+4,  4);
+    memcpy(&fileKey, data+8,  8);
+    memcpy(&n,       data+16, 4);
+    valid =    magic == fileMagic && version == fileVersion && fileKey == key && n == numSamples
+            && file.getSize() == 20 + (UINT64) n * sizeof(float);
+  }
+  if( !valid )
+    return false;
+  memcpy(buffer, data+20, numSamples*sizeof(float));
+  file.close();
+
+  // mark as most recently used:
+  entries.splice(entries.begin(), entries, entry);
+  touchFile(path);
+  return true;
+}
+
+bool RenderCache::store(UINT64 key, const float* samples, int numSamples)
+{
+  EntryIterator entry = findEntry(key);
+  if( entry != entries.end() )
+    removeEntry(entry);
+
+  // write into a temporary file first and rename it, such that no half-written entries can
+  // appear:
+  std::string path    = getPath(key);
+  std::string tmpPath = path + ".tmp";
+  FILE* f = fopen(tmpPath.c_str(), "wb");
+  if( f == NULL )
+    return false;
+  int  magic   = fileMagic;
+  int  version = fileVersion;
+  bool ok      =    fwrite(&magic,      4, 1, f) == 1
+                 && fwrite(&version,    4, 1, f) == 1
+                 && fwrite(&key,        8, 1, f) == 1
+                 && fwrite(&numSamples, 4, 1, f) == 1
+                 && (int) fwrite(samples, sizeof(float), numSamples, f) == numSamples;
+  ok = (fclose(f) == 0) && ok;
+  if( ok )
+  {
+    remove(path.c_str());
+    ok = rename(tmpPath.c_str(), path.c_str()) == 0;
+  }
+  if( !ok )
+  {
+    remove(tmpPath.c_str());
+    return false;
+  }
+
+  Entry e;
+  e.key      = key;
+  e.numBytes = 20 + (UINT64) numSamples * sizeof(float);
+  entries.push_front(e);
+  index[key]   = entries.begin();
+  sizeInBytes += e.numBytes;
+  evict();
+  return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+// others:
+
+void RenderCache::resetMetrics()
+{
+  numHits      = 0;
+  numMisses    = 0;
+  numEvictions = 0;
+}
+
+void RenderCache::clear()
+{
+  while( !entries.empty() )
+    removeEntry(entries.begin());
+}
+
+std::string RenderCache::getPath(UINT64 key) const
+{
+  char name[32];
+  sprintf(name, "%08X%08X.r303", (unsigned int) (key >> 32), (unsigned int) (key & 0xFFFFFFFF));
+  return directory + "/" + name;
+}
+
+RenderCache::EntryIterator RenderCache::findEntry(UINT64 key)
+{
+  std::map<UINT64, EntryIterator>::iterator it = index.find(key);
+  if( it == index.end() )
+    return entries.end();
+  return it->second;
+}
+
+void RenderCache::removeEntry(EntryIterator entry)
+{
+  remove(getPath(entry->key).c_str());
+  sizeInBytes -= entry->numBytes;
+  index.erase(entry->key);
+  entries.erase(entry);
+}
+
+void RenderCache::evict()
+{
+  while( sizeInBytes > capacity && !entries.empty() )
+  {
+    EntryIterator last = entries.end();
+    --last;
+    removeEntry(last);
+    numEvictions++;
+  }
+}
+
+void RenderCache::scanDirectory()
+{
+  std::vector<FileInfo> files;
+  listFiles(directory, ".r303", files);
+  std::stable_sort(files.begin(), files.end(), isNewerThan);
+
+  for(unsigned int i=0; i<files.size(); i++)
+  {
+    // the name is the key in 16 hex digits:
+    unsigned int hi, lo;
+    const std::string& name = files[i].name;
+    if( name.size() != 21 || sscanf(name.c_str(), "%8X%8X", &hi, &lo) != 2 )
+      continue;
+    Entry e;
+    e.key      = ((UINT64) hi << 32) | lo;
+    e.numBytes = files[i].size;
+    if( index.find(e.key) != index.end() )
+      continue;
+    entries.push_back(e);
+    index[e.key]  = --entries.end();
+    sizeInBytes  += e.numBytes;
+  }
+}
@@ -0,0 +1,145 @@
+#ifndef rosic_RenderCache_h
+#define rosic_RenderCache_h
+
+// rosic-indcludes:
+#include "rosic_Open303.h"
+
+#include <string>
+#include <list>
+#include <map>
+
+namespace rosic
+{
+
+  /**
+
+  This is a content-addressed cache for offline renders of Open303. The key of a render is a
+  64-bit hash over everything that determines its output: the canonical content of the active
+  pattern (keys, octaves, accent, slide and gate flags of the played steps, where the content of
+  steps with closed gate is ignored, and the step length), the permissible keys, tempo and
+  sequencer mode, the sample rate, all user parameters, the complete runtime state of the synth (as
+  written by Open303::saveState) and the number of samples. Identical combinations from different
+  patterns of a library thus share one entry.
+
+  The rendered audio is stored as 32-bit float samples in one file per entry inside a directory and
+  read back via memory mapping. When the total size of the entries exceeds the capacity, the least
+  recently used entries are evicted. The order of use survives sessions via the modification times
+  of the files, which are updated on each hit. Note that the files are written in the byte order of
+  the machine, so a cache directory should not be shared between platforms of different
+  endianness.
+
+  The cache is not thread-safe - use one instance per thread (with different directories).
+
+  */
+
+  class RenderCache
+  {
+
+  public:
+
+    //---------------------------------------------------------------------------------------------
+    // construction/destruction:
+
+    /** Constructor. Uses the given directory (which must exist) for the entries and scans it for
+    entries from earlier sessions. The capacity is given in bytes. */
+    RenderCache(const char* directory, UINT64 capacityInBytes);
+
+    /** Destructor. */
+    ~RenderCache();
+
+    //---------------------------------------------------------------------------------------------
+    // parameter settings:
+
+    /** Sets the capacity in bytes - evicts entries when the cache is larger than that. */
+    void setCapacity(UINT64 newCapacityInBytes);
+
+    //---------------------------------------------------------------------------------------------
+    // inquiry:
+
+    /** Computes the key for a render of numSamples samples with the synth in its current state. */
+    static UINT64 computeKey(Open303& synth, int numSamples);
+
+    /** Returns the number of renders that were served from the cache. */
+    int getNumHits() const { return numHits; }
+
+    /** Returns the number of renders that had to be computed. */
+    int getNumMisses() const { return numMisses; }
+
+    /** Returns the ratio of hits to all requests (zero when there were no requests yet). */
+    double getHitRate() const;
+
+    /** Returns the number of entries that were evicted to stay within the capacity. */
+    int getNumEvictions() const { return numEvictions; }
+
+    /** Returns the number of entries in the cache. */
+    int getNumEntries() const { return (int) entries.size(); }
+
+    /** Returns the total size of the entries in bytes. */
+    UINT64 getSizeInBytes() const { return sizeInBytes; }
+
+    //---------------------------------------------------------------------------------------------
+    // processing:
+
+    /** Fills the buffer with numSamples samples of output of the synth. On a hit, the samples are
+    copied from the store and the synth is not touched at all - in particular, it will not advance
+    its state. On a miss, the synth renders the samples (advancing its state) and they are put
+    into the store. Returns true on a hit. */
+    bool render(Open303& synth, float* buffer, int numSamples);
+
+    /** Looks up the entry with the given key and copies its samples into the buffer when it
+    exists and has the expected length. Returns true on success. This does not count as hit or
+    miss. */
+    bool lookup(UINT64 key, float* buffer, int numSamples);
+
+    /** Puts the samples into the store under the given key (replacing an existing entry) and evicts
+    old entries, if necessary. Returns false when the file could not be written. */
+    bool store(UINT64 key, const float* samples, int numSamples);
+
+    //---------------------------------------------------------------------------------------------
+    // others:
+
+    /** Sets the hit, miss and eviction counters back to zero. */
+    void resetMetrics();
+
+    /** Removes all entries (and their files). */
+    void clear();
+
+  protected:
+
+    struct Entry
+    {
+      UINT64 key;
+      UINT64 numBytes; // size of the file
+    };
+    typedef std::list<Entry>::iterator EntryIterator;
+
+    /** Returns the path of the file for the given key. */
+    std::string getPath(UINT64 key) const;
+
+    /** Finds the entry for the given key in the list - returns entries.end() if there is none. */
+    EntryIterator findEntry(UINT64 key);
+
+    /** Removes the given entry and its file. */
+    void removeEntry(EntryIterator entry);
+
+    /** Evicts the least recently used entries until we are within the capacity. */
+    void evict();
+
+    /** Scans the directory for existing entries and sorts them by their modification times. */
+    void scanDirectory();
+
+    static const int fileMagic   = 0x33303352; // 'R303'
+    static const int fileVersion = 1;
+
+    std::string                     directory;
+    std::list<Entry>                entries;     // ordered by use, most recently used at the front
+    std::map<UINT64, EntryIterator> index;       // to find the entries by key
+    UINT64                          capacity;    // maximum total size in bytes
+    UINT64                          sizeInBytes; // current total size
+    int                             numHits, numMisses, numEvictions;
+
+  };
+
+} // end namespace rosic
+
+#endif // rosic_RenderCache_h
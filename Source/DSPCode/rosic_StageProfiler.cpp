@@ -0,0 +1,72 @@
+#include "rosic_StageProfiler.h"
+using namespace rosic;
+
+//-------------------------------------------------------------------------------------------------
+// construction/destruction:
+
+StageProfiler::StageProfiler()
+{
+  clear();
+}
+
+StageProfiler::StageProfiler(const StageProfiler& /*other*/)
+{
+  clear();
+}
+
+StageProfiler& StageProfiler::operator=(const StageProfiler& /*other*/)
+{
+  clear();
+  return *this;
+}
+
+//-------------------------------------------------------------------------------------------------
+// inquiry:
+
+bool StageProfiler::isEnabled()
+{
+#ifdef OPEN303_PROFILE_STAGES
+  return true;
+#else
+  return false;
+#endif
+}
+
+void StageProfiler::getSnapshot(Snapshot* snapshot) const
+{
+#ifdef OPEN303_PROFILE_STAGES
+  // reader side of the sequence lock - retry when the writer was active while we were reading:
+  unsigned s1, s2;
+  do
+  {
+    s1 = sequence.load(std::memory_order_acquire);
+    for(int i=0; i<NUM_STAGES; i++)
+      snapshot->ticks[i] = publishedTicks[i].load(std::memory_order_relaxed);
+    snapshot->numSamples = publishedNumSamples.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    s2 = sequence.load(std::memory_order_relaxed);
+  } while( (s1 & 1) != 0 || s1 != s2 );
+#else
+  for(int i=0; i<NUM_STAGES; i++)
+    snapshot->ticks[i] = 0;
+  snapshot->numSamples = 0;
+#endif
+}
+
+//-------------------------------------------------------------------------------------------------
+// others:
+
+void StageProfiler::clear()
+{
+#ifdef OPEN303_PROFILE_STAGES
+  for(int i=0; i<NUM_STAGES; i++)
+  {
+    accumulated[i] = 0;
+    publishedTicks[i].store(0);
+  }
+  numSamples    = 0;
+  lastTimeStamp = 0;
+  publishedNumSamples.store(0);
+  sequence.store(0);
+#endif
+}
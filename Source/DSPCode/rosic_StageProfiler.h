@@ -0,0 +1,177 @@
+#ifndef rosic_StageProfiler_h
+#define rosic_StageProfiler_h
+
+// rosic-indcludes:
+#include "GlobalDefinitions.h"
+
+// Define OPEN303_PROFILE_STAGES (for example via the compiler's command line) to switch the
+// profiler on. When it is not defined, StageProfiler is an empty class whose inlined member
+// functions do nothing, such that the profiling calls in Open303::getSample compile to nothing.
+#ifdef OPEN303_PROFILE_STAGES
+  #include <atomic>
+  #if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+    #include <intrin.h>
+    #define ROSIC_HAS_RDTSC
+  #elif defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+    #include <x86intrin.h>
+    #define ROSIC_HAS_RDTSC
+  #else
+    #include <chrono>
+  #endif
+#endif
+
+namespace rosic
+{
+
+  /**
+
+  This is a class for accumulating the time that is spent in the various processing stages of
+  Open303::getSample. The audio thread marks the end of each stage via endStage() which attributes
+  the time elapsed since the previous mark to that stage. The time is measured in CPU cycles (via
+  rdtsc) on x86 and in nanoseconds (via std::chrono::steady_clock) elsewhere.
+
+  The accumulated values are published after each sample under a sequence lock, so getSnapshot()
+  may be polled from any other thread and always returns a consistent set of values. Hosts are
+  expected to compute the differences between successive snapshots.
+
+  */
+
+  class StageProfiler
+  {
+
+  public:
+
+    /** Enumeration of the processing stages that are measured separately. */
+    enum stages
+    {
+      SEQUENCER = 0, // step sequencer and note triggering
+      OSCILLATOR,    // wavetable updates, pitch slew and oscillator readout
+      ENVELOPES,     // envelopes and instantaneous cutoff computation
+      PRE_HIGHPASS,  // highpass before the main filter
+      FILTER,        // the TeeBeeFilter
+      DECIMATOR,     // the anti-aliasing filter
+      POST_FILTERS,  // amp declicker, allpass, highpass, notch and amplification
+
+      NUM_STAGES
+    };
+
+    /** A set of accumulated values as returned by getSnapshot(). */
+    struct Snapshot
+    {
+      UINT64 ticks[NUM_STAGES]; // accumulated time per stage
+      UINT64 numSamples;        // number of samples measured so far
+    };
+
+    //---------------------------------------------------------------------------------------------
+    // construction/destruction:
+
+    /** Constructor. */
+    StageProfiler();
+
+    /** Copy constructor. The measurements are not copied - the new profiler starts from zero
+    because it belongs to a different engine. */
+    StageProfiler(const StageProfiler& other);
+
+    /** Assignment operator. Resets the measurements. @see StageProfiler(const StageProfiler&) */
+    StageProfiler& operator=(const StageProfiler& other);
+
+    //---------------------------------------------------------------------------------------------
+    // inquiry:
+
+    /** Returns true when the profiler was compiled in (i.e. OPEN303_PROFILE_STAGES is defined). */
+    static bool isEnabled();
+
+    /** Copies the accumulated values into the passed snapshot - this may be called from any
+    thread. When the profiler is disabled, the snapshot is filled with zeros. */
+    void getSnapshot(Snapshot* snapshot) const;
+
+    //---------------------------------------------------------------------------------------------
+    // measurement (to be called from the audio thread only):
+
+    /** Marks the beginning of a new sample. */
+    INLINE void beginSample();
+
+    /** Attributes the time since the previous mark to the given stage. */
+    INLINE void endStage(int stage);
+
+    /** Marks the end of a sample (or of a block of samples, when the stages were measured for a
+    whole block) and publishes the accumulated values. */
+    INLINE void endSample(int numSamplesMeasured = 1);
+
+    //=============================================================================================
+
+  protected:
+
+    /** Sets all accumulated and published values to zero. */
+    void clear();
+
+#ifdef OPEN303_PROFILE_STAGES
+
+    /** Returns the current value of the time stamp counter. */
+    INLINE static UINT64 readTimeStamp();
+
+    UINT64 accumulated[NUM_STAGES]; // the audio thread's private accumulators
+    UINT64 numSamples;              // number of measured samples
+    UINT64 lastTimeStamp;           // time stamp of the previous mark
+
+    // published copies of the accumulators, guarded by a sequence lock:
+    std::atomic<UINT64>   publishedTicks[NUM_STAGES];
+    std::atomic<UINT64>   publishedNumSamples;
+    std::atomic<unsigned> sequence;
+
+#endif
+
+  };
+
+  //-----------------------------------------------------------------------------------------------
+  // inlined functions:
+
+#ifdef OPEN303_PROFILE_STAGES
+
+  INLINE UINT64 StageProfiler::readTimeStamp()
+  {
+  #ifdef ROSIC_HAS_RDTSC
+    return (UINT64) __rdtsc();
+  #else
+    return (UINT64) std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+  #endif
+  }
+
+  INLINE void StageProfiler::beginSample()
+  {
+    lastTimeStamp = readTimeStamp();
+  }
+
+  INLINE void StageProfiler::endStage(int stage)
+  {
+    UINT64 now           = readTimeStamp();
+    accumulated[stage]  += now - lastTimeStamp;
+    lastTimeStamp        = now;
+  }
+
+  INLINE void StageProfiler::endSample(int numSamplesMeasured)
+  {
+    numSamples += numSamplesMeasured;
+
+    // writer side of the sequence lock - an odd sequence number indicates an update in progress:
+    unsigned s = sequence.load(std::memory_order_relaxed);
+    sequence.store(s+1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for(int i=0; i<NUM_STAGES; i++)
+      publishedTicks[i].store(accumulated[i], std::memory_order_relaxed);
+    publishedNumSamples.store(numSamples, std::memory_order_relaxed);
+    sequence.store(s+2, std::memory_order_release);
+  }
+
+#else
+
+  INLINE void StageProfiler::beginSample() {}
+  INLINE void StageProfiler::endStage(int /*stage*/) {}
+  INLINE void StageProfiler::endSample(int /*numSamplesMeasured*/) {}
+
+#endif
+
+} // end namespace rosic
+
+#endif // rosic_StageProfiler_h
@@ -0,0 +1,145 @@
+#include "rosic_StateStream.h"
+#include <string.h> // for memcpy
+#include <math.h>
+#include <limits>
+using namespace rosic;
+
+//=================================================================================================
+// class StateWriter:
+
+StateWriter::StateWriter(unsigned char* buffer_, int capacity_)
+{
+  buffer        = buffer_;
+  capacity      = buffer_ != NULL ? capacity_ : 0;
+  position      = 0;
+  reference     = NULL;
+  referenceSize = 0;
+  maxDeviation  = 0.0;
+  mismatch      = false;
+}
+
+void StateWriter::writeDouble(double value)
+{
+  UINT64 bits;
+  memcpy(&bits, &value, sizeof(double));
+  if( reference != NULL )
+  {
+    UINT64 referenceBits = readReferenceBits(8);
+    double referenceValue;
+    memcpy(&referenceValue, &referenceBits, sizeof(double));
+    double deviation = fabs(value-referenceValue);
+    double magnitude = fabs(value) > fabs(referenceValue) ? fabs(value) : fabs(referenceValue);
+    if( magnitude > 1.0 )
+      deviation /= magnitude;
+    if( !(deviation <= maxDeviation) ) // also catches NaN
+      maxDeviation = deviation;
+  }
+  writeBits(bits, 8);
+}
+
+void StateWriter::writeInt(int value)
+{
+  UINT64 bits = (UINT64) (unsigned int) value;
+  if( reference != NULL && readReferenceBits(4) != bits )
+    mismatch = true;
+  writeBits(bits, 4);
+}
+
+void StateWriter::writeBool(bool value)
+{
+  UINT64 bits = value ? 1 : 0;
+  if( reference != NULL && readReferenceBits(1) != bits )
+    mismatch = true;
+  writeBits(bits, 1);
+}
+
+void StateWriter::setReference(const unsigned char* reference_, int numBytes)
+{
+  reference     = reference_;
+  referenceSize = reference_ != NULL ? numBytes : 0;
+}
+
+double StateWriter::getMaxDeviation() const
+{
+  if( mismatch )
+    return std::numeric_limits<double>::infinity();
+  return maxDeviation;
+}
+
+void StateWriter::writeBits(UINT64 bits, int numBytes)
+{
+  for(int i=0; i<numBytes; i++)
+  {
+    if( position < capacity )
+      buffer[position] = (unsigned char) ((bits >> (8*i)) & 0xFF);
+    position++;
+  }
+}
+
+UINT64 StateWriter::readReferenceBits(int numBytes)
+{
+  if( position+numBytes > referenceSize )
+  {
+    mismatch = true;
+    return 0;
+  }
+  UINT64 bits = 0;
+  for(int i=0; i<numBytes; i++)
+    bits |= ((UINT64) reference[position+i]) << (8*i);
+  return bits;
+}
+
+//=================================================================================================
+// class StateReader:
+
+StateReader::StateReader(const unsigned char* buffer_, int numBytes_)
+{
+  buffer   = buffer_;
+  numBytes = buffer_ != NULL ? numBytes_ : 0;
+  position = 0;
+  failed   = false;
+}
+
+double StateReader::readDouble()
+{
+  UINT64 bits = readBits(8);
+  double value;
+  memcpy(&value, &bits, sizeof(double));
+  return value;
+}
+
+int StateReader::readInt()
+{
+  return (int) (unsigned int) readBits(4);
+}
+
+bool StateReader::readBool()
+{
+  return readBits(1) != 0;
+}
+
+void StateReader::skip(int numBytesToSkip)
+{
+  if( numBytesToSkip < 0 || position+numBytesToSkip > numBytes )
+  {
+    failed   = true;
+    position = numBytes;
+    return;
+  }
+  position += numBytesToSkip;
+}
+
+UINT64 StateReader::readBits(int numBytesToRead)
+{
+  if( position+numBytesToRead > numBytes )
+  {
+    failed   = true;
+    position = numBytes;
+    return 0;
+  }
+  UINT64 bits = 0;
+  for(int i=0; i<numBytesToRead; i++)
+    bits |= ((UINT64) buffer[position+i]) << (8*i);
+  position += numBytesToRead;
+  return bits;
+}
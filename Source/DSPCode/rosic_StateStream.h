@@ -0,0 +1,129 @@
+#ifndef rosic_StateStream_h
+#define rosic_StateStream_h
+
+// rosic-indcludes:
+#include "GlobalDefinitions.h"
+
+namespace rosic
+{
+
+  /**
+
+  This is a class for serializing the runtime state of DSP objects (filter histories, oscillator
+  phases, etc.) into a compact binary representation. All values are stored in little endian byte
+  order with fixed sizes (8 bytes for doubles, 4 bytes for ints, 1 byte for bools), such that the
+  data may be exchanged between different platforms. The writer never writes beyond the capacity of
+  the buffer - instead, it sets an overflow flag and keeps counting the bytes, so passing a NULL
+  buffer with zero capacity can be used to measure the required size.
+
+  The writer may also compare the values that it writes with a reference state that was written
+  before (@see setReference) - this is used to find out whether a state has repeated within some
+  tolerance.
+
+  */
+
+  class StateWriter
+  {
+
+  public:
+
+    /** Constructor. The buffer must hold at least 'capacity' bytes and may be NULL. */
+    StateWriter(unsigned char* buffer, int capacity);
+
+    /** Writes a double precision number (8 bytes). */
+    void writeDouble(double value);
+
+    /** Writes an integer (4 bytes). */
+    void writeInt(int value);
+
+    /** Writes a boolean (1 byte). */
+    void writeBool(bool value);
+
+    /** Sets a reference state (written by the same sequence of write calls) with which the
+    subsequently written values are compared. Pass NULL to switch the comparison off. */
+    void setReference(const unsigned char* reference, int numBytes);
+
+    /** Returns the largest deviation of a written double from its reference value, where the
+    deviation is the absolute difference for values up to one and the relative difference for
+    larger ones. Ints and bools must match exactly - when they don't (or when more bytes were
+    written than the reference has), the deviation is infinite. @see setReference */
+    double getMaxDeviation() const;
+
+    /** Returns the number of bytes that have been written (or would have been written, in case of
+    an overflow). */
+    int getNumBytesWritten() const { return position; }
+
+    /** Returns true when the capacity of the buffer was not sufficient. */
+    bool hasOverflowed() const { return position > capacity; }
+
+  protected:
+
+    /** Writes the lower numBytes bytes of the passed bit pattern in little endian order. */
+    void writeBits(UINT64 bits, int numBytes);
+
+    /** Returns the bits of the reference at the write position, or sets the mismatch flag and
+    returns zero when the reference is too short. */
+    UINT64 readReferenceBits(int numBytes);
+
+    unsigned char* buffer;   // the buffer to write into
+    int            capacity; // capacity of the buffer in bytes
+    int            position; // write position
+
+    const unsigned char* reference;     // the reference state for comparisons (may be NULL)
+    int                  referenceSize; // size of the reference in bytes
+    double               maxDeviation;  // largest deviation of a double so far
+    bool                 mismatch;      // flag to indicate an int or bool mismatch
+
+  };
+
+  /**
+
+  This is the counterpart to StateWriter which reads the values back. When it's asked to read
+  beyond the end of the buffer, it returns zeros and sets a failure flag.
+
+  */
+
+  class StateReader
+  {
+
+  public:
+
+    /** Constructor. */
+    StateReader(const unsigned char* buffer, int numBytes);
+
+    /** Reads a double precision number (8 bytes). */
+    double readDouble();
+
+    /** Reads an integer (4 bytes). */
+    int readInt();
+
+    /** Reads a boolean (1 byte). */
+    bool readBool();
+
+    /** Advances the read position by the given number of bytes without reading them. */
+    void skip(int numBytesToSkip);
+
+    /** Returns the number of bytes that have been read so far. */
+    int getNumBytesRead() const { return position; }
+
+    /** Returns the number of bytes that are left to read. */
+    int getNumBytesLeft() const { return numBytes - position; }
+
+    /** Returns true when an attempt was made to read beyond the end of the buffer. */
+    bool hasFailed() const { return failed; }
+
+  protected:
+
+    /** Reads numBytes bytes in little endian order and returns them as bit pattern. */
+    UINT64 readBits(int numBytes);
+
+    const unsigned char* buffer;   // the buffer to read from
+    int                  numBytes; // size of the buffer in bytes
+    int                  position; // read position
+    bool                 failed;   // flag to indicate a read beyond the end
+
+  };
+
+} // end namespace rosic
+
+#endif // rosic_StateStream_h
@@ -0,0 +1,277 @@
+#include "rosic_UnisonLanes.h"
+#include "rosic_FastMathVectorOps.h"
+using namespace rosic;
+
+typedef FastMathVectorOps Ops;
+typedef Ops::VD           VD;
+
+//-------------------------------------------------------------------------------------------------
+// construction/destruction:
+
+UnisonLanes::UnisonLanes()
+{
+  numLanes = 1;
+  fbB0     = 1.0;
+  fbB1     = 0.0;
+  fbA1     = 0.0;
+  for(int l=0; l<maxNumLanes; l++)
+  {
+    detunes[l]          = 0.0;
+    startPhases[l]      = 0.0;
+    cutoffOffsets[l]    = 0.0;
+    incrementFactors[l] = 1.0;
+    cutoffFactors[l]    = 1.0;
+    phases[l]           = 0.0;
+    b0[l]               = 0.0;
+    k[l]                = 0.0;
+    g[l]                = 1.0;
+    resetLane(l);
+  }
+}
+
+UnisonLanes::~UnisonLanes()
+{
+
+}
+
+//-------------------------------------------------------------------------------------------------
+// parameter settings:
+
+void UnisonLanes::setNumLanes(int newNumLanes)
+{
+  newNumLanes = clip(newNumLanes, 1, maxNumLanes);
+
+  // the lanes behind numLanes are computed along in the SIMD vectors (with zero input), so we
+  // reset those that are switched off as well:
+  for(int l=rmin(numLanes, newNumLanes); l<maxNumLanes; l++)
+    resetLane(l);
+  numLanes = newNumLanes;
+}
+
+void UnisonLanes::setLaneDetune(int lane, double newDetune)
+{
+  if( lane < 0 || lane >= maxNumLanes )
+    return;
+  detunes[lane]          = newDetune;
+  incrementFactors[lane] = exp2Fast(newDetune/1200.0);
+}
+
+void UnisonLanes::setLaneStartPhase(int lane, double newStartPhase)
+{
+  if( lane < 0 || lane >= maxNumLanes )
+    return;
+  startPhases[lane] = newStartPhase;
+}
+
+void UnisonLanes::setLaneCutoffOffset(int lane, double newOffset)
+{
+  if( lane < 0 || lane >= maxNumLanes )
+    return;
+  cutoffOffsets[lane] = newOffset;
+  cutoffFactors[lane] = exp2Fast(newOffset/12.0);
+}
+
+//-------------------------------------------------------------------------------------------------
+// audio processing:
+
+void UnisonLanes::setCutoff(double cutoff, const TeeBeeFilter& prototype)
+{
+  fbB0 = prototype.feedbackHighpass.b0;
+  fbB1 = prototype.feedbackHighpass.b1;
+  fbA1 = prototype.feedbackHighpass.a1;
+
+  // the same formulas as in TeeBeeFilter::setCutoff and calculateCoefficientsApprox4 (in TB_303
+  // mode), with the same order of operations:
+  VD r = Ops::set(prototype.resonanceSkewed);
+  for(int o=0; o<numLanes; o+=Ops::numLanes)
+  {
+    VD fc = Ops::mul(Ops::set(cutoff), Ops::load(cutoffFactors+o));
+    fc    = Ops::min(Ops::max(fc, Ops::set(200.0)), Ops::set(20000.0));
+    VD wc = Ops::mul(Ops::set(prototype.twoPiOverSampleRate), fc);
+    VD fx = Ops::div(Ops::mul(wc, Ops::set(ONE_OVER_SQRT2)), Ops::set(2*PI));
+
+    VD num = Ops::add(Ops::set(0.00045522346), Ops::mul(Ops::set(6.1922189), fx));
+    VD den = Ops::add(Ops::add(Ops::set(1.0), Ops::mul(Ops::set(12.358354), fx)),
+                      Ops::mul(Ops::set(4.4156345), Ops::mul(fx, fx)));
+    Ops::store(b0+o, Ops::div(num, den));
+
+    VD kv = Ops::add(fx, Ops::set(7198.6997));
+    kv    = Ops::sub(Ops::mul(fx, kv), Ops::set(5837.7917));
+    kv    = Ops::sub(Ops::mul(fx, kv), Ops::set(476.47308));
+    kv    = Ops::add(Ops::mul(fx, kv), Ops::set(614.95611));
+    kv    = Ops::add(Ops::mul(fx, kv), Ops::set(213.87126));
+    kv    = Ops::add(Ops::mul(fx, kv), Ops::set(16.998792));
+
+    VD gv = Ops::mul(kv, Ops::set(0.058823529411764705882352941176471));
+    gv    = Ops::add(Ops::mul(Ops::sub(gv, Ops::set(1.0)), r), Ops::set(1.0));
+    gv    = Ops::mul(gv, Ops::add(Ops::set(1.0), r));
+    Ops::store(g+o, gv);
+    Ops::store(k+o, Ops::mul(kv, r));
+  }
+}
+
+void UnisonLanes::render(const BlendOscillator& oscillator, const OnePoleFilter& preHighpass,
+                         double* buffer, int numSamples)
+{
+  static const int chunkSize = 16;
+  double in[chunkSize*maxNumLanes];   // the oscillator outputs, sample by sample
+  double out[Ops::numLanes];
+  double increment = oscillator.getIncrement();
+  double gain      = 1.0 / sqrt((double) numLanes);
+  int    numPadded = ((numLanes+Ops::numLanes-1) / Ops::numLanes) * Ops::numLanes;
+  int    l, n;
+
+  VD hpB0   = Ops::set(preHighpass.b0);
+  VD hpB1   = Ops::set(preHighpass.b1);
+  VD hpA1   = Ops::set(preHighpass.a1);
+  VD fb0    = Ops::set(fbB0);
+  VD fb1    = Ops::set(fbB1);
+  VD fa1    = Ops::set(fbA1);
+  VD two    = Ops::set(2.0);
+  VD r6     = Ops::set(1.0/6.0);
+  VD limit  = Ops::set(SQRT2);
+  VD mLimit = Ops::set(-SQRT2);
+
+  for(int start=0; start<numSamples; start+=chunkSize)
+  {
+    int length = rmin(chunkSize, numSamples-start);
+
+    // the table lookups, lane by lane (the padding lanes get zero input):
+    for(n=0; n<length; n++)
+    {
+      double* x = &in[n*maxNumLanes];
+      for(l=0; l<numLanes; l++)
+        x[l] = -oscillator.getSample(&phases[l], increment*incrementFactors[l]);
+      for(l=numLanes; l<numPadded; l++)
+        x[l] = 0.0;
+      buffer[start+n] = 0.0;
+    }
+
+    // the filters, Ops::numLanes lanes at a time:
+    for(int o=0; o<numPadded; o+=Ops::numLanes)
+    {
+      VD b  = Ops::load(b0+o);
+      VD b2 = Ops::mul(two, b);
+      VD kv = Ops::load(k+o);
+      VD g2 = Ops::mul(two, Ops::load(g+o));
+      VD hx = Ops::load(hpX1+o), hy = Ops::load(hpY1+o);
+      VD fx = Ops::load(fbX1+o), fy = Ops::load(fbY1+o);
+      VD s1 = Ops::load(y1+o), s2 = Ops::load(y2+o), s3 = Ops::load(y3+o), s4 = Ops::load(y4+o);
+      int numActive = rmin(numLanes-o, Ops::numLanes);
+
+      for(n=0; n<length; n++)
+      {
+        // pre-filter highpass:
+        VD x = Ops::load(&in[n*maxNumLanes+o]);
+        hy   = Ops::add(Ops::add(Ops::mul(hpB0, x), Ops::mul(hpB1, hx)), Ops::mul(hpA1, hy));
+        hx   = x;
+
+        // feedback through the shaper and the feedback highpass:
+        VD sh = Ops::min(Ops::max(s4, mLimit), limit);
+        sh    = Ops::sub(sh, Ops::mul(Ops::mul(Ops::mul(r6, sh), sh), sh));
+        VD fi = Ops::mul(kv, sh);
+        fy    = Ops::add(Ops::add(Ops::mul(fb0, fi), Ops::mul(fb1, fx)), Ops::mul(fa1, fy));
+        fx    = fi;
+
+        // the ladder:
+        VD y0 = Ops::sub(hy, fy);
+        s1 = Ops::add(s1, Ops::mul(b2, Ops::add(Ops::sub(y0, s1), s2)));
+        s2 = Ops::add(s2, Ops::mul(b,  Ops::add(Ops::sub(s1, Ops::mul(two, s2)), s3)));
+        s3 = Ops::add(s3, Ops::mul(b,  Ops::add(Ops::sub(s2, Ops::mul(two, s3)), s4)));
+        s4 = Ops::add(s4, Ops::mul(b,  Ops::sub(s3, Ops::mul(two, s4))));
+
+        Ops::store(out, Ops::mul(g2, s4));
+        for(l=0; l<numActive; l++)
+          buffer[start+n] += out[l];
+      }
+
+      Ops::store(hpX1+o, hx);
+      Ops::store(hpY1+o, hy);
+      Ops::store(fbX1+o, fx);
+      Ops::store(fbY1+o, fy);
+      Ops::store(y1+o, s1);
+      Ops::store(y2+o, s2);
+      Ops::store(y3+o, s3);
+      Ops::store(y4+o, s4);
+    }
+
+    for(n=0; n<length; n++)
+      buffer[start+n] *= gain;
+  }
+}
+
+//-------------------------------------------------------------------------------------------------
+// others:
+
+void UnisonLanes::resetPhases(const BlendOscillator& oscillator)
+{
+  for(int l=0; l<maxNumLanes; l++)
+  {
+    double phase = oscillator.startIndex + (startPhases[l]/360.0)*oscillator.tableLengthDbl;
+    phases[l]    = fmod(phase, oscillator.tableLengthDbl);
+    if( phases[l] < 0.0 )
+      phases[l] += oscillator.tableLengthDbl;
+  }
+}
+
+void UnisonLanes::reset()
+{
+  for(int l=0; l<maxNumLanes; l++)
+    resetLane(l);
+}
+
+void UnisonLanes::saveState(StateWriter& writer) const
+{
+  for(int l=0; l<maxNumLanes; l++)
+  {
+    writer.writeDouble(phases[l]);
+    writer.writeDouble(hpX1[l]);
+    writer.writeDouble(hpY1[l]);
+    writer.writeDouble(fbX1[l]);
+    writer.writeDouble(fbY1[l]);
+    writer.writeDouble(y1[l]);
+    writer.writeDouble(y2[l]);
+    writer.writeDouble(y3[l]);
+    writer.writeDouble(y4[l]);
+  }
+}
+
+void UnisonLanes::loadState(StateReader& reader)
+{
+  for(int l=0; l<maxNumLanes; l++)
+  {
+    phases[l] = reader.readDouble();
+    hpX1[l]   = reader.readDouble();
+    hpY1[l]   = reader.readDouble();
+    fbX1[l]   = reader.readDouble();
+    fbY1[l]   = reader.readDouble();
+    y1[l]     = reader.readDouble();
+    y2[l]     = reader.readDouble();
+    y3[l]     = reader.readDouble();
+    y4[l]     = reader.readDouble();
+  }
+}
+
+bool UnisonLanes::isStateValid(StateReader& reader, const BlendOscillator& oscillator) const
+{
+  bool valid = true;
+  for(int l=0; l<maxNumLanes; l++)
+  {
+    double phase = reader.readDouble();
+    if( !(phase >= 0.0 && phase < oscillator.tableLengthDbl) ) // false for NaNs, too
+      valid = false;
+    for(int i=0; i<8; i++) // the filter states
+      reader.readDouble();
+  }
+  return valid;
+}
+
+//-------------------------------------------------------------------------------------------------
+// internal functions:
+
+void UnisonLanes::resetLane(int lane)
+{
+  hpX1[lane] = hpY1[lane] = 0.0;
+  fbX1[lane] = fbY1[lane] = 0.0;
+  y1[lane]   = y2[lane]   = y3[lane] = y4[lane] = 0.0;
+}
@@ -0,0 +1,145 @@
+#ifndef rosic_UnisonLanes_h
+#define rosic_UnisonLanes_h
+
+// rosic-indcludes:
+#include "rosic_BlendOscillator.h"
+#include "rosic_OnePoleFilter.h"
+#include "rosic_TeeBeeFilter.h"
+#include "rosic_StateStream.h"
+
+namespace rosic
+{
+
+  /**
+
+  This is a class for rendering a stack of detuned oscillator/filter voices (lanes) within one
+  Open303. Each lane has its own phase, a detune (applied to the frequency of the shared
+  oscillator), a start phase and a cutoff offset (applied to the shared instantaneous cutoff
+  frequency) and runs its own pre-filter highpass and TB_303 filter. Everything else - sequencer,
+  envelopes, slew limiter, cutoff modulation and the parameters of oscillator and filters - is
+  shared, such that the control path is computed once for all lanes.
+
+  The lanes read the shared oscillator's wavetables one after another (the table lookups don't
+  vectorize), but the filters of several lanes are computed at once in the lanes of the SIMD
+  vectors of FastMathVectorOps, as are their coefficients. The outputs of the lanes are summed
+  and divided by the square root of the number of lanes, which keeps the level of the detuned
+  (uncorrelated) stack about the same as that of a single voice.
+
+  The lanes only emulate the TB_303 mode of TeeBeeFilter, which is the one that Open303 uses by
+  default. In the other modes, Open303 renders a single voice through its TeeBeeFilter instead.
+
+  */
+
+  class UnisonLanes
+  {
+
+  public:
+
+    /** The maximum number of lanes. */
+    static const int maxNumLanes = 8;
+
+    //---------------------------------------------------------------------------------------------
+    // construction/destruction:
+
+    /** Constructor. */
+    UnisonLanes();
+
+    /** Destructor. */
+    ~UnisonLanes();
+
+    //---------------------------------------------------------------------------------------------
+    // parameter settings:
+
+    /** Sets the number of lanes (1...maxNumLanes). Lanes that are switched on are reset. */
+    void setNumLanes(int newNumLanes);
+
+    /** Sets the detune of a lane in cents. */
+    void setLaneDetune(int lane, double newDetune);
+
+    /** Sets the phase (in degrees) to which a lane's oscillator is reset by resetPhases. */
+    void setLaneStartPhase(int lane, double newStartPhase);
+
+    /** Sets the offset of a lane's cutoff frequency with respect to the shared cutoff frequency
+    in semitones. */
+    void setLaneCutoffOffset(int lane, double newOffset);
+
+    //---------------------------------------------------------------------------------------------
+    // inquiry:
+
+    /** Returns the number of lanes. */
+    int getNumLanes() const { return numLanes; }
+
+    /** Returns the detune of a lane in cents. */
+    double getLaneDetune(int lane) const { return detunes[lane]; }
+
+    /** Returns the start phase of a lane in degrees. */
+    double getLaneStartPhase(int lane) const { return startPhases[lane]; }
+
+    /** Returns the cutoff offset of a lane in semitones. */
+    double getLaneCutoffOffset(int lane) const { return cutoffOffsets[lane]; }
+
+    //---------------------------------------------------------------------------------------------
+    // audio processing:
+
+    /** Calculates the filter coefficients of all lanes from the shared instantaneous cutoff
+    frequency and the resonance, sample rate and feedback highpass of the prototype filter (the
+    result for a lane without cutoff offset is the same as the prototype's after
+    prototype.setCutoff(cutoff)). The prototype is assumed to be in TB_303 mode. */
+    void setCutoff(double cutoff, const TeeBeeFilter& prototype);
+
+    /** Renders the sum of the lanes into the buffer - the lanes run the oscillator's waveform at
+    its current increment (times their detune factors) through their own copies of the pre-filter
+    highpass and the filter. The oscillator itself is not advanced. For a single lane without
+    detune and offsets, the output is the same as that of the chain
+    filter.getSample(preHighpass.getSample(-oscillator.getSample())). */
+    void render(const BlendOscillator& oscillator, const OnePoleFilter& preHighpass,
+                double* buffer, int numSamples);
+
+    //---------------------------------------------------------------------------------------------
+    // others:
+
+    /** Resets the phases of the lanes to the oscillator's start phase plus their own start
+    phases. */
+    void resetPhases(const BlendOscillator& oscillator);
+
+    /** Resets the states of the lane's filters. */
+    void reset();
+
+    /** Writes the phases and the filter states of the lanes into the stream (all maxNumLanes of
+    them, such that the size of the state doesn't depend on the settings). */
+    void saveState(StateWriter& writer) const;
+
+    /** Reads the phases and filter states back from the stream. @see saveState */
+    void loadState(StateReader& reader);
+
+    /** Reads a state like loadState does, but only returns whether it can be loaded, i.e. whether
+    all phases are valid indices into the tables of the oscillator. */
+    bool isStateValid(StateReader& reader, const BlendOscillator& oscillator) const;
+
+    //=============================================================================================
+
+  protected:
+
+    /** Resets the filter states of a single lane. */
+    void resetLane(int lane);
+
+    int    numLanes;
+    double detunes[maxNumLanes], startPhases[maxNumLanes], cutoffOffsets[maxNumLanes];
+
+    // the per lane values as arrays, such that the lanes of a SIMD vector are adjacent:
+    double incrementFactors[maxNumLanes]; // 2^(detune/1200)
+    double cutoffFactors[maxNumLanes];    // 2^(offset/12)
+    double phases[maxNumLanes];
+    double b0[maxNumLanes], k[maxNumLanes], g[maxNumLanes];   // filter coefficients
+    double y1[maxNumLanes], y2[maxNumLanes], y3[maxNumLanes], y4[maxNumLanes];
+    double hpX1[maxNumLanes], hpY1[maxNumLanes]; // pre-filter highpass states
+    double fbX1[maxNumLanes], fbY1[maxNumLanes]; // feedback highpass states
+
+    // the coefficients of the feedback highpass (copied from the prototype in setCutoff):
+    double fbB0, fbB1, fbA1;
+
+  };
+
+} // end namespace rosic
+
+#endif // rosic_UnisonLanes_h
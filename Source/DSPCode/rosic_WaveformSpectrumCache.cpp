@@ -0,0 +1,205 @@
+#include "rosic_WaveformSpectrumCache.h"
+using namespace rosic;
+
+//-------------------------------------------------------------------------------------------------
+// construction/destruction:
+
+WaveformSpectrumCache::WaveformSpectrumCache(int maxNumEntries_)
+{
+  maxNumEntries = maxNumEntries_ > 0 ? maxNumEntries_ : 1;
+  numHits       = 0;
+  numMisses     = 0;
+}
+
+WaveformSpectrumCache& WaveformSpectrumCache::getSharedInstance()
+{
+  static WaveformSpectrumCache sharedInstance;
+  return sharedInstance;
+}
+
+//-------------------------------------------------------------------------------------------------
+// parameter settings:
+
+void WaveformSpectrumCache::setMaxNumEntries(int newMaxNumEntries)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  maxNumEntries = newMaxNumEntries > 0 ? newMaxNumEntries : 1;
+  evict();
+}
+
+//-------------------------------------------------------------------------------------------------
+// inquiry:
+
+int WaveformSpectrumCache::getNumHits() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return numHits;
+}
+
+int WaveformSpectrumCache::getNumMisses() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return numMisses;
+}
+
+//-------------------------------------------------------------------------------------------------
+// processing:
+
+/** 64-bit FNV-1a hash over the lengths and the samples. */
+static UINT64 computeKey(const double* waveform, int length, int fftSize)
+{
+  UINT64 h = 0xCBF29CE484222325ULL;
+  const unsigned char* bytes;
+  int i;
+
+  bytes = (const unsigned char*) &length;
+  for(i=0; i<(int)sizeof(length); i++)
+  {
+    h ^= bytes[i];
+    h *= 0x100000001B3ULL;
+  }
+  bytes = (const unsigned char*) &fftSize;
+  for(i=0; i<(int)sizeof(fftSize); i++)
+  {
+    h ^= bytes[i];
+    h *= 0x100000001B3ULL;
+  }
+  bytes = (const unsigned char*) waveform;
+  for(i=0; i<length*(int)sizeof(double); i++)
+  {
+    h ^= bytes[i];
+    h *= 0x100000001B3ULL;
+  }
+  return h;
+}
+
+void WaveformSpectrumCache::getSpectrum(const double* waveform, int length, double* spectrum,
+                                        int fftSize)
+{
+  UINT64 key = computeKey(waveform, length, fftSize);
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::map<UINT64, EntryIterator>::iterator found = index.find(key);
+    if( found != index.end() )
+    {
+      entries.splice(entries.begin(), entries, found->second); // most recently used
+      const std::vector<double>& cached = entries.front().spectrum;
+      for(int i=0; i<fftSize; i++)
+        spectrum[i] = cached[i];
+      numHits++;
+      return;
+    }
+  }
+
+  // compute the spectrum without holding the lock, such that other threads may use the cache
+  // in the meantime:
+  computeSpectrum(waveform, length, spectrum, fftSize);
+
+  std::lock_guard<std::mutex> lock(mutex);
+  numMisses++;
+  if( index.find(key) == index.end() ) // another thread may have stored it in the meantime
+  {
+    Entry entry;
+    entry.key = key;
+    entry.spectrum.assign(spectrum, spectrum+fftSize);
+    entries.push_front(entry);
+    index[key] = entries.begin();
+    evict();
+  }
+}
+
+void WaveformSpectrumCache::computeSpectrum(const double* waveform, int length, double* spectrum,
+                                            int fftSize)
+{
+  int k;
+  for(k=0; k<fftSize; k++)
+    spectrum[k] = 0.0;
+  if( length < 1 )
+    return;
+
+  // the harmonics that both lengths can represent (the Nyquist bins are left out because their
+  // phases are ambiguous):
+  int numBins = (rmin(length, fftSize)+1) / 2;
+
+  std::vector<Complex> bins(numBins);
+  if( length >= 2 && isPowerOfTwo(length) )
+  {
+    std::vector<double> tmp(waveform, waveform+length);
+    FourierTransformerRadix2 transformer;
+    transformer.setBlockSize(length);
+    transformer.transformRealSignal(&tmp[0], &tmp[0]);
+    bins[0] = Complex(tmp[0], 0.0);
+    for(k=1; k<numBins; k++)
+      bins[k] = Complex(tmp[2*k], tmp[2*k+1]);
+  }
+  else
+    bluestein(waveform, length, &bins[0], numBins);
+
+  // the resampled cycle has fftSize instead of length samples, so the (unnormalized) DFT values
+  // scale by the ratio of the lengths:
+  double scaler = (double) fftSize / (double) length;
+  for(k=0; k<numBins; k++)
+  {
+    spectrum[2*k]   = scaler * bins[k].re;
+    spectrum[2*k+1] = scaler * bins[k].im;
+  }
+  spectrum[1] = 0.0; // the Nyquist value (the imaginary part of DC is zero anyway)
+}
+
+void WaveformSpectrumCache::clear()
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  entries.clear();
+  index.clear();
+}
+
+//-------------------------------------------------------------------------------------------------
+// internal functions:
+
+void WaveformSpectrumCache::bluestein(const double* signal, int length, Complex* bins,
+                                      int numBins)
+{
+  // with k*n = (k^2 + n^2 - (k-n)^2) / 2, the DFT becomes a convolution with the chirp
+  // c[m] = exp(i*pi*m^2/length), which is computed via FFTs of a power-of-2 size >= 2*length-1:
+  int M = 2;
+  while( M < 2*length-1 )
+    M *= 2;
+
+  std::vector<Complex> chirp(length), a(M), b(M);
+  int n;
+  for(n=0; n<length; n++)
+  {
+    // reduce n^2 modulo 2*length to keep the argument of the exponential small:
+    double phi = PI * (double) (((long long) n * n) % (2*length)) / (double) length;
+    chirp[n]   = Complex(cos(phi), sin(phi));
+  }
+  for(n=0; n<length; n++)
+  {
+    a[n] = signal[n] * chirp[n].getConjugate();
+    b[n] = chirp[n];
+    if( n > 0 )
+      b[M-n] = chirp[n];
+  }
+
+  FourierTransformerRadix2 transformer;
+  transformer.setBlockSize(M);
+  transformer.setDirection(FourierTransformerRadix2::FORWARD);
+  transformer.transformComplexBufferInPlace(&a[0]);
+  transformer.transformComplexBufferInPlace(&b[0]);
+  for(n=0; n<M; n++)
+    a[n] *= b[n];
+  transformer.setDirection(FourierTransformerRadix2::INVERSE);
+  transformer.transformComplexBufferInPlace(&a[0]);
+
+  for(int k=0; k<numBins; k++)
+    bins[k] = chirp[k].getConjugate() * a[k];
+}
+
+void WaveformSpectrumCache::evict()
+{
+  while( (int) entries.size() > maxNumEntries )
+  {
+    index.erase(entries.back().key);
+    entries.pop_back();
+  }
+}
@@ -0,0 +1,105 @@
+#ifndef rosic_WaveformSpectrumCache_h
+#define rosic_WaveformSpectrumCache_h
+
+// rosic-indcludes:
+#include "rosic_FourierTransformerRadix2.h"
+#include "rosic_FunctionTemplates.h"
+
+#include <list>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace rosic
+{
+
+  /**
+
+  This class computes the spectra of single-cycle waveforms of arbitrary length as they would be
+  after periodic (sinc-) resampling to a power-of-2 length, and caches them keyed by the content
+  of the waveform. The spectrum is computed directly from the DFT of the original cycle (scaled
+  by the ratio of the lengths and truncated to the harmonics that both lengths can represent), so
+  the resampled waveform itself never needs to be formed - MipMappedWaveTable uses the spectrum
+  directly for its bandlimited versions. Power-of-2 lengths use the radix-2 FFT directly, other
+  lengths use Bluestein's algorithm (a chirp convolution via radix-2 FFTs).
+
+  The computation allocates memory and takes some time, so it should happen outside the audio
+  thread (typically in the thread that loads the waveforms). When a library of waveforms is loaded
+  into several oscillators or synth instances, each waveform is transformed only once. The cache
+  keeps the most recently used entries up to a maximum number of entries. All functions are
+  thread-safe.
+
+  */
+
+  class WaveformSpectrumCache
+  {
+
+  public:
+
+    //---------------------------------------------------------------------------------------------
+    // construction/destruction:
+
+    /** Constructor. */
+    WaveformSpectrumCache(int maxNumEntries = 256);
+
+    /** Returns an instance that is shared by all MipMappedWaveTable objects. */
+    static WaveformSpectrumCache& getSharedInstance();
+
+    //---------------------------------------------------------------------------------------------
+    // parameter settings:
+
+    /** Sets the maximum number of entries - evicts the least recently used entries, if there are
+    more than that. */
+    void setMaxNumEntries(int newMaxNumEntries);
+
+    //---------------------------------------------------------------------------------------------
+    // inquiry:
+
+    /** Returns the number of requests that were served from the cache. */
+    int getNumHits() const;
+
+    /** Returns the number of requests for which the spectrum had to be computed. */
+    int getNumMisses() const;
+
+    //---------------------------------------------------------------------------------------------
+    // processing:
+
+    /** Fills the spectrum (of length fftSize, which must be a power of 2) with the spectrum of the
+    cycle of 'length' samples after resampling to fftSize samples. The format is the one of
+    FourierTransformerRadix2::transformRealSignal (interleaved re/im with the Nyquist value in
+    spectrum[1], which is always zero here). Looks the result up in the cache first. */
+    void getSpectrum(const double* waveform, int length, double* spectrum, int fftSize);
+
+    /** Computes the spectrum like getSpectrum, but without the cache. */
+    static void computeSpectrum(const double* waveform, int length, double* spectrum,
+      int fftSize);
+
+    /** Removes all entries. */
+    void clear();
+
+  protected:
+
+    struct Entry
+    {
+      UINT64              key;
+      std::vector<double> spectrum;
+    };
+    typedef std::list<Entry>::iterator EntryIterator;
+
+    /** Computes the unnormalized DFT bins 0...numBins-1 of the signal of given length via
+    Bluestein's algorithm. */
+    static void bluestein(const double* signal, int length, Complex* bins, int numBins);
+
+    /** Evicts the least recently used entries until there are at most maxNumEntries. */
+    void evict();
+
+    std::list<Entry>                entries; // ordered by use, most recently used at the front
+    std::map<UINT64, EntryIterator> index;   // to find the entries by key
+    int                             maxNumEntries, numHits, numMisses;
+    mutable std::mutex              mutex;
+
+  };
+
+} // end namespace rosic
+
+#endif // rosic_WaveformSpectrumCache_h
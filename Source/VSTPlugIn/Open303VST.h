@@ -1,117 +1,151 @@
-#ifndef Open303VST_h
-#define Open303VST_h
-
-#include "public.sdk/source/vst2.x/audioeffectx.h"
-#include "../DSPCode/rosic_Open303.h"
-using namespace rosic;
-
-//#define SHOW_INTERNAL_PARAMETERS // comment this for builds that should only show 'user'-parameters
-
-enum Open303Parameters
-{
-  WAVEFORM = 0,
-  TUNING,
-  CUTOFF,
-  RESONANCE,
-  ENVMOD,
-  DECAY,
-  ACCENT,
-  VOLUME,
-
-  FILTER_TYPE,
-
-#ifdef SHOW_INTERNAL_PARAMETERS
-  AMP_SUSTAIN,
-  TANH_SHAPER_DRIVE,
-  TANH_SHAPER_OFFSET,
-  PRE_FILTER_HPF,
-  FEEDBACK_HPF,
-  POST_FILTER_HPF,
-  SQUARE_PHASE_SHIFT,
-#endif
-
-  OPEN303_NUM_PARAMETERS
-};
-
-//=================================================================================================
-// class Open303VSTProgram:
-
-class Open303VSTProgram
-{
-  friend class Open303VST;
-public:
-  Open303VSTProgram();
-  ~Open303VSTProgram() {}
-private:
-  float parameters[OPEN303_NUM_PARAMETERS];
-  char  name[kVstMaxProgNameLen+1];
-};
-
-//=================================================================================================
-// class Open303VST:
-
-class Open303VST : public AudioEffectX
-{
-public:
-
-  // construction/destruction:
-  Open303VST (audioMasterCallback audioMaster);
-  ~Open303VST();
-
-  // audio- and event processing:
-  virtual void     processReplacing(float** inputs, float** outputs, VstInt32 sampleFrames);
-  virtual VstInt32 processEvents   (VstEvents* events);
-  virtual void     handleEvent     (VstMidiEvent midiEvent);
-
-  // program handling:
-  virtual void     setProgram           (VstInt32 program);
-  virtual void     setProgramName       (char* name);
-  virtual void     getProgramName       (char* name);
-  virtual bool     getProgramNameIndexed(VstInt32 category, VstInt32 index, char* text);
-
-  // parameter handling:
-  virtual void     setParameter       (VstInt32 index, float value);
-  virtual float    getParameter       (VstInt32 index);
-  virtual void     getParameterLabel  (VstInt32 index, char* label);
-  virtual void     getParameterDisplay(VstInt32 index, char* text);
-  virtual void     getParameterName   (VstInt32 index, char* text);
-
-  // audio processing parameters:
-  virtual void     setSampleRate(float    sampleRate);
-  virtual void     setBlockSize (VstInt32 blockSize);
-
-  // callbacks to pass plugin info to the host:
-  virtual bool     getOutputProperties(VstInt32 index, VstPinProperties* properties);
-  virtual bool     getEffectName   (char* name);
-  virtual bool     getVendorString (char* text);
-  virtual bool     getProductString(char* text);
-  virtual VstInt32 getVendorVersion();
-  virtual VstInt32 canDo           (char* text);
-  virtual VstInt32 getNumMidiInputChannels () { return 1; }
-  virtual VstInt32 getNumMidiOutputChannels() { return 0; }
-
-private:
-
-  // internal functions:
-  void noteOn(VstInt32 note, VstInt32 velocity, VstInt32 delta);
-
-  /** Converts the data bytes of a MIDI pitchwheel message into a value in semitones. */
-  double convertToPitch(unsigned char highByte,unsigned char lowByte);
-
-  static const int numOutputs  = 2;
-  static const int numPrograms = 128;
-
-  // program handling:
-  Open303VSTProgram* programs;
-  VstInt32           channelPrograms[16];
-
-  // MIDI event handling:
-	int      eventBufferLength;
-	VstEvent *eventBuffer;
-
-  // the embedded core dsp object:
-  Open303 open303Core;
-
-};
-
-#endif
+#ifndef Open303VST_h
+#define Open303VST_h
+
+#include "public.sdk/source/vst2.x/audioeffectx.h"
+#include "../DSPCode/rosic_Open303.h"
+#include "../DSPCode/rosic_AutomationSpan.h"
+#include "../DSPCode/rosic_DenormalGuard.h"
+using namespace rosic;
+
+//#define SHOW_INTERNAL_PARAMETERS // comment this for builds that should only show 'user'-parameters
+
+enum Open303Parameters
+{
+  WAVEFORM = 0,
+  TUNING,
+  CUTOFF,
+  RESONANCE,
+  ENVMOD,
+  DECAY,
+  ACCENT,
+  VOLUME,
+
+  FILTER_TYPE,
+
+#ifdef SHOW_INTERNAL_PARAMETERS
+  AMP_SUSTAIN,
+  TANH_SHAPER_DRIVE,
+  TANH_SHAPER_OFFSET,
+  PRE_FILTER_HPF,
+  FEEDBACK_HPF,
+  POST_FILTER_HPF,
+  SQUARE_PHASE_SHIFT,
+#endif
+
+  OPEN303_NUM_PARAMETERS
+};
+
+//=================================================================================================
+// class Open303VSTProgram:
+
+class Open303VSTProgram
+{
+  friend class Open303VST;
+public:
+  Open303VSTProgram();
+  ~Open303VSTProgram() {}
+private:
+  float parameters[OPEN303_NUM_PARAMETERS];
+  char  name[kVstMaxProgNameLen+1];
+};
+
+//=================================================================================================
+// class Open303VST:
+
+class Open303VST : public AudioEffectX
+{
+public:
+
+  // construction/destruction:
+  Open303VST (audioMasterCallback audioMaster);
+  ~Open303VST();
+
+  // audio- and event processing:
+  virtual void     processReplacing(float** inputs, float** outputs, VstInt32 sampleFrames);
+  virtual VstInt32 processEvents   (VstEvents* events);
+  virtual void     handleEvent     (VstMidiEvent midiEvent);
+
+  // program handling:
+  virtual void     setProgram           (VstInt32 program);
+  virtual void     setProgramName       (char* name);
+  virtual void     getProgramName       (char* name);
+  virtual bool     getProgramNameIndexed(VstInt32 category, VstInt32 index, char* text);
+
+  // parameter handling:
+  virtual void     setParameter       (VstInt32 index, float value);
+  virtual float    getParameter       (VstInt32 index);
+  virtual void     getParameterLabel  (VstInt32 index, char* label);
+  virtual void     getParameterDisplay(VstInt32 index, char* text);
+  virtual void     getParameterName   (VstInt32 index, char* text);
+
+  // audio processing parameters:
+  virtual void     setSampleRate(float    sampleRate);
+  virtual void     setBlockSize (VstInt32 blockSize);
+
+  // callbacks to pass plugin info to the host:
+  virtual bool     getOutputProperties(VstInt32 index, VstPinProperties* properties);
+  virtual bool     getEffectName   (char* name);
+  virtual bool     getVendorString (char* text);
+  virtual bool     getProductString(char* text);
+  virtual VstInt32 getVendorVersion();
+  virtual VstInt32 canDo           (char* text);
+  virtual VstInt32 getNumMidiInputChannels () { return 1; }
+  virtual VstInt32 getNumMidiOutputChannels() { return 0; }
+
+private:
+
+  // internal functions:
+  void noteOn(VstInt32 note, VstInt32 velocity, VstInt32 delta);
+
+  /** Converts the data bytes of a MIDI pitchwheel message into a value in semitones. */
+  double convertToPitch(unsigned char highByte,unsigned char lowByte);
+
+  /** Returns the index of the parameter that is controlled by the given MIDI controller number or
+  -1, if the controller isn't mapped. */
+  int controllerToParameter(unsigned char controllerNumber);
+
+  /** Returns the index of the core's automatable parameter (see Open303::automatableParameters)
+  that corresponds to our parameter with the given index or -1, if there is none. */
+  int getAutomatableIndex(VstInt32 index);
+
+  /** Maps a normalized value of one of the automatable parameters into the unit of the
+  corresponding setter of the core. */
+  double mapToCore(VstInt32 index, float value);
+
+  /** Renders the samples from start to end (exclusive) into the outputs, applying the controller
+  breakpoints that were collected for this segment sample accurately. Afterwards, the parameters
+  are updated to their last values (and the host is notified) and the breakpoints are cleared. */
+  void renderSegment(float* out1, float* out2, int start, int end);
+
+  static const int numOutputs   = 2;
+  static const int numPrograms  = 128;
+  static const int maxNumEvents = 1024; // events beyond that number within one block are dropped
+  static const int renderBufferSize = 256;
+  static const int numAutomatable   = Open303::NUM_AUTOMATABLE_PARAMETERS;
+
+  // program handling:
+  Open303VSTProgram* programs;
+  VstInt32           channelPrograms[16];
+
+  // MIDI event handling (the buffer is preallocated to avoid memory allocation in the audio
+  // thread):
+	int      eventBufferLength;
+	VstEvent eventBuffer[maxNumEvents];
+
+  // the controller events for the automatable parameters within the current segment of a block
+  // are passed to the core as breakpoints (in the core's units), such that they are applied
+  // sample accurately without splitting the block:
+  AutomationSpan  automationSpans[numAutomatable];
+  AutomationSpan* automationPointers[numAutomatable];
+  int             numBreakpoints[numAutomatable];
+  int             breakpointPositions[numAutomatable][maxNumEvents];
+  double          breakpointValues[numAutomatable][maxNumEvents];
+  float           lastAutomatedValues[numAutomatable];   // normalized, for the host
+  double          renderBuffer[renderBufferSize];
+
+  // the embedded core dsp object:
+  Open303 open303Core;
+
+};
+
+#endif
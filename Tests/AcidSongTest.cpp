@@ -0,0 +1,198 @@
+// This test compiles a song (a chain of two patterns with different tempi, transpositions, step
+// lengths and slides across the pattern boundaries) and plays it with an AcidSongPlayer. It checks
+// that the timeline is sorted and that the bars start every 16 steps, that the output doesn't
+// depend on the block size, that seeking to the start of a chain entry (by bar and by sample)
+// renders exactly the same as playing the rest of the chain as a song of its own from the start,
+// and that the position wraps around at the end when looping.
+//
+// The tempi are chosen such that the steps have an integer number of samples - otherwise the
+// rounding of the step positions would depend on where the song starts.
+
+#include "../Source/DSPCode/rosic_AcidSongPlayer.h"
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+using namespace rosic;
+
+static const double sampleRate     = 44100.0;
+static const int    stepsPerBar    = 16;
+static const int    numTailSamples = 44100;
+
+// the chain: pattern, repeats, tempo (with 5250, 6300 and 4410 samples per step), transposition
+static const AcidSong::Entry chain[] =
+{
+  { 0, 1, 126.0,  0 },
+  { 1, 2, 105.0,  5 },
+  { 0, 1, 150.0, -2 },
+};
+static const int numEntries = sizeof(chain) / sizeof(AcidSong::Entry);
+
+static void setUpSynth(Open303& synth)
+{
+  synth.setSampleRate(sampleRate);
+  synth.setCutoff(800.0);
+  synth.setResonance(70.0);
+  synth.setEnvMod(60.0);
+  synth.setDecay(400.0);
+  synth.setAccent(50.0);
+  for(int p=0; p<2; p++)
+  {
+    AcidPattern* pattern = synth.sequencer.getPattern(p);
+    for(int k=0; k<16; k++)
+    {
+      pattern->setKey(k, (k*(5+p)) % 12);
+      pattern->setGate(k, k%7 != 3);
+      pattern->setSlide(k, k%3 == 0);
+      pattern->setAccent(k, k%4 == 1);
+    }
+  }
+  synth.sequencer.getPattern(1)->setStepLength(0.5);
+  synth.sequencer.getPattern(0)->setSlide(15, true); // slides into the next entry
+}
+
+// compiles the entries of the chain from firstEntry on into the song:
+static void compileSong(AcidSong& song, Open303& synth, int firstEntry)
+{
+  song.setRootKey(36);
+  for(int e=firstEntry; e<numEntries; e++)
+    song.addEntry(chain[e].pattern, chain[e].numRepeats, chain[e].bpm, chain[e].transpose);
+  song.compile(synth.sequencer, sampleRate);
+}
+
+// plays the song on a fresh synth from the given sample on and returns the output, including a
+// release tail, in blocks of the given size:
+static std::vector<double> play(const AcidSong& song, int startSample, int blockSize)
+{
+  Open303 synth;
+  setUpSynth(synth);
+  AcidSongPlayer player;
+  player.setSynth(&synth);
+  player.setSong(&song);
+  if( startSample > 0 )
+    player.seekToSample(startSample);
+
+  std::vector<double> output(song.getLengthInSamples() - startSample + numTailSamples);
+  int numSamples = (int) output.size();
+  for(int n=0; n<numSamples; n+=blockSize)
+    player.render(&output[n], rmin(blockSize, numSamples-n));
+  return output;
+}
+
+static bool isIdentical(const std::vector<double>& a, const std::vector<double>& b)
+{
+  return a.size() == b.size() && memcmp(&a[0], &b[0], a.size()*sizeof(double)) == 0;
+}
+
+static bool checkTimeline(const AcidSong& song)
+{
+  bool ok = true;
+  const AcidSong::Event* events = song.getEvents();
+  for(int i=1; i<song.getNumEvents(); i++)
+  {
+    if( events[i].sample < events[i-1].sample )
+      ok = false;
+  }
+
+  // the bars start every 16 steps - there are 16 steps per pattern here:
+  int bar = 0, start = 0;
+  for(int e=0; e<numEntries; e++)
+  {
+    int stepLength = (int) (sampleRate * 15.0 / chain[e].bpm);
+    for(int r=0; r<chain[e].numRepeats; r++)
+    {
+      if( bar >= song.getNumBars() || song.getBarStart(bar) != start )
+        ok = false;
+      start += stepsPerBar * stepLength;
+      bar++;
+    }
+  }
+  if( song.getNumBars() != bar || song.getLengthInSamples() != start )
+    ok = false;
+
+  printf("timeline: %d events, %d bars, %d samples %s\n", song.getNumEvents(), song.getNumBars(),
+    song.getLengthInSamples(), ok ? "" : "FAILED");
+  return ok;
+}
+
+static bool checkBlockSizes(const AcidSong& song)
+{
+  static const int blockSizes[] = { 1, 64, 333, 4096 };
+  std::vector<double> reference = play(song, 0, song.getLengthInSamples() + numTailSamples);
+  bool ok = true;
+  for(int b=0; b<(int) (sizeof(blockSizes)/sizeof(int)); b++)
+  {
+    if( !isIdentical(play(song, 0, blockSizes[b]), reference) )
+    {
+      printf("block size %d: output differs - FAILED\n", blockSizes[b]);
+      ok = false;
+    }
+  }
+  printf("block sizes: %s\n", ok ? "output identical" : "FAILED");
+  return ok;
+}
+
+static bool checkSeeks(Open303& synth, const AcidSong& song)
+{
+  bool ok = true;
+  int bar = 0;
+  for(int e=0; e<numEntries; e++)
+  {
+    if( e > 0 )
+    {
+      AcidSong rest;
+      compileSong(rest, synth, e);
+      std::vector<double> expected = play(rest, 0, 512);
+
+      // seek by bar on a fresh synth:
+      Open303 seekSynth;
+      setUpSynth(seekSynth);
+      AcidSongPlayer player;
+      player.setSynth(&seekSynth);
+      player.setSong(&song);
+      player.seekToBar(bar);
+      bool positionOk = player.getPosition() == song.getBarStart(bar);
+      std::vector<double> byBar(expected.size());
+      for(int n=0; n<(int) byBar.size(); n+=512)
+        player.render(&byBar[n], rmin(512, (int) byBar.size()-n));
+
+      std::vector<double> bySample = play(song, song.getBarStart(bar), 512);
+
+      bool seekOk = positionOk && isIdentical(byBar, expected) && isIdentical(bySample, expected);
+      printf("seek to bar %d (entry %d): %s\n", bar, e,
+        seekOk ? "identical to playing the rest of the chain" : "differs - FAILED");
+      ok = ok && seekOk;
+    }
+    bar += chain[e].numRepeats;
+  }
+  return ok;
+}
+
+static bool checkLooping(const AcidSong& song)
+{
+  Open303 synth;
+  setUpSynth(synth);
+  AcidSongPlayer player;
+  player.setSynth(&synth);
+  player.setSong(&song);
+  player.setLooping(true);
+  player.seekToSample(song.getLengthInSamples() - 1000);
+  std::vector<double> buffer(3000);
+  player.render(&buffer[0], 3000);
+  bool ok = player.getPosition() == 2000 && !player.isFinished();
+  printf("looping: position %d after the wrap %s\n", player.getPosition(), ok ? "" : "FAILED");
+  return ok;
+}
+
+int main()
+{
+  Open303 synth;
+  setUpSynth(synth);
+  AcidSong song;
+  compileSong(song, synth, 0);
+
+  bool ok = checkTimeline(song);
+  ok = checkBlockSizes(song)    && ok;
+  ok = checkSeeks(synth, song)  && ok;
+  ok = checkLooping(song)       && ok;
+  return ok ? 0 : 1;
+}
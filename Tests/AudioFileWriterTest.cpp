@@ -0,0 +1,211 @@
+// This test writes WAV files with the AudioFileWriter in all sample formats, through the threaded
+// path and through the memory mapped one, with a small block size such that many blocks are handed
+// over to the I/O thread. It parses the files back and checks the RIFF, fmt, fact and data chunks
+// and their sizes, the samples and the pad byte after an odd number of data bytes. Writing a file
+// larger than 4 GB would take too long, so the conversion of the JUNK chunk into the ds64 chunk of
+// an RF64 file is checked with a writer whose RIFF size limit is lowered.
+
+#include "../Source/DSPCode/rosic_AudioFileWriter.h"
+#include "../Source/DSPCode/rosic_FunctionTemplates.h"
+#include "../Source/DSPCode/rosic_NumberManipulations.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+using namespace rosic;
+
+static const char* path       = "AudioFileWriterTest.wav";
+static const int   sampleRate = 48000;
+static const int   blockSize  = 100;   // frames per block of the writer
+
+static const char* formatNames[] = { "PCM 16", "PCM 24", "float" };
+
+// a writer that switches to RF64 for files above the given RIFF size:
+class SmallRiffWriter : public AudioFileWriter
+{
+public:
+  SmallRiffWriter(UINT64 newMaxRiffSize) { maxRiffSize = newMaxRiffSize; }
+};
+
+static UINT32 read16(const unsigned char* p)
+{
+  return p[0] | (p[1] << 8);
+}
+
+static UINT32 read32(const unsigned char* p)
+{
+  return (UINT32) p[0] | ((UINT32) p[1] << 8) | ((UINT32) p[2] << 16) | ((UINT32) p[3] << 24);
+}
+
+static UINT64 read64(const unsigned char* p)
+{
+  return (UINT64) read32(p) | ((UINT64) read32(p+4) << 32);
+}
+
+// the expected encoding of a sample (as in AudioFileWriter::write):
+static void encodeSample(double x, int format, unsigned char* p)
+{
+  if( format == AudioFileWriter::FLOAT_32 )
+  {
+    float f = (float) x;
+    memcpy(p, &f, 4); // little endian machines only
+  }
+  else
+  {
+    double scale = format == AudioFileWriter::PCM_16 ? 32767.0 : 8388607.0;
+    int    i     = roundToInt(scale * clip(x, -1.0, 1.0));
+    for(int b=0; b<(format == AudioFileWriter::PCM_16 ? 2 : 3); b++)
+      p[b] = (unsigned char) ((i >> (8*b)) & 0xFF);
+  }
+}
+
+static bool readFile(std::vector<unsigned char>& data)
+{
+  FILE* f = fopen(path, "rb");
+  if( f == NULL )
+    return false;
+  fseek(f, 0, SEEK_END);
+  data.resize(ftell(f));
+  fseek(f, 0, SEEK_SET);
+  bool ok = data.empty() || fread(&data[0], data.size(), 1, f) == 1;
+  fclose(f);
+  return ok;
+}
+
+// writes a file and parses it back - returns an error message or NULL when everything's right:
+static const char* checkFile(int format, int numChannels, int numFrames, bool useMemoryMapping,
+  UINT64 maxRiffSize)
+{
+  std::vector<double> frames(numFrames*numChannels);
+  for(int n=0; n<(int) frames.size(); n++)
+    frames[n] = 1.2 * sin(0.01*n); // with some clipping
+
+  SmallRiffWriter writer(maxRiffSize);
+  writer.setBlockSize(blockSize);
+  if( !writer.open(path, sampleRate, numChannels, format, useMemoryMapping) )
+    return "can't open the file";
+  for(int n=0; n<numFrames; n+=37) // not aligned with the blocks
+  {
+    int numToWrite = rmin(37, numFrames-n);
+    if( !writer.write(&frames[n*numChannels], numToWrite) )
+      return "write failed";
+  }
+  if( writer.getNumFramesWritten() != (UINT64) numFrames )
+    return "wrong number of frames written";
+  if( !writer.close() )
+    return "close failed";
+
+  std::vector<unsigned char> file;
+  if( !readFile(file) )
+    return "can't read the file";
+
+  int    bytesPerSample = format == AudioFileWriter::PCM_16 ? 2 :
+                          (format == AudioFileWriter::PCM_24 ? 3 : 4);
+  bool   isFloat        = format == AudioFileWriter::FLOAT_32;
+  UINT64 dataSize       = (UINT64) numFrames * numChannels * bytesPerSample;
+  int    headerSize     = 12 + 36 + (isFloat ? 26+12 : 24) + 8;
+  UINT64 riffSize       = headerSize - 8 + dataSize + (dataSize & 1);
+  bool   isRF64         = riffSize > maxRiffSize;
+  if( file.size() != headerSize + dataSize + (dataSize & 1) )
+    return "wrong file size";
+
+  // RIFF header and JUNK or ds64 chunk:
+  const unsigned char* p = &file[0];
+  if(    memcmp(p, isRF64 ? "RF64" : "RIFF", 4) != 0 || memcmp(p+8, "WAVE", 4) != 0
+      || read32(p+4) != (isRF64 ? 0xFFFFFFFF : riffSize) )
+    return "wrong RIFF header";
+  p += 12;
+  if( memcmp(p, isRF64 ? "ds64" : "JUNK", 4) != 0 || read32(p+4) != 28 )
+    return "wrong JUNK/ds64 chunk header";
+  if( isRF64 )
+  {
+    if( read64(p+8) != riffSize || read64(p+16) != dataSize || read64(p+24) != (UINT64) numFrames
+      || read32(p+32) != 0 )
+      return "wrong ds64 chunk";
+  }
+  else
+  {
+    for(int i=8; i<36; i++)
+    {
+      if( p[i] != 0 )
+        return "JUNK chunk not zero";
+    }
+  }
+  p += 36;
+
+  // fmt and fact chunk:
+  if(    memcmp(p, "fmt ", 4) != 0 || read32(p+4) != (UINT32) (isFloat ? 18 : 16)
+      || read16(p+8) != (UINT32) (isFloat ? 3 : 1) || read16(p+10) != (UINT32) numChannels
+      || read32(p+12) != (UINT32) sampleRate
+      || read32(p+16) != (UINT32) (sampleRate*numChannels*bytesPerSample)
+      || read16(p+20) != (UINT32) (numChannels*bytesPerSample)
+      || read16(p+22) != (UINT32) (8*bytesPerSample) )
+    return "wrong fmt chunk";
+  p += 24;
+  if( isFloat )
+  {
+    if(    read16(p) != 0 || memcmp(p+2, "fact", 4) != 0 || read32(p+6) != 4
+        || read32(p+10) != (isRF64 ? 0xFFFFFFFF : (UINT32) numFrames) )
+      return "wrong fact chunk";
+    p += 14;
+  }
+
+  // data chunk, samples and pad byte:
+  if( memcmp(p, "data", 4) != 0 || read32(p+4) != (isRF64 ? 0xFFFFFFFF : (UINT32) dataSize) )
+    return "wrong data chunk header";
+  p += 8;
+  for(int n=0; n<(int) frames.size(); n++)
+  {
+    unsigned char expected[4];
+    encodeSample(frames[n], format, expected);
+    if( memcmp(p + n*bytesPerSample, expected, bytesPerSample) != 0 )
+      return "wrong samples";
+  }
+  if( (dataSize & 1) && p[dataSize] != 0 )
+    return "pad byte not zero";
+  return NULL;
+}
+
+int main()
+{
+  struct Case
+  {
+    int format, numChannels, numFrames;
+  };
+  const Case cases[] =
+  {
+    { AudioFileWriter::PCM_16,   2, 1000 },
+    { AudioFileWriter::PCM_16,   1, 1234 },
+    { AudioFileWriter::PCM_24,   2, 1000 },
+    { AudioFileWriter::PCM_24,   1, 1235 }, // odd number of data bytes
+    { AudioFileWriter::FLOAT_32, 2, 1000 },
+    { AudioFileWriter::FLOAT_32, 3, 1   },  // less than a block
+    { AudioFileWriter::PCM_16,   1, 0    },  // empty
+  };
+
+  bool ok = true;
+  for(int c=0; c<(int) (sizeof(cases)/sizeof(Case)); c++)
+  {
+    for(int m=0; m<2; m++)
+    {
+      for(int r=0; r<2; r++)
+      {
+        // the RF64 variant switches to RF64 for any file with data:
+        UINT64 maxRiffSize = r == 0 ? 0xFFFFFFFF : 100;
+        const char* error  = checkFile(cases[c].format, cases[c].numChannels, cases[c].numFrames,
+          m == 1, maxRiffSize);
+        printf("%-6s, %d channels, %5d frames, %-8s, %s: %s\n", formatNames[cases[c].format],
+          cases[c].numChannels, cases[c].numFrames, m == 1 ? "mapped" : "threaded",
+          r == 0 ? "4 GB RIFF limit" : "lowered RIFF limit", error == NULL ? "ok" : error);
+        if( error != NULL )
+        {
+          printf("FAILED\n");
+          ok = false;
+        }
+      }
+    }
+  }
+
+  remove(path);
+  return ok ? 0 : 1;
+}
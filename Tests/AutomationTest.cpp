@@ -0,0 +1,316 @@
+// This test renders a sequenced Open303 with sample accurate automation through processBlock and
+// compares it with the path that it replaces: rendering sample by sample and calling the setters
+// before each sample. The values for the setters are computed here from the documented semantics
+// of AutomationSpan. The scenarios are breakpoints with held values and with ramps (including the
+// ramp from the value before the block to the first breakpoint, which crosses the 64 sample chunks
+// of processBlock), dense buffers, several breakpoints at one position and blocks that are split
+// into sub-blocks with AutomationSpan::setOffset.
+//
+// Held values and dense buffers must give identical output. The ramps are computed incrementally
+// within processBlock (and restarted at each chunk), so they may differ in the last bits of the
+// values - there, the output must be very close.
+
+#include "../Source/DSPCode/rosic_Open303.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+using namespace rosic;
+
+static const int numParameters  = Open303::NUM_AUTOMATABLE_PARAMETERS;
+static const int blockSize      = 1000;
+static const int numBlocks      = 6;
+static const int maxBreakpoints = 8;
+
+typedef void (Open303::*Setter)(double);
+static const Setter setters[numParameters] =
+{
+  &Open303::setCutoff, &Open303::setResonance, &Open303::setEnvMod, &Open303::setAccent,
+  &Open303::setVolume
+};
+
+// the breakpoints of one parameter in one block:
+struct Breakpoints
+{
+  int    positions[maxBreakpoints];
+  double values[maxBreakpoints];
+  int    num;
+};
+
+// an automation scenario - either breakpoints or dense buffers for each parameter:
+struct Scenario
+{
+  const char*         name;
+  bool                interpolate;
+  bool                dense;
+  std::vector<int>    splits;  // sub-block boundaries within each block (for setOffset)
+  Breakpoints         breakpoints[numBlocks][numParameters];
+  std::vector<double> buffers[numParameters]; // for the dense scenario, numBlocks*blockSize each
+};
+
+static void setUpSynth(Open303& synth)
+{
+  synth.setSampleRate(44100.0);
+  synth.setCutoff(800.0);
+  synth.setResonance(70.0);
+  synth.setEnvMod(60.0);
+  synth.setDecay(400.0);
+  synth.setAccent(50.0);
+  synth.setVolume(-6.0);
+  synth.setWaveform(0.85);
+  synth.sequencer.setMode(AcidSequencer::KEY_SYNC);
+  AcidPattern* pattern = synth.sequencer.getPattern(0);
+  for(int k=0; k<16; k++)
+  {
+    pattern->setGate(k, k%3 != 2);
+    pattern->setKey(k, (k*5) % 12);
+    pattern->setSlide(k, k%4 == 1);
+    pattern->setAccent(k, k%5 == 0);
+  }
+  synth.noteOn(40, 100);
+}
+
+static double getParameter(Open303& synth, int p)
+{
+  switch( p )
+  {
+  case Open303::CUTOFF:    return synth.getCutoff();
+  case Open303::RESONANCE: return synth.getResonance();
+  case Open303::ENV_MOD:   return synth.getEnvMod();
+  case Open303::ACCENT:    return synth.getAccent();
+  default:                 return synth.getVolume();
+  }
+}
+
+// the value of a parameter at sample n of a block according to the semantics of AutomationSpan,
+// computed in closed form:
+static double getExpectedValue(const Scenario& s, int block, int p, int n, double previousValue)
+{
+  if( s.dense )
+    return s.buffers[p][block*blockSize + n];
+
+  const Breakpoints& b = s.breakpoints[block][p];
+  int k = -1; // the last breakpoint at or before n (the last one of several at one position)
+  while( k+1 < b.num && b.positions[k+1] <= n )
+    k++;
+  int j = k+1; // the first one behind n
+  while( j < b.num && b.positions[j] <= n )
+    j++;
+
+  if( j >= b.num )
+    return b.values[b.num-1];
+  if( k < 0 )
+  {
+    if( !s.interpolate )
+      return previousValue;
+    return previousValue + (b.values[j]-previousValue) * (n+1) / (b.positions[j]+1);
+  }
+  if( !s.interpolate )
+    return b.values[k];
+  return b.values[k] + (b.values[j]-b.values[k]) * (n-b.positions[k])
+    / (b.positions[j]-b.positions[k]);
+}
+
+static bool isAutomated(const Scenario& s, int block, int p)
+{
+  return s.dense ? !s.buffers[p].empty() : s.breakpoints[block][p].num > 0;
+}
+
+// renders with processBlock and the automation spans:
+static std::vector<double> renderSpans(const Scenario& s)
+{
+  Open303 synth;
+  setUpSynth(synth);
+  std::vector<double> out(numBlocks*blockSize);
+  for(int block=0; block<numBlocks; block++)
+  {
+    AutomationSpan spans[numParameters];
+    const AutomationSpan* spanPointers[numParameters];
+    for(int p=0; p<numParameters; p++)
+    {
+      spanPointers[p] = &spans[p];
+      if( !isAutomated(s, block, p) )
+        continue;
+      if( s.dense )
+        spans[p].setBuffer(&s.buffers[p][block*blockSize]);
+      else
+      {
+        const Breakpoints& b = s.breakpoints[block][p];
+        spans[p].setBreakpoints(b.positions, b.values, b.num, s.interpolate);
+      }
+    }
+
+    // the sub-blocks (a note event at each split, as a host would send it):
+    int start = 0;
+    for(int i=0; i<=(int) s.splits.size(); i++)
+    {
+      int end = i < (int) s.splits.size() ? s.splits[i] : blockSize;
+      for(int p=0; p<numParameters; p++)
+        spans[p].setOffset(start);
+      synth.processBlock(&out[block*blockSize + start], end-start, spanPointers);
+      if( i < (int) s.splits.size() )
+        synth.noteOn(45 + i, 90);
+      start = end;
+    }
+  }
+  return out;
+}
+
+// renders sample by sample with the setters:
+static std::vector<double> renderSetters(const Scenario& s)
+{
+  Open303 synth;
+  setUpSynth(synth);
+  std::vector<double> out(numBlocks*blockSize);
+  for(int block=0; block<numBlocks; block++)
+  {
+    double previous[numParameters];
+    for(int p=0; p<numParameters; p++)
+      previous[p] = getParameter(synth, p);
+
+    int split = 0;
+    for(int n=0; n<blockSize; n++)
+    {
+      if( split < (int) s.splits.size() && n == s.splits[split] )
+      {
+        synth.noteOn(45 + split, 90);
+        split++;
+      }
+      for(int p=0; p<numParameters; p++)
+      {
+        if( isAutomated(s, block, p) )
+          (synth.*setters[p])(getExpectedValue(s, block, p, n, previous[p]));
+      }
+      out[block*blockSize + n] = synth.getSample();
+    }
+  }
+  return out;
+}
+
+static void addBreakpoint(Scenario& s, int block, int p, int position, double value)
+{
+  Breakpoints& b = s.breakpoints[block][p];
+  b.positions[b.num] = position;
+  b.values[b.num]    = value;
+  b.num++;
+}
+
+// sets up breakpoints for all blocks and parameters (some of them not automated in some blocks),
+// with the first breakpoint late in some blocks, such that ramps from the previous value cross
+// several chunks:
+static void setUpBreakpoints(Scenario& s)
+{
+  static const double low[numParameters]  = { 300.0,  10.0,  0.0,  0.0, -20.0 };
+  static const double high[numParameters] = { 2400.0, 95.0, 100.0, 100.0, 0.0 };
+  for(int block=0; block<numBlocks; block++)
+  {
+    for(int p=0; p<numParameters; p++)
+    {
+      s.breakpoints[block][p].num = 0;
+      if( (block+p) % 4 == 3 )
+        continue;
+      int position = (block*37 + p*53) % 300;
+      int num      = 1 + (block+2*p) % 4;
+      for(int k=0; k<num; k++)
+      {
+        double x = 0.5 + 0.5*sin(1.7*block + 2.3*p + 0.9*k);
+        addBreakpoint(s, block, p, position, low[p] + (high[p]-low[p])*x);
+        position += 1 + (k*151 + p*67) % 250;
+      }
+    }
+  }
+}
+
+static void setUpScenarios(std::vector<Scenario>& scenarios)
+{
+  Scenario s;
+  s.dense = false;
+
+  s.name        = "held breakpoints";
+  s.interpolate = false;
+  setUpBreakpoints(s);
+  scenarios.push_back(s);
+
+  s.name        = "ramps";
+  s.interpolate = true;
+  scenarios.push_back(s);
+
+  // several breakpoints at one position (the last one counts):
+  s.name        = "held, several at one position";
+  s.interpolate = false;
+  for(int block=0; block<numBlocks; block++)
+  {
+    for(int p=0; p<numParameters; p++)
+    {
+      Breakpoints& b = s.breakpoints[block][p];
+      if( b.num > 0 && b.num < maxBreakpoints-1 )
+      {
+        int k = b.num/2;
+        for(int i=b.num-1; i>=k; i--)
+        {
+          b.positions[i+2] = b.positions[i];
+          b.values[i+2]    = b.values[i];
+        }
+        b.values[k]   = 0.5*b.values[k];     // superseded by the next ones at the same position
+        b.values[k+1] = 0.8*b.values[k+2];
+        b.positions[k] = b.positions[k+1] = b.positions[k+2];
+        b.num += 2;
+      }
+    }
+  }
+  scenarios.push_back(s);
+
+  s.name        = "ramps, several at one position";
+  s.interpolate = true;
+  scenarios.push_back(s);
+
+  s.name        = "held, sub-blocks";
+  s.interpolate = false;
+  setUpBreakpoints(s);
+  s.splits.push_back(100);
+  s.splits.push_back(333);
+  s.splits.push_back(334);
+  s.splits.push_back(700);
+  scenarios.push_back(s);
+
+  s.name        = "ramps, sub-blocks";
+  s.interpolate = true;
+  scenarios.push_back(s);
+
+  s.name  = "dense buffers, sub-blocks";
+  s.dense = true;
+  for(int p=0; p<numParameters; p++)
+  {
+    if( p == Open303::ACCENT )
+      continue;
+    s.buffers[p].resize(numBlocks*blockSize);
+    for(int n=0; n<numBlocks*blockSize; n++)
+      s.buffers[p][n] = getExpectedValue(scenarios[0], n/blockSize, p, n%blockSize, 50.0);
+  }
+  s.buffers[Open303::CUTOFF][1234] = 5000.0; // a single outlier
+  scenarios.push_back(s);
+}
+
+int main()
+{
+  std::vector<Scenario> scenarios;
+  setUpScenarios(scenarios);
+
+  bool ok = true;
+  for(int i=0; i<(int) scenarios.size(); i++)
+  {
+    const Scenario& s = scenarios[i];
+    std::vector<double> spans   = renderSpans(s);
+    std::vector<double> setters = renderSetters(s);
+    double maxDiff = 0.0;
+    for(int n=0; n<(int) spans.size(); n++)
+      maxDiff = fmax(maxDiff, fabs(spans[n] - setters[n]));
+    bool identical = memcmp(&spans[0], &setters[0], spans.size()*sizeof(double)) == 0;
+    bool scenarioOk = s.interpolate ? maxDiff < 1.e-9 : identical;
+    printf("%-31s: %s (maximum difference %g) %s\n", s.name,
+      identical ? "identical to the setters" : "differs from the setters", maxDiff,
+      scenarioOk ? "" : "FAILED");
+    ok = ok && scenarioOk;
+  }
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,127 @@
+// This test renders the same sequence of notes (and then the sequencer) through Open303::getSample
+// and through Open303::processBlock with several block sizes - smaller than, equal to and larger
+// than the 64 sample chunks in which processBlock runs its block kernels, and not aligned with
+// them. The blocks are split at the events, as hosts do. The outputs must be identical, sample by
+// sample.
+
+#include "../Source/DSPCode/rosic_Open303.h"
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+using namespace rosic;
+
+static const int numSequencerSamples = 100000;
+
+// the note events: sample position, note and velocity (zero for note-offs):
+struct Event
+{
+  int position, note, velocity;
+};
+
+static const Event events[] =
+{
+  {     0, 36,  80 },
+  {  6000, 36,   0 },
+  {  8000, 48, 120 },
+  { 11000, 39, 100 }, // slides, because 48 is still held
+  { 14000, 48,   0 },
+  { 14500, 39,   0 },
+  { 16000, 41,  80 },
+  { 22000, 41,   0 },
+  { 24000, 43, 127 },
+  { 30000, 43,   0 },
+};
+static const int numEvents = sizeof(events) / sizeof(Event);
+static const int numSamples = 32000; // the note part, the sequencer runs afterwards
+
+static void setUpSynth(Open303& synth)
+{
+  synth.setSampleRate(44100.0);
+  synth.setCutoff(800.0);
+  synth.setResonance(70.0);
+  synth.setEnvMod(60.0);
+  synth.setDecay(400.0);
+  synth.setAccent(50.0);
+  synth.setVolume(-6.0);
+  synth.setWaveform(0.85);
+  synth.setTanhShaperDrive(30.0);
+  synth.setTanhShaperOffset(4.0);
+  synth.setSquarePhaseShift(190.0);
+}
+
+static void setUpSequencer(Open303& synth)
+{
+  synth.sequencer.setMode(AcidSequencer::KEY_SYNC);
+  AcidPattern* pattern = synth.sequencer.getPattern(0);
+  for(int k=0; k<16; k++)
+  {
+    pattern->setGate(k, k%3 != 2);
+    pattern->setKey(k, (k*5) % 12);
+    pattern->setSlide(k, k%4 == 1);
+    pattern->setAccent(k, k%5 == 0);
+  }
+  synth.noteOn(40, 100);
+}
+
+// renders the part from start to end in blocks of the given size (or through getSample when the
+// size is zero):
+static void renderPart(Open303& synth, double* out, int start, int end, int blockSize)
+{
+  if( blockSize == 0 )
+  {
+    for(int n=start; n<end; n++)
+      out[n] = synth.getSample();
+  }
+  else
+  {
+    for(int n=start; n<end; n+=blockSize)
+      synth.processBlock(&out[n], rmin(blockSize, end-n));
+  }
+}
+
+static std::vector<double> render(int blockSize)
+{
+  Open303 synth;
+  setUpSynth(synth);
+  std::vector<double> out(numSamples + numSequencerSamples);
+
+  int position = 0;
+  for(int e=0; e<numEvents; e++)
+  {
+    renderPart(synth, &out[0], position, events[e].position, blockSize);
+    synth.noteOn(events[e].note, events[e].velocity);
+    position = events[e].position;
+  }
+  renderPart(synth, &out[0], position, numSamples, blockSize);
+
+  setUpSequencer(synth);
+  renderPart(synth, &out[0], numSamples, numSamples + numSequencerSamples, blockSize);
+  return out;
+}
+
+int main()
+{
+  static const int blockSizes[] = { 1, 63, 64, 65, 100, 257, 4096 };
+  std::vector<double> reference = render(0);
+
+  bool ok = true;
+  for(int b=0; b<(int) (sizeof(blockSizes)/sizeof(int)); b++)
+  {
+    std::vector<double> out = render(blockSizes[b]);
+    int firstDifference = -1;
+    for(int n=0; n<(int) out.size() && firstDifference == -1; n++)
+    {
+      if( memcmp(&out[n], &reference[n], sizeof(double)) != 0 )
+        firstDifference = n;
+    }
+    if( firstDifference == -1 )
+      printf("block size %4d: identical to getSample\n", blockSizes[b]);
+    else
+    {
+      printf("block size %4d: differs from getSample at sample %d - FAILED\n", blockSizes[b],
+        firstDifference);
+      ok = false;
+    }
+  }
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,130 @@
+// This test runs Open303 the way an audio device would (by means of the CallbackSimulator) - a
+// single instance and a rack of instances, with recorded note and parameter events, at several
+// buffer sizes - and fails when any callback misses its deadline. The callbacks run back to back,
+// so the test takes less time than it simulates.
+//
+// Whether deadlines are missed depends on the machine and the other load on it. A single
+// preemption by the OS can make a callback late, so a configuration is run up to numAttempts times
+// and fails only when every attempt misses deadlines - a real overload misses them each time.
+// Still, a loaded or virtualized machine can stall the process for milliseconds at a time, so ctest
+// only runs this test when the build is configured with OPEN303_TIMING_TESTS (then with the label
+// "timing", such that it can be excluded again with ctest -LE timing).
+//
+// Usage: CallbackSimulatorTest [blockSize ...] - the given block sizes replace the default ones for
+// both scenarios.
+
+#include "../Source/DSPCode/rosic_CallbackSimulator.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+using namespace rosic;
+
+static const double sampleRate = 44100.0;
+
+// the buffer sizes and durations of the scenarios:
+static const int    singleBlockSizes[]   = { 64, 256, 1024 };
+static const double singleDuration       = 10.0;
+static const int    rackBlockSizes[]     = { 256, 1024 };
+static const double rackDuration         = 5.0;
+static const int    numRackInstances     = 8;
+static const int    numAttempts          = 3;
+
+// a note every 1/8 second (with a different pitch for each instance) and a cutoff change every
+// 1/32 second for all instances:
+static void addEvents(CallbackSimulator& simulator, int numInstances, double duration)
+{
+  static const int notes[8] = { 36, 48, 36, 43, 39, 36, 51, 46 };
+  int numSteps = (int) (duration * 8);
+  for(int s=0; s<numSteps; s++)
+  {
+    for(int i=0; i<numInstances; i++)
+    {
+      simulator.addNoteEvent(s/8.0,         i, notes[s%8] + i%12, s%4 == 0 ? 127 : 80);
+      simulator.addNoteEvent(s/8.0 + 0.1,   i, notes[s%8] + i%12, 0);
+    }
+    for(int k=0; k<4; k++)
+      simulator.addParameterEvent(s/8.0 + k/32.0, -1, &Open303::setCutoff, 300.0 + 200.0*k);
+  }
+}
+
+static bool report(const char* scenario, int blockSize, int attempt,
+  const CallbackSimulator& simulator)
+{
+  CallbackSimulator::Statistics statistics;
+  simulator.getStatistics(&statistics);
+  bool ok = statistics.numDeadlineMisses == 0;
+  printf("%-20s block %5d, attempt %d: period %7.1f us, mean %7.1f us, p99.9 %7.1f us, "
+    "max %7.1f us, %d of %d deadlines missed\n", scenario, blockSize, attempt+1,
+    1.e6*statistics.blockPeriod, 1.e6*statistics.meanRenderTime, 1.e6*statistics.p999RenderTime,
+    1.e6*statistics.maxRenderTime, statistics.numDeadlineMisses, statistics.numCallbacks);
+  return ok;
+}
+
+static bool runSingleInstance(int blockSize, int attempt)
+{
+  Open303 synth;
+  CallbackSimulator simulator;
+  simulator.setSynth(&synth);
+  simulator.setSampleRate(sampleRate);
+  simulator.setBlockSize(blockSize);
+  addEvents(simulator, 1, singleDuration);
+  simulator.run(singleDuration);
+  return report("single instance", blockSize, attempt, simulator);
+}
+
+static bool runRack(int blockSize, int attempt)
+{
+  Open303Rack rack(numRackInstances);
+  CallbackSimulator simulator;
+  simulator.setRack(&rack);
+  simulator.setSampleRate(sampleRate);
+  simulator.setBlockSize(blockSize);
+  addEvents(simulator, numRackInstances, rackDuration);
+  simulator.run(rackDuration);
+
+  char scenario[64];
+  snprintf(scenario, sizeof(scenario), "rack, %d instances", numRackInstances);
+  return report(scenario, blockSize, attempt, simulator);
+}
+
+// runs a scenario until an attempt meets all deadlines:
+static bool runAttempts(bool (*scenario)(int, int), int blockSize)
+{
+  for(int a=0; a<numAttempts; a++)
+  {
+    if( scenario(blockSize, a) )
+      return true;
+  }
+  printf("FAILED\n");
+  return false;
+}
+
+int main(int argc, char* argv[])
+{
+  int numSingle = sizeof(singleBlockSizes) / sizeof(int);
+  int numRack   = sizeof(rackBlockSizes)   / sizeof(int);
+  std::vector<int> singleSizes(singleBlockSizes, singleBlockSizes + numSingle);
+  std::vector<int> rackSizes(rackBlockSizes, rackBlockSizes + numRack);
+  if( argc > 1 )
+  {
+    singleSizes.clear();
+    for(int i=1; i<argc; i++)
+    {
+      int blockSize = atoi(argv[i]);
+      if( blockSize <= 0 )
+      {
+        printf("invalid block size: %s\n", argv[i]);
+        return 1;
+      }
+      singleSizes.push_back(blockSize);
+    }
+    rackSizes = singleSizes;
+  }
+
+  bool ok = true;
+  for(int b=0; b<(int) singleSizes.size(); b++)
+    ok = runAttempts(&runSingleInstance, singleSizes[b]) && ok;
+  for(int b=0; b<(int) rackSizes.size(); b++)
+    ok = runAttempts(&runRack, rackSizes[b]) && ok;
+  return ok ? 0 : 1;
+}
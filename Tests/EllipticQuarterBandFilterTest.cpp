@@ -0,0 +1,292 @@
+// This test checks the second order section (SOS) cascade of the EllipticQuarterBandFilter against
+// the 12th order direct form coefficients it was derived from: the frequency response (measured
+// from the impulse response of the cascade) has to match the exact transfer function of the
+// direct form within the documented tolerance. It also checks that getSampleDecimated produces
+// bit-identical output to getSample and prints the timings of both next to the one of the
+// original direct form realization (for information - timings are not checked).
+
+#include "../Source/DSPCode/rosic_EllipticQuarterBandFilter.h"
+#include <chrono>
+#include <complex>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+using namespace rosic;
+
+// the direct form coefficients (of the transfer function B(z)/A(z) with a0 = 1):
+static const double b[13] =
+{
+   0.00013671732099945628, -0.00055538501265606384,  0.0013681887636296387,
+  -0.0022158566490711852,   0.0028320091007278322,  -0.0029776933151090413,
+   0.0030283628243514991,  -0.0029776933151090413,   0.0028320091007278331,
+  -0.0022158566490711861,   0.0013681887636296393,  -0.00055538501265606384,
+   0.00013671732099945636
+};
+
+static const double a[13] =
+{
+     1.0,                  -9.1891604652189471,   40.177553696870497,
+  -110.11636661771178,    210.18506612078195,   -293.84744771903240,
+   308.16345558359234,   -244.06786780384243,    144.81877911392738,
+   -62.770692151724198,    18.867762095902137,    -3.5327094230551848,
+     0.31183189275203149
+};
+
+// the frequency response of the direct form coefficients at omega = pi*i/numFrequencies (real and
+// imaginary part), evaluated in 60 digit arithmetic - the denominator A(z) gets as small as 1.e-6
+// near the passband edge while its terms are up to 308, so evaluating B(z)/A(z) in long double
+// has errors around 1.e-10 which is above the tolerance we want to check:
+static const int numFrequencies = 64;
+
+static const double exactResponse[numFrequencies+1][2] =
+{
+  { 0.99999999999579059, 0 },
+  { 0.9007396069683109, -0.44198091829770453 },
+  { 0.60956620409336748, -0.80478945957452241 },
+  { 0.16917478956799625, -0.997024920050117 },
+  { -0.31939827955867411, -0.9539324143624679 },
+  { -0.73511767642693793, -0.67847403114909965 },
+  { -0.97820645508330306, -0.21908219192169365 },
+  { -0.94993575438482691, 0.34283301490891355 },
+  { -0.57411539655218458, 0.83095410244149503 },
+  { 0.069183817485327245, 0.9989636191726321 },
+  { 0.73423215780332907, 0.68432228016545749 },
+  { 1.0008991576127215, -0.14463035325182422 },
+  { 0.33767711995071303, -0.94126866501166739 },
+  { -0.89873987209309969, -0.46207905966829771 },
+  { 0.23926293926574865, 0.98087427258874427 },
+  { -0.041801100966150535, -0.0032904094506349584 },
+  { -0.00010063097795357525, 9.7247210175863908e-05 },
+  { -5.137397593522894e-06, 1.173593893723028e-05 },
+  { -6.4205550214453054e-08, 3.9628510559025177e-07 },
+  { -3.7277503788957282e-07, -1.5659068018405192e-05 },
+  { -1.8814556210465152e-06, -1.108548319503283e-05 },
+  { 6.1897395834873358e-08, 2.1053095388763522e-07 },
+  { 3.6986598169187988e-06, 9.1267245726962001e-06 },
+  { 6.7902352169005363e-06, 1.336141108860364e-05 },
+  { 8.2580178422077574e-06, 1.3633275118914568e-05 },
+  { 7.9731188048240292e-06, 1.1393970054850544e-05 },
+  { 6.2818514534972675e-06, 7.9346689618654102e-06 },
+  { 3.6745222458546408e-06, 4.1634897671935638e-06 },
+  { 6.1519848505441929e-07, 6.3214876938018559e-07 },
+  { -2.5248503962858175e-06, -2.3723440878082957e-06 },
+  { -5.4795476736169706e-06, -4.7381340639241977e-06 },
+  { -8.0766342763426453e-06, -6.4595439516856448e-06 },
+  { -1.0218559612402314e-05, -7.5893761867462838e-06 },
+  { -1.1863134086793221e-05, -8.2081045967010328e-06 },
+  { -1.3006907226119508e-05, -8.4050765705739238e-06 },
+  { -1.3672034388982034e-05, -8.2677400911008108e-06 },
+  { -1.3896435193763976e-05, -7.8760009883293089e-06 },
+  { -1.3726704736897296e-05, -7.2997343733845096e-06 },
+  { -1.3213181972209069e-05, -6.5981536735612582e-06 },
+  { -1.240664002252873e-05, -5.8202118016949233e-06 },
+  { -1.1356160071245881e-05, -5.005523267635348e-06 },
+  { -1.0107848070517668e-05, -4.1855001809389591e-06 },
+  { -8.7041380818932519e-06, -3.3845248994570926e-06 },
+  { -7.1834941720861352e-06, -2.6210629751997183e-06 },
+  { -5.5803753294955733e-06, -1.9086693571220415e-06 },
+  { -3.925367292360366e-06, -1.2568700284626741e-06 },
+  { -2.245414189108996e-06, -6.7191788468901403e-07 },
+  { -5.6410392152400577e-07, -1.5743052604721508e-07 },
+  { 1.0980237205929521e-06, 2.8507817952406079e-07 },
+  { 2.7231665634240031e-06, 6.5575947600832336e-07 },
+  { 4.2959600589541155e-06, 9.5607086941358537e-07 },
+  { 5.8031955285489727e-06, 1.1884848002722511e-06 },
+  { 7.2335608549767096e-06, 1.3562538806615577e-06 },
+  { 8.5774054912908482e-06, 1.4632231364451269e-06 },
+  { 9.82653012981381e-06, 1.5136810588538265e-06 },
+  { 1.0974000422248779e-05, 1.5122425239862306e-06 },
+  { 1.2013983585808446e-05, 1.463757752109642e-06 },
+  { 1.2941606444840921e-05, 1.3732424425798521e-06 },
+  { 1.3752833354535935e-05, 1.245825039702832e-06 },
+  { 1.4444362471303165e-05, 1.0867077713796347e-06 },
+  { 1.5013538930734006e-05, 9.0113866991836797e-07 },
+  { 1.5458283639618896e-05, 6.9439224725774833e-07 },
+  { 1.5777036563807725e-05, 4.7175686833845441e-07 },
+  { 1.596871358603675e-05, 2.3852715816607846e-07 },
+  { 1.6032676209187984e-05, 0 }
+};
+
+typedef std::complex<long double> ComplexLD;
+
+// evaluates a polynomial in z^-1 at z = e^(j*omega):
+static ComplexLD evaluate(const double* coeffs, int length, long double omega)
+{
+  ComplexLD sum = 0.0L;
+  for(int k=0; k<length; k++)
+    sum += (long double) coeffs[k] * std::polar(1.0L, -omega*k);
+  return sum;
+}
+
+// checks that the table of the exact response belongs to the direct form coefficients (within
+// the accuracy of the evaluation in long double, which may be just double):
+static bool checkExactResponse()
+{
+  double maxError = 0.0;
+  for(int i=0; i<=numFrequencies; i++)
+  {
+    long double omega = PI * i / numFrequencies;
+    ComplexLD   value = evaluate(b, 13, omega) / evaluate(a, 13, omega);
+    ComplexLD   exact(exactResponse[i][0], exactResponse[i][1]);
+    maxError = fmax(maxError, (double) std::abs(value - exact));
+  }
+  bool ok = maxError <= 1.e-6;
+  if( !ok )
+    printf("the exact response doesn't match the direct form coefficients FAILED\n");
+  return ok;
+}
+
+// returns the maximum absolute deviation of the frequency response of an impulse response from
+// the exact response:
+static double getMaxResponseError(const std::vector<double>& h)
+{
+  double maxError = 0.0;
+  for(int i=0; i<=numFrequencies; i++)
+  {
+    long double omega    = PI * i / numFrequencies;
+    ComplexLD   measured = 0.0L;
+    for(size_t n=0; n<h.size(); n++)
+      measured += (long double) h[n] * std::polar(1.0L, -omega*n);
+    ComplexLD exact(exactResponse[i][0], exactResponse[i][1]);
+    maxError = fmax(maxError, (double) std::abs(measured - exact));
+  }
+  return maxError;
+}
+
+// the original direct form II realization, for comparison:
+class DirectFormFilter
+{
+public:
+  DirectFormFilter() { memset(w, 0, sizeof(w)); }
+  double getSample(double in)
+  {
+    double tmp = in;
+    for(int k=1; k<13; k++)
+      tmp -= a[k]*w[k-1];
+    double y = b[0]*tmp;
+    for(int k=1; k<13; k++)
+      y += b[k]*w[k-1];
+    memmove(&w[1], &w[0], 11*sizeof(double));
+    w[0] = tmp;
+    return y;
+  }
+protected:
+  double w[12];
+};
+
+static bool checkFrequencyResponse()
+{
+  // the impulse responses (the poles have radii below 0.993, so they have decayed far below the
+  // double precision range after this length):
+  static const int length = 16384;
+  std::vector<double> hSections(length), hDirectForm(length);
+  EllipticQuarterBandFilter sections;
+  DirectFormFilter          directForm;
+  for(int n=0; n<length; n++)
+  {
+    hSections[n]   = sections.getSample(n == 0 ? 1.0 : 0.0);
+    hDirectForm[n] = directForm.getSample(n == 0 ? 1.0 : 0.0);
+  }
+
+  static const double tolerance = 2.e-14; // as documented in rosic_EllipticQuarterBandFilter.h
+  double sectionsError   = getMaxResponseError(hSections);
+  double directFormError = getMaxResponseError(hDirectForm);
+  bool ok = sectionsError <= tolerance;
+  printf("frequency response: max error %.3g (limit %.3g) %s\n", sectionsError, tolerance,
+    ok ? "" : "FAILED");
+  printf("frequency response of the direct form realization: max error %.3g\n",
+    directFormError);
+  return ok;
+}
+
+// a deterministic noise signal:
+static void fillNoise(std::vector<double>& x)
+{
+  unsigned int state = 1;
+  for(size_t n=0; n<x.size(); n++)
+  {
+    state = state * 1664525u + 1013904223u;
+    x[n]  = (double) (state >> 8) / 8388608.0 - 1.0;
+  }
+}
+
+static bool checkDecimatedIsIdentical()
+{
+  static const int factor = 4, length = 65536;
+  std::vector<double> x(length), y(length), block(factor);
+  fillNoise(x);
+
+  EllipticQuarterBandFilter perSample, perBlock;
+  for(int n=0; n<length; n++)
+    y[n] = perSample.getSample(x[n]);
+
+  for(int n=0; n<length; n+=factor)
+  {
+    memcpy(&block[0], &x[n], factor*sizeof(double));
+    double last = perBlock.getSampleDecimated(&block[0], factor);
+    if( memcmp(&block[0], &y[n], factor*sizeof(double)) != 0 || last != y[n+factor-1] )
+    {
+      printf("getSampleDecimated differs from getSample at sample %d FAILED\n", n);
+      return false;
+    }
+  }
+  printf("getSampleDecimated is bit-identical to getSample\n");
+  return true;
+}
+
+static double getSeconds(std::chrono::steady_clock::time_point start)
+{
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+
+static void printTimings()
+{
+  static const int factor = 4, length = 1 << 20, numRuns = 4;
+  std::vector<double> x(length);
+  fillNoise(x);
+  volatile double sink = 0.0;
+
+  DirectFormFilter directForm;
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for(int r=0; r<numRuns; r++)
+    for(int n=0; n<length; n++)
+      sink = directForm.getSample(x[n]);
+  double directFormTime = getSeconds(start);
+
+  EllipticQuarterBandFilter perSample;
+  start = std::chrono::steady_clock::now();
+  for(int r=0; r<numRuns; r++)
+    for(int n=0; n<length; n++)
+      sink = perSample.getSample(x[n]);
+  double perSampleTime = getSeconds(start);
+
+  EllipticQuarterBandFilter perBlock;
+  double block[factor];
+  start = std::chrono::steady_clock::now();
+  for(int r=0; r<numRuns; r++)
+  {
+    for(int n=0; n<length; n+=factor)
+    {
+      memcpy(block, &x[n], sizeof(block));
+      sink = perBlock.getSampleDecimated(block, factor);
+    }
+  }
+  double perBlockTime = getSeconds(start);
+  (void) sink;
+
+  double numSamples = (double) length * numRuns;
+  printf("ns per sample: direct form %.2f, sections (getSample) %.2f, sections (decimated) %.2f\n",
+    1.e9 * directFormTime / numSamples, 1.e9 * perSampleTime / numSamples,
+    1.e9 * perBlockTime / numSamples);
+}
+
+int main()
+{
+  bool ok = checkExactResponse();
+  ok = checkFrequencyResponse()    && ok;
+  ok = checkDecimatedIsIdentical() && ok;
+  printTimings();
+  return ok ? 0 : 1;
+}
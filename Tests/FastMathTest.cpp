@@ -0,0 +1,251 @@
+// This test sweeps the fast math functions over their documented ranges and checks the maximum
+// errors of the accuracy contracts in rosic_FastMath.h against the long double functions of libm
+// - for the inlined scalar versions as well as for the array versions, which use the SIMD
+// instruction set the library was compiled for (the test is built a second time with AVX2, when
+// the compiler supports it).
+
+#include "../Source/DSPCode/rosic_FastMath.h"
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+using namespace rosic;
+
+// a linear congruential generator, such that the arguments are the same on all platforms:
+static UINT64 randomState = 1;
+
+static double getRandom(double min, double max)
+{
+  randomState = randomState * 6364136223846793005ULL + 1442695040888963407ULL;
+  return min + (max-min) * (double) (randomState >> 11) / 9007199254740992.0; // 2^53
+}
+
+// the arguments: a regular grid over the range (including its ends) plus random values in it:
+static void fillArguments(std::vector<double>& x, double min, double max)
+{
+  int numGrid = (int) x.size() / 2;
+  for(int i=0; i<numGrid; i++)
+    x[i] = min + (max-min) * i / (numGrid-1);
+  for(int i=numGrid; i<(int) x.size(); i++)
+    x[i] = getRandom(min, max);
+}
+
+// keeps track of the maximum error of one function version:
+struct ErrorMeter
+{
+  const char* name;
+  double      maxError, limit, worstArgument;
+
+  ErrorMeter(const char* name_, double limit_)
+  {
+    name          = name_;
+    limit         = limit_;
+    maxError      = 0.0;
+    worstArgument = 0.0;
+  }
+
+  void add(double error, double argument)
+  {
+    if( !(error <= maxError) ) // NaN counts as larger
+    {
+      maxError      = error;
+      worstArgument = argument;
+    }
+  }
+
+  bool report()
+  {
+    bool ok = maxError <= limit;
+    printf("%-40s max error %.3g (limit %.3g) at %.17g %s\n", name, maxError, limit,
+      worstArgument, ok ? "" : "FAILED");
+    return ok;
+  }
+};
+
+static double relativeError(double y, long double reference)
+{
+  return (double) (fabsl((long double) y - reference) / fabsl(reference));
+}
+
+static double absoluteError(double y, long double reference)
+{
+  return (double) fabsl((long double) y - reference);
+}
+
+static const int numArguments = 1000001; // odd, so the array functions have a remainder
+
+static bool testExp2()
+{
+  std::vector<double> x(numArguments), y(numArguments);
+  fillArguments(x, -1022.0, 1023.0);
+  exp2Fast(&x[0], &y[0], numArguments);
+
+  ErrorMeter scalar("exp2Fast, relative", 2e-16), array("exp2Fast array, relative", 2e-16);
+  for(int i=0; i<numArguments; i++)
+  {
+    long double reference = exp2l((long double) x[i]);
+    scalar.add(relativeError(exp2Fast(x[i]), reference), x[i]);
+    array.add(relativeError(y[i], reference), x[i]);
+  }
+
+  // the arguments outside the range are clipped:
+  bool clipped = exp2Fast(-2000.0) == ldexp(1.0, -1022) && exp2Fast(2000.0) == ldexp(1.0, 1023);
+  double out[2], in[2] = { -2000.0, 2000.0 };
+  exp2Fast(in, out, 2);
+  clipped = clipped && out[0] == ldexp(1.0, -1022) && out[1] == ldexp(1.0, 1023);
+  if( !clipped )
+    printf("exp2Fast doesn't clip its argument FAILED\n");
+
+  bool ok = scalar.report();
+  ok = array.report() && ok;
+  return ok && clipped;
+}
+
+static bool testLog2()
+{
+  // the arguments are spread over all exponents of the normal numbers (plus a dense sweep
+  // around one, where the result is small):
+  std::vector<double> x(numArguments), y(numArguments);
+  for(int i=0; i<numArguments; i++)
+  {
+    if( i % 2 == 0 )
+      x[i] = exp2l((long double) getRandom(-1022.0, 1023.99));
+    else
+      x[i] = getRandom(0.5, 2.0);
+  }
+  log2Fast(&x[0], &y[0], numArguments);
+
+  ErrorMeter scalarAbs("log2Fast, absolute (result in -1...1)", 2.5e-16);
+  ErrorMeter scalarRel("log2Fast, relative (result outside)", 1.5e-16);
+  ErrorMeter arrayAbs("log2Fast array, absolute", 2.5e-16);
+  ErrorMeter arrayRel("log2Fast array, relative", 1.5e-16);
+  for(int i=0; i<numArguments; i++)
+  {
+    long double reference = log2l((long double) x[i]);
+    if( fabsl(reference) <= 1.0L )
+    {
+      scalarAbs.add(absoluteError(log2Fast(x[i]), reference), x[i]);
+      arrayAbs.add(absoluteError(y[i], reference), x[i]);
+    }
+    else
+    {
+      scalarRel.add(relativeError(log2Fast(x[i]), reference), x[i]);
+      arrayRel.add(relativeError(y[i], reference), x[i]);
+    }
+  }
+  bool ok = scalarAbs.report();
+  ok = scalarRel.report() && ok;
+  ok = arrayAbs.report() && ok;
+  ok = arrayRel.report() && ok;
+  return ok;
+}
+
+static bool testPow()
+{
+  // the error limit depends on the magnitude of the result's exponent, so we measure the error
+  // relative to that limit (the bound for the measured value is then 1):
+  std::vector<double> x(numArguments), y(numArguments), z(numArguments);
+  for(int i=0; i<numArguments; i++)
+  {
+    x[i] = exp2l((long double) getRandom(-20.0, 20.0));
+    y[i] = getRandom(-40.0, 40.0);
+  }
+  powFast(&x[0], &y[0], &z[0], numArguments);
+
+  ErrorMeter scalar("powFast, relative / bound", 1.0);
+  ErrorMeter array("powFast array, relative / bound", 1.0);
+  for(int i=0; i<numArguments; i++)
+  {
+    long double reference = powl((long double) x[i], (long double) y[i]);
+    double      bound     = (1.0 + fabs(y[i] * log2(x[i]))) * 3e-16;
+    scalar.add(relativeError(powFast(x[i], y[i]), reference) / bound, x[i]);
+    array.add(relativeError(z[i], reference) / bound, x[i]);
+  }
+  bool ok = scalar.report();
+  ok = array.report() && ok;
+  return ok;
+}
+
+static bool testTanh()
+{
+  std::vector<double> x(numArguments), y(numArguments);
+  fillArguments(x, -40.0, 40.0);
+  for(int i=0; i<numArguments; i += 4)
+    x[i] = getRandom(-1e-3, 1e-3); // small arguments, where the relative error matters most
+  tanhFast(&x[0], &y[0], numArguments);
+
+  ErrorMeter scalarAbs("tanhFast, absolute", 2e-16);
+  ErrorMeter scalarRel("tanhFast, relative", 5e-16);
+  ErrorMeter arrayAbs("tanhFast array, absolute", 2e-16);
+  ErrorMeter arrayRel("tanhFast array, relative", 5e-16);
+  for(int i=0; i<numArguments; i++)
+  {
+    long double reference = tanhl((long double) x[i]);
+    double      s         = tanhFast(x[i]);
+    scalarAbs.add(absoluteError(s, reference), x[i]);
+    arrayAbs.add(absoluteError(y[i], reference), x[i]);
+    if( reference != 0.0L )
+    {
+      scalarRel.add(relativeError(s, reference), x[i]);
+      arrayRel.add(relativeError(y[i], reference), x[i]);
+    }
+  }
+  bool ok = scalarAbs.report();
+  ok = scalarRel.report() && ok;
+  ok = arrayAbs.report() && ok;
+  ok = arrayRel.report() && ok;
+  return ok;
+}
+
+static bool testSinCos()
+{
+  std::vector<double> x(numArguments), s(numArguments), c(numArguments);
+  double range = ldexp(PI, 20);
+  for(int i=0; i<numArguments; i++)
+  {
+    if( i % 2 == 0 )
+      x[i] = getRandom(-range, range);
+    else
+      x[i] = getRandom(-4.0*PI, 4.0*PI);
+  }
+  sinCosFast(&x[0], &s[0], &c[0], numArguments);
+
+  ErrorMeter scalarSin("sinCosFast sine, absolute", 2e-16);
+  ErrorMeter scalarCos("sinCosFast cosine, absolute", 2e-16);
+  ErrorMeter arraySin("sinCosFast array sine, absolute", 2e-16);
+  ErrorMeter arrayCos("sinCosFast array cosine, absolute", 2e-16);
+  for(int i=0; i<numArguments; i++)
+  {
+    long double sinReference = sinl((long double) x[i]);
+    long double cosReference = cosl((long double) x[i]);
+    double sinValue, cosValue;
+    sinCosFast(x[i], &sinValue, &cosValue);
+    scalarSin.add(absoluteError(sinValue, sinReference), x[i]);
+    scalarCos.add(absoluteError(cosValue, cosReference), x[i]);
+    arraySin.add(absoluteError(s[i], sinReference), x[i]);
+    arrayCos.add(absoluteError(c[i], cosReference), x[i]);
+  }
+  bool ok = scalarSin.report();
+  ok = scalarCos.report() && ok;
+  ok = arraySin.report() && ok;
+  ok = arrayCos.report() && ok;
+  return ok;
+}
+
+int main()
+{
+#if defined(__AVX2__) && (defined(__GNUC__) || defined(__clang__))
+  if( !__builtin_cpu_supports("avx2") )
+  {
+    printf("the CPU doesn't support AVX2 - skipped\n");
+    return 77;
+  }
+#endif
+  printf("instruction set of the array functions: %s\n", getFastMathInstructionSet());
+
+  bool ok = testExp2();
+  ok = testLog2()   && ok;
+  ok = testPow()    && ok;
+  ok = testTanh()   && ok;
+  ok = testSinCos() && ok;
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,152 @@
+// This test renders a sequenced Open303 with an IncrementalRenderer, edits steps of the pattern
+// (accents, keys, gates and slides) and lets update() re-render the affected parts. With a zero
+// convergence threshold, the result after each update must be identical, sample by sample, to a
+// full render of the edited pattern from scratch - while update() must not have rendered anything
+// before the first affected step. With a small threshold, an accent edit must reconverge (and
+// render clearly less) and the result must stay close to the full render.
+
+#include "../Source/DSPCode/rosic_IncrementalRenderer.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+using namespace rosic;
+
+static const int numSamples = 10*44100;
+
+static void setUpPattern(AcidPattern* pattern)
+{
+  for(int k=0; k<16; k++)
+  {
+    pattern->setKey(k, (k*5) % 12);
+    pattern->setGate(k, k%7 != 3);
+    pattern->setSlide(k, k%3 == 0);
+    pattern->setAccent(k, k%4 == 1);
+  }
+}
+
+static void setUpSynth(Open303& synth, const AcidPattern& pattern)
+{
+  synth.setSampleRate(44100.0);
+  synth.setCutoff(800.0);
+  synth.setResonance(70.0);
+  synth.setEnvMod(60.0);
+  synth.setDecay(400.0);
+  synth.setAccent(50.0);
+  synth.sequencer.setMode(AcidSequencer::HOST_SYNC);
+  synth.sequencer.setTempo(130.0);
+  *synth.sequencer.getPattern(0) = pattern;
+  synth.sequencer.start();
+  synth.noteOn(36, 100);
+}
+
+// returns the maximum absolute difference between the output of the renderer and a full render of
+// its current pattern:
+static double getDifferenceToFullRender(IncrementalRenderer& renderer)
+{
+  IncrementalRenderer full;
+  setUpSynth(full.synth, *renderer.synth.sequencer.getPattern(0));
+  full.render(numSamples);
+  if( memcmp(full.getOutput(), renderer.getOutput(), numSamples*sizeof(double)) == 0 )
+    return 0.0;
+  double maxDiff = 0.0;
+  for(int n=0; n<numSamples; n++)
+    maxDiff = fmax(maxDiff, fabs(full.getOutput()[n] - renderer.getOutput()[n]));
+  return maxDiff > 0.0 ? maxDiff : 1.e-300; // differences in the bits of zeros count, too
+}
+
+enum edits
+{
+  ACCENT,
+  KEY,
+  GATE,
+  SLIDE,
+
+  NUM_EDITS
+};
+
+static const char* editNames[NUM_EDITS] = { "accent", "key", "gate", "slide" };
+
+static void applyEdit(AcidPattern* pattern, int edit, int step)
+{
+  switch( edit )
+  {
+  case ACCENT: pattern->setAccent(step, !pattern->getAccent(step));  break;
+  case KEY:    pattern->setKey(step, (pattern->getKey(step)+3) % 12); break;
+  case GATE:   pattern->setGate(step, !pattern->getGate(step));      break;
+  case SLIDE:  pattern->setSlide(step, !pattern->getSlide(step));    break;
+  }
+}
+
+static bool checkExactUpdates()
+{
+  AcidPattern pattern;
+  setUpPattern(&pattern);
+  IncrementalRenderer renderer;
+  setUpSynth(renderer.synth, pattern);
+  renderer.setConvergenceThreshold(0.0);
+  renderer.render(numSamples);
+
+  bool ok = true;
+  if( getDifferenceToFullRender(renderer) != 0.0 )
+  {
+    printf("the initial render differs from a full render - FAILED\n");
+    ok = false;
+  }
+
+  // the length of a step in samples, such that we know where the first affected step starts (up
+  // to the rounding of the step boundaries):
+  double stepLength = 0.25 * 60.0/130.0 * 44100.0;
+  static const int steps[NUM_EDITS] = { 9, 5, 12, 14 };
+  for(int e=0; e<NUM_EDITS; e++)
+  {
+    applyEdit(renderer.synth.sequencer.getPattern(0), e, steps[e]);
+    renderer.stepWasEdited(steps[e]);
+    int numRendered = renderer.update();
+    double maxDiff  = getDifferenceToFullRender(renderer);
+
+    // the predecessor of the edited step is affected, too (its slide depends on the next gate),
+    // but nothing before that must have been rendered:
+    int firstAffected = (int) ((steps[e]-1) * stepLength) - 1;
+    bool editOk = maxDiff == 0.0 && numRendered > 0 && numRendered <= numSamples - firstAffected;
+    printf("%-6s edit of step %2d: %7d of %d samples re-rendered, difference to a full render "
+      "%g %s\n", editNames[e], steps[e], numRendered, numSamples, maxDiff, editOk ? "" : "FAILED");
+    ok = ok && editOk;
+  }
+
+  // rerender must reproduce the same output:
+  renderer.rerender();
+  if( getDifferenceToFullRender(renderer) != 0.0
+    || renderer.getNumSamplesRendered() != numSamples )
+  {
+    printf("rerender differs from a full render - FAILED\n");
+    ok = false;
+  }
+  return ok;
+}
+
+static bool checkThresholdUpdate()
+{
+  static const double threshold = 1.e-6;
+  AcidPattern pattern;
+  setUpPattern(&pattern);
+  IncrementalRenderer renderer;
+  setUpSynth(renderer.synth, pattern);
+  renderer.setConvergenceThreshold(threshold);
+  renderer.render(numSamples);
+
+  applyEdit(renderer.synth.sequencer.getPattern(0), ACCENT, 9);
+  renderer.stepWasEdited(9);
+  int    numRendered = renderer.update();
+  double maxDiff     = getDifferenceToFullRender(renderer);
+  bool   ok          = numRendered < numSamples*3/4 && maxDiff <= 100*threshold;
+  printf("accent edit with threshold %g: %d of %d samples re-rendered, difference to a full "
+    "render %g %s\n", threshold, numRendered, numSamples, maxDiff, ok ? "" : "FAILED");
+  return ok;
+}
+
+int main()
+{
+  bool ok = checkExactUpdates();
+  ok = checkThresholdUpdate() && ok;
+  return ok ? 0 : 1;
+}
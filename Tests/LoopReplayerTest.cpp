@@ -0,0 +1,99 @@
+// This test lets a LoopReplayer render an Open303 that plays a pattern until the replay of the
+// recorded loop has started and then changes a setting of the synth directly (not through the
+// replayer). The replayer detects such changes by comparing Open303::writeSettings, so the replay
+// has to end in the next processBlock call - for the filter mode as well as for the parameters
+// that Open303 stores itself. Without a change, the replay has to go on.
+
+#include "../Source/DSPCode/rosic_LoopReplayer.h"
+#include <stdio.h>
+using namespace rosic;
+
+static const int    blockSize  = 256;
+static const double maxSeconds = 20.0; // the time after which the replay must have started
+
+enum changes
+{
+  NO_CHANGE,
+  FILTER_MODE,
+  CUTOFF,
+
+  NUM_CHANGES
+};
+
+static const char* changeNames[NUM_CHANGES] = { "no change", "filter mode", "cutoff" };
+
+static void setUpSynth(Open303& synth)
+{
+  synth.setSampleRate(44100.0);
+  synth.setCutoff(800.0);
+  synth.setResonance(70.0);
+  synth.setEnvMod(60.0);
+  synth.setDecay(400.0);
+  synth.setAccent(50.0);
+  synth.sequencer.setMode(AcidSequencer::KEY_SYNC);
+  synth.sequencer.setTempo(120.0);
+  AcidPattern* pattern = synth.sequencer.getPattern(0);
+  for(int k=0; k<16; k++)
+  {
+    pattern->setGate(k, k < 14);
+    pattern->setKey(k, (k*5) % 12);
+    pattern->setSlide(k, k%4 == 1);
+    pattern->setAccent(k, k%5 == 0);
+  }
+  synth.noteOn(40, 100);
+}
+
+static void applyChange(Open303& synth, int change)
+{
+  if( change == FILTER_MODE )
+    synth.filter.setMode(TeeBeeFilter::LP_24);
+  else if( change == CUTOFF )
+    synth.setCutoff(1500.0);
+}
+
+// returns true when the replay starts and then ends (or goes on for NO_CHANGE) as it should:
+static bool checkChange(int change)
+{
+  Open303 synth;
+  setUpSynth(synth);
+  LoopReplayer replayer;
+  replayer.setSynth(&synth);
+
+  double block[blockSize];
+  int maxBlocks = (int) (maxSeconds * 44100.0 / blockSize);
+  int b = 0;
+  while( b < maxBlocks && !replayer.isReplaying() )
+  {
+    replayer.processBlock(block, blockSize);
+    b++;
+  }
+  if( !replayer.isReplaying() )
+  {
+    printf("%-12s: the replay didn't start within %.0f s\n", changeNames[change], maxSeconds);
+    return false;
+  }
+
+  // a few blocks into the replay, such that it isn't just about to end anyway:
+  for(int i=0; i<4; i++)
+    replayer.processBlock(block, blockSize);
+  UINT64 numRendered = replayer.getNumRenderedSamples();
+
+  applyChange(synth, change);
+  replayer.processBlock(block, blockSize);
+
+  bool replaying = replayer.isReplaying();
+  bool ok        = (change == NO_CHANGE) ? replaying : !replaying;
+  if( change == NO_CHANGE && replayer.getNumRenderedSamples() != numRendered )
+    ok = false; // the synth must not have been rendered during the replay
+  printf("%-12s: replay started after %.2f s, %s after the change - %s\n", changeNames[change],
+    b * blockSize / 44100.0, replaying ? "replaying" : "rendering live", ok ? "ok" : "FAILED");
+  return ok;
+}
+
+int main()
+{
+  bool ok = true;
+  for(int change=0; change<NUM_CHANGES; change++)
+    ok = checkChange(change) && ok;
+  return ok ? 0 : 1;
+}
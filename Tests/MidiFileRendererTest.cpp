@@ -0,0 +1,104 @@
+// This test renders a small MIDI file with a tempo change at several sample rates and checks that
+// the events are applied at the right samples. The events are cutoff controllers, so their sample
+// positions can be read off the synth's cutoff while rendering one sample at a time.
+
+#include "../Source/DSPCode/rosic_MidiFileRenderer.h"
+#include <math.h>
+#include <stdio.h>
+using namespace rosic;
+
+static const unsigned char midiFile[] =
+{
+  // header: format 1, 2 tracks, 480 ticks per quarter note
+  'M', 'T', 'h', 'd', 0, 0, 0, 6,   0, 1,   0, 2,   0x01, 0xE0,
+
+  // tempo track: 120 bpm at tick 0, 90 bpm at tick 960
+  'M', 'T', 'r', 'k', 0, 0, 0, 19,
+  0x00,       0xFF, 0x51, 0x03, 0x07, 0xA1, 0x20,  // 500000 us per quarter note
+  0x87, 0x40, 0xFF, 0x51, 0x03, 0x0A, 0x2C, 0x2A,  // delta 960: 666666 us per quarter note
+  0x00,       0xFF, 0x2F, 0x00,
+
+  // note track: a note with cutoff changes at ticks 240, 960, 1200 and 2000
+  'M', 'T', 'r', 'k', 0, 0, 0, 32,
+  0x00,       0x90, 0x24, 0x64,
+  0x81, 0x70, 0xB0, 0x4A, 0x10,                    // delta 240
+  0x85, 0x50, 0xB0, 0x4A, 0x40,                    // delta 720
+  0x81, 0x70, 0xB0, 0x4A, 0x70,                    // delta 240
+  0x86, 0x20, 0xB0, 0x4A, 0x20,                    // delta 800
+  0x64,       0x80, 0x24, 0x00,                    // delta 100
+  0x00,       0xFF, 0x2F, 0x00
+};
+
+static const int numEvents = 4;
+
+// the times of the cutoff events in seconds according to the tempo map:
+static double getEventTime(int event)
+{
+  static const int ticks[numEvents] = { 240, 960, 1200, 2000 };
+  int tick = ticks[event];
+  if( tick <= 960 )
+    return tick * 0.5 / 480.0;
+  return 960 * 0.5 / 480.0 + (tick-960) * 0.666666 / 480.0;
+}
+
+static bool checkSampleRate(const char* path, double sampleRate)
+{
+  Open303 synth;
+  synth.setSampleRate(sampleRate);
+  MidiFileRenderer renderer;
+  renderer.setSynth(&synth);
+  if( !renderer.open(path) )
+  {
+    printf("can't open %s\n", path);
+    return false;
+  }
+
+  INT64  eventSamples[numEvents];
+  int    numFound = 0;
+  double cutoff   = synth.getCutoff();
+  double sample;
+  int    numSamples = (int) ceil(3.0 * sampleRate);
+  for(int n=0; n<numSamples && numFound<numEvents; n++)
+  {
+    renderer.render(&sample, 1);
+    if( synth.getCutoff() != cutoff )
+    {
+      cutoff = synth.getCutoff();
+      eventSamples[numFound++] = n;
+    }
+  }
+
+  bool ok = numFound == numEvents;
+  for(int e=0; e<numFound; e++)
+  {
+    INT64 expected = (INT64) floor(getEventTime(e) * sampleRate + 0.5);
+    if( eventSamples[e] != expected )
+    {
+      printf("%g Hz: event %d at sample %lld instead of %lld\n", sampleRate, e,
+        (long long) eventSamples[e], (long long) expected);
+      ok = false;
+    }
+  }
+  if( numFound != numEvents )
+    printf("%g Hz: found %d of %d events\n", sampleRate, numFound, numEvents);
+  return ok;
+}
+
+int main()
+{
+  const char* path = "MidiFileRendererTest.mid";
+  FILE* f = fopen(path, "wb");
+  if( f == NULL || fwrite(midiFile, sizeof(midiFile), 1, f) != 1 )
+  {
+    printf("can't write %s\n", path);
+    return 1;
+  }
+  fclose(f);
+
+  bool ok = true;
+  ok = checkSampleRate(path, 44100.0) && ok;
+  ok = checkSampleRate(path, 48000.0) && ok;
+  ok = checkSampleRate(path, 96000.0) && ok;
+  remove(path);
+  return ok ? 0 : 1;
+}
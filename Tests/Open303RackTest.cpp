@@ -0,0 +1,118 @@
+// This test renders a rack of Open303 instances with more instances than threads, uneven loads
+// (idle instances, instances with unison lanes and plain ones), several buses with different gains
+// and a maximum block size that is smaller than (and doesn't divide) the block size of the host.
+// The buses must be identical, sample by sample, to rendering each instance on its own, serially,
+// and mixing the outputs in the order of the instances - regardless of the group size and of which
+// thread has rendered (or stolen) which group.
+
+#include "../Source/DSPCode/rosic_Open303Rack.h"
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+using namespace rosic;
+
+static const int numInstances = 13;
+static const int numBuses     = 3;
+static const int numThreads   = 3;
+static const int blockSize    = 256;  // of the host
+static const int numBlocks    = 60;
+static const int numSamples   = blockSize*numBlocks;
+
+static void setUpInstance(Open303& synth, int i)
+{
+  synth.setSampleRate(44100.0);
+  synth.setCutoff(300.0 + 100.0*i);
+  synth.setResonance(50.0 + i);
+  synth.setEnvMod(60.0);
+  synth.setDecay(400.0);
+  synth.setAccent(50.0);
+  synth.setVolume(-6.0);
+  synth.setWaveform((i%4) * 0.3);
+  if( i%4 == 1 )
+  {
+    synth.setNumUnisonLanes(4); // about four times the load
+    synth.setUnisonDetune(15.0);
+  }
+
+  synth.sequencer.setMode(AcidSequencer::KEY_SYNC);
+  AcidPattern* pattern = synth.sequencer.getPattern(0);
+  for(int k=0; k<16; k++)
+  {
+    pattern->setGate(k, (k+i)%3 != 2);
+    pattern->setKey(k, (k*5+i) % 12);
+    pattern->setSlide(k, k%4 == 1);
+    pattern->setAccent(k, k%5 == 0);
+  }
+  if( i%4 != 3 )
+    synth.noteOn(36 + i%12, 100); // the others stay idle
+}
+
+static int getBus(int i)
+{
+  return (i*2) % numBuses;
+}
+
+static double getGain(int i)
+{
+  return 0.5 + 0.1*i;
+}
+
+// renders each instance on its own and mixes the outputs like the rack does:
+static std::vector<double> renderSerially()
+{
+  std::vector<double> buses(numBuses*numSamples, 0.0), output(numSamples);
+  for(int i=0; i<numInstances; i++)
+  {
+    Open303 synth;
+    setUpInstance(synth, i);
+    for(int n=0; n<numSamples; n+=blockSize)
+      synth.processBlock(&output[n], blockSize);
+    double* bus = &buses[getBus(i)*numSamples];
+    for(int n=0; n<numSamples; n++)
+      bus[n] += getGain(i) * output[n];
+  }
+  return buses;
+}
+
+static std::vector<double> renderRack(int maxBlockSize, int groupSize)
+{
+  Open303Rack rack(numInstances, numBuses, numThreads, false);
+  rack.setSampleRate(44100.0);
+  rack.setMaxBlockSize(maxBlockSize);
+  rack.setGroupSize(groupSize);
+  for(int i=0; i<numInstances; i++)
+  {
+    setUpInstance(*rack.getInstance(i), i);
+    rack.setInstanceBus(i, getBus(i));
+    rack.setInstanceGain(i, getGain(i));
+  }
+
+  std::vector<double> buses(numBuses*numSamples);
+  double* busPointers[numBuses];
+  for(int n=0; n<numSamples; n+=blockSize)
+  {
+    for(int b=0; b<numBuses; b++)
+      busPointers[b] = &buses[b*numSamples + n];
+    rack.processBlock(busPointers, blockSize);
+  }
+  return buses;
+}
+
+int main()
+{
+  // maximum block sizes and group sizes (zero chooses it automatically):
+  static const int configurations[][2] = { { 100, 0 }, { 64, 1 }, { 37, 5 }, { 512, 2 } };
+  std::vector<double> reference = renderSerially();
+
+  bool ok = true;
+  for(int c=0; c<(int) (sizeof(configurations)/sizeof(configurations[0])); c++)
+  {
+    std::vector<double> buses = renderRack(configurations[c][0], configurations[c][1]);
+    bool identical = memcmp(&buses[0], &reference[0], buses.size()*sizeof(double)) == 0;
+    printf("%d instances, %d threads, max block size %3d, group size %d: %s\n", numInstances,
+      numThreads, configurations[c][0], configurations[c][1],
+      identical ? "identical to serial rendering" : "differs from serial rendering - FAILED");
+    ok = ok && identical;
+  }
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,189 @@
+// This test writes a bank of patterns with PatternBank::writeFile (with unsorted IDs), opens it,
+// looks up every pattern by its ID and checks that getPattern decodes exactly what was written
+// (with the step lengths quantized to 1/256 step) and that validateFile accepts the bank. Then it
+// damages single records (keys 13...15, reserved note bits, step counts and lengths out of range)
+// and checks that validateFile reports the damaged record and that getPattern rejects it without
+// touching the pattern, while the other records can still be read.
+
+#include "../Source/DSPCode/rosic_PatternBank.h"
+#include <stdio.h>
+#include <vector>
+using namespace rosic;
+
+static const char* path        = "PatternBankTest.p303";
+static const int   numPatterns = 50;
+static const int   headerSize  = 16;
+static const int   recordSize  = 36;
+
+static UINT32 getId(int i)
+{
+  return (UINT32) ((i*37) % numPatterns) * 1000 + 7; // unique, but not sorted
+}
+
+static void setUpPattern(AcidPattern* pattern, int i)
+{
+  pattern->setNumSteps(1 + i%16);
+  pattern->setStepLength((1 + (i*11) % 256) / 256.0);
+  for(int s=0; s<16; s++)
+  {
+    AcidNote* note = pattern->getNote(s);
+    note->key    = (i+s) % 13;
+    note->octave = (i+s) % 16 - 8;
+    note->accent = (i+s) % 2 == 0;
+    note->slide  = (i+s) % 3 == 0;
+    note->gate   = (i+s) % 5 != 0;
+  }
+}
+
+static bool isEqual(AcidPattern& a, AcidPattern& b)
+{
+  if( a.getNumSteps() != b.getNumSteps() || a.getStepLength() != b.getStepLength() )
+    return false;
+  for(int s=0; s<16; s++)
+  {
+    AcidNote* x = a.getNote(s);
+    AcidNote* y = b.getNote(s);
+    if(    x->key != y->key || x->octave != y->octave || x->accent != y->accent
+        || x->slide != y->slide || x->gate != y->gate )
+      return false;
+  }
+  return true;
+}
+
+static bool checkRoundTrip(std::vector<AcidPattern>& patterns)
+{
+  PatternBank bank;
+  if( !bank.open(path) || bank.getNumPatterns() != numPatterns )
+  {
+    printf("round trip: can't open the bank - FAILED\n");
+    return false;
+  }
+
+  bool ok = true;
+  for(int i=0; i<numPatterns; i++)
+  {
+    int index = bank.findPattern(getId(i));
+    AcidPattern pattern;
+    if( index < 0 || bank.getPatternId(index) != getId(i) || !bank.getPattern(index, &pattern)
+      || !isEqual(pattern, patterns[i]) )
+    {
+      printf("round trip: pattern %d differs - FAILED\n", i);
+      ok = false;
+    }
+  }
+
+  AcidPattern pattern;
+  if( bank.findPattern(8) != -1 || bank.getPattern(-1, &pattern)
+    || bank.getPattern(numPatterns, &pattern) )
+  {
+    printf("round trip: a missing pattern was found - FAILED\n");
+    ok = false;
+  }
+
+  int badRecord = -1;
+  int result    = PatternBank::validateFile(path, &badRecord);
+  if( result != PatternBank::VALID )
+  {
+    printf("round trip: validateFile returned %d - FAILED\n", result);
+    ok = false;
+  }
+
+  std::vector<UINT32> duplicateIds(2, getId(0));
+  if( PatternBank::writeFile("PatternBankTest2.p303", &patterns[0], &duplicateIds[0], 2) )
+  {
+    printf("round trip: duplicate IDs were accepted - FAILED\n");
+    ok = false;
+  }
+
+  printf("round trip: %d patterns %s\n", numPatterns, ok ? "identical" : "FAILED");
+  return ok;
+}
+
+static bool checkCorruptions(const std::vector<unsigned char>& file)
+{
+  struct Corruption
+  {
+    const char* name;
+    int         offset;  // within the record
+    int         value;   // 16 bit little endian when offset >= 2, a byte otherwise
+    int         expectedResult;
+  };
+  const Corruption corruptions[] =
+  {
+    { "key 13",               4+2*3,  0x000D, PatternBank::BAD_NOTE   },
+    { "key 15",               4+2*15, 0x040F, PatternBank::BAD_NOTE   },
+    { "reserved note bits",   4,      0x0800, PatternBank::BAD_NOTE   },
+    { "0 steps",              0,      0,      PatternBank::BAD_RECORD },
+    { "17 steps",             0,      17,     PatternBank::BAD_RECORD },
+    { "reserved record byte", 1,      1,      PatternBank::BAD_RECORD },
+    { "step length 0",        2,      0,      PatternBank::BAD_RECORD },
+    { "step length 257",      2,      257,    PatternBank::BAD_RECORD },
+  };
+  static const int damagedRecord = 23;
+
+  bool ok = true;
+  for(int c=0; c<(int) (sizeof(corruptions)/sizeof(Corruption)); c++)
+  {
+    std::vector<unsigned char> damaged(file);
+    int offset = headerSize + 4*numPatterns + damagedRecord*recordSize + corruptions[c].offset;
+    damaged[offset] = (unsigned char) (corruptions[c].value & 0xFF);
+    if( corruptions[c].offset >= 2 )
+      damaged[offset+1] = (unsigned char) (corruptions[c].value >> 8);
+
+    FILE* f = fopen(path, "wb");
+    bool written = f != NULL && fwrite(&damaged[0], damaged.size(), 1, f) == 1;
+    if( f != NULL )
+      fclose(f);
+
+    int badRecord = -1;
+    int result    = PatternBank::validateFile(path, &badRecord);
+
+    PatternBank bank;
+    AcidPattern pattern, untouched;
+    bool opened   = bank.open(path);
+    bool rejected = !bank.getPattern(damagedRecord, &pattern) && isEqual(pattern, untouched);
+    bool others   = bank.getPattern(damagedRecord-1, &pattern)
+                    && bank.getPattern(damagedRecord+1, &pattern);
+
+    bool corruptionOk = written && result == corruptions[c].expectedResult
+      && badRecord == damagedRecord && opened && rejected && others;
+    printf("%-20s: validateFile returned %d for record %d, getPattern %s %s\n",
+      corruptions[c].name, result, badRecord, rejected ? "rejected it" : "accepted it",
+      corruptionOk ? "" : "FAILED");
+    ok = ok && corruptionOk;
+  }
+  return ok;
+}
+
+int main()
+{
+  std::vector<AcidPattern> patterns(numPatterns);
+  std::vector<UINT32>      ids(numPatterns);
+  for(int i=0; i<numPatterns; i++)
+  {
+    setUpPattern(&patterns[i], i);
+    ids[i] = getId(i);
+  }
+  if( !PatternBank::writeFile(path, &patterns[0], &ids[0], numPatterns) )
+  {
+    printf("can't write %s\n", path);
+    return 1;
+  }
+
+  bool ok = checkRoundTrip(patterns);
+
+  std::vector<unsigned char> file(headerSize + numPatterns*(4+recordSize));
+  FILE* f = fopen(path, "rb");
+  if( f == NULL || fread(&file[0], file.size(), 1, f) != 1 )
+  {
+    printf("can't read %s\n", path);
+    ok = false;
+  }
+  else
+    ok = checkCorruptions(file) && ok;
+  if( f != NULL )
+    fclose(f);
+
+  remove(path);
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,375 @@
+// This test drives Open303 through a set of note, controller and automation scenarios and fails
+// when anything inside the real-time scopes allocates or frees memory, locks a mutex or makes one
+// of the blocking system calls that are hooked below. The library is built with
+// OPEN303_CHECK_REALTIME, so the scopes are active in getSample, processBlock, noteOn, etc. - and
+// the test wraps its own scope around each step of a scenario, such that the setters that a host
+// calls from the audio thread (in between the render calls) are covered as well.
+//
+// The hooks replace the glibc functions by versions that count the calls inside a scope and then
+// forward to glibc's internal entry points (or to the next definition of the symbol), so this test
+// only builds on Linux.
+
+#include "../Source/DSPCode/rosic_Open303.h"
+#include "../Source/DSPCode/rosic_AutomationSpan.h"
+#include "../Source/DSPCode/rosic_RealTimeScope.h"
+#include <dlfcn.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+using namespace rosic;
+
+//-------------------------------------------------------------------------------------------------
+// hooks:
+
+enum violationTypes
+{
+  ALLOCATION = 0,
+  LOCK,
+  SYSCALL,
+
+  NUM_VIOLATION_TYPES
+};
+
+static volatile int numHookedViolations[NUM_VIOLATION_TYPES];
+
+static void registerCall(int type)
+{
+  if( RealTimeScope::isInside() )
+  {
+    numHookedViolations[type]++;
+    RealTimeScope::checkViolation();
+  }
+}
+
+extern "C"
+{
+  void*   __libc_malloc(size_t size);
+  void*   __libc_calloc(size_t num, size_t size);
+  void*   __libc_realloc(void* p, size_t size);
+  void*   __libc_memalign(size_t alignment, size_t size);
+  void    __libc_free(void* p);
+  ssize_t __read(int fd, void* buffer, size_t numBytes);
+  ssize_t __write(int fd, const void* buffer, size_t numBytes);
+  int     __nanosleep(const struct timespec* duration, struct timespec* remaining);
+
+  void* malloc(size_t size)
+  {
+    registerCall(ALLOCATION);
+    return __libc_malloc(size);
+  }
+
+  void* calloc(size_t num, size_t size)
+  {
+    registerCall(ALLOCATION);
+    return __libc_calloc(num, size);
+  }
+
+  void* realloc(void* p, size_t size)
+  {
+    registerCall(ALLOCATION);
+    return __libc_realloc(p, size);
+  }
+
+  void* aligned_alloc(size_t alignment, size_t size)
+  {
+    registerCall(ALLOCATION);
+    return __libc_memalign(alignment, size);
+  }
+
+  int posix_memalign(void** p, size_t alignment, size_t size)
+  {
+    registerCall(ALLOCATION);
+    *p = __libc_memalign(alignment, size);
+    return *p != NULL ? 0 : ENOMEM;
+  }
+
+  void free(void* p)
+  {
+    if( p != NULL )
+      registerCall(ALLOCATION);
+    __libc_free(p);
+  }
+
+  int pthread_mutex_lock(pthread_mutex_t* mutex)
+  {
+    typedef int (*LockFunction)(pthread_mutex_t*);
+    static LockFunction nextLock = NULL;
+    if( nextLock == NULL )
+      nextLock = (LockFunction) dlsym(RTLD_NEXT, "pthread_mutex_lock");
+    registerCall(LOCK);
+    return nextLock(mutex);
+  }
+
+  ssize_t read(int fd, void* buffer, size_t numBytes)
+  {
+    registerCall(SYSCALL);
+    return __read(fd, buffer, numBytes);
+  }
+
+  ssize_t write(int fd, const void* buffer, size_t numBytes)
+  {
+    registerCall(SYSCALL);
+    return __write(fd, buffer, numBytes);
+  }
+
+  int nanosleep(const struct timespec* duration, struct timespec* remaining)
+  {
+    registerCall(SYSCALL);
+    return __nanosleep(duration, remaining);
+  }
+}
+
+//-------------------------------------------------------------------------------------------------
+// scenarios:
+
+enum commands
+{
+  NOTE_ON,          // key, velocity
+  ALL_NOTES_OFF,
+  PITCH_BEND,       // -, semitones
+  PARAMETER,        // parameter, value
+  SEQUENCER,        // sequencer mode, tempo
+  RENDER_SAMPLES,   // number of samples, rendered with getSample
+  RENDER_BLOCKS,    // number of samples, rendered with processBlock in blocks of 'value' samples
+  RENDER_AUTOMATED, // number of samples, rendered with automation in blocks of 'value' samples
+  END
+};
+
+enum parameters
+{
+  WAVEFORM,
+  CUTOFF,
+  RESONANCE,
+  ENV_MOD,
+  DECAY,
+  ACCENT,
+  VOLUME,
+  TUNING,
+  FILTER_MODE,
+  OSCILLATOR_ENGINE,
+  UNISON_LANES,
+  UNISON_DETUNE,
+  SLIDE_TIME,
+  SQUARE_PHASE_SHIFT,
+  TANH_SHAPER_DRIVE
+};
+
+struct ScenarioStep
+{
+  int    command;
+  int    argument;
+  double value;
+};
+
+struct Scenario
+{
+  const char*  name;
+  ScenarioStep steps[32];
+};
+
+static const Scenario scenarios[] =
+{
+  { "single notes",
+    { { NOTE_ON, 48, 100 }, { RENDER_SAMPLES, 4000, 0 }, { NOTE_ON, 48, 0 },
+      { RENDER_SAMPLES, 8000, 0 }, { NOTE_ON, 36, 127 }, { RENDER_BLOCKS, 4000, 64 },
+      { NOTE_ON, 36, 0 }, { RENDER_BLOCKS, 20000, 512 }, { END, 0, 0 } } },
+
+  { "legato and slides",
+    { { PARAMETER, SLIDE_TIME, 80 }, { NOTE_ON, 40, 100 }, { RENDER_BLOCKS, 1000, 32 },
+      { NOTE_ON, 43, 80 }, { RENDER_BLOCKS, 1000, 32 }, { NOTE_ON, 47, 120 },
+      { RENDER_SAMPLES, 1000, 0 }, { NOTE_ON, 43, 0 }, { RENDER_SAMPLES, 1000, 0 },
+      { NOTE_ON, 47, 0 }, { NOTE_ON, 40, 0 }, { RENDER_BLOCKS, 8000, 256 }, { END, 0, 0 } } },
+
+  { "controllers",
+    { { NOTE_ON, 45, 100 }, { PARAMETER, CUTOFF, 400 }, { RENDER_BLOCKS, 300, 16 },
+      { PARAMETER, RESONANCE, 90 }, { RENDER_BLOCKS, 300, 16 }, { PARAMETER, ENV_MOD, 80 },
+      { RENDER_SAMPLES, 300, 0 }, { PARAMETER, DECAY, 1500 }, { PARAMETER, ACCENT, 70 },
+      { RENDER_SAMPLES, 300, 0 }, { PARAMETER, VOLUME, -12 }, { PARAMETER, WAVEFORM, 0.3 },
+      { RENDER_BLOCKS, 300, 7 }, { PARAMETER, TUNING, 442 }, { PARAMETER, FILTER_MODE, 4 },
+      { RENDER_BLOCKS, 300, 64 }, { PARAMETER, SQUARE_PHASE_SHIFT, 200 },
+      { PARAMETER, TANH_SHAPER_DRIVE, 24 }, { RENDER_BLOCKS, 2000, 64 },
+      { PITCH_BEND, 0, 2.5 }, { RENDER_SAMPLES, 500, 0 }, { NOTE_ON, 45, 0 },
+      { RENDER_BLOCKS, 8000, 512 }, { END, 0, 0 } } },
+
+  { "automation",
+    { { NOTE_ON, 38, 127 }, { RENDER_AUTOMATED, 8192, 512 }, { NOTE_ON, 50, 100 },
+      { RENDER_AUTOMATED, 4096, 100 }, { NOTE_ON, 50, 0 }, { NOTE_ON, 38, 0 },
+      { RENDER_AUTOMATED, 20000, 1024 }, { END, 0, 0 } } },
+
+  { "oscillator engines and unison",
+    { { PARAMETER, OSCILLATOR_ENGINE, BlendOscillator::POLYBLEP }, { NOTE_ON, 41, 100 },
+      { RENDER_BLOCKS, 2000, 128 }, { PARAMETER, OSCILLATOR_ENGINE, BlendOscillator::PREBLENDED },
+      { PARAMETER, WAVEFORM, 0.7 }, { RENDER_BLOCKS, 2000, 128 },
+      { PARAMETER, OSCILLATOR_ENGINE, BlendOscillator::WAVETABLE },
+      { RENDER_SAMPLES, 2000, 0 }, { PARAMETER, UNISON_LANES, 4 },
+      { PARAMETER, UNISON_DETUNE, 15 }, { RENDER_BLOCKS, 4000, 128 },
+      { PARAMETER, UNISON_LANES, 1 }, { RENDER_BLOCKS, 2000, 128 }, { ALL_NOTES_OFF, 0, 0 },
+      { RENDER_BLOCKS, 8000, 512 }, { END, 0, 0 } } },
+
+  { "sequencer",
+    { { SEQUENCER, AcidSequencer::KEY_SYNC, 130 }, { NOTE_ON, 40, 100 },
+      { RENDER_BLOCKS, 44100, 512 }, { PARAMETER, CUTOFF, 1200 }, { RENDER_SAMPLES, 20000, 0 },
+      { SEQUENCER, AcidSequencer::KEY_SYNC, 95 }, { RENDER_AUTOMATED, 30000, 256 },
+      { NOTE_ON, 40, 0 }, { SEQUENCER, AcidSequencer::OFF, 130 }, { RENDER_BLOCKS, 10000, 512 },
+      { END, 0, 0 } } }
+};
+
+static const int numScenarios = sizeof(scenarios) / sizeof(Scenario);
+
+//-------------------------------------------------------------------------------------------------
+// rendering:
+
+static const int maxBlockSize = 1024;
+
+static void setParameter(Open303& synth, int parameter, double value)
+{
+  switch( parameter )
+  {
+  case WAVEFORM:           synth.setWaveform(value);                 break;
+  case CUTOFF:             synth.setCutoff(value);                   break;
+  case RESONANCE:          synth.setResonance(value);                break;
+  case ENV_MOD:            synth.setEnvMod(value);                   break;
+  case DECAY:              synth.setDecay(value);                    break;
+  case ACCENT:             synth.setAccent(value);                   break;
+  case VOLUME:             synth.setVolume(value);                   break;
+  case TUNING:             synth.setTuning(value);                   break;
+  case FILTER_MODE:        synth.filter.setMode((int) value);        break;
+  case OSCILLATOR_ENGINE:  synth.setOscillatorEngine((int) value);   break;
+  case UNISON_LANES:       synth.setNumUnisonLanes((int) value);     break;
+  case UNISON_DETUNE:      synth.setUnisonDetune(value);             break;
+  case SLIDE_TIME:         synth.setSlideTime(value);                break;
+  case SQUARE_PHASE_SHIFT: synth.setSquarePhaseShift(value);         break;
+  case TANH_SHAPER_DRIVE:  synth.setTanhShaperDrive(value);          break;
+  }
+}
+
+// renders with a dense cutoff sweep, stepped resonance and a ramped volume and returns the peak:
+static double renderAutomated(Open303& synth, double* buffer, int numSamples, int blockSize,
+                            double* cutoffs)
+{
+  int    positions[2];
+  double resonances[2], volumes[2];
+  AutomationSpan spans[Open303::NUM_AUTOMATABLE_PARAMETERS];
+  const AutomationSpan* automation[Open303::NUM_AUTOMATABLE_PARAMETERS];
+  for(int p=0; p<Open303::NUM_AUTOMATABLE_PARAMETERS; p++)
+    automation[p] = &spans[p];
+
+  double peak = 0.0;
+  for(int start=0; start<numSamples; start+=blockSize)
+  {
+    int n = rmin(blockSize, numSamples-start);
+    for(int i=0; i<n; i++)
+      cutoffs[i] = 300.0 + 1500.0 * (double) ((start+i) % 5000) / 5000.0;
+    positions[0]  = 0;
+    positions[1]  = n/2;
+    resonances[0] = 40.0;
+    resonances[1] = 85.0;
+    volumes[0]    = -6.0;
+    volumes[1]    = -18.0;
+    spans[Open303::CUTOFF].setBuffer(cutoffs);
+    spans[Open303::RESONANCE].setBreakpoints(positions, resonances, 2, false);
+    spans[Open303::VOLUME].setBreakpoints(positions, volumes, 2, true);
+    synth.processBlock(buffer, n, automation);
+    for(int i=0; i<n; i++)
+      peak = rmax(peak, fabs(buffer[i]));
+  }
+  return peak;
+}
+
+static bool runScenario(const Scenario& scenario)
+{
+  // preparation (allowed to allocate):
+  Open303 synth;
+  synth.setSampleRate(44100.0);
+  for(int k=0; k<16; k++)
+  {
+    AcidPattern* pattern = synth.sequencer.getPattern(0);
+    pattern->setGate(k, k%3 != 2);
+    pattern->setKey(k, (k*5) % 12);
+    pattern->setSlide(k, k%4 == 1);
+    pattern->setAccent(k, k%5 == 0);
+  }
+  double buffer[maxBlockSize], cutoffs[maxBlockSize];
+  RealTimeScope::resetNumViolations();
+  for(int t=0; t<NUM_VIOLATION_TYPES; t++)
+    numHookedViolations[t] = 0;
+
+  // the scenario itself runs inside real-time scopes:
+  double peak = 0.0;
+  for(int s=0; scenario.steps[s].command != END; s++)
+  {
+    RealTimeScope realTimeScope;
+    const ScenarioStep& step = scenario.steps[s];
+    switch( step.command )
+    {
+    case NOTE_ON:       synth.noteOn(step.argument, (int) step.value);   break;
+    case ALL_NOTES_OFF: synth.allNotesOff();                             break;
+    case PITCH_BEND:    synth.setPitchBend(step.value);                  break;
+    case PARAMETER:     setParameter(synth, step.argument, step.value);  break;
+    case SEQUENCER:
+      synth.sequencer.setMode(step.argument);
+      synth.sequencer.setTempo(step.value);
+      break;
+    case RENDER_SAMPLES:
+      for(int n=0; n<step.argument; n++)
+        peak = rmax(peak, fabs(synth.getSample()));
+      break;
+    case RENDER_BLOCKS:
+      for(int start=0; start<step.argument; start+=(int) step.value)
+      {
+        int n = rmin((int) step.value, step.argument-start);
+        synth.processBlock(buffer, n);
+        for(int i=0; i<n; i++)
+          peak = rmax(peak, fabs(buffer[i]));
+      }
+      break;
+    case RENDER_AUTOMATED:
+      peak = rmax(peak, renderAutomated(synth, buffer, step.argument, (int) step.value, cutoffs));
+      break;
+    }
+  }
+
+  int numViolations = RealTimeScope::getNumViolations();
+  printf("%-30s allocations: %d, locks: %d, system calls: %d, peak: %.3f\n", scenario.name,
+    numHookedViolations[ALLOCATION], numHookedViolations[LOCK], numHookedViolations[SYSCALL], peak);
+  return numViolations == 0 && peak > 0.0;
+}
+
+int main()
+{
+  if( !RealTimeScope::isEnabled() )
+  {
+    printf("the library was built without OPEN303_CHECK_REALTIME\n");
+    return 1;
+  }
+
+  // make sure that the hooks catch what they are supposed to catch:
+  {
+    RealTimeScope realTimeScope;
+    void* p = malloc(16);
+    free(p);
+    pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+    pthread_mutex_lock(&mutex);
+    pthread_mutex_unlock(&mutex);
+  }
+  if( RealTimeScope::getNumViolations() != 3 )
+  {
+    printf("the hooks are not effective\n");
+    return 1;
+  }
+
+  int numFailed = 0;
+  for(int s=0; s<numScenarios; s++)
+  {
+    if( !runScenario(scenarios[s]) )
+      numFailed++;
+  }
+  if( numFailed > 0 )
+  {
+    printf("%d of %d scenarios failed\n", numFailed, numScenarios);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,106 @@
+// This test checks that the key of the render cache (which hashes Open303::writeSettings) changes
+// with every setting that a host can change - in particular with all the parameters that the
+// plugin exposes and with the sample rate. A setting that is missing in writeSettings would let
+// the cache return (and the loop replayer keep playing) audio that was rendered with the old value.
+
+#include "../Source/DSPCode/rosic_RenderCache.h"
+#include <stdio.h>
+using namespace rosic;
+
+enum settings
+{
+  SAMPLE_RATE,
+  WAVEFORM,
+  TUNING,
+  CUTOFF,
+  RESONANCE,
+  ENV_MOD,
+  DECAY,
+  ACCENT,
+  VOLUME,
+  FILTER_MODE,
+  FILTER_DRIVE,
+  AMP_SUSTAIN,
+  TANH_SHAPER_DRIVE,
+  TANH_SHAPER_OFFSET,
+  PRE_FILTER_HPF,
+  FEEDBACK_HPF,
+  POST_FILTER_HPF,
+  SQUARE_PHASE_SHIFT,
+  OSCILLATOR_ENGINE,
+  UNISON_LANES,
+
+  NUM_SETTINGS
+};
+
+static const char* settingNames[NUM_SETTINGS] =
+{
+  "sample rate", "waveform", "tuning", "cutoff", "resonance", "env mod", "decay", "accent",
+  "volume", "filter mode", "filter drive", "amp sustain", "tanh shaper drive",
+  "tanh shaper offset", "pre filter highpass", "feedback highpass", "post filter highpass",
+  "square phase shift", "oscillator engine", "unison lanes"
+};
+
+static void changeSetting(Open303& synth, int setting)
+{
+  switch( setting )
+  {
+  case SAMPLE_RATE:        synth.setSampleRate(96000.0);                          break;
+  case WAVEFORM:           synth.setWaveform(0.25);                               break;
+  case TUNING:             synth.setTuning(442.0);                                break;
+  case CUTOFF:             synth.setCutoff(777.0);                                break;
+  case RESONANCE:          synth.setResonance(33.0);                              break;
+  case ENV_MOD:            synth.setEnvMod(12.0);                                 break;
+  case DECAY:              synth.setDecay(345.0);                                 break;
+  case ACCENT:             synth.setAccent(22.0);                                 break;
+  case VOLUME:             synth.setVolume(-9.0);                                 break;
+  case FILTER_MODE:        synth.filter.setMode(TeeBeeFilter::LP_12);             break;
+  case FILTER_DRIVE:       synth.filter.setDrive(6.0);                            break;
+  case AMP_SUSTAIN:        synth.setAmpSustain(-20.0);                            break;
+  case TANH_SHAPER_DRIVE:  synth.setTanhShaperDrive(12.0);                        break;
+  case TANH_SHAPER_OFFSET: synth.setTanhShaperOffset(2.0);                        break;
+  case PRE_FILTER_HPF:     synth.setPreFilterHighpass(90.0);                      break;
+  case FEEDBACK_HPF:       synth.setFeedbackHighpass(200.0);                      break;
+  case POST_FILTER_HPF:    synth.setPostFilterHighpass(30.0);                     break;
+  case SQUARE_PHASE_SHIFT: synth.setSquarePhaseShift(90.0);                       break;
+  case OSCILLATOR_ENGINE:  synth.setOscillatorEngine(BlendOscillator::POLYBLEP);  break;
+  case UNISON_LANES:       synth.setNumUnisonLanes(3);                            break;
+  }
+}
+
+int main()
+{
+  int numFailed = 0;
+
+  Open303 rateChecker;
+  rateChecker.setSampleRate(48000.0);
+  if( rateChecker.getSampleRate() != 48000.0 )
+  {
+    printf("getSampleRate returns %g after setSampleRate(48000)\n", rateChecker.getSampleRate());
+    numFailed++;
+  }
+
+  // the key includes the runtime state, so the reference is set up like the others below:
+  Open303 reference;
+  reference.setSampleRate(44100.0);
+  UINT64 referenceKey = RenderCache::computeKey(reference, 44100);
+
+  for(int s=0; s<NUM_SETTINGS; s++)
+  {
+    Open303 synth;
+    synth.setSampleRate(44100.0);
+    if( RenderCache::computeKey(synth, 44100) != referenceKey )
+    {
+      printf("the key of an unchanged synth differs\n");
+      return 1;
+    }
+    changeSetting(synth, s);
+    if( RenderCache::computeKey(synth, 44100) == referenceKey )
+    {
+      printf("the key doesn't change with the %s\n", settingNames[s]);
+      numFailed++;
+    }
+  }
+
+  return numFailed > 0 ? 1 : 0;
+}
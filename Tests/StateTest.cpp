@@ -0,0 +1,182 @@
+// This test saves the runtime state of an Open303 in the middle of a note, renders on, restores
+// the state and renders again - the two renderings must be identical, sample by sample. It does so
+// with and without the sequencer running. Then it checks that loadState rejects truncated and
+// corrupted data (a wrong header, out of range notes, oscillator phases and sequencer steps)
+// without touching the state: after the rejected loads, the synth must still render exactly what
+// it rendered after the last valid load.
+
+#include "../Source/DSPCode/rosic_Open303.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+using namespace rosic;
+
+static const int numPreRollSamples = 12345; // the state is saved after these
+static const int numSamples        = 20000; // rendered after the save and after each load
+
+// the byte offsets of some variables in the state (see Open303::writeState):
+static const int currentNoteOffset  = 48;   // after magic, version and 5 doubles
+static const int numHeldNotesOffset = 58;   // after currentNote, noteOffCountDown and 2 bools
+static const int sequencerStepFromEnd = 16; // the sequencer writes running, step, countDown and
+                                            // driftError at the very end
+
+static void setUpSynth(Open303& synth, bool useSequencer)
+{
+  synth.setCutoff(800.0);
+  synth.setResonance(70.0);
+  synth.setEnvMod(60.0);
+  synth.setDecay(400.0);
+  synth.setAccent(50.0);
+  synth.setWaveform(0.85);
+  if( useSequencer )
+  {
+    synth.sequencer.setMode(AcidSequencer::KEY_SYNC);
+    AcidPattern* pattern = synth.sequencer.getPattern(0);
+    for(int k=0; k<16; k++)
+    {
+      pattern->setGate(k, k%3 != 2);
+      pattern->setKey(k, (k*5) % 12);
+      pattern->setSlide(k, k%4 == 1);
+      pattern->setAccent(k, k%5 == 0);
+    }
+  }
+}
+
+static void render(Open303& synth, std::vector<double>& out)
+{
+  out.resize(numSamples);
+  for(int n=0; n<numSamples; n++)
+    out[n] = synth.getSample();
+}
+
+static bool isIdentical(const std::vector<double>& a, const std::vector<double>& b)
+{
+  return a.size() == b.size() && memcmp(&a[0], &b[0], a.size()*sizeof(double)) == 0;
+}
+
+static void writeInt(std::vector<unsigned char>& state, int offset, int value)
+{
+  for(int i=0; i<4; i++)
+    state[offset+i] = (unsigned char) (((unsigned int) value) >> (8*i));
+}
+
+static void writeDouble(std::vector<unsigned char>& state, int offset, double value)
+{
+  UINT64 bits;
+  memcpy(&bits, &value, sizeof(double));
+  for(int i=0; i<8; i++)
+    state[offset+i] = (unsigned char) (bits >> (8*i));
+}
+
+static int readInt(const std::vector<unsigned char>& state, int offset)
+{
+  unsigned int value = 0;
+  for(int i=0; i<4; i++)
+    value |= ((unsigned int) state[offset+i]) << (8*i);
+  return (int) value;
+}
+
+static bool checkCorruptions(Open303& synth, const std::vector<unsigned char>& state)
+{
+  int size        = (int) state.size();
+  int phaseOffset = numHeldNotesOffset + 4 + 8*readInt(state, numHeldNotesOffset);
+  int stepOffset  = size - sequencerStepFromEnd;
+
+  struct Corruption
+  {
+    const char* name;
+    int         offset;
+    int         intValue;      // written when isDouble is false
+    double      doubleValue;   // written when isDouble is true
+    bool        isDouble;
+  };
+  const Corruption corruptions[] =
+  {
+    { "wrong magic",               0,                  0,     0.0,   false },
+    { "wrong version",             4,                  12345, 0.0,   false },
+    { "current note 128",          currentNoteOffset,  128,   0.0,   false },
+    { "current note -2",           currentNoteOffset,  -2,    0.0,   false },
+    { "held notes -1",             numHeldNotesOffset, -1,    0.0,   false },
+    { "oscillator phase -1",       phaseOffset,        0,     -1.0,  true  },
+    { "oscillator phase 1e9",      phaseOffset,        0,     1.e9,  true  },
+    { "oscillator phase NaN",      phaseOffset,        0,     NAN,   true  },
+    { "sequencer step 16",         stepOffset,         16,    0.0,   false },
+    { "sequencer step 1000000",    stepOffset,         1000000, 0.0, false },
+    { "sequencer step -1",         stepOffset,         -1,    0.0,   false },
+    { "sequencer countdown -100",  stepOffset+4,       -100,  0.0,   false },
+  };
+
+  bool ok = true;
+  for(int c=0; c<(int) (sizeof(corruptions)/sizeof(Corruption)); c++)
+  {
+    std::vector<unsigned char> corrupted(state);
+    if( corruptions[c].isDouble )
+      writeDouble(corrupted, corruptions[c].offset, corruptions[c].doubleValue);
+    else
+      writeInt(corrupted, corruptions[c].offset, corruptions[c].intValue);
+    if( synth.loadState(&corrupted[0], size) )
+    {
+      printf("  %s was accepted - FAILED\n", corruptions[c].name);
+      ok = false;
+    }
+  }
+
+  // truncated and too long data:
+  std::vector<unsigned char> longer(state);
+  longer.push_back(0);
+  if( synth.loadState(&state[0], size-1) || synth.loadState(&state[0], 20)
+    || synth.loadState(&longer[0], size+1) || synth.loadState(NULL, 0) )
+  {
+    printf("  truncated or too long data was accepted - FAILED\n");
+    ok = false;
+  }
+  return ok;
+}
+
+static bool checkSaveAndLoad(bool useSequencer)
+{
+  const char* name = useSequencer ? "with sequencer" : "without sequencer";
+  Open303 synth;
+  setUpSynth(synth, useSequencer);
+  synth.noteOn(40, 120);
+  synth.noteOn(45, 60);
+  for(int n=0; n<numPreRollSamples; n++)
+    synth.getSample();
+
+  std::vector<unsigned char> state(synth.getMaxStateSize());
+  int size = synth.saveState(&state[0], (int) state.size());
+  if( size == 0 || size != synth.getStateSize() )
+  {
+    printf("%s: saveState returned %d bytes - FAILED\n", name, size);
+    return false;
+  }
+  state.resize(size);
+
+  std::vector<double> first, second, third;
+  render(synth, first);
+  bool loaded = synth.loadState(&state[0], size);
+  render(synth, second);
+  bool ok = loaded && isIdentical(first, second);
+  printf("%s: %d bytes, output after loading %s\n", name, size,
+    ok ? "identical" : "differs - FAILED");
+
+  // the rejected loads must leave the state as it was after the last valid one:
+  synth.loadState(&state[0], size);
+  if( !checkCorruptions(synth, state) )
+    ok = false;
+  render(synth, third);
+  if( !isIdentical(first, third) )
+  {
+    printf("  the rejected loads have changed the state - FAILED\n");
+    ok = false;
+  }
+  return ok;
+}
+
+int main()
+{
+  bool ok = checkSaveAndLoad(false);
+  ok = checkSaveAndLoad(true) && ok;
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,196 @@
+// This test checks the unison lanes against the single voice of Open303. A single lane without
+// detune and offsets, rendered through UnisonLanes directly, must produce exactly the output of
+// the chain oscillator -> highpass1 -> filter, for all oscillator engines and with a sweeping
+// cutoff and changing frequencies. Switching to 4 lanes (with lane 0 still without detune and
+// offsets) and back to 1 must not disturb lane 0, and the switched off lanes must not leak into
+// the output - so after switching back, the output must be that of the chain again.
+//
+// On the level of Open303, switching from 4 lanes to 1 before the first note must give the plain
+// single voice, and switching from 1 lane to 4 and back in the middle of a sequence must give the
+// same output through getSample and processBlock, without any invalid samples.
+
+#include "../Source/DSPCode/rosic_Open303.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+using namespace rosic;
+
+static const int oversampling    = 4;     // samples per call of UnisonLanes::render (as in Open303)
+static const int numCalls        = 5000;  // per phase of the lane test
+static const int numLanes        = 4;
+static const int numSynthSamples = 40000;
+
+static void setUpSynth(Open303& synth)
+{
+  synth.setSampleRate(44100.0);
+  synth.setCutoff(800.0);
+  synth.setResonance(70.0);
+  synth.setEnvMod(60.0);
+  synth.setDecay(400.0);
+  synth.setAccent(50.0);
+  synth.setVolume(-6.0);
+  synth.setWaveform(0.85);
+}
+
+// renders numCalls calls through the lanes and the chain of the synth's own oscillator, highpass1
+// and filter and returns whether they are identical (or just runs them when compare is false):
+static bool renderLanesAndChain(Open303& synth, int offset, bool compare)
+{
+  bool identical = true;
+  for(int c=0; c<numCalls; c++)
+  {
+    int    n  = offset + c;
+    double fc = 300.0 + 5000.0*(0.5+0.5*sin(n*0.003));
+    synth.oscillator.setFrequency(55.0 * (1.0 + (n/1000) % 5));
+    synth.oscillator.calculateIncrement();
+    synth.filter.setCutoff(fc);
+    synth.unison.setCutoff(fc, synth.filter);
+
+    double lanes[oversampling], chain[oversampling];
+    synth.unison.render(synth.oscillator, synth.highpass1, lanes, oversampling);
+    for(int i=0; i<oversampling; i++)
+      chain[i] = synth.filter.getSample(synth.highpass1.getSample(-synth.oscillator.getSample()));
+    if( compare && memcmp(lanes, chain, sizeof(lanes)) != 0 )
+      identical = false;
+  }
+  return identical;
+}
+
+static bool checkLanes()
+{
+  static const int   engines[]     = { BlendOscillator::WAVETABLE, BlendOscillator::POLYBLEP,
+                                       BlendOscillator::PREBLENDED };
+  static const char* engineNames[] = { "wavetable", "polyBLEP", "preblended" };
+
+  bool ok = true;
+  for(int e=0; e<3; e++)
+  {
+    Open303 synth;
+    setUpSynth(synth);
+    synth.setOscillatorEngine(engines[e]);
+    synth.oscillator.updateWaveTables();
+    synth.oscillator.resetPhase();
+    synth.highpass1.reset();
+    synth.filter.reset();
+    synth.unison.resetPhases(synth.oscillator);
+    synth.unison.reset();
+
+    bool single = renderLanesAndChain(synth, 0, true);
+
+    // the other lanes detuned, lane 0 as before:
+    synth.unison.setNumLanes(numLanes);
+    for(int l=1; l<numLanes; l++)
+    {
+      synth.unison.setLaneDetune(l, 7.0*l);
+      synth.unison.setLaneCutoffOffset(l, -1.5*l);
+      synth.unison.setLaneStartPhase(l, 40.0*l);
+    }
+    renderLanesAndChain(synth, numCalls, false);
+
+    synth.unison.setNumLanes(1);
+    bool back = renderLanesAndChain(synth, 2*numCalls, true);
+
+    printf("%-10s: 1 lane %s, after %d lanes and back to 1 %s\n", engineNames[e],
+      single ? "identical to the chain" : "differs from the chain - FAILED", numLanes,
+      back ? "identical to the chain" : "differs from the chain - FAILED");
+    ok = ok && single && back;
+  }
+  return ok;
+}
+
+static void setUpSequencer(Open303& synth)
+{
+  synth.sequencer.setMode(AcidSequencer::KEY_SYNC);
+  AcidPattern* pattern = synth.sequencer.getPattern(0);
+  for(int k=0; k<16; k++)
+  {
+    pattern->setGate(k, k%3 != 2);
+    pattern->setKey(k, (k*5) % 12);
+    pattern->setSlide(k, k%4 == 1);
+    pattern->setAccent(k, k%5 == 0);
+  }
+}
+
+// renders the sequence with switches between 1 and 4 lanes at fixed positions, through getSample
+// (blockSize 0) or processBlock:
+static std::vector<double> renderSwitches(int blockSize)
+{
+  static const int switches[][2] = { { 10000, numLanes }, { 20000, 1 }, { 30000, numLanes } };
+  Open303 synth;
+  setUpSynth(synth);
+  synth.setUnisonDetune(20.0);
+  synth.setUnisonCutoffSpread(3.0);
+  setUpSequencer(synth);
+  synth.noteOn(40, 100);
+
+  std::vector<double> out(numSynthSamples);
+  int position = 0;
+  for(int s=0; s<=3; s++)
+  {
+    int end = s < 3 ? switches[s][0] : numSynthSamples;
+    for(int n=position; n<end; n+=rmax(blockSize, 1))
+    {
+      if( blockSize == 0 )
+        out[n] = synth.getSample();
+      else
+        synth.processBlock(&out[n], rmin(blockSize, end-n));
+    }
+    if( s < 3 )
+      synth.setNumUnisonLanes(switches[s][1]);
+    position = end;
+  }
+  return out;
+}
+
+static bool checkSynth()
+{
+  // switching to 4 lanes and back before the first note:
+  Open303 plain, switched;
+  setUpSynth(plain);
+  setUpSynth(switched);
+  switched.setUnisonDetune(20.0);
+  switched.setNumUnisonLanes(numLanes);
+  switched.setNumUnisonLanes(1);
+  plain.noteOn(40, 100);
+  switched.noteOn(40, 100);
+  bool identical = true;
+  for(int n=0; n<numSynthSamples; n++)
+  {
+    double y1 = plain.getSample();
+    double y2 = switched.getSample();
+    if( memcmp(&y1, &y2, sizeof(double)) != 0 )
+      identical = false;
+  }
+  printf("%d lanes and back to 1 before the first note: %s\n", numLanes,
+    identical ? "identical to the single voice" : "differs from the single voice - FAILED");
+
+  // switching in the middle of a sequence:
+  std::vector<double> reference = renderSwitches(0);
+  bool valid = true;
+  for(int n=0; n<numSynthSamples; n++)
+  {
+    if( !(fabs(reference[n]) < 10.0) )
+      valid = false;
+  }
+  bool blocksIdentical = true;
+  static const int blockSizes[] = { 1, 64, 100, 4096 };
+  for(int b=0; b<(int) (sizeof(blockSizes)/sizeof(int)); b++)
+  {
+    std::vector<double> out = renderSwitches(blockSizes[b]);
+    if( memcmp(&out[0], &reference[0], out.size()*sizeof(double)) != 0 )
+      blocksIdentical = false;
+  }
+  printf("switches between 1 and %d lanes in a sequence: %s, processBlock %s\n", numLanes,
+    valid ? "valid output" : "invalid output - FAILED",
+    blocksIdentical ? "identical to getSample" : "differs from getSample - FAILED");
+
+  return identical && valid && blocksIdentical;
+}
+
+int main()
+{
+  bool ok = checkLanes();
+  ok = checkSynth() && ok;
+  return ok ? 0 : 1;
+}